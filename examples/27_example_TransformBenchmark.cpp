@@ -0,0 +1,170 @@
+// 27_example_TransformBenchmark.cpp
+//
+// Benchmark: world matrices of a transform hierarchy.
+//
+//   Transform   per object: Transform::GetLocalTransformationMatrix times the
+//               parent's world matrix (what entity parenting does)
+//   System      TransformSystem::Update over the same hierarchy, all slots
+//               dirty, at 1/4, 1/2 and the full object count (cost should
+//               grow linearly)
+//   Partial     TransformSystem::Update with 10% of the chains moved
+//
+// The hierarchy is made of chains of CHAIN_DEPTH transforms (root, child,
+// grandchild, ...). No window output; results go to the debug log. The
+// system's world matrices are checked against the per-object reference
+// (max absolute element error).
+
+#include "gidx.h"
+
+#include <chrono>
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+
+using namespace DirectX;
+
+namespace
+{
+    constexpr uint32_t OBJECT_COUNT = 100000;
+    constexpr uint32_t CHAIN_DEPTH  = 4;
+    constexpr int      REPEATS      = 50;
+
+    struct LocalTRS
+    {
+        XMFLOAT3 position;
+        XMFLOAT4 rotation;
+        XMFLOAT3 scale;
+        uint32_t parent; // index into the same array, UINT32_MAX = root
+    };
+
+    // prepare() runs untimed before every repeat.
+    template<typename Prepare, typename Func>
+    double BestOfMs(Prepare&& prepare, Func&& func)
+    {
+        double best = 1e30;
+        for (int r = 0; r < REPEATS; ++r)
+        {
+            prepare();
+            const auto t0 = std::chrono::high_resolution_clock::now();
+            func();
+            const auto t1 = std::chrono::high_resolution_clock::now();
+            best = (std::min)(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+        }
+        return best;
+    }
+
+    std::vector<LocalTRS> MakeHierarchy(uint32_t count)
+    {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> pos(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+        std::uniform_real_distribution<float> scl(0.5f, 2.0f);
+
+        std::vector<LocalTRS> trs(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            LocalTRS& t = trs[i];
+            t.position = XMFLOAT3(pos(rng), pos(rng), pos(rng));
+            XMStoreFloat4(&t.rotation, XMQuaternionRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)));
+            t.scale    = XMFLOAT3(scl(rng), scl(rng), scl(rng));
+            t.parent   = (i % CHAIN_DEPTH == 0) ? UINT32_MAX : i - 1;
+        }
+        return trs;
+    }
+
+    // Parents are created first, so handle i belongs to trs[i].
+    std::vector<TransformHandle> Fill(TransformSystem& system, const std::vector<LocalTRS>& trs)
+    {
+        std::vector<TransformHandle> handles(trs.size());
+        for (size_t i = 0; i < trs.size(); ++i)
+        {
+            const LocalTRS& t = trs[i];
+            handles[i] = system.Create(t.parent == UINT32_MAX ? INVALID_TRANSFORM : handles[t.parent]);
+            system.SetLocal(handles[i], t.position, t.rotation, t.scale);
+        }
+        system.Update();
+        return handles;
+    }
+
+    // Re-setting a root's position marks its whole chain dirty.
+    void TouchChains(TransformSystem& system, const std::vector<LocalTRS>& trs,
+                     const std::vector<TransformHandle>& handles, uint32_t everyNth)
+    {
+        for (size_t i = 0; i < trs.size(); i += static_cast<size_t>(CHAIN_DEPTH) * everyNth)
+            system.SetPosition(handles[i], trs[i].position.x, trs[i].position.y, trs[i].position.z);
+    }
+}
+
+int main(LPVOID hwnd)
+{
+    const std::vector<LocalTRS> trs = MakeHierarchy(OBJECT_COUNT);
+
+    Debug::Log("========================================");
+    Debug::Log("TransformBenchmark: ", OBJECT_COUNT, " transforms in chains of ", CHAIN_DEPTH,
+               ", best of ", REPEATS);
+
+    // Per-object reference: Transform + parent multiply in creation order.
+    std::vector<Transform>   transforms(OBJECT_COUNT);
+    std::vector<XMFLOAT4X4A> reference(OBJECT_COUNT);
+    for (uint32_t i = 0; i < OBJECT_COUNT; ++i)
+    {
+        const LocalTRS& t = trs[i];
+        transforms[i].Position(t.position.x, t.position.y, t.position.z);
+        transforms[i].SetRotationQuaternion(XMLoadFloat4(&t.rotation));
+        transforms[i].SetScale(t.scale.x, t.scale.y, t.scale.z);
+    }
+
+    const double transformMs = BestOfMs(
+        [&]() { for (Transform& t : transforms) t.SetChanged(true); },
+        [&]()
+        {
+            for (uint32_t i = 0; i < OBJECT_COUNT; ++i)
+            {
+                XMMATRIX world = transforms[i].GetLocalTransformationMatrix();
+                if (trs[i].parent != UINT32_MAX)
+                    world = XMMatrixMultiply(world, XMLoadFloat4x4A(&reference[trs[i].parent]));
+                XMStoreFloat4x4A(&reference[i], world);
+            }
+        });
+    Debug::Log("  Transform (per object) : ", transformMs, " ms");
+
+    // TransformSystem::Update, full hierarchy dirty, growing object counts.
+    for (uint32_t count = OBJECT_COUNT / 4; count <= OBJECT_COUNT; count *= 2)
+    {
+        const std::vector<LocalTRS> part(trs.begin(), trs.begin() + count);
+        TransformSystem system;
+        const std::vector<TransformHandle> handles = Fill(system, part);
+
+        uint32_t updated = 0;
+        const double ms = BestOfMs(
+            [&]() { TouchChains(system, part, handles, 1); },
+            [&]() { updated = system.Update(); });
+
+        Debug::Log("  System Update ", count, " : ", ms, " ms  (", ms * 1.0e6 / count, " ns/transform, ",
+                   updated, " updated)");
+
+        if (count == OBJECT_COUNT)
+        {
+            float err = 0.0f;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                XMFLOAT4X4A world;
+                XMStoreFloat4x4A(&world, system.GetWorldMatrix(handles[i]));
+                for (int r = 0; r < 4; ++r)
+                    for (int c = 0; c < 4; ++c)
+                        err = (std::max)(err, std::fabs(world.m[r][c] - reference[i].m[r][c]));
+            }
+            Debug::Log("  System vs Transform    : x", transformMs / ms, ", max err ", err);
+
+            const double partialMs = BestOfMs(
+                [&]() { TouchChains(system, part, handles, 10); },
+                [&]() { updated = system.Update(); });
+            Debug::Log("  System Update 10% moved: ", partialMs, " ms  (", updated, " updated)");
+        }
+    }
+
+    Debug::Log("========================================");
+
+    return 0;
+}
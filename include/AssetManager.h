@@ -7,6 +7,8 @@
 #include "MeshAsset.h"
 #include "Material.h"
 #include "Shader.h"
+#include "StaticBatcher.h"
+#include "MeshSimplifier.h"
 
 class Scene;
 class Mesh;
@@ -14,7 +16,9 @@ class Mesh;
 class AssetManager
 {
 public:
-    AssetManager() = default;
+    // revisions: change counters of the scene the assets are drawn in
+    // (Scene::GetRenderRevision); must outlive the AssetManager.
+    explicit AssetManager(RenderRevision& revisions) : m_revisions(revisions) {}
     ~AssetManager();
 
     void Init() {}
@@ -59,6 +63,18 @@ public:
     Mesh* CreateManagedMesh(Scene& scene);
     void DeleteManagedMesh(Scene& scene, Mesh* mesh);
 
+    // Static batching (see StaticBatcher). Build replaces earlier batches;
+    // the new batch surfaces still need their GPU buffers.
+    StaticBatchStats BuildStaticBatches(Scene& scene, const StaticBatchDesc& desc = StaticBatchDesc{});
+    void ClearStaticBatches(Scene& scene);
+    const std::vector<Mesh*>& GetStaticBatches() const noexcept { return m_staticBatcher.GetBatches(); }
+
+    // Levels of detail (see MeshSimplifier). Build replaces earlier levels
+    // of the asset and returns the number of reduced levels; the new LOD
+    // surfaces still need their GPU buffers.
+    uint32_t BuildMeshLods(Scene& scene, MeshAsset* asset, const MeshLodDesc& desc = MeshLodDesc{});
+    void ClearMeshLods(Scene& scene, MeshAsset* asset);
+
 private:
     template<typename T>
     static bool RemoveOwned(std::vector<std::unique_ptr<T>>& owner, T* ptr)
@@ -73,8 +89,11 @@ private:
     bool IsMeshAssetInUse(const Scene& scene, const MeshAsset* asset) const;
     unsigned int CountMeshAssetUsers(const Scene& scene, const MeshAsset* asset) const;
 
+    RenderRevision& m_revisions;
+
     uint32_t m_nextShaderId = 0;
     uint32_t m_nextMaterialId = 0;
+    uint32_t m_nextSurfaceId = 0;
 
     std::vector<Surface*>   m_surfaces;
     std::vector<MeshAsset*> m_meshAssets;
@@ -87,4 +106,6 @@ private:
     std::vector<std::unique_ptr<Shader>>    m_ownedShaders;
 
     Material* m_defaultMaterial = nullptr;
+
+    StaticBatcher m_staticBatcher;
 };
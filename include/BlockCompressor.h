@@ -0,0 +1,55 @@
+#pragma once
+#include <cstdint>
+#include "TextureImage.h"
+
+// Channels compared by BlockCompressor::Psnr.
+enum PSNR_CHANNELS : uint32_t
+{
+    PSNR_R    = 1u << 0,
+    PSNR_G    = 1u << 1,
+    PSNR_B    = 1u << 2,
+    PSNR_A    = 1u << 3,
+    PSNR_RGB  = PSNR_R | PSNR_G | PSNR_B,
+    PSNR_RGBA = PSNR_RGB | PSNR_A,
+};
+
+// CPU encoder and decoder for the BC formats of TextureFormat. No D3D
+// calls; used by the texture cooker (tools/texcook) and by Texture when a
+// device cannot sample a cooked format.
+//
+//   BC1  principal axis endpoints, least squares refined, 4 color mode
+//   BC3  BC1 color block + BC4 alpha block
+//   BC4  min/max endpoints, 8 and 6 value modes, the better one is kept
+//   BC5  two BC4 blocks (red, green)
+//   BC7  mode 6 (one subset, RGBA); blocks with alpha also try mode 5
+//        (separate color and alpha indices), opaque blocks mode 1 with the
+//        best scoring two-subset partitions. The decoder handles modes 1,
+//        5 and 6 only, so BC7 files from other encoders may fail to decode
+//        on the CPU
+class BlockCompressor
+{
+public:
+    BlockCompressor() = delete;
+
+    // Cooker default per usage: Color and Linear -> BC7 (BC1, or BC3 with
+    // alpha, when preferSmall), Normal -> BC5, Scalar -> BC4.
+    static TextureFormat ChooseFormat(TextureUsage usage, bool hasAlpha, bool preferSmall = false) noexcept;
+
+    // True when any texel of level 0 has alpha below 255.
+    static bool HasAlpha(const TextureImage& rgba) noexcept;
+
+    // Compresses every level of an RGBA8 image into out (same size and
+    // level count). BC4 encodes red, BC5 red and green. Returns false for
+    // a compressed source or RGBA8 as target.
+    static bool Compress(const TextureImage& rgba, TextureFormat format, TextureImage& out);
+
+    // Decodes every level to RGBA8. BC4 decodes to (r, 0, 0, 255), BC5 to
+    // (r, g, 0, 255), as the GPU samples them. RGBA8 input is copied.
+    static bool Decompress(const TextureImage& image, TextureImage& out);
+
+    // Peak signal to noise ratio in dB of one level of two RGBA8 images of
+    // the same size, over the channels in channelMask. Identical images
+    // return 99.
+    static double Psnr(const TextureImage& reference, const TextureImage& test,
+                       uint32_t level, uint32_t channelMask = PSNR_RGBA);
+};
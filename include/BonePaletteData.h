@@ -7,8 +7,7 @@ static const int MAX_BONES = 128;
 
 // Engine-side Bone-Palette-Daten fuer Skinning.
 // Der eigentliche DX11-Constant-Buffer wird im Backend verwaltet.
-__declspec(align(16))
-struct BonePaletteData
+struct alignas(16) BonePaletteData
 {
     DirectX::XMMATRIX boneMatrices[MAX_BONES];
 };
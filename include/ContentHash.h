@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Hashes of file contents and path keys, for deduplicating assets loaded
+// under different names (TexturePool). No D3D calls.
+class ContentHash
+{
+public:
+    ContentHash() = delete;
+
+    // XXH64 (xxHash, 64 bit). Same values as the reference implementation,
+    // so hashes can be compared with the ones of external tools.
+    static uint64_t Xxh64(const void* data, size_t size, uint64_t seed = 0) noexcept;
+
+    // Cache key of a file: absolute, normalized, symlinks resolved as far
+    // as the path exists, lowercase (Windows paths ignore case). '/' and
+    // '\\' both count as separators, so spellings of one file share a key.
+    static std::wstring CanonicalPath(const wchar_t* filename);
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+// World-space view volume built from a view + projection matrix pair
+// (camera matrixSet or light view/projection).
+//
+// Perspective projections become a DirectX::BoundingFrustum, orthographic
+// ones a DirectX::BoundingOrientedBox (BoundingFrustum cannot represent a
+// parallel volume). A degenerate projection yields an invalid volume that
+// accepts everything, so culling never hides meshes by accident.
+//
+// SetFromExtrudedReceivers builds the shadow caster volume of a directional
+// light: the light-space AABB of a receiver volume (camera frustum),
+// extruded towards the light. Only meshes that overlap it can throw a
+// shadow into the visible region.
+class CullingVolume
+{
+public:
+    CullingVolume() = default;
+
+    void SetFromViewProjection(const DirectX::XMMATRIX& view, const DirectX::XMMATRIX& proj);
+    void SetFromExtrudedReceivers(const CullingVolume& receivers, const DirectX::XMMATRIX& lightView);
+
+    bool IsValid() const noexcept { return m_valid; }
+    bool IsOrthographic() const noexcept { return m_kind == Kind::OrientedBox; }
+
+    // Returns true when the box is (partially) inside. Invalid volume: always true.
+    bool Intersects(const DirectX::BoundingBox& box) const;
+
+    // Writes the 8 world-space corners (order as DirectXMath GetCorners).
+    // Returns false for an invalid volume.
+    bool GetCorners(DirectX::XMFLOAT3* corners) const;
+
+private:
+    enum class Kind
+    {
+        Frustum,
+        OrientedBox,
+        LightSpaceBox,
+    };
+
+    DirectX::BoundingFrustum     m_frustum;
+    DirectX::BoundingOrientedBox m_box;
+    DirectX::BoundingBox         m_lightBox;   // LightSpaceBox: bounds in light view space
+    DirectX::XMFLOAT4X4          m_lightView;  // LightSpaceBox: world -> light view
+    Kind                         m_kind  = Kind::Frustum;
+    bool                         m_valid = false;
+};
@@ -2,10 +2,11 @@
 
 #include <d3d11.h>
 #include <cstring>
+#include <cstdint>
 #include "gdxutil.h"
 #include "gdxdevice.h"
 
-struct MatrixSet;
+struct EntityConstants;
 
 class EntityGpuData
 {
@@ -28,6 +29,11 @@ public:
         constantBuffer = nullptr;
     }
 
+    // Counts a bind/upload done by the backend's shared frame buffer so the
+    // per-frame stats cover both paths.
+    static void CountUpload() { ++StatsStorage().uploads; }
+    static void CountBind()   { ++StatsStorage().binds; }
+
     static void ResetFrameStats()
     {
         StatsStorage() = {};
@@ -38,10 +44,18 @@ public:
         return StatsStorage();
     }
 
-    void Upload(const GDXDevice* device, const MatrixSet& matrices)
+    void Upload(const GDXDevice* device, const EntityConstants& constants)
+    {
+        if (Write(device, constants))
+            Bind(device);
+    }
+
+    // Ring-buffer upload without binding (fallback path of
+    // Dx11RenderBackend when constant buffer offsets are unavailable).
+    bool Write(const GDXDevice* device, const EntityConstants& constants)
     {
-        if (!device) return;
-        if (!EnsureRingBuffers(device)) return;
+        if (!device) return false;
+        if (!EnsureRingBuffers(device)) return false;
 
         const unsigned int nextIndex = (m_currentBufferIndex + 1u) % kBufferCount;
         if (m_constantBuffers[nextIndex])
@@ -58,13 +72,13 @@ public:
         if (FAILED(hr))
         {
             DBLOG_HR(hr);
-            return;
+            return false;
         }
 
-        std::memcpy(mapped.pData, &matrices, sizeof(MatrixSet));
+        std::memcpy(mapped.pData, &constants, sizeof(EntityConstants));
         device->GetDeviceContext()->Unmap(constantBuffer, 0);
-        Bind(device);
         ++StatsStorage().uploads;
+        return true;
     }
 
     void Bind(const GDXDevice* device) const
@@ -80,6 +94,11 @@ public:
 
     ID3D11Buffer* constantBuffer = nullptr;
 
+    // Byte offset of this frame's block in the backend's shared frame
+    // constant buffer (FrameConstantAllocator). Only meaningful while the
+    // owning mesh is marked updated this frame.
+    uint32_t frameOffset = UINT32_MAX;
+
 private:
     bool EnsureRingBuffers(const GDXDevice* device)
     {
@@ -2,12 +2,15 @@
 #include "IRenderBackend.h"
 #include "TexturePool.h"
 #include "Dx11ShadowMap.h"
+#include "FrameConstantAllocator.h"
 
 #include <memory>
 
 struct ID3D11SamplerState;
 struct ID3D11BlendState;
 struct ID3D11ShaderResourceView;
+struct ID3D11Buffer;
+struct ID3D11DeviceContext1;
 
 class Dx11ShadowMap;
 class Dx11LightManagerGpuData;
@@ -72,6 +75,28 @@ public:
     void BindMaterial(const Material* material, const TexturePool* texturePool) override;
     void SetAlphaBlend(bool enable) override;
 
+    // Step 6
+    bool IsShaderValid(const Shader* shader, ShaderBindMode mode) const override;
+    void BindShader(GDXDevice& device, Shader* shader, ShaderBindMode mode) override;
+    void UploadEntityConstants(GDXDevice& device, Mesh& mesh, const EntityConstants& constants) override;
+    void DrawSurface(GDXDevice& device, Surface& surface, unsigned int flagsVertex) override;
+
+    // Step 7
+    bool UploadInstanceData(GDXDevice& device, const DirectX::XMFLOAT4X4* worlds, uint32_t count) override;
+    void DrawSurfaceInstanced(GDXDevice& device, Surface& surface, unsigned int flagsVertex,
+                              uint32_t instanceCount, uint32_t firstInstance) override;
+
+    // Step 8
+    void ResetEntityConstants() override;
+    void CommitEntityConstants(GDXDevice& device) override;
+
+    // Step 9
+    void UploadPassConstants(GDXDevice& device, const PassConstants& constants) override;
+
+    // True when entity constants go through the shared frame buffer
+    // (D3D11.1 constant buffer offsets); false = per-entity ring buffers.
+    bool UsesFrameConstantBuffer() const noexcept { return m_context1 != nullptr; }
+
     // Internal: called by GDXDevice::CreateShadowBuffer.
     bool EnsureShadowCreated(GDXDevice& device, unsigned int width, unsigned int height);
 
@@ -79,6 +104,10 @@ public:
     const Dx11ShadowMap& GetShadow() const;
 
 private:
+    // Switches between the bound shader's stream and packed input layouts
+    // to match the surface. False if the required layout is missing.
+    bool SelectInputLayout(GDXDevice& device, bool packed);
+
     GDXDevice* m_device = nullptr;
 
     std::unique_ptr<Dx11ShadowMap> m_shadow;
@@ -98,5 +127,30 @@ private:
     std::unique_ptr<Dx11LightManagerGpuData> m_lightGpuData;
     std::unique_ptr<LightArrayBuffer>        m_lightCBData;
 
+    // Shader bound by BindShader and whether its packed input layout is
+    // active (see SelectInputLayout).
+    Shader* m_boundShader        = nullptr;
+    bool    m_packedLayoutBound  = false;
+
+    // Per-instance world matrices (dynamic VB, grown on demand).
+    ID3D11Buffer* m_instanceBuffer   = nullptr;
+    uint32_t      m_instanceCapacity = 0;
+
+    // Frame constant buffer for entity matrices: all blocks of a frame are
+    // packed by m_entityConstants and bound per draw via offset.
+    // m_context1 is nullptr when offsets are unsupported (fallback path).
+    FrameConstantAllocator m_entityConstants;
+    ID3D11DeviceContext1*  m_context1           = nullptr;
+    ID3D11Buffer*          m_frameCB            = nullptr;
+    uint32_t               m_frameCBCapacity    = 0;
+    bool                   m_frameNoOverwrite   = false; // MapNoOverwriteOnDynamicConstantBuffer
+    bool                   m_frameCBWritten     = false; // DISCARD already done this frame
+    unsigned int           m_frameCommits       = 0;
+
+    // Per-pass block (b5), rewritten at the start of every pass.
+    ID3D11Buffer* m_passCB = nullptr;
+
+    void InitFrameConstants(GDXDevice& device);
+
     void CreateFrameStates(GDXDevice& device);
 };
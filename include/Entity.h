@@ -3,9 +3,12 @@
 #include <cstdint>
 #include <vector>
 #include <algorithm>
+#include <new>
 #include "Transform.h"
+#include "TransformSystem.h"
 #include "gdxutil.h"
 #include "RenderLayers.h"
+#include "RenderRevision.h"
 #include "Viewport.h"
 
 // Forward declarations
@@ -54,8 +57,8 @@ public:
         float Width, float Height,
         float MinDepth, float MaxDepth);
 
-    void* operator new(size_t size) { return _aligned_malloc(size, 16); }
-    void  operator delete(void* p) noexcept { _aligned_free(p); }
+    void* operator new(size_t size) { return ::operator new(size, std::align_val_t{ 16 }); }
+    void  operator delete(void* p) noexcept { ::operator delete(p, std::align_val_t{ 16 }); }
 
     EntityType GetEntityType() const noexcept { return m_entityType; }
     bool IsMesh()   const noexcept { return m_entityType == EntityType::Mesh; }
@@ -67,16 +70,29 @@ public:
     inline Light* AsLight()  noexcept { return reinterpret_cast<Light*>(this); }
 
     bool IsActive()  const noexcept { return m_active; }
-    void SetActive(bool active)     noexcept { m_active = active; }
+    void SetActive(bool active)     noexcept { if (m_active != active) { m_active = active; MarkRenderDirty(); } }
 
     bool IsVisible() const noexcept { return m_visible; }
-    void SetVisible(bool visible)   noexcept { m_visible = visible; }
+    void SetVisible(bool visible)   noexcept { if (m_visible != visible) { m_visible = visible; MarkRenderDirty(); } }
 
     bool GetCastShadows() const noexcept { return m_castShadows; }
-    void SetCastShadows(bool enabled) noexcept { m_castShadows = enabled; }
+    void SetCastShadows(bool enabled) noexcept { if (m_castShadows != enabled) { m_castShadows = enabled; MarkRenderDirty(); } }
 
     uint32_t GetLayerMask() const noexcept { return m_layerMask; }
-    void     SetLayerMask(uint32_t mask) noexcept { m_layerMask = mask; }
+    void     SetLayerMask(uint32_t mask) noexcept { if (m_layerMask != mask) { m_layerMask = mask; MarkRenderDirty(); } }
+
+    // Marks the entity as never moving after level load. Only a hint for
+    // bake steps such as AssetManager::BuildStaticBatches; rendering and
+    // transforms are unaffected.
+    bool IsStatic() const noexcept { return m_static; }
+    void SetStatic(bool isStatic)  noexcept { m_static = isStatic; }
+
+    // Change stamps for the retained render queues (see RenderRevision.h).
+    // The render revision changes with the flags above and, for meshes, with
+    // asset and slot material assignment; the world revision whenever a mesh
+    // world matrix is invalidated.
+    uint32_t GetRenderRevision() const noexcept { return m_renderRevision; }
+    uint32_t GetWorldRevision()  const noexcept { return m_worldRevision; }
 
     // ==================== PARENT / CHILD HIERARCHY ====================
 
@@ -100,21 +116,62 @@ public:
 
     // Liefert die vollstaendige Weltmatrix unter Beruecksichtigung der Parent-Chain.
     // worldMatrix = local * parent->GetWorldMatrix()  (rekursiv, wenn Parent vorhanden)
+    //
+    // The result is cached. Any transform change, SetParent or
+    // DetachFromParent marks this entity and its whole subtree dirty; a clean
+    // entity returns the cache without touching its parents.
     DirectX::XMMATRIX GetWorldMatrix() const;
 
+    // Invalidates the cached world matrix of this entity and all descendants.
+    // Called by Transform on every change. Stops at already dirty entities:
+    // a dirty entity always has dirty descendants.
+    void MarkWorldDirty() noexcept;
+    bool IsWorldDirty() const noexcept { return m_worldDirty; }
+
+    // Recomputes the cached world matrices of this subtree top-down, visiting
+    // only dirty entities. The parent must be clean (see Scene::UpdateWorldMatrices).
+    void UpdateWorldMatrices();
+
+    // Binds this entity to a TransformSystem slot. While bound, the world
+    // matrix comes from the system (after TransformSystem::Update); the
+    // Transform member and the entity parent are ignored for it. Bound
+    // entities should not be entity parents - use TransformSystem::SetParent.
+    // system = nullptr unbinds.
+    void BindTransform(TransformSystem* system, TransformHandle handle) noexcept;
+    TransformHandle GetTransformHandle() const noexcept { return m_transformHandle; }
+
+    // Binds the change counters of the owning scene (Scene::Create*) and
+    // takes fresh stamps from them. Unbound entities touch no counter.
+    void BindRenderRevision(RenderRevision* revisions) noexcept;
+
 protected:
+    void MarkRenderDirty() noexcept { if (m_revisions) m_renderRevision = m_revisions->TouchState(); }
+
     EntityType m_entityType = EntityType::Unknown;
 
     bool     m_active = true;
     bool     m_visible = true;
     bool     m_castShadows = true;
+    bool     m_static = false;
     uint32_t m_layerMask = LAYER_DEFAULT;
 
-    bool& isActive = m_active;
+    bool& isActive = m_active; // legacy alias; writes bypass MarkRenderDirty
+
+    RenderRevision* m_revisions      = nullptr;
+    uint32_t        m_renderRevision = 0;
+    uint32_t        m_worldRevision  = 0;
 
     // Hierarchy
     Entity* m_parent = nullptr;
     std::vector<Entity*> m_children;
+
+    // World matrix cache (see GetWorldMatrix)
+    mutable DirectX::XMMATRIX m_worldCache;
+    mutable bool              m_worldDirty = true;
+
+    // Optional data-oriented transform (see BindTransform)
+    TransformSystem* m_transformSystem = nullptr;
+    TransformHandle  m_transformHandle = INVALID_TRANSFORM;
 };
 
 typedef Entity* LPENTITY;
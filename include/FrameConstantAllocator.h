@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+// Frame-scoped linear allocator for per-draw constant blocks (entity
+// matrices). CPU side only, no graphics API: the backend copies the packed
+// bytes into one GPU buffer and binds each block by its offset.
+//
+// Blocks are aligned to ALIGNMENT bytes, the granularity of D3D11.1
+// constant buffer offsets (16 constants of 16 bytes). Data written since
+// the last MarkCommitted() is the pending range a backend still has to
+// upload; earlier blocks never move, so offsets stay valid for the frame.
+class FrameConstantAllocator
+{
+public:
+    static constexpr uint32_t ALIGNMENT      = 256;
+    static constexpr uint32_t INVALID_OFFSET = UINT32_MAX;
+
+    FrameConstantAllocator() = default;
+
+    // Rewinds to offset 0 for a new frame. Capacity is kept.
+    void Reset() noexcept;
+
+    // Copies size bytes into the next aligned block and returns its byte
+    // offset. The rest of the block is zero-filled.
+    uint32_t Allocate(const void* data, uint32_t size);
+
+    // Marks everything allocated so far as uploaded.
+    void MarkCommitted() noexcept { m_committed = m_used; }
+
+    // Pending range [GetPendingBegin(), GetUsedBytes()).
+    uint32_t GetPendingBegin() const noexcept { return m_committed; }
+    uint32_t GetUsedBytes()    const noexcept { return m_used; }
+    bool     HasPending()      const noexcept { return m_used > m_committed; }
+
+    uint32_t       GetAllocationCount() const noexcept { return m_allocations; }
+    const uint8_t* GetData()            const noexcept { return m_data.data(); }
+
+    static uint32_t AlignedSize(uint32_t size) noexcept
+    {
+        return (size + ALIGNMENT - 1u) & ~(ALIGNMENT - 1u);
+    }
+
+private:
+    std::vector<uint8_t> m_data;
+    uint32_t             m_used        = 0;
+    uint32_t             m_committed   = 0;
+    uint32_t             m_allocations = 0;
+};
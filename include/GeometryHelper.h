@@ -1,8 +1,43 @@
 #pragma once
+#include <cstdint>
+#include <vector>
 #include <DirectXMath.h>
 
 class Surface; // forward
 
+// Post-transform vertex cache statistics of an index list (FIFO cache model).
+struct GeometryCacheStats
+{
+    uint32_t triangles   = 0;
+    uint32_t vertices    = 0;     // distinct vertices referenced
+    uint32_t transformed = 0;     // vertex shader invocations (cache misses)
+    float    acmr        = 0.0f;  // transformed / triangles; 0.5 ideal, 3 worst
+    float    atvr        = 0.0f;  // transformed / vertices; 1 ideal
+};
+
+struct GeometryOptimizeDesc
+{
+    bool vertexCache = true;   // Forsyth triangle order
+    bool overdraw    = true;   // reorder triangle clusters outside-in
+    bool vertexFetch = true;   // renumber vertices in order of first use
+
+    // Soft cluster split for the overdraw pass: a cluster may end where its
+    // running ACMR is within this factor of the whole cluster's ACMR. 1.0
+    // keeps the vertex cache result; higher values give more, smaller
+    // clusters (less overdraw, slightly worse ACMR).
+    float overdrawThreshold = 1.05f;
+
+    // FIFO size used for clustering and for the statistics.
+    uint32_t cacheSize = 16;
+};
+
+struct GeometryOptimizeReport
+{
+    GeometryCacheStats before;
+    GeometryCacheStats after;
+    bool               optimized = false;  // false: surface left unchanged
+};
+
 // Statische Geometrie-Hilfsfunktionen.
 // Berechnung geometrischer Eigenschaften geh\xf6rt nicht in den Datenbeh\xe4lter Surface.
 class GeometryHelper
@@ -17,4 +52,27 @@ public:
         DirectX::XMMATRIX       rotationMatrix,
         DirectX::XMFLOAT3&      minOut,
         DirectX::XMFLOAT3&      maxOut);
+
+    // Reorders index and vertex data for the GPU: vertex cache, then
+    // overdraw, then vertex fetch. The geometry stays the same, only the
+    // order changes; FillBuffer must run again afterwards. Surfaces with
+    // out-of-range indices are left unchanged.
+    static GeometryOptimizeReport Optimize(Surface& surface, const GeometryOptimizeDesc& desc = GeometryOptimizeDesc{});
+
+    static GeometryCacheStats AnalyzeVertexCache(
+        const std::vector<unsigned int>& indices,
+        uint32_t                         vertexCount,
+        uint32_t                         cacheSize = 16);
+
+    // Single passes of Optimize. All indices must be < vertexCount.
+    static void OptimizeVertexCache(std::vector<unsigned int>& indices, uint32_t vertexCount);
+    static void OptimizeOverdraw(
+        std::vector<unsigned int>&             indices,
+        const std::vector<DirectX::XMFLOAT3>&  positions,
+        uint32_t                               cacheSize,
+        float                                  threshold);
+
+    // Returns remap[oldIndex] = newIndex in order of first use (unused
+    // vertices go last) and rewrites the indices accordingly.
+    static std::vector<uint32_t> OptimizeVertexFetch(std::vector<unsigned int>& indices, uint32_t vertexCount);
 };
@@ -1,11 +1,17 @@
 #pragma once
 #include <DirectXMath.h>
 #include <vector>
+#include <cstdint>
 #include "Viewport.h"
 
 class GDXDevice;
 class Entity;
 class Mesh;
+class Surface;
+class Shader;
+struct EntityConstants;
+struct PassConstants;
+enum class ShaderBindMode;
 class Light;
 class Material;
 class TexturePool;
@@ -19,6 +25,13 @@ class RenderTextureTarget;
 // Step 3: Material bind path (SRVs t0..t6 + CB b2) + frame-level states encapsulated.
 // Step 4: Per-entity constant path fully encapsulated (matrix CB b0, bone CB b4).
 // Step 5: Light constant upload (CB b1) + entity frame stats encapsulated.
+// Step 6: Shader bind, entity CB upload and surface draw encapsulated, so the
+//         complete flush can run without D3D11 (see RecordingRenderBackend).
+// Step 7: Hardware instancing (per-instance world matrices + instanced draw).
+// Step 8: Entity constants staged per pass into one frame-scoped buffer and
+//         committed once (see FrameConstantAllocator).
+// Step 9: View/projection moved into a per-pass block (b5); the entity block
+//         (b0) only holds world + inverse transpose.
 // IMPORTANT: no behavior change, slots and order remain exactly as before.
 class IRenderBackend
 {
@@ -30,6 +43,8 @@ public:
         unsigned int uploads       = 0;
         unsigned int binds         = 0;
         unsigned int ringRotations = 0;
+        unsigned int frameBytes    = 0; // bytes used in the frame constant buffer
+        unsigned int frameCommits  = 0; // CommitEntityConstants calls that copied data
     };
 
     virtual ~IRenderBackend() = default;
@@ -106,4 +121,55 @@ public:
 
     // Enables or disables alpha blending on render target 0.
     virtual void SetAlphaBlend(bool enable) = 0;
+
+    // Step 6 ----------------------------------------------------------------
+
+    // False for backends that never touch the GDXDevice (headless/recording).
+    // RenderManager skips its IsInitialized() guards for such backends.
+    virtual bool RequiresDevice() const { return true; }
+
+    // Returns true when the shader can be bound in the given mode.
+    virtual bool IsShaderValid(const Shader* shader, ShaderBindMode mode) const = 0;
+
+    // Binds input layout + VS (+ PS for VS_PS, PS = nullptr for VS_ONLY).
+    virtual void BindShader(GDXDevice& device, Shader* shader, ShaderBindMode mode) = 0;
+
+    // Stages the entity block (b0: world, world inverse transpose) of a mesh for this frame.
+    // Called once per mesh and frame; every draw then uses BindEntityConstants.
+    // The data reaches the GPU with the next CommitEntityConstants (backends
+    // without offset binding may upload immediately).
+    virtual void UploadEntityConstants(GDXDevice& device, Mesh& mesh, const EntityConstants& constants) = 0;
+
+    // Binds the surface vertex streams selected by flagsVertex and issues the indexed draw.
+    virtual void DrawSurface(GDXDevice& device, Surface& surface, unsigned int flagsVertex) = 0;
+
+    // Step 7 ----------------------------------------------------------------
+
+    // Uploads the per-instance world matrices (row-major, one per instance)
+    // for the current flush. firstInstance of DrawSurfaceInstanced indexes
+    // into this array. Returns false if the data could not be uploaded; the
+    // caller then draws the affected meshes one by one.
+    virtual bool UploadInstanceData(GDXDevice& device, const DirectX::XMFLOAT4X4* worlds, uint32_t count) = 0;
+
+    // Binds the surface streams plus the instance stream and draws
+    // instanceCount instances starting at firstInstance. flagsVertex must
+    // contain D3DVERTEX_INSTANCE_WORLD (the instanced shader's layout).
+    virtual void DrawSurfaceInstanced(GDXDevice& device, Surface& surface, unsigned int flagsVertex,
+                                      uint32_t instanceCount, uint32_t firstInstance) = 0;
+
+    // Step 8 ----------------------------------------------------------------
+
+    // Starts a new frame for staged entity constants. Called once per frame
+    // by RenderManager::InvalidateFrame; earlier blocks become invalid.
+    virtual void ResetEntityConstants() = 0;
+
+    // Copies every entity block staged since the last commit to the GPU.
+    // Called once per pass after staging and before its first draw.
+    virtual void CommitEntityConstants(GDXDevice& device) = 0;
+
+    // Step 9 ----------------------------------------------------------------
+
+    // Uploads the pass block (view, projection, eye position) and binds it
+    // to VS/PS b5. Called at the start of each pass; valid for all its draws.
+    virtual void UploadPassConstants(GDXDevice& device, const PassConstants& constants) = 0;
 };
@@ -14,6 +14,11 @@ public:
     void Init(ID3D11Device* device);
     HRESULT CreateInputLayoutVertex(ID3D11InputLayout** layout, SHADER* shader, DWORD& saveFlags, DWORD flags);
 
+    // Layout for surfaces with one interleaved, quantized stream in slot 0
+    // (VertexPacker offsets); the instance stream, if any, uses slot 1.
+    // CreateInputLayoutVertex also creates it in shader->inputlayoutPacked.
+    HRESULT CreateInputLayoutPacked(ID3D11InputLayout** layout, SHADER* shader, DWORD flags);
+
 private:
     ID3D11Device* m_device;
 };
\ No newline at end of file
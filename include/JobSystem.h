@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing job system for data-parallel engine work
+// (render/shadow queue build).
+//
+// - One job deque per participating thread. Index 0 belongs to the calling
+//   thread (render thread), 1..N-1 to the workers.
+// - A thread pops from the back of its own deque and steals from the front
+//   of the others when it runs dry.
+// - ParallelFor blocks; the caller executes jobs too, so threadCount = 1
+//   means "no workers, run everything inline".
+//
+// Not re-entrant: do not call ParallelFor from inside a job.
+class JobSystem
+{
+public:
+    // begin/end: index range, chunk: 0-based chunk number (stable, use it to
+    // address per-chunk output buffers).
+    using RangeFunc = std::function<void(uint32_t begin, uint32_t end, uint32_t chunk)>;
+
+    JobSystem() = default;
+    ~JobSystem();
+
+    JobSystem(const JobSystem&)            = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // threadCount includes the calling thread. 0 = std::thread::hardware_concurrency().
+    void Start(unsigned int threadCount);
+    void Stop();
+
+    unsigned int GetThreadCount() const noexcept { return static_cast<unsigned int>(m_queues.size()); }
+    bool         IsRunning()      const noexcept { return m_running.load(std::memory_order_acquire); }
+
+    // Splits [0, count) into chunkCount contiguous ranges and runs func on
+    // each. Returns when all chunks are done.
+    void ParallelFor(uint32_t count, uint32_t chunkCount, const RangeFunc& func);
+
+private:
+    struct Job
+    {
+        const RangeFunc*       func    = nullptr;
+        uint32_t               begin   = 0;
+        uint32_t               end     = 0;
+        uint32_t               chunk   = 0;
+        std::atomic<uint32_t>* pending = nullptr;
+    };
+
+    struct JobQueue
+    {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    };
+
+    bool PopLocal(unsigned int queueIndex, Job& out);
+    bool Steal(unsigned int thiefIndex, Job& out);
+    bool TryRunOne(unsigned int queueIndex);
+    void WorkerMain(unsigned int queueIndex);
+
+    std::vector<std::unique_ptr<JobQueue>> m_queues;
+    std::vector<std::thread>               m_workers;
+
+    std::mutex              m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    std::atomic<uint32_t>   m_queued  { 0 };
+    std::atomic<bool>       m_running { false };
+};
@@ -6,8 +6,7 @@
 // Der Matrix-Buffer lebt in gpuData (EntityGpuData) - geerbt von Entity.
 class LightGpuData;
 
-__declspec(align(16))
-struct LightBufferData
+struct alignas(16) LightBufferData
 {
     DirectX::XMFLOAT4 lightPosition;
     DirectX::XMFLOAT4 lightDirection;
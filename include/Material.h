@@ -1,7 +1,9 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include <new>
 #include <DirectXMath.h>
+#include "RenderRevision.h"
 
 // Material.h kennt kein DX11 (keine COM-Interfaces, kein <d3d11.h>).
 // DirectXMath bleibt – es ist eine reine Mathematik-Bibliothek.
@@ -97,6 +99,7 @@ public:
     {
         if (enabled) properties.flags |= MF_TRANSPARENT;
         else         properties.flags &= ~MF_TRANSPARENT;
+        TouchAssets(); // moves draws between opaque/transparent queues
     }
     inline bool IsTransparent() const { return (properties.flags & MF_TRANSPARENT) != 0; }
 
@@ -112,6 +115,9 @@ public:
     // 0 = nicht initialisiert (Material nicht ueber CreateMaterial erstellt).
     uint32_t id = 0;
 
+    // Change counters of the owning scene, bound by AssetManager::CreateMaterial.
+    void BindRenderRevision(RenderRevision* revisions) noexcept { m_revisions = revisions; }
+
     uint32_t albedoIndex = 0;
     uint32_t normalIndex = 1;
     uint32_t ormIndex = 2;
@@ -186,7 +192,7 @@ public:
 // ==================== SHADOW FLAGS ====================
     // Getter/Setter – direkte Feldzugriffe vermeiden, da receiveShadows
     // mit properties.receiveShadows (float fuer den Shader) synchron bleiben muss.
-    inline void SetCastShadows(bool enabled)    { m_castShadows = enabled; }
+    inline void SetCastShadows(bool enabled)    { m_castShadows = enabled; TouchAssets(); }
     inline void SetReceiveShadows(bool enabled)
     {
         m_receiveShadows = enabled;
@@ -213,13 +219,17 @@ public:
 
     // ==================== MEMORY MANAGEMENT ====================
     void* operator new(size_t size) {
-        return _aligned_malloc(size, 16);
+        return ::operator new(size, std::align_val_t{ 16 });
     }
     void operator delete(void* p) noexcept {
-        _aligned_free(p);
+        ::operator delete(p, std::align_val_t{ 16 });
     }
 
 private:
+    void TouchAssets() noexcept { if (m_revisions) m_revisions->TouchAssets(); }
+
+    RenderRevision* m_revisions = nullptr;
+
     // Shadow-Flags als private Member – Zugriff nur ueber Setter,
     // damit properties.receiveShadows (float) stets synchron bleibt.
     bool m_castShadows    = true;
@@ -1,6 +1,6 @@
 #pragma once
-#include <d3d11.h>
 #include <vector>
+#include <cstdint>
 #include <DirectXMath.h>
 #include <DirectXCollision.h>
 #include "Entity.h"
@@ -10,6 +10,7 @@
 class Surface;
 class Material;
 class MeshAsset;
+struct ID3D11Buffer;
 
 enum COLLISION {
     NONE = 0,
@@ -35,7 +36,7 @@ public:
     friend class AssetManager;
 
     void Update(const GDXDevice* device) override;
-    void Update(const GDXDevice* device, const MatrixSet* matrixSet);
+    void Update(const GDXDevice* device, const EntityConstants* constants);
 
     unsigned int NumSurface() const { return m_meshRenderer.NumSlots(); }
     unsigned int GetSlotCount() const noexcept { return m_meshRenderer.NumSlots(); }
@@ -53,27 +54,80 @@ public:
     void RemoveSurface(Surface* surface);
 
     void SetCollisionMode(COLLISION collision);
+    bool HasCollision() const noexcept { return collisionType != COLLISION::NONE; }
     bool CheckCollision(Mesh* mesh);
-    void CalculateOBB(unsigned int index);
 
-    bool IsUpdatedThisFrame() const noexcept { return m_updatedThisFrame; }
-    void MarkUpdated()              noexcept { m_updatedThisFrame = true; }
-    void ResetFrameFlag()           noexcept { m_updatedThisFrame = false; }
+    // Collision box (obb): the extents of surface slot 0 around the mesh
+    // pivot, transformed by the world matrix, so entity parents and
+    // TransformSystem bindings count. UpdateOBB refreshes it only when the
+    // world matrix or the asset geometry changed; Scene::UpdateWorldMatrices
+    // and CheckCollision call it, rendering does not. CalculateOBB forces
+    // a recompute (the index is ignored, slot 0 is used).
+    void UpdateOBB();
+    void CalculateOBB(unsigned int index);
 
-    void* operator new(size_t size) { return _aligned_malloc(size, 16); }
-    void  operator delete(void* p) noexcept { _aligned_free(p); }
+    // World-space culling bound (AABB of all MeshAsset surfaces).
+    // Cached: the local AABB is rebuilt only when the asset geometry changes,
+    // the world AABB only when the passed world matrix differs from last time.
+    // Returns false when the mesh has no geometry (caller treats it as visible).
+    bool GetWorldBounds(const DirectX::XMMATRIX& world, DirectX::BoundingBox& outBounds);
+    void InvalidateBounds() noexcept { m_localBoundsValid = false; m_worldBoundsValid = false; }
+
+    // Set while a static batch draws this mesh's geometry (see StaticBatcher).
+    // The mesh stays in the scene for picking and collision but is skipped by
+    // the render queues.
+    bool IsStaticBatched() const noexcept { return m_staticBatched; }
+    void SetStaticBatched(bool batched) noexcept { if (m_staticBatched != batched) { m_staticBatched = batched; MarkRenderDirty(); } }
+
+    // Level of detail chosen by the last main camera queue build
+    // (MeshAsset::SelectLod). Shadow casters draw the same level.
+    uint32_t GetLodLevel() const noexcept { return m_lodLevel; }
+    void SetLodLevel(uint32_t level) noexcept { m_lodLevel = static_cast<uint8_t>(level); }
+
+    // Once-per-frame entity upload flag. Compared against a global frame
+    // stamp, so starting a frame is O(1) instead of a reset of every mesh.
+    bool IsUpdatedThisFrame() const noexcept { return m_updatedFrame == s_frame; }
+    void MarkUpdated()              noexcept { m_updatedFrame = s_frame; }
+    void ResetFrameFlag()           noexcept { m_updatedFrame = 0; }
+    static void BeginFrame()        noexcept { if (++s_frame == 0) s_frame = 1; }
+
+    void* operator new(size_t size) { return ::operator new(size, std::align_val_t{ 16 }); }
+    void  operator delete(void* p) noexcept { ::operator delete(p, std::align_val_t{ 16 }); }
 
 private:
-    void SetMeshAssetInternal(MeshAsset* asset) noexcept { m_meshRenderer.SetAsset(asset); }
-    void DetachMeshAssetInternal() noexcept { m_meshRenderer.ClearAsset(); }
+    void RefreshOBB();
+
+    void SetMeshAssetInternal(MeshAsset* asset) noexcept { m_meshRenderer.SetAsset(asset); MarkRenderDirty(); }
+    void DetachMeshAssetInternal() noexcept { m_meshRenderer.ClearAsset(); MarkRenderDirty(); }
     MeshAsset* AccessMeshAssetInternal() noexcept { return m_meshRenderer.AccessAsset(); }
-    void SetSlotMaterialInternal(unsigned int slot, Material* material) { m_meshRenderer.SetMaterial(slot, material); }
-    void ClearSlotMaterialsInternal() { m_meshRenderer.ClearSlotMaterials(); }
-    void ClearMaterialReferenceInternal(Material* material) { m_meshRenderer.ClearMaterialReference(material); }
+    void SetSlotMaterialInternal(unsigned int slot, Material* material) { m_meshRenderer.SetMaterial(slot, material); MarkRenderDirty(); }
+    void ClearSlotMaterialsInternal() { m_meshRenderer.ClearSlotMaterials(); MarkRenderDirty(); }
+    void ClearMaterialReferenceInternal(Material* material) { m_meshRenderer.ClearMaterialReference(material); MarkRenderDirty(); }
 
     MeshRenderer m_meshRenderer;
     COLLISION collisionType      = COLLISION::NONE;
-    bool      m_updatedThisFrame = false;
+    uint32_t  m_updatedFrame     = 0;
+    bool      m_staticBatched    = false;
+    uint8_t   m_lodLevel         = 0;
+
+    static uint32_t s_frame;
+
+    // Culling bounds cache (see GetWorldBounds)
+    DirectX::XMMATRIX    m_boundsWorld       = DirectX::XMMatrixIdentity();
+    DirectX::BoundingBox m_localBounds;
+    DirectX::BoundingBox m_worldBounds;
+    const MeshAsset*     m_boundsAsset       = nullptr;
+    uint64_t             m_boundsSignature   = 0;
+    bool                 m_localBoundsValid  = false;
+    bool                 m_worldBoundsValid  = false;
+    bool                 m_hasGeometry       = false;
+
+    // Collision box cache (see UpdateOBB)
+    DirectX::XMMATRIX    m_obbWorld          = DirectX::XMMatrixIdentity();
+    DirectX::XMFLOAT3    m_obbExtents        = { 0.0f, 0.0f, 0.0f };
+    const MeshAsset*     m_obbAsset          = nullptr;
+    uint64_t             m_obbSignature      = 0;
+    bool                 m_obbValid          = false;
 };
 
 typedef Mesh* LPMESH;
@@ -1,8 +1,18 @@
 #pragma once
 #include <vector>
 #include <cstdint>
+#include <DirectXCollision.h>
 
 class Surface;
+class RenderRevision;
+
+// One reduced level of detail of a MeshAsset (see AssetManager::BuildMeshLods).
+// slots parallels MeshAsset::GetSlots; nullptr = use the next finer level.
+struct MeshLod
+{
+    std::vector<Surface*> slots;       // non-owning, like the base slots
+    float                 screenSize = 0.0f; // drawn below this projected size
+};
 
 // MeshAsset: Geometriedaten einer 3D-Ressource.
 //
@@ -24,6 +34,9 @@ public:
     MeshAsset()  = default;
     ~MeshAsset() = default;
 
+    // Change counters of the owning scene, bound by AssetManager::CreateMeshAsset.
+    void BindRenderRevision(RenderRevision* revisions) noexcept { m_revisions = revisions; }
+
     // Fuegt einen Surface-Slot hinzu (non-owning).
     // Wird vom AssetManager beim Aufbau des Meshes aufgerufen.
     void AddSlot(Surface* surface);
@@ -47,9 +60,43 @@ public:
 
     bool IsEmpty() const noexcept { return m_slots.empty(); }
 
+    // Object-space AABB over all slot positions.
+    // Returns false when no slot holds any vertex.
+    bool ComputeLocalBounds(DirectX::BoundingBox& outBounds) const;
+
+    // Levels of detail. Level 0 are the slots themselves; AddLod appends
+    // the next coarser level. Thresholds must decrease from level to level.
+    void AddLod(const std::vector<Surface*>& slots, float screenSize);
+    void ClearLods();
+    uint32_t NumLods() const noexcept { return 1u + static_cast<uint32_t>(m_lods.size()); }
+    const std::vector<MeshLod>& GetLods() const noexcept { return m_lods; }
+
+    // Surface drawn for slot at the given level. Falls back to the next finer
+    // level when the slot has no surface there.
+    Surface* GetLodSlot(uint32_t lod, unsigned int slot) const;
+
+    // Level for a projected size (bounding sphere diameter / viewport
+    // height). Starting from current, a level is only left once the size is
+    // beyond its threshold by the hysteresis fraction, so a mesh near a
+    // threshold does not switch every frame.
+    uint32_t SelectLod(float screenSize, uint32_t current, float hysteresis) const noexcept;
+
+    // Cheap change signature (slot count, vertex counts and geometry
+    // revisions), used by Mesh to detect geometry edits without rescanning
+    // positions every frame.
+    uint64_t GetGeometrySignature() const;
+
 private:
+    // Shared by every mesh using this asset: re-resolve all draw records.
+    void TouchAssets() noexcept;
+
+    RenderRevision* m_revisions = nullptr;
+
     // Non-owning Zeiger auf die zugehoerigen Surface-Objekte.
     // Reihenfolge entspricht dem Slot-Index, der auch als Index
     // in MeshRenderer::slotMaterials dient.
     std::vector<Surface*> m_slots;
+
+    // Reduced levels, finest first (level 1 = m_lods[0]).
+    std::vector<MeshLod> m_lods;
 };
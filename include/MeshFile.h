@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <windows.h>
+
+class MeshAsset;
+class AssetManager;
+class BufferManager;
+
+// Binary mesh file (.oymesh), version 1. Little endian.
+//
+//   MeshFileHeader
+//   MeshFileSlot[slotCount]
+//   attribute blocks, each at a MESHFILE_ALIGNMENT aligned file offset
+//
+// Every block is a tightly packed array in exactly the layout the GPU
+// buffers use (XMFLOAT3 positions, XMUINT4 bone indices, R16/R32 indices,
+// VertexPacker vertices, ...), so a loader can hand the mapped pages
+// straight to CreateBuffer.
+constexpr uint32_t MESHFILE_MAGIC     = 0x534D594Fu; // "OYMS"
+constexpr uint32_t MESHFILE_VERSION   = 1;
+constexpr uint32_t MESHFILE_ALIGNMENT = 16;
+
+enum MeshFileStream : uint32_t
+{
+    MESHFILE_STREAM_POSITION = 0,
+    MESHFILE_STREAM_NORMAL,
+    MESHFILE_STREAM_TANGENT,
+    MESHFILE_STREAM_COLOR,
+    MESHFILE_STREAM_UV1,
+    MESHFILE_STREAM_UV2,
+    MESHFILE_STREAM_BONE_INDICES,
+    MESHFILE_STREAM_BONE_WEIGHTS,
+    MESHFILE_STREAM_PACKED,       // VertexPacker layout, stride in MeshFileSlot::packedStride
+    MESHFILE_STREAM_INDEX,        // uint16 or uint32, see MeshFileSlot::indexSize
+    MESHFILE_STREAM_COUNT
+};
+
+struct MeshFileHeader
+{
+    uint32_t magic      = MESHFILE_MAGIC;
+    uint32_t version    = MESHFILE_VERSION;
+    uint32_t headerSize = sizeof(MeshFileHeader);
+    uint32_t slotSize   = 0;   // sizeof(MeshFileSlot)
+    uint32_t slotCount  = 0;
+    uint32_t reserved   = 0;
+    uint64_t fileSize   = 0;
+    float    boundsMin[3] = { 0.0f, 0.0f, 0.0f }; // all slots, object space
+    float    boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+};
+
+struct MeshFileSlot
+{
+    uint32_t vertexCount  = 0;
+    uint32_t indexCount   = 0;
+    uint32_t indexSize    = 4;  // 2 or 4 bytes
+    uint32_t packedStride = 0;  // 0 = no packed stream
+    float    boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+    float    boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+    uint64_t offsets[MESHFILE_STREAM_COUNT] = {}; // 0 = stream not stored
+};
+
+static_assert(sizeof(MeshFileHeader) == 56, "MeshFileHeader layout");
+static_assert(sizeof(MeshFileSlot) == 120, "MeshFileSlot layout");
+
+struct MeshFileWriteDesc
+{
+    // Separate float streams (positions, normals, ...), drawn like FillBuffer.
+    bool floatStreams = true;
+
+    // Interleaved quantized stream (VertexPacker), drawn like FillBufferPacked.
+    // Skipped for slots that cannot be packed. At least one kind is written.
+    bool packedStream = false;
+};
+
+struct MeshFileLoadDesc
+{
+    // Prefer the packed stream when the file has both.
+    bool packed = false;
+
+    // Also copy the geometry into the Surface vectors (picking, collision,
+    // LOD generation, static batching). Off = GPU only; the surfaces keep
+    // counts and bounds (Surface::IsGpuOnly).
+    bool keepCpuGeometry = false;
+};
+
+// Read-only memory mapping of a .oymesh file. Validates the header, slot
+// table, block ranges and index values on Open; the accessors then return
+// pointers into the mapped view.
+class MappedMeshFile
+{
+public:
+    MappedMeshFile() = default;
+    ~MappedMeshFile();
+
+    MappedMeshFile(const MappedMeshFile&)            = delete;
+    MappedMeshFile& operator=(const MappedMeshFile&) = delete;
+
+    bool Open(const wchar_t* filename);
+    void Close();
+
+    bool IsOpen() const noexcept { return m_view != nullptr; }
+
+    const MeshFileHeader& GetHeader() const noexcept { return *m_header; }
+    uint32_t GetSlotCount() const noexcept { return m_header ? m_header->slotCount : 0u; }
+    const MeshFileSlot& GetSlot(uint32_t slot) const noexcept { return m_slots[slot]; }
+
+    // Block of a stream, nullptr when the slot does not store it.
+    const void* GetStream(uint32_t slot, MeshFileStream stream) const noexcept;
+    static uint64_t GetStreamSize(const MeshFileSlot& slot, MeshFileStream stream) noexcept;
+
+private:
+    bool Validate(uint64_t size);
+    // Largest value in the index block of a slot (range already checked).
+    uint32_t MaxIndex(const MeshFileSlot& slot) const noexcept;
+
+    HANDLE                m_file    = INVALID_HANDLE_VALUE;
+    HANDLE                m_mapping = nullptr;
+    const uint8_t*        m_view    = nullptr;
+    const MeshFileHeader* m_header  = nullptr;
+    const MeshFileSlot*   m_slots   = nullptr;
+};
+
+class MeshFile
+{
+public:
+    MeshFile() = delete;
+
+    // Writes all non-empty slots of the asset (CPU geometry; GPU-only slots
+    // are skipped). Empty slots are stored as empty slots, so slot indices
+    // and materials still line up.
+    static bool Write(const MeshAsset& asset, const wchar_t* filename,
+                      const MeshFileWriteDesc& desc = MeshFileWriteDesc{});
+
+    // Maps the file and adds one surface per stored slot to asset. Vertex
+    // and index buffers are created straight from the mapped pages; the
+    // mapping is closed again before returning. Returns false (and adds
+    // nothing) when the file is missing or invalid; a failed buffer upload
+    // also returns false, its slot is added without GPU buffers.
+    static bool Load(const wchar_t* filename, MeshAsset& asset, AssetManager& assets,
+                     BufferManager& buffers, const MeshFileLoadDesc& desc = MeshFileLoadDesc{});
+};
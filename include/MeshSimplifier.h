@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class Surface;
+
+struct SimplifyDesc
+{
+    // Target triangle count as a fraction of the source (0..1].
+    float targetRatio = 0.5f;
+
+    // Largest allowed geometric error, relative to the diagonal of the
+    // source bounding box. Simplification stops early at this error.
+    float maxError = 0.02f;
+};
+
+struct SimplifyResult
+{
+    uint32_t sourceTriangles = 0;
+    uint32_t triangles       = 0;
+    uint32_t vertices        = 0;     // referenced by the result
+    float    error           = 0.0f;  // largest collapse error, relative to the diagonal
+};
+
+struct MeshLodDesc
+{
+    // Reduced levels besides LOD 0. Fewer are built when a level would not
+    // remove enough triangles (see minStep).
+    uint32_t levels = 3;
+
+    // Triangle ratio from one level to the next.
+    float reduction = 0.5f;
+
+    // LOD 1 is drawn below this projected size (bounding sphere diameter as
+    // a fraction of the viewport height); each further level below
+    // screenSizeStep times the previous threshold.
+    float screenSize     = 0.5f;
+    float screenSizeStep = 0.5f;
+
+    // Allowed error of LOD 1 relative to the mesh diagonal. Deeper levels
+    // scale it with their smaller screen size, so the projected error stays
+    // about the same.
+    float maxError = 0.02f;
+
+    // A level is dropped (and the chain ends) when it keeps more than this
+    // fraction of the previous level's triangles.
+    float minStep = 0.85f;
+};
+
+// Quadric error edge-collapse simplifier (Garland/Heckbert quadrics).
+//
+// Every collapse moves a vertex onto one of its neighbours, so surviving
+// vertices keep their exact attributes: normals, colors, both UV sets,
+// tangents and bone data are copied, never interpolated. Vertices on a UV
+// or normal seam (several vertices at one position), on an open border or
+// at non-manifold edges never move; interior vertices may collapse into
+// them. Collapses that flip a triangle or break the edge link condition
+// are rejected.
+class MeshSimplifier
+{
+public:
+    MeshSimplifier() = delete;
+
+    // Writes the simplified index list (indices into source) to outIndices.
+    static SimplifyResult SimplifyIndices(
+        const Surface&             source,
+        const SimplifyDesc&        desc,
+        std::vector<unsigned int>& outIndices);
+
+    // Simplifies source into target (cleared first) and keeps only the
+    // referenced vertices. Does not touch the GPU buffer of target.
+    static SimplifyResult Simplify(const Surface& source, Surface& target, const SimplifyDesc& desc);
+};
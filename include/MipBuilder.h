@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include "TextureImage.h"
+
+enum class MipFilter : uint8_t
+{
+    Box,     // area average, exact 2x2 for even sizes; fast, slightly soft
+    Kaiser,  // Kaiser windowed sinc (width 3, alpha 4); sharper, for offline cooking
+};
+
+struct MipDesc
+{
+    MipFilter filter = MipFilter::Box;
+
+    // Levels including level 0. 0 = full chain down to 1x1, 1 = no mips.
+    uint32_t maxLevels = 0;
+};
+
+// CPU mip chain builder for RGBA8 images. No D3D calls, safe on worker
+// threads (TextureLoader) and in offline tools.
+//
+// Every level is filtered from the level above it, separably and one
+// destination row at a time, so the working set stays a few rows wide.
+// Edges are clamped (the texture sampler clamps as well). Per usage:
+//   Color  - rgb is decoded from sRGB, averaged in linear light and encoded
+//            again, so mips keep the brightness of level 0; alpha is linear.
+//   Normal - xyz is decoded from [0,1] to [-1,1], averaged and renormalized
+//            (flat (0,0,1) where the average cancels out).
+//   Linear, Scalar - all channels are averaged as stored.
+class MipBuilder
+{
+public:
+    MipBuilder() = delete;
+
+    // Levels of a full chain for this size (1 for 1x1).
+    static uint32_t CountLevels(uint32_t width, uint32_t height) noexcept;
+
+    // Replaces the mip chain of an RGBA8 image (level 0 is kept) with
+    // min(desc.maxLevels, CountLevels) levels. Returns false (image
+    // unchanged) for block compressed images, when level 0 is empty or
+    // its pixel data is too short.
+    static bool Build(TextureImage& image, TextureUsage usage, const MipDesc& desc = MipDesc{});
+};
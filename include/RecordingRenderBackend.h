@@ -0,0 +1,166 @@
+#pragma once
+#include "IRenderBackend.h"
+#include "FrameConstantAllocator.h"
+#include "gdxutil.h"
+
+#include <cstdint>
+#include <vector>
+
+// Headless backend: implements every IRenderBackend method without touching
+// D3D11 and appends a compact record per call instead.
+//
+// Purpose:
+//   - profile queue build / sort / flush CPU cost on machines without a GPU
+//   - assert exact command streams (shader/material/entity/draw order)
+//
+// Usage:
+//   renderManager.SetBackendFactory([](GDXDevice&) {
+//       return std::make_unique<RecordingRenderBackend>();
+//   });
+//
+// The record list is cleared at frame start (ResetEntityFrameStats is called
+// once per frame by RenderManager::InvalidateFrame), capacity is kept, so after
+// RenderScene() it holds exactly the stream of that frame.
+class RecordingRenderBackend : public IRenderBackend
+{
+public:
+    enum class RecordType : uint8_t
+    {
+        BeginShadowPass,
+        EndShadowPass,
+        BeginMainPass,
+        EndMainPass,
+        BeginRttPass,
+        EndRttPass,
+        UpdateShadowMatrices,
+        BindShadowMatrices,
+        BindShadowResources,
+        UploadLights,
+        ResetMaterialCache,
+        BindFrameSampler,
+        SetAlphaBlend,
+        BindShader,
+        BindMaterial,
+        UploadEntity,
+        BindEntity,
+        BindBones,
+        DrawSurface,
+        UploadInstances,
+        DrawSurfaceInstanced,
+        CommitEntityConstants,
+        UploadPass,
+
+        Count
+    };
+
+    // 24 bytes on x64. 'object' identifies the bound/drawn object
+    // (Shader*, Material*, Mesh*, Surface*), 'id' carries Shader::id /
+    // Material::id / Surface::id where available, 'arg' is type specific
+    // (bind mode, flagsVertex, light count, blend on/off, instance count).
+    // DrawSurfaceInstanced stores firstInstance in 'id', UploadEntity the
+    // block's byte offset in the frame allocator.
+    struct Record
+    {
+        const void* object = nullptr;
+        uint32_t    id     = 0;
+        uint32_t    arg    = 0;
+        RecordType  type   = RecordType::Count;
+    };
+
+    RecordingRenderBackend() = default;
+    ~RecordingRenderBackend() override = default;
+
+    // Step 4
+    void BindEntityConstants(GDXDevice& device, const Entity& entity) override;
+    void BindBoneConstants(GDXDevice& device, const Mesh& mesh) override;
+
+    // Step 5
+    void UploadLightConstants(
+        const std::vector<Light*>& lights,
+        const DirectX::XMFLOAT4&  globalAmbient) override;
+
+    EntityStats GetEntityFrameStats() const override;
+    void        ResetEntityFrameStats() override;
+
+    // Step 1
+    void UpdateShadowMatrixBuffer(
+        GDXDevice& device,
+        const DirectX::XMMATRIX& lightViewMatrix,
+        const DirectX::XMMATRIX& lightProjMatrix) override;
+
+    void BindShadowMatrixConstantBufferVS(GDXDevice& device) override;
+
+    void BindShadowResourcesPS(GDXDevice& device, ShadowMapTarget& shadowTarget) override;
+
+    // Step 2
+    void BeginShadowPass() override;
+    void EndShadowPass() override;
+
+    void BeginMainPass(
+        GDXDevice& device,
+        BackbufferTarget& backbufferTarget,
+        const Viewport& cameraViewport) override;
+
+    void EndMainPass() override;
+
+    void BeginRttPass(GDXDevice& device, RenderTextureTarget& rttTarget) override;
+    void EndRttPass() override;
+
+    // Step 3
+    void ResetMaterialCache() override;
+    void BindFrameSampler() override;
+    void BindMaterial(const Material* material, const TexturePool* texturePool) override;
+    void SetAlphaBlend(bool enable) override;
+
+    // Step 6
+    bool RequiresDevice() const override { return false; }
+    bool IsShaderValid(const Shader* shader, ShaderBindMode mode) const override;
+    void BindShader(GDXDevice& device, Shader* shader, ShaderBindMode mode) override;
+    void UploadEntityConstants(GDXDevice& device, Mesh& mesh, const EntityConstants& constants) override;
+    void DrawSurface(GDXDevice& device, Surface& surface, unsigned int flagsVertex) override;
+
+    // Step 7
+    bool UploadInstanceData(GDXDevice& device, const DirectX::XMFLOAT4X4* worlds, uint32_t count) override;
+    void DrawSurfaceInstanced(GDXDevice& device, Surface& surface, unsigned int flagsVertex,
+                              uint32_t instanceCount, uint32_t firstInstance) override;
+
+    // Step 8
+    void ResetEntityConstants() override;
+    void CommitEntityConstants(GDXDevice& device) override;
+
+    // Step 9
+    void UploadPassConstants(GDXDevice& device, const PassConstants& constants) override;
+
+    // Recording control ----------------------------------------------------
+
+    // When disabled only the per-type counters are updated (benchmark mode,
+    // no per-call push_back).
+    void SetRecordCommands(bool enable) noexcept { m_recordCommands = enable; }
+    bool GetRecordCommands() const noexcept { return m_recordCommands; }
+
+    const std::vector<Record>& GetRecords() const noexcept { return m_records; }
+    unsigned int GetCount(RecordType type) const noexcept;
+
+    // World matrices of the last UploadInstanceData call (packing check).
+    const std::vector<DirectX::XMFLOAT4X4>& GetInstanceData() const noexcept { return m_instanceData; }
+
+    // Entity blocks staged this frame, packed exactly as the D3D11 backend
+    // packs its frame constant buffer.
+    const FrameConstantAllocator& GetEntityConstants() const noexcept { return m_entityConstants; }
+
+    // Pass block of the last UploadPassConstants call.
+    const PassConstants& GetPassConstants() const noexcept { return m_passConstants; }
+
+    // Clears records and counters (keeps capacity).
+    void Clear();
+
+private:
+    void Append(RecordType type, const void* object = nullptr, uint32_t id = 0, uint32_t arg = 0);
+
+    std::vector<Record> m_records;
+    std::vector<DirectX::XMFLOAT4X4> m_instanceData;
+    FrameConstantAllocator           m_entityConstants;
+    PassConstants                    m_passConstants{};
+    unsigned int        m_counts[static_cast<size_t>(RecordType::Count)] = {};
+    bool                m_recordCommands = true;
+};
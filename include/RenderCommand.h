@@ -11,7 +11,7 @@ class IRenderBackend;
 
 // Ein RenderCommand beschreibt einen einzelnen Draw-Aufruf vollstaendig.
 // Er ist selbst ausfuehrbar (Execute) und wird von RenderQueue::Sort()
-// nach Shader- und Material-Pointer sortiert.
+// nach seinem 64-bit sortKey (Pass, Shader-, Material-, Surface-ID, Tiefe) sortiert.
 //
 // Vorteile gegenueber DrawEntry in verschachtelten Buckets:
 //   - Flache Liste: einfach sortierbar nach Shader, Material, Tiefe
@@ -23,7 +23,16 @@ struct RenderCommand
     // Was gezeichnet wird
     Mesh* mesh = nullptr;
     Surface* surface = nullptr;
-    DirectX::XMMATRIX      world = DirectX::XMMatrixIdentity();
+
+    // Index into the owning RenderQueue's per-frame world matrix table
+    // (RenderQueue::GetWorld). Keeps the command a small POD: sorting and
+    // iteration never move 64-byte matrices.
+    uint32_t               worldIndex = 0;
+
+    // Index of the RetainedDrawList record that produced the command, used to
+    // patch the retained queues per mesh. Fills padding; size stays 64 bytes.
+    static constexpr uint32_t NO_RECORD = 0xFFFFFFFFu;
+    uint32_t               drawRecord = NO_RECORD;
 
     // Wie gezeichnet wird
     Shader* shader = nullptr;
@@ -33,6 +42,9 @@ struct RenderCommand
     // Backend-Hook (API-neutral). RenderCommand selbst bleibt frei von DX11/VK Calls.
     IRenderBackend* backend = nullptr;
 
+    // Packed sort key (RenderSortKey.h), built once by RenderQueue::Submit.
+    uint64_t sortKey = 0;
+
     // Fuehrt den Draw-Call aus. Wird von RenderManager::FlushRenderQueue aufgerufen.
     // Voraussetzung: Shader und Material sind bereits gebunden (State-Batch-Logik
     // im Flush erkennt Wechsel anhand des vorherigen Commands).
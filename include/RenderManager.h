@@ -1,19 +1,28 @@
 #pragma once
 #include "Scene.h"
 #include "AssetManager.h"
-#include "TexturePool.h"
 #include "RenderQueue.h"
-#include "gdxdevice.h"
 #include "ShadowMapTarget.h"
 #include "BackbufferTarget.h"
-#include "RenderTextureTarget.h"
+#include "CullingVolume.h"
+#include "RetainedDrawList.h"
+#include <atomic>
 #include <memory>
+#include <functional>
+#include <vector>
 
-// No <d3d11.h>, no Dx11LightManagerGpuData, no LightArrayBuffer.
+// No <d3d11.h>, no Dx11LightManagerGpuData, no LightArrayBuffer, no
+// Dx11RenderBackend: GDXEngine installs the D3D11 backend factory. With
+// RecordingRenderBackend the whole pipeline builds and runs without the
+// Windows SDK (tests/RenderManagerTest, tests/RenderQueueBenchmark).
 // All GPU work lives in the backend or in RenderCommand::Execute.
 
 class IRenderBackend;
-class Dx11RenderBackend;
+class GDXDevice;
+class TexturePool;
+class RenderTextureTarget;
+class Light;
+class JobSystem;
 
 class RenderManager
 {
@@ -28,6 +37,16 @@ public:
         unsigned int entityUploads        = 0;
         unsigned int entityConstantBinds  = 0;
         unsigned int entityRingRotations  = 0;
+        unsigned int entityFrameBytes     = 0; // frame constant buffer bytes used
+        unsigned int entityFrameCommits   = 0; // frame constant buffer copies
+        unsigned int visibleMeshes        = 0; // passed frustum culling (main pass)
+        unsigned int culledMeshes         = 0; // rejected by frustum culling (main pass)
+        unsigned int shadowCulled         = 0; // casters rejected by light-space culling
+        unsigned int instancedDrawCalls   = 0; // opaque instanced draws (part of opaqueDrawCalls)
+        unsigned int instancedMeshes      = 0; // opaque commands drawn through instancing
+        unsigned int queueRebuilds        = 0; // retained queues rebuilt from scratch
+        unsigned int queuePatchedMeshes   = 0; // meshes re-culled by incremental queue patches
+        unsigned int lodMeshes            = 0; // visible meshes drawn below LOD 0
 
         bool operator==(const FrameStats& other) const noexcept
         {
@@ -38,15 +57,45 @@ public:
                    materialBinds        == other.materialBinds        &&
                    entityUploads        == other.entityUploads        &&
                    entityConstantBinds  == other.entityConstantBinds  &&
-                   entityRingRotations  == other.entityRingRotations;
+                   entityRingRotations  == other.entityRingRotations  &&
+                   entityFrameBytes     == other.entityFrameBytes     &&
+                   entityFrameCommits   == other.entityFrameCommits   &&
+                   visibleMeshes        == other.visibleMeshes        &&
+                   culledMeshes         == other.culledMeshes         &&
+                   shadowCulled         == other.shadowCulled         &&
+                   instancedDrawCalls   == other.instancedDrawCalls   &&
+                   instancedMeshes      == other.instancedMeshes      &&
+                   queueRebuilds        == other.queueRebuilds        &&
+                   queuePatchedMeshes   == other.queuePatchedMeshes   &&
+                   lodMeshes            == other.lodMeshes;
         }
 
         bool operator!=(const FrameStats& other) const noexcept
         {
             return !(*this == other);
         }
+
+        // Draw and bind counters only. Culling, queue patch, LOD and frame
+        // constant buffer counters move with the camera nearly every frame.
+        bool SameDrawStats(const FrameStats& other) const noexcept
+        {
+            return opaqueDrawCalls      == other.opaqueDrawCalls      &&
+                   transparentDrawCalls == other.transparentDrawCalls &&
+                   shadowDrawCalls      == other.shadowDrawCalls      &&
+                   shaderBinds          == other.shaderBinds          &&
+                   materialBinds        == other.materialBinds        &&
+                   entityConstantBinds  == other.entityConstantBinds  &&
+                   entityRingRotations  == other.entityRingRotations  &&
+                   instancedDrawCalls   == other.instancedDrawCalls   &&
+                   instancedMeshes      == other.instancedMeshes;
+        }
     };
 
+    // Creates the backend on first use through the factory. GDXEngine sets
+    // one for Dx11RenderBackend; tools/CI run the full pipeline headless, e.g.
+    //   rm.SetBackendFactory([](GDXDevice&) { return std::make_unique<RecordingRenderBackend>(); });
+    using BackendFactory = std::function<std::unique_ptr<IRenderBackend>(GDXDevice&)>;
+
     RenderManager(Scene& scene, AssetManager& assetManager, GDXDevice& device);
     ~RenderManager();
 
@@ -54,6 +103,9 @@ public:
     void SetDirectionalLight(LPENTITY dirLight);
     void RenderScene();
 
+    // Single passes; RenderScene runs both. Callers outside RenderScene must
+    // call Scene::UpdateWorldMatrices once before: parallel queue builds read
+    // the world matrix caches from job threads and never fill them.
     void RenderShadowPass();
     void RenderNormalPass();
 
@@ -62,15 +114,163 @@ public:
     void SetRTTTarget(RenderTextureTarget* rtt, LPENTITY rttCamera = nullptr);
 
     void EnsureBackend();
+
+    // Replaces the backend factory. The current backend is dropped and
+    // recreated through the new factory on the next EnsureBackend/RenderScene.
+    void SetBackendFactory(BackendFactory factory);
+    IRenderBackend* GetBackend() const noexcept { return m_backend.get(); }
     void SetTexturePool(TexturePool* pool) noexcept { m_texturePool = pool; }
     void SetShadowShader(Shader* shader)   noexcept { m_shadowShader = shader; }
+
+    // Ambient term of the light constants (b1). GDXEngine::SetGlobalAmbient
+    // forwards here.
+    void SetGlobalAmbient(const DirectX::XMFLOAT4& ambient) noexcept { m_globalAmbient = ambient; }
+    const DirectX::XMFLOAT4& GetGlobalAmbient() const noexcept { return m_globalAmbient; }
     const FrameStats& GetFrameStats() const noexcept { return m_frameStats; }
 
+    // The debug log prints the frame stats whenever the draw counters change
+    // (FrameStats::SameDrawStats). Verbose also logs on every change of the
+    // per-frame counters (culling, queue patches, constant buffer bytes).
+    void SetVerboseFrameStats(bool enable) noexcept { m_verboseFrameStats = enable; }
+    bool GetVerboseFrameStats() const noexcept { return m_verboseFrameStats; }
+
+    // Dumps every command of the camera and shadow queues to the debug log
+    // whenever their size changes. Off by default: with culling the size
+    // changes almost every frame.
+    void SetVerboseQueueLog(bool enable) noexcept { m_verboseQueueLog = enable; }
+    bool GetVerboseQueueLog() const noexcept { return m_verboseQueueLog; }
+
+    // Frustum culling in BuildRenderQueue and light-space caster culling in
+    // BuildShadowQueue (default on). Meshes without geometry are never culled.
+    void SetFrustumCulling(bool enable) noexcept { m_frustumCulling = enable; }
+    bool GetFrustumCulling() const noexcept { return m_frustumCulling; }
+
+    // Non-owning. With more than one thread, queue builds of large scenes are
+    // split into mesh ranges and run on the job system. nullptr = serial.
+    void SetJobSystem(JobSystem* jobSystem) noexcept { m_jobSystem = jobSystem; }
+
+    // Opaque runs of at least INSTANCING_MIN_RUN commands with the same
+    // shader, material and surface are drawn as one instanced draw when the
+    // shader has an instancedVariant (default on).
+    void SetInstancing(bool enable) noexcept { m_instancing = enable; }
+    bool GetInstancing() const noexcept { return m_instancing; }
+
+    // Retained render queues (default on). Queues are kept across frames per
+    // camera: with unchanged camera/light matrices and no scene change a
+    // build costs nothing; changed meshes (RenderRevision.h) are re-culled
+    // and merged into the sorted queues. Off = full rebuild on every build.
+    void SetRetainedQueues(bool enable) noexcept { m_retainedQueues = enable; }
+    bool GetRetainedQueues() const noexcept { return m_retainedQueues; }
+
+    // Level of detail selection (default on). Meshes whose asset has LODs
+    // (AssetManager::BuildMeshLods) draw the level matching their projected
+    // size; the main camera's choice is kept per mesh and used by the shadow
+    // pass. Bias scales the projected size (> 1 keeps detail longer);
+    // hysteresis is the fraction a size must pass a threshold by before the
+    // level changes.
+    void SetLodSelection(bool enable) noexcept { m_lodSelection = enable; }
+    bool GetLodSelection() const noexcept { return m_lodSelection; }
+    void SetLodBias(float bias) noexcept { m_lodBias = (std::max)(bias, 0.0f); }
+    float GetLodBias() const noexcept { return m_lodBias; }
+    void SetLodHysteresis(float hysteresis) noexcept { m_lodHysteresis = (std::min)((std::max)(hysteresis, 0.0f), 0.9f); }
+    float GetLodHysteresis() const noexcept { return m_lodHysteresis; }
+
 private:
-    RenderQueue m_opaque;
-    RenderQueue m_shadow;
+    // Scenes below this size are built serially (job overhead > gain).
+    static constexpr uint32_t PARALLEL_BUILD_MIN_MESHES = 512;
+    static constexpr uint32_t PARALLEL_BUILD_MIN_CHUNK  = 128;
+
+    // Shorter runs are drawn per mesh (instance upload not worth it).
+    static constexpr uint32_t INSTANCING_MIN_RUN = 2;
+
+    // One instanced draw: commands [firstCommand, firstCommand + count) of
+    // m_opaque, worlds at m_instanceWorlds[firstInstance...].
+    struct InstanceRun
+    {
+        uint32_t firstCommand  = 0;
+        uint32_t count         = 0;
+        uint32_t firstInstance = 0;
+    };
+
+    // Cameras that keep their own retained queues (main + RTT cameras);
+    // the least recently used one is dropped beyond this.
+    static constexpr uint32_t MAX_RETAINED_VIEWS = 4;
+
+    // Outcome of one draw record in a queue build.
+    static constexpr uint8_t RECORD_SKIPPED = 0; // not drawable / other layer
+    static constexpr uint8_t RECORD_VISIBLE = 1;
+    static constexpr uint8_t RECORD_CULLED  = 2;
 
-    std::vector<std::pair<float, RenderCommand>> m_transFrame;
+    // State of one draw record when a retained queue last built it.
+    struct RecordStamp
+    {
+        uint64_t geometry = 0; // MeshAsset::GetGeometrySignature
+        uint32_t resolve  = 0; // RetainedDrawList::Record::resolveStamp
+        uint32_t world    = 0; // Entity::GetWorldRevision
+        uint8_t  result   = RECORD_SKIPPED;
+        uint8_t  lod      = 0; // level drawn (main: hysteresis input, shadow: Mesh::GetLodLevel)
+    };
+
+    // Build inputs besides the scene. A retained queue is rebuilt from
+    // scratch when any of them differs from its last build.
+    struct QueueKey
+    {
+        DirectX::XMFLOAT4X4 view       = {};
+        DirectX::XMFLOAT4X4 proj       = {};
+        DirectX::XMFLOAT4X4 cameraView = {}; // shadow: receiver frustum of the caster volume
+        DirectX::XMFLOAT4X4 cameraProj = {};
+        IRenderBackend*     backend    = nullptr;
+        uint32_t            cullMask   = 0;
+        uint32_t            flags      = 0;  // culling volumes in use, LOD selection
+        float               lodBias    = 0.0f;
+        uint32_t            layout     = 0;  // RetainedDrawList::GetLayoutRevision
+        uint32_t            bulk       = 0;  // RenderRevision::GetBulk
+
+        bool operator==(const QueueKey& other) const noexcept;
+    };
+
+    struct RetainedQueueState
+    {
+        QueueKey                 key;
+        bool                     valid            = false;
+        uint32_t                 stateRevision    = 0; // RenderRevision::GetState at last build
+        uint32_t                 worldRevision    = 0; // RenderRevision::GetWorld at last build
+        uint32_t                 geometryRevision = 0; // RenderRevision::GetGeometry at last build
+        uint32_t                 lodRevision      = 0; // m_lodRevision at last build
+        std::vector<RecordStamp> stamps;               // one per draw record
+        unsigned int             visible          = 0;
+        unsigned int             culled           = 0;
+        unsigned int             lodMeshes        = 0;
+    };
+
+    // Retained opaque/transparent queues of one camera. The active view's
+    // queues are swapped into m_opaque/m_transparent (see SelectView).
+    struct RetainedView
+    {
+        const Entity*      camera  = nullptr;
+        uint64_t           lastUse = 0;
+        RetainedQueueState state;
+        RenderQueue        opaque      { RenderPass::Opaque };
+        RenderQueue        transparent { RenderPass::Transparent };
+    };
+
+    // Per-chunk output of the parallel build. Merged into the main queues in
+    // chunk order, so command order (and therefore sorting) matches the
+    // serial build exactly.
+    struct BuildChunk
+    {
+        RenderQueue  opaque      { RenderPass::Opaque };
+        RenderQueue  transparent { RenderPass::Transparent };
+        RenderQueue  shadow      { RenderPass::Shadow };
+        unsigned int visible      = 0;
+        unsigned int culled       = 0;
+        unsigned int shadowCulled = 0;
+        unsigned int lodMeshes    = 0;
+    };
+
+    RenderQueue m_opaque      { RenderPass::Opaque };
+    RenderQueue m_shadow      { RenderPass::Shadow };
+    RenderQueue m_transparent { RenderPass::Transparent }; // back-to-front via sort key
 
     LPENTITY m_currentCam;
     LPENTITY m_directionLight;
@@ -80,6 +280,7 @@ private:
     GDXDevice&    m_device;
 
     std::unique_ptr<IRenderBackend> m_backend;
+    BackendFactory                  m_backendFactory;
 
     ShadowMapTarget  m_shadowTarget;
     BackbufferTarget m_backbufferTarget;
@@ -90,25 +291,94 @@ private:
     // Shadow-pass VS (VS-only, b0=world, b3=lightViewProj). Non-owning.
     Shader* m_shadowShader = nullptr;
 
+    DirectX::XMFLOAT4 m_globalAmbient{ 0.2f, 0.2f, 0.2f, 1.0f };
+
     // RTT support
     RenderTextureTarget* m_activeRTT = nullptr;
     LPENTITY             m_rttCamera = nullptr;
 
+    bool          m_frustumCulling = true;
+    CullingVolume m_cameraVolume;
+    CullingVolume m_lightVolume;
+    CullingVolume m_casterVolume;
+
+    // Per-build parameters, written before a build and read-only inside it.
+    uint32_t          m_buildCullMask   = 0;
+    DirectX::XMFLOAT3 m_buildCamPos     = { 0.0f, 0.0f, 0.0f };
+    bool              m_useCameraVolume = false;
+    bool              m_useLightVolume  = false;
+    bool              m_useCasterVolume = false;
+    bool              m_buildLod        = false; // select LODs in this build
+    bool              m_buildLodOwner   = false; // main camera: store the level in the mesh
+    bool              m_buildOrtho      = false;
+    float             m_buildProjScale  = 1.0f;  // projection _22
+    RecordStamp*      m_buildStamps     = nullptr;
+
+    JobSystem*              m_jobSystem = nullptr;
+    std::vector<BuildChunk> m_buildChunks;
+
+    bool                              m_instancing = true;
+    std::vector<InstanceRun>          m_instanceRuns;
+    std::vector<DirectX::XMFLOAT4X4>  m_instanceWorlds;
+
+    bool                      m_retainedQueues = true;
+    RetainedDrawList          m_drawList;
+    std::vector<RetainedView> m_views;
+    int                       m_activeView     = -1;
+    uint64_t                  m_viewUseCounter = 0;
+    RetainedQueueState        m_shadowState;
+    RenderQueue               m_patchOpaque      { RenderPass::Opaque };
+    RenderQueue               m_patchTransparent { RenderPass::Transparent };
+    RenderQueue               m_patchShadow      { RenderPass::Shadow };
+    std::vector<uint8_t>      m_patchRemoved;
+
+    bool                  m_lodSelection  = true;
+    float                 m_lodBias       = 1.0f;
+    float                 m_lodHysteresis = 0.1f;
+    std::atomic<uint32_t> m_lodRevision{ 0 }; // bumped when a mesh changes its level
+
     bool       m_flushOnce = false;
     FrameStats m_frameStats{};
     FrameStats m_lastLoggedFrameStats{};
     bool       m_hasLastLoggedFrameStats = false;
+    bool       m_verboseFrameStats       = false;
+    bool       m_verboseQueueLog         = false;
 
     // Helper functions
     void RenderMainPassAtomic();
     void BuildRenderQueue();
-    void BuildShadowQueue();
-    void FlushRenderQueue();
-    void FlushShadowQueue(const DirectX::XMMATRIX& lightViewMatrix,
+    void BuildShadowQueue(const Light& light,
+                          const DirectX::XMMATRIX& lightViewMatrix,
                           const DirectX::XMMATRIX& lightProjMatrix);
+    void BuildRenderRange(uint32_t begin, uint32_t end,
+                          RenderQueue& opaque, RenderQueue& transparent,
+                          unsigned int& visible, unsigned int& culled, unsigned int& lodMeshes);
+    void BuildShadowRange(uint32_t begin, uint32_t end,
+                          RenderQueue& out, unsigned int& culled);
+    uint8_t BuildRenderRecord(uint32_t index, RenderQueue& opaque, RenderQueue& transparent, uint8_t& lod);
+    uint8_t BuildShadowRecord(uint32_t index, RenderQueue& out, uint8_t& lod);
+    float ProjectedSize(const DirectX::BoundingBox& bounds) const;
+    uint32_t SelectRecordLod(Mesh& mesh, const DirectX::XMMATRIX& world, uint32_t current) const;
+    void RequestTextureDetail(const RenderQueue& queue, float viewportHeight);
+    void StampRecord(RecordStamp& stamp, uint32_t index, uint8_t result, uint8_t lod) const;
+    bool IsRecordChanged(const RecordStamp& stamp, uint32_t index, bool checkGeometry) const;
+    uint32_t PatchRenderQueue(RetainedQueueState& state, bool checkGeometry);
+    uint32_t PatchShadowQueue(RetainedQueueState& state, bool checkGeometry);
+    void SelectView(const Entity* camera);
+    void InvalidateRetainedQueues();
+    uint32_t GetBuildChunkCount(uint32_t meshCount) const;
+    void PrepareParallelBuild(uint32_t chunkCount);
+    void StageEntityConstants(RenderQueue& queue, bool skipInstanceRuns = false);
+    void UploadPassConstants(const DirectX::XMMATRIX& viewMatrix,
+                             const DirectX::XMMATRIX& projMatrix);
+    void FlushRenderQueue();
+    bool CanInstance(const RenderCommand& cmd) const;
+    void BuildInstanceRuns();
+    void FlushShadowQueue();
     void FlushTransparentQueue();
     void UpdateShadowMatrixBuffer(const DirectX::XMMATRIX& viewMatrix,
                                   const DirectX::XMMATRIX& projMatrix);
+    bool IsBackendReady() const;
     void InvalidateFrame();
     void LogFrameStatsIfChanged();
 
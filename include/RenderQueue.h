@@ -1,10 +1,12 @@
 #pragma once
 #include <vector>
-#include <algorithm>
+#include <cstdint>
 #include <DirectXMath.h>
 #include "RenderCommand.h"
+#include "RenderSortKey.h"
 #include "Shader.h"
 #include "Material.h"
+#include "Surface.h"
 
 class Shader;
 class Material;
@@ -17,50 +19,124 @@ class IRenderBackend;
 // Vorher: verschachtelte ShaderBatch -> MaterialBatch -> DrawEntry Hierarchie.
 // Jetzt:  jeder Command ist eigenstaendig und traegt alle noetigen Daten.
 //
-// Sort() ordnet nach Shader- dann Material-Pointer (lexikographisch), um
-// State-Wechsel auf der GPU zu minimieren. Dasselbe Ziel wie die alte
-// Bucket-Struktur, aber flexibler (z.B. Tiefensortierung fuer Transparenz).
+// Hot/cold: Commands tragen nur einen 32-bit worldIndex. Die Weltmatrizen
+// liegen einmal pro Mesh und Frame in m_worlds (64-byte aligned).
+//
+// Jeder Command bekommt beim Submit einen 64-bit sortKey (RenderSortKey.h).
+// Sort() sortiert nur (key, index)-Paare per stabilem LSD-Radix-Sort und
+// ordnet die Commands danach einmal um. Kein Vergleich dereferenziert
+// Shader/Material.
 struct RenderQueue
 {
     std::vector<RenderCommand> commands;
+    RenderPass                 pass = RenderPass::Opaque;
+
+    RenderQueue() = default;
+    explicit RenderQueue(RenderPass queuePass) : pass(queuePass) {}
 
     void Clear()
     {
         commands.clear();
+        m_worlds.clear();
+    }
+
+    // Appends one world matrix to the per-frame table and returns its index.
+    // Call once per mesh and pass the index to every Submit of its surfaces.
+    uint32_t AddWorld(const DirectX::XMMATRIX& world)
+    {
+        m_worlds.push_back(WorldEntry{ world });
+        return static_cast<uint32_t>(m_worlds.size() - 1);
     }
 
+    const DirectX::XMMATRIX& GetWorld(uint32_t worldIndex) const noexcept
+    {
+        return m_worlds[worldIndex].world;
+    }
+
+    // depth: squared view distance (any monotonic distance works).
+    // Opaque/Shadow: near first inside a state batch. Transparent: far first.
     void Submit(Shader* shader, int flagsVertex, Material* material,
-        Mesh* mesh, Surface* surface, const DirectX::XMMATRIX& world,
-        IRenderBackend* backend)
+        Mesh* mesh, Surface* surface, uint32_t worldIndex,
+        IRenderBackend* backend, float depth = 0.0f,
+        uint32_t drawRecord = RenderCommand::NO_RECORD)
     {
         RenderCommand cmd;
         cmd.mesh = mesh;
         cmd.surface = surface;
-        cmd.world = world;
+        cmd.worldIndex = worldIndex;
+        cmd.drawRecord = drawRecord;
         cmd.shader = shader;
         cmd.material = material;
         cmd.flagsVertex = flagsVertex;
         cmd.backend = backend;
+        cmd.sortKey = MakeKey(shader, material, surface, depth);
         commands.push_back(cmd);
     }
 
-    // Sortiert nach stabiler Shader-ID, dann Material-ID.
-    // Minimiert GPU-State-Wechsel ohne Pointer-Truncation auf 64-bit Plattformen.
-    // ID 0 bedeutet: Objekt wurde nicht ueber AssetManager::Create* angelegt –
-    // solche Commands landen ans Ende (nach allen gueltigen Batches).
-    void Sort()
+    // Appends another queue's commands and world table (parallel build merge).
+    // Sort keys are already final; only worldIndex is rebased.
+    void Append(const RenderQueue& other)
     {
-        std::sort(commands.begin(), commands.end(),
-            [](const RenderCommand& a, const RenderCommand& b) {
-                const uint32_t as = a.shader   ? a.shader->id   : 0xFFFFFFFFu;
-                const uint32_t bs = b.shader   ? b.shader->id   : 0xFFFFFFFFu;
-                if (as != bs) return as < bs;
-
-                const uint32_t am = a.material ? a.material->id : 0xFFFFFFFFu;
-                const uint32_t bm = b.material ? b.material->id : 0xFFFFFFFFu;
-                return am < bm;
-            });
+        const uint32_t base = static_cast<uint32_t>(m_worlds.size());
+        m_worlds.insert(m_worlds.end(), other.m_worlds.begin(), other.m_worlds.end());
+
+        const size_t first = commands.size();
+        commands.insert(commands.end(), other.commands.begin(), other.commands.end());
+        for (size_t i = first; i < commands.size(); ++i)
+            commands[i].worldIndex += base;
     }
 
+    uint64_t MakeKey(const Shader* shader, const Material* material,
+        const Surface* surface, float depth) const noexcept
+    {
+        const uint32_t s = shader   ? shader->id   : 0xFFFFFFFFu;
+        const uint32_t m = material ? material->id : 0xFFFFFFFFu;
+
+        if (pass == RenderPass::Transparent)
+            return RenderSortKey::MakeTransparent(s, m, depth);
+
+        const uint32_t f = surface ? surface->id : 0xFFFFFFFFu;
+        return RenderSortKey::MakeOpaque(pass, s, m, f, depth);
+    }
+
+    // Incremental patching of a retained, already sorted queue (see
+    // RenderManager::PatchRenderQueue). Implemented in RenderQueue.cpp.
+    //
+    // RemoveRecords drops every command whose drawRecord is flagged in
+    // removed; their world entries stay unreferenced until CompactWorlds.
+    // MergeSorted merges a sorted queue into this sorted queue in O(n); on
+    // equal keys commands already in this queue come first.
+    void RemoveRecords(const std::vector<uint8_t>& removed);
+    void MergeSorted(const RenderQueue& other);
+    void CompactWorlds();
+
+    // Stable LSD radix sort over (sortKey, index), 8 bit digits.
+    // Digits that are identical for all entries are skipped, so typical
+    // scenes (few passes/shaders) need far fewer than 8 scatter passes.
+    // Implemented in RenderQueue.cpp.
+    void Sort();
+
     size_t Count() const noexcept { return commands.size(); }
+
+private:
+    // One cache line per matrix; the table is only appended to during build
+    // and read during flush, never sorted.
+    struct alignas(64) WorldEntry
+    {
+        DirectX::XMMATRIX world;
+    };
+
+    struct SortEntry
+    {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    // Scratch storage reused across frames (no per-frame allocation once warm).
+    std::vector<SortEntry>     m_sortA;
+    std::vector<SortEntry>     m_sortB;
+    std::vector<RenderCommand> m_sorted;
+    std::vector<WorldEntry>    m_worlds;
+    std::vector<WorldEntry>    m_worldScratch;
+    std::vector<uint32_t>      m_worldRemap;
 };
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+
+// Change counters for the retained render queues (RenderManager,
+// RetainedDrawList). Every mutation that can change what the queues
+// contain bumps one of them; a queue build whose counters and camera are
+// unchanged reuses the previous result without touching a single mesh.
+//
+//   State     entity render flags, mesh asset / slot materials, mesh
+//             create/delete. The entity also stores the new value
+//             (Entity::GetRenderRevision), so only meshes with a changed
+//             revision are re-resolved.
+//   Assets    material shader / transparency / shadow flag, shared asset
+//             slots. Re-resolves every mesh (rare, mostly load time).
+//   World     mesh world matrix changes, stored per mesh in
+//             Entity::GetWorldRevision for incremental queue patching.
+//   Geometry  vertex edits, touched once per GPU upload of a surface
+//             (gidx.h FillBuffer/UpdateVertexBuffer). Queues re-cull only
+//             meshes whose MeshAsset::GetGeometrySignature changed.
+//   Bulk      TransformSystem updates (no per-entity stamp, forces a rebuild).
+//
+// Owned by Scene (Scene::GetRenderRevision). Scene binds its entities,
+// AssetManager its materials and mesh assets; unbound objects touch nothing.
+// Values are never reused, so a stamp comparison is an exact change test.
+// Not thread-safe: scene mutations happen on the main thread.
+class RenderRevision
+{
+public:
+    uint32_t TouchState()    noexcept { return ++m_state; }
+    uint32_t TouchAssets()   noexcept { return ++m_assets; }
+    uint32_t TouchWorld()    noexcept { return ++m_world; }
+    uint32_t TouchGeometry() noexcept { return ++m_geometry; }
+    uint32_t TouchBulk()     noexcept { return ++m_bulk; }
+
+    uint32_t GetState()    const noexcept { return m_state; }
+    uint32_t GetAssets()   const noexcept { return m_assets; }
+    uint32_t GetWorld()    const noexcept { return m_world; }
+    uint32_t GetGeometry() const noexcept { return m_geometry; }
+    uint32_t GetBulk()     const noexcept { return m_bulk; }
+
+private:
+    uint32_t m_state    = 1;
+    uint32_t m_assets   = 1;
+    uint32_t m_world    = 1;
+    uint32_t m_geometry = 1;
+    uint32_t m_bulk     = 1;
+};
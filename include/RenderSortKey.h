@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// 64-bit packed render sort key.
+//
+// Ascending key order == draw order. Keys are built once in Submit and the
+// queue is sorted by key only (RenderQueue::Sort, LSD radix), no pointer
+// dereference during sorting.
+//
+// Opaque / Shadow layout (state first, then front-to-back):
+//   63..60  pass        (4)
+//   59..48  shader id   (12)
+//   47..32  material id (16)
+//   31..16  surface id  (16)
+//   15..0   depth       (16, quantized, near first)
+//
+// Transparent layout (back-to-front first, then state):
+//   63..60  pass        (4)
+//   59..28  depth       (32, inverted, far first)
+//   27..16  shader id   (12)
+//   15..0   material id (16)
+//
+// Ids that do not fit into their field and null objects (id 0xFFFFFFFF)
+// saturate to the field maximum, so they sort after all valid batches.
+enum class RenderPass : uint8_t
+{
+    Shadow      = 0,
+    Opaque      = 1,
+    Transparent = 2,
+};
+
+namespace RenderSortKey
+{
+    constexpr uint32_t SHADER_BITS   = 12;
+    constexpr uint32_t MATERIAL_BITS = 16;
+    constexpr uint32_t SURFACE_BITS  = 16;
+    constexpr uint32_t DEPTH_BITS    = 16;
+
+    inline uint64_t Field(uint32_t value, uint32_t bits) noexcept
+    {
+        const uint32_t maxValue = (1u << bits) - 1u;
+        return static_cast<uint64_t>(value < maxValue ? value : maxValue);
+    }
+
+    // Positive IEEE floats compare like their bit patterns, so the raw bits
+    // are a monotonic 32-bit depth. Negative / NaN depth maps to 0.
+    inline uint32_t DepthBits(float depth) noexcept
+    {
+        if (!(depth > 0.0f)) return 0u;
+        uint32_t bits = 0;
+        std::memcpy(&bits, &depth, sizeof(bits));
+        return bits;
+    }
+
+    inline uint64_t MakeOpaque(RenderPass pass, uint32_t shaderId, uint32_t materialId,
+                               uint32_t surfaceId, float depth) noexcept
+    {
+        // Top 16 bits of the float: sign + exponent + 7 mantissa bits.
+        const uint32_t depth16 = DepthBits(depth) >> 16;
+
+        return (static_cast<uint64_t>(pass) << 60) |
+               (Field(shaderId,   SHADER_BITS)   << 48) |
+               (Field(materialId, MATERIAL_BITS) << 32) |
+               (Field(surfaceId,  SURFACE_BITS)  << 16) |
+               static_cast<uint64_t>(depth16);
+    }
+
+    inline uint64_t MakeTransparent(uint32_t shaderId, uint32_t materialId, float depth) noexcept
+    {
+        const uint32_t invDepth = ~DepthBits(depth);
+
+        return (static_cast<uint64_t>(RenderPass::Transparent) << 60) |
+               (static_cast<uint64_t>(invDepth) << 28) |
+               (Field(shaderId,   SHADER_BITS)   << 16) |
+               Field(materialId, MATERIAL_BITS);
+    }
+
+    inline RenderPass GetPass(uint64_t key) noexcept
+    {
+        return static_cast<RenderPass>(key >> 60);
+    }
+}
@@ -1,10 +1,16 @@
 #pragma once
 #include "IRenderTarget.h"
 #include "Texture.h"
+#ifdef _WIN32
 #include <d3d11.h>
+#endif
 
 class GDXDevice;
 
+struct ID3D11RenderTargetView;
+struct ID3D11DepthStencilView;
+struct D3D11_VIEWPORT;
+
 // Render-to-Texture Target.
 // Verwaltet alle D3D11-Ressourcen selbst (Textur, RTV, SRV, Depth).
 // Der interne Texture-Wrapper kann direkt mit Engine::MaterialTexture / EntityTexture
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <unordered_map>
+
+class Scene;
+class Mesh;
+class Surface;
+class Material;
+class Shader;
+
+// Retained per-mesh draw data for the render queues.
+//
+// Every queue build used to re-resolve each mesh (asset slots, slot or
+// fallback material, shader, transparency). The draw list keeps one record
+// per scene mesh (same order as Scene::GetMeshes) and re-resolves a record
+// only when the mesh's render revision changed. Material, shader and shared
+// asset changes (RenderRevision::TouchAssets) or a new fallback material
+// re-resolve all records. Sync() is O(1) while no revision counter moved.
+//
+// Live per-frame inputs (world matrix, layer mask, mesh shadow flag) are
+// not cached; the queue builds read them from the mesh.
+class RetainedDrawList
+{
+public:
+    struct Item
+    {
+        Surface*  surface     = nullptr;
+        Material* material    = nullptr;
+        Shader*   shader      = nullptr;
+        uint32_t  slot        = 0;     // asset slot, selects the LOD surface
+        int       flagsVertex = 0;
+        bool      transparent = false;
+        bool      castShadows = false; // material flag; shader validity is checked per build
+    };
+
+    struct Record
+    {
+        Mesh*             mesh           = nullptr;
+        uint32_t          renderRevision = 0;     // Entity::GetRenderRevision at resolve
+        uint32_t          resolveStamp   = 0;     // unique per resolve, compared by the queues
+        bool              drawable       = false; // asset, surfaces, active, visible, not batched
+        std::vector<Item> items;
+    };
+
+    // Brings the records up to date with the scene. Returns true when any
+    // record was resolved, added or removed.
+    bool Sync(const Scene& scene, Material* standardMaterial);
+
+    // Forces a full re-resolve on the next Sync.
+    void Invalidate() noexcept { m_invalid = true; }
+
+    const std::vector<Record>& GetRecords() const noexcept { return m_records; }
+    uint32_t GetRecordCount() const noexcept { return static_cast<uint32_t>(m_records.size()); }
+
+    // Changes whenever record indices change or every record was resolved.
+    // Queues patched per record must rebuild from scratch on a new value.
+    uint32_t GetLayoutRevision() const noexcept { return m_layoutRevision; }
+
+    // Records resolved by the last Sync that did any work.
+    uint32_t GetResolvedCount() const noexcept { return m_resolvedCount; }
+
+private:
+    void Resolve(Record& record, Mesh* mesh, Material* standardMaterial);
+    void Relayout(const std::vector<Mesh*>& meshes, Material* standardMaterial, bool resolveAll);
+
+    std::vector<Record>                  m_records;
+    std::vector<Record>                  m_scratch;
+    std::unordered_map<Mesh*, uint32_t>  m_index;
+
+    Material* m_standardMaterial = nullptr;
+    uint32_t  m_syncedState      = 0;
+    uint32_t  m_syncedAssets     = 0;
+    uint32_t  m_layoutRevision   = 1;
+    uint32_t  m_resolveCounter   = 0;
+    uint32_t  m_resolvedCount    = 0;
+    bool      m_invalid          = true;
+};
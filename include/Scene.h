@@ -7,6 +7,7 @@
 #include "Camera.h"
 #include "Light.h"
 #include "Mesh.h"
+#include "TransformSystem.h"
 
 #ifndef MAX_LIGHTS
 #define MAX_LIGHTS 32
@@ -33,6 +34,23 @@ public:
     void DeleteCamera(Camera* camera);
     void DeleteLight(Light* light);
 
+    // Top-down world matrix update: recomputes only entities whose transform
+    // (or an ancestor's) changed since the last call. Called once per frame
+    // before the render queues are built; afterwards GetWorldMatrix is a
+    // plain cache read, safe to call from job threads.
+    void UpdateWorldMatrices();
+
+    // Optional SoA transform store for large numbers of moving objects.
+    // Updated first in UpdateWorldMatrices; see Entity::BindTransform.
+    TransformSystem&       GetTransformSystem() noexcept       { return m_transformSystem; }
+    const TransformSystem& GetTransformSystem() const noexcept { return m_transformSystem; }
+
+    // Change counters of the retained render queues (see RenderRevision.h).
+    // Bound to every entity created here and to the assets of the
+    // AssetManager constructed with it.
+    RenderRevision&       GetRenderRevision() noexcept       { return m_renderRevision; }
+    const RenderRevision& GetRenderRevision() const noexcept { return m_renderRevision; }
+
     Mesh* GetPreviousMesh(Mesh* currentMesh);
     Camera* GetPreviousCamera(Camera* currentCamera);
 
@@ -46,6 +64,20 @@ public:
     Light* GetLight(size_t index) const noexcept { return (index < m_lights.size()) ? m_lights[index] : nullptr; }
 
 private:
+    template<typename T>
+    static void UpdateWorldRoots(const std::vector<T*>& entities)
+    {
+        // Start at the topmost dirty entity of each chain; dirty entities
+        // below a dirty parent are handled by that parent's subtree walk.
+        for (T* e : entities)
+        {
+            if (!e || !e->IsWorldDirty()) continue;
+            const Entity* parent = e->GetParent();
+            if (parent && parent->IsWorldDirty()) continue;
+            e->UpdateWorldMatrices();
+        }
+    }
+
     template<typename T>
     static bool RemoveOwned(std::vector<std::unique_ptr<T>>& owner, T* ptr)
     {
@@ -55,6 +87,10 @@ private:
         return true;
     }
 
+    // Declared first: entities touch it from their destructors.
+    RenderRevision  m_renderRevision;
+    TransformSystem m_transformSystem;
+
     std::vector<Mesh*>   m_meshes;
     std::vector<Camera*> m_cameras;
     std::vector<Light*>  m_lights;
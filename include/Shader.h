@@ -1,14 +1,22 @@
 // Shader.h
 #pragma once
 #include <vector>
-#include <d3d11.h>
-#include <d3dcompiler.h>
 #include <string>
 #include "gdxutil.h"
 #include "Material.h"
 
+#ifdef _WIN32
+#include <d3d11.h>
+#include <d3dcompiler.h>
+#endif
+
 class GDXDevice;
 
+struct ID3D11InputLayout;
+struct ID3D11VertexShader;
+struct ID3D11PixelShader;
+struct ID3D10Blob;
+
 // Shader-Klasse - Verwaltet Vertex und Pixel Shader mit Blobs und Input Layout
 // 
 // Memory Management:
@@ -47,6 +55,7 @@ public:
     std::wstring pixelShaderFile;
 
     ID3D11InputLayout* inputlayoutVertex;
+    ID3D11InputLayout* inputlayoutPacked = nullptr; // one interleaved stream (VertexPacker), optional
     ID3D11VertexShader* vertexShader;
     ID3D11PixelShader* pixelShader;
 
@@ -61,6 +70,12 @@ public:
     // ==================== MATERIAL-VERWALTUNG ====================
     std::vector<Material*> materials;
 
+    // Optional instanced VS variant (same PS, world matrix per instance,
+    // flagsVertex includes D3DVERTEX_INSTANCE_WORLD). Not owned.
+    // RenderManager collapses runs of identical draws into one instanced
+    // draw when set; nullptr = always one draw per mesh.
+    Shader* instancedVariant = nullptr;
+
 
     // Setzt diesen Shader als aktiv (Input Layout, VS, optional PS)
     // - VS_PS: InputLayout + VS + PS
@@ -72,14 +87,10 @@ public:
     // ==================== HILFSMETHODEN ====================
 
     // Gibt Vertex Shader Bytecode zurück (aus Blob)
-    inline void* GetVertexBytecode() const {
-        return blobVS ? blobVS->GetBufferPointer() : nullptr;
-    }
+    void* GetVertexBytecode() const;
 
     // Gibt Größe des Vertex Shader Bytecode zurück
-    inline SIZE_T GetVertexBytecodeSize() const {
-        return blobVS ? blobVS->GetBufferSize() : 0;
-    }
+    SIZE_T GetVertexBytecodeSize() const;
 
 
     //Gibt an ob dieser Shader vollständig initialisiert ist – abhängig vom Bind-Mode
@@ -15,6 +15,7 @@ enum class ShaderKey
     Standard = 0,
     StandardSkinned = 1,
     Shadow = 2,          // VS-only shadow pass shader (reads b0 world + b3 light view/proj)
+    StandardInstanced = 3, // Standard VS with per-instance world matrix, same PS
 };
 
 struct ShaderKeyHash
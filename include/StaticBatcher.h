@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class Scene;
+class AssetManager;
+class Mesh;
+
+struct StaticBatchDesc
+{
+    // Edge length of the world-space grid cells that bound a batch. Keeps
+    // batches cullable; <= 0 puts every mesh into one cell.
+    float    chunkSize   = 64.0f;
+
+    // Vertex limit of one merged surface. Groups above it are split into
+    // several surfaces. Up to 65536 the surfaces keep 16-bit indices.
+    uint32_t maxVertices = 65536;
+
+    // Cells with fewer static meshes are left as they are.
+    uint32_t minMeshes   = 2;
+};
+
+struct StaticBatchStats
+{
+    uint32_t sourceMeshes   = 0;  // meshes now drawn by a batch
+    uint32_t sourceSurfaces = 0;  // surface slots merged
+    uint32_t batchMeshes    = 0;
+    uint32_t batchSurfaces  = 0;  // draw calls that replace sourceSurfaces
+    uint32_t vertices       = 0;
+    uint32_t indices        = 0;
+};
+
+// Bakes static meshes into merged, pre-transformed geometry.
+//
+// Candidates are meshes flagged with Entity::SetStatic that are active,
+// visible, not skinned and whose slots all resolve to an opaque material.
+// They are grouped by layer mask, shadow flag and grid cell of their world
+// bounds center; each group becomes one batch mesh (identity transform)
+// with one surface per material and vertex format. Source meshes stay in
+// the scene for picking and collision and are marked with
+// Mesh::SetStaticBatched, which removes them from the render queues.
+//
+// Baking is CPU only. The caller uploads the batch surfaces (gidx
+// BakeStaticBatches does this). Moving or editing a source mesh afterwards
+// is not reflected until the batches are built again.
+class StaticBatcher
+{
+public:
+    StaticBatcher() = default;
+
+    // Replaces all batches built earlier. World matrices must be current
+    // (Scene::UpdateWorldMatrices).
+    StaticBatchStats Build(Scene& scene, AssetManager& assets, const StaticBatchDesc& desc);
+
+    // Deletes the batch meshes and their surfaces and makes the source
+    // meshes render again.
+    void Clear(Scene& scene, AssetManager& assets);
+
+    const std::vector<Mesh*>& GetBatches() const noexcept { return m_batches; }
+    const StaticBatchStats&   GetStats()   const noexcept { return m_stats; }
+
+private:
+    std::vector<Mesh*> m_batches;
+    std::vector<Mesh*> m_sources;
+    StaticBatchStats   m_stats;
+};
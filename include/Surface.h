@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
 #include <memory>
+#include <cstdint>
+#include <span>
 #include <DirectXMath.h>
 #include "IGpuResource.h"
 
@@ -22,6 +24,35 @@ public:
 
     void AddIndex(unsigned int index);
 
+    // Bulk submission: one copy per stream instead of one call per vertex.
+    // Add* appends, Set* replaces the stream with a moved-in vector. Streams
+    // are independent, so each must end up with CountVertices() elements
+    // (or stay empty) like with the per-vertex calls.
+    void AddVertices(std::span<const DirectX::XMFLOAT3> positions);
+    void AddNormals(std::span<const DirectX::XMFLOAT3> normals);
+    void AddColors(std::span<const DirectX::XMFLOAT4> colors);
+    void AddTexCoords(std::span<const DirectX::XMFLOAT2> uv);
+    void AddTexCoords2(std::span<const DirectX::XMFLOAT2> uv);
+    void AddTangents(std::span<const DirectX::XMFLOAT4> tangents);
+    void AddBoneData(std::span<const DirectX::XMUINT4> indices, std::span<const DirectX::XMFLOAT4> weights);
+
+    // baseVertex is added to every index (appending a chunk of vertices).
+    void AddIndices(std::span<const unsigned int> indices, unsigned int baseVertex = 0);
+
+    void SetVertices(std::vector<DirectX::XMFLOAT3>&& positions);
+    void SetNormals(std::vector<DirectX::XMFLOAT3>&& normals);
+    void SetColors(std::vector<DirectX::XMFLOAT4>&& colors);
+    void SetTexCoords(std::vector<DirectX::XMFLOAT2>&& uv);
+    void SetTexCoords2(std::vector<DirectX::XMFLOAT2>&& uv);
+    void SetTangents(std::vector<DirectX::XMFLOAT4>&& tangents);
+    void SetIndices(std::vector<unsigned int>&& indices);
+    void SetBoneData(std::vector<DirectX::XMUINT4>&& indices, std::vector<DirectX::XMFLOAT4>&& weights);
+
+    // Reserves room for that many more vertices and indices. Positions and
+    // indices are always reserved; vertexFlags (D3DVERTEX_*) selects the
+    // other streams, 0 = normals and UV1.
+    void Reserve(unsigned int vertices, unsigned int indices, uint32_t vertexFlags = 0);
+
     float GetVertexX(unsigned int index) const;
     float GetVertexY(unsigned int index) const;
     float GetVertexZ(unsigned int index) const;
@@ -47,6 +78,21 @@ public:
 
     void ComputeTangents();
 
+    // Geometry that exists only in GPU buffers (MeshFile::Load without CPU
+    // copy). The vectors stay empty; counts and object-space bounds stand in
+    // for them. FillBuffer/UpdateBuffer must not be called on such surfaces.
+    void SetGpuOnly(uint32_t vertexCount, uint32_t indexCount,
+                    const DirectX::XMFLOAT3& boundsMin, const DirectX::XMFLOAT3& boundsMax) noexcept;
+    bool IsGpuOnly() const noexcept { return m_gpuOnly; }
+    uint32_t CountGpuVertices() const noexcept { return m_gpuVertexCount; }
+    uint32_t CountGpuIndices()  const noexcept { return m_gpuIndexCount; }
+    const DirectX::XMFLOAT3& GetGpuBoundsMin() const noexcept { return m_gpuBoundsMin; }
+    const DirectX::XMFLOAT3& GetGpuBoundsMax() const noexcept { return m_gpuBoundsMax; }
+
+    // Counts position edits (also at the same vertex count), so cached
+    // bounds can tell that they are stale (MeshAsset::GetGeometrySignature).
+    uint32_t GetGeometryRevision() const noexcept { return m_geometryRevision; }
+
     void SetBoneData(unsigned int vertexIndex,
                      unsigned int b0, unsigned int b1,
                      unsigned int b2, unsigned int b3,
@@ -67,7 +113,15 @@ public:
     bool isActive = true;
     std::unique_ptr<IGpuResource> gpu;  // owned
 
+    // Stable numeric identifier assigned by AssetManager::CreateSurface.
+    // Used as mesh/surface field of the render sort key (RenderSortKey.h).
+    // 0 = not created through AssetManager.
+    uint32_t id = 0;
+
 private:
+    // Every write to m_positions ends with this.
+    void PositionsChanged() noexcept;
+
     std::vector<DirectX::XMFLOAT3> m_positions;
     std::vector<DirectX::XMFLOAT3> m_normals;
     std::vector<DirectX::XMFLOAT4> m_colors;
@@ -77,6 +131,14 @@ private:
     std::vector<unsigned int>       m_indices;
     std::vector<DirectX::XMUINT4>   m_boneIndices;
     std::vector<DirectX::XMFLOAT4>  m_boneWeights;
+
+    bool              m_gpuOnly        = false;
+    uint32_t          m_gpuVertexCount = 0;
+    uint32_t          m_gpuIndexCount  = 0;
+    DirectX::XMFLOAT3 m_gpuBoundsMin   = { 0.0f, 0.0f, 0.0f };
+    DirectX::XMFLOAT3 m_gpuBoundsMax   = { 0.0f, 0.0f, 0.0f };
+
+    uint32_t          m_geometryRevision = 0;
 };
 
 typedef Surface* LPSURFACE;
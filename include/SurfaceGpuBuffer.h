@@ -3,7 +3,8 @@
 #include "gdxutil.h"
 #include "IGpuResource.h"
 
-class GDXDevice; // forward
+class GDXDevice;     // forward
+class BufferManager; // forward
 
 // DirectX-11-Implementierung von IGpuResource.
 // Verwaltet die GPU-seitigen Vertex- und Index-Buffer einer Surface
@@ -22,6 +23,13 @@ public:
     void SetWireframe(bool enabled) noexcept override { m_wireframe = enabled; }
     bool IsWireframe()        const noexcept override { return m_wireframe;    }
 
+    // Instanced draw: binds the surface streams plus instanceBuffer (one
+    // row-major float4x4 per instance) in the slot after the last stream.
+    // Used by Dx11RenderBackend::DrawSurfaceInstanced.
+    void DrawInstanced(const GDXDevice* device, unsigned int flagsVertex,
+                       ID3D11Buffer* instanceBuffer, UINT instanceStride,
+                       UINT instanceCount, UINT firstInstance) const;
+
     // DX11-interne Buffer-Member -- nur fuer gidx.h::FillBuffer / UpdateBuffer
     ID3D11Buffer* positionBuffer = nullptr;
     ID3D11Buffer* normalBuffer   = nullptr;
@@ -33,6 +41,14 @@ public:
     ID3D11Buffer* boneWeightBuffer   = nullptr;
     ID3D11Buffer* indexBuffer        = nullptr;
 
+    // Alternative to the separate streams: all attributes interleaved and
+    // quantized in one buffer (VertexPacker). Drawn with the shader's
+    // inputlayoutPacked; the backend switches layouts per surface.
+    ID3D11Buffer* packedBuffer       = nullptr;
+    unsigned int  stridePacked       = 0;
+
+    bool IsPacked() const noexcept { return packedBuffer != nullptr; }
+
     unsigned int stridePosition = 0;
     unsigned int strideNormal   = 0;
     unsigned int strideTangent  = 0;
@@ -42,6 +58,21 @@ public:
 
     unsigned int indexCount = 0;
 
+    // R16_UINT when every index fits in 16 bit, else R32_UINT.
+    DXGI_FORMAT  indexFormat = DXGI_FORMAT_R32_UINT;
+
+    // Uploads indices as R16_UINT if the largest index is below 65536
+    // (half the memory and index fetch bandwidth), otherwise as R32_UINT.
+    // Sets indexBuffer, indexCount and indexFormat.
+    HRESULT CreateIndexBuffer(BufferManager& bufferManager, const unsigned int* indices, unsigned int count);
+
+    // Uploads indices that are already 16 bit (e.g. a mapped mesh file).
+    HRESULT CreateIndexBuffer(BufferManager& bufferManager, const uint16_t* indices, unsigned int count);
+
 private:
+    // Binds index buffer, topology and the vertex streams selected by
+    // flagsVertex to slots 0..streamCount-1. False if a stream is missing.
+    bool BindStreams(ID3D11DeviceContext* ctx, unsigned int flagsVertex, UINT& streamCount) const;
+
     bool m_wireframe = false;
 };
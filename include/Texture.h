@@ -3,13 +3,24 @@
 #include <vector>
 #include <string>
 #include "gdxutil.h"
+#include "TextureImage.h"
+#include "MipBuilder.h"
+
+struct ID3D11Device;
+struct ID3D11DeviceContext;
+struct ID3D11Texture2D;
+struct ID3D11ShaderResourceView;
+struct ID3D11SamplerState;
 
 class Texture
 {
 private:
 	UINT32* m_pixels;
+#ifdef _WIN32
 	D3D11_TEXTURE2D_DESC m_desc;
+#endif
 	bool m_isLocked;
+	uint64_t m_memorySize;
 
 public:
 	Texture();
@@ -20,13 +31,38 @@ public:
 	ID3D11ShaderResourceView* m_textureView;
 	ID3D11SamplerState* m_imageSamplerState;
 
-	HRESULT AddTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext, const wchar_t* filename);
+	// Decodes the file, builds its mip chain (mips.maxLevels = 1: none;
+	// files that bring their own levels keep them) and creates the texture.
+	HRESULT AddTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext, const wchar_t* filename,
+	                   TextureUsage usage = TextureUsage::Color, const MipDesc& mips = MipDesc{});
+
+	// Decodes an image file to RGBA8 (stb_image), or reads a cooked .dds /
+	// .ktx2 file as stored (TextureFile). No D3D calls, safe on worker
+	// threads (TextureLoader). contentHash receives the XXH64 of the file
+	// bytes (ContentHash), for deduplication in TexturePool.
+	static HRESULT DecodeFile(const wchar_t* filename, TextureImage& out, uint64_t* contentHash = nullptr);
+
+	// The two steps of DecodeFile. DecodeMemory picks the decoder by the
+	// extension of filename.
+	static HRESULT ReadFileBytes(const wchar_t* filename, std::vector<uint8_t>& out);
+	static HRESULT DecodeMemory(const uint8_t* data, size_t size, const wchar_t* filename, TextureImage& out);
+
+	// Creates texture, SRV and sampler from a decoded image, with its mip
+	// levels from firstLevel on as initial data (TexturePool streaming
+	// leaves out the largest ones). BC blocks are uploaded as they are,
+	// or decoded to RGBA8 when the device cannot sample the format.
+	// Replaces the texture this object held before.
+	HRESULT CreateFromImage(ID3D11Device* device, const TextureImage& image, const wchar_t* filename,
+	                        uint32_t firstLevel = 0);
 	HRESULT CreateTexture(ID3D11Device* device, int width, int height);
 	HRESULT LockBuffer(ID3D11DeviceContext* deviceContext);
 	void UnlockBuffer(ID3D11DeviceContext* deviceContext);
 	void SetPixel(ID3D11DeviceContext* deviceContext, int x, int y, unsigned char r, unsigned char g, unsigned char b, unsigned char alpha);
 	void GetPixel(int x, int y, unsigned char& r, unsigned char& g, unsigned char& b, unsigned char& alpha);
 
+	// Texel bytes of all mip levels on the GPU.
+	uint64_t GetMemorySize() const { return m_memorySize; }
+
 };
 
 typedef Texture** LPLPTEXTURE;
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include "TextureImage.h"
+
+// Texture containers for cooked textures (tools/texcook). Both store all
+// mip levels in the TextureImage layout and carry the format as a DXGI
+// (DDS) or Vulkan (KTX2) format number, so no D3D header is needed.
+//
+//   DDS   "DDS " + DDS_HEADER + DDS_HEADER_DXT10. Reading also accepts the
+//         legacy FourCCs DXT1, DXT5, ATI1/BC4U and ATI2/BC5U.
+//   KTX2  KTX 2.0 without supercompression, one face, one layer.
+//
+// sRGB variants of a format are read as their UNORM format: the engine
+// samples every texture as UNORM (see Texture::CreateFromImage).
+enum class TextureFileType : uint8_t
+{
+    Dds,
+    Ktx2,
+};
+
+class TextureFile
+{
+public:
+    TextureFile() = delete;
+
+    // Type by extension (.dds, .ktx2, case insensitive). Returns false for
+    // anything else.
+    static bool TypeFromPath(const std::filesystem::path& path, TextureFileType& type);
+
+    static bool Write(const std::filesystem::path& path, const TextureImage& image, TextureFileType type);
+
+    // Reads a DDS or KTX2 file (detected by its magic). Returns false, and
+    // leaves out empty, for unknown formats, cube maps, arrays, volumes
+    // and truncated files.
+    static bool Read(const std::filesystem::path& path, TextureImage& out);
+    static bool ReadMemory(const uint8_t* data, size_t size, TextureImage& out);
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// How the texels of a texture are used. Decides how mip levels are
+// filtered (MipBuilder) and which block format the cooker picks
+// (BlockCompressor::ChooseFormat).
+enum class TextureUsage : uint8_t
+{
+    Color,   // sRGB encoded color (albedo, decal): filtered in linear light
+    Normal,  // tangent-space normal map: filtered as vectors, renormalized
+    Linear,  // data (ORM): filtered as stored
+    Scalar,  // single channel data in red (occlusion, roughness, metallic)
+};
+
+// Texel layout of a TextureImage. The BC formats store 4x4 blocks of
+// 8 (BC1, BC4) or 16 bytes; the texture is created from them as is.
+enum class TextureFormat : uint8_t
+{
+    RGBA8,
+    BC1,  // rgb, 4 bpp
+    BC3,  // rgb + smooth alpha, 8 bpp
+    BC4,  // one channel, 4 bpp
+    BC5,  // two channels (normal xy), 8 bpp
+    BC7,  // rgba, 8 bpp
+};
+
+// Decoded or cooked image (Texture::DecodeFile, TextureFile). pixels holds
+// mipLevels levels back to back, level 0 first, each tightly packed (see
+// RowPitch: width * 4 for RGBA8, a row of 4x4 blocks for BC formats).
+struct TextureImage
+{
+    std::vector<uint8_t> pixels;
+    uint32_t      width     = 0;
+    uint32_t      height    = 0;
+    uint32_t      mipLevels = 1;
+    TextureFormat format    = TextureFormat::RGBA8;
+
+    bool IsBlockCompressed() const noexcept { return format != TextureFormat::RGBA8; }
+
+    // Bytes per 4x4 block, or per texel for RGBA8.
+    uint32_t BlockBytes() const noexcept
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1:
+        case TextureFormat::BC4: return 8;
+        case TextureFormat::BC3:
+        case TextureFormat::BC5:
+        case TextureFormat::BC7: return 16;
+        default:                 return 4;
+        }
+    }
+
+    uint32_t LevelWidth(uint32_t level)  const noexcept { return (width  >> level) > 0 ? (width  >> level) : 1u; }
+    uint32_t LevelHeight(uint32_t level) const noexcept { return (height >> level) > 0 ? (height >> level) : 1u; }
+
+    // Bytes per row of texels (RGBA8) or of blocks (BC).
+    uint32_t RowPitch(uint32_t level) const noexcept
+    {
+        return IsBlockCompressed() ? ((LevelWidth(level) + 3) / 4) * BlockBytes() : LevelWidth(level) * 4;
+    }
+
+    size_t LevelSize(uint32_t level) const noexcept
+    {
+        const uint32_t rows = IsBlockCompressed() ? (LevelHeight(level) + 3) / 4 : LevelHeight(level);
+        return static_cast<size_t>(RowPitch(level)) * rows;
+    }
+
+    size_t LevelOffset(uint32_t level) const noexcept
+    {
+        size_t offset = 0;
+        for (uint32_t l = 0; l < level; ++l)
+            offset += LevelSize(l);
+        return offset;
+    }
+};
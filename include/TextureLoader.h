@@ -0,0 +1,77 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Texture.h"
+
+// Worker threads that decode image files for TexturePool::LoadTextureAsync.
+//
+// Only file I/O, decoding (Texture::DecodeFile) and mip generation
+// (MipBuilder) run here; D3D objects are created by the pool on the render
+// thread. Separate from JobSystem on
+// purpose: decodes take milliseconds and must never end up on the render
+// thread's own queue inside ParallelFor.
+class TextureLoader
+{
+public:
+    struct Result
+    {
+        uint32_t     ticket      = 0;
+        HRESULT      hr          = E_FAIL;
+        uint64_t     contentHash = 0; // of the file bytes (ContentHash::Xxh64)
+        TextureImage image;
+    };
+
+    TextureLoader() = default;
+    ~TextureLoader();
+
+    TextureLoader(const TextureLoader&)            = delete;
+    TextureLoader& operator=(const TextureLoader&) = delete;
+
+    // 0 = hardware threads - 1, at most 4 (leave room for the render thread).
+    void Start(unsigned int threadCount);
+    void Stop();
+
+    bool IsRunning() const noexcept { return m_running.load(std::memory_order_acquire); }
+    unsigned int GetThreadCount() const noexcept { return static_cast<unsigned int>(m_workers.size()); }
+
+    void Submit(uint32_t ticket, const std::wstring& filename, TextureUsage usage, const MipDesc& mips);
+
+    // Moves all finished results to out (appends). Never blocks.
+    void Collect(std::vector<Result>& out);
+
+    // Blocks until a result is ready or nothing is queued or decoding.
+    void WaitForResult();
+
+    // Submitted and not yet collected.
+    uint32_t GetPending() const noexcept { return m_pending.load(std::memory_order_acquire); }
+
+private:
+    struct Request
+    {
+        uint32_t     ticket = 0;
+        std::wstring filename;
+        TextureUsage usage  = TextureUsage::Color;
+        MipDesc      mips;
+    };
+
+    void WorkerMain();
+
+    std::vector<std::thread> m_workers;
+
+    std::mutex              m_requestMutex;
+    std::condition_variable m_requestCv;
+    std::deque<Request>     m_requests;
+
+    std::mutex              m_resultMutex;
+    std::condition_variable m_resultCv;
+    std::vector<Result>     m_results;
+
+    std::atomic<uint32_t> m_pending { 0 };
+    std::atomic<bool>     m_running { false };
+};
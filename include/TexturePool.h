@@ -1,26 +1,48 @@
 #pragma once
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 #include "gdxutil.h"
 #include "Texture.h"
+#include "TextureLoader.h"
+#include "TextureResidency.h"
 
 // Vorwaertsdeklarationen - kein <d3d11.h> im Header.
 struct ID3D11Device;
 struct ID3D11DeviceContext;
 struct ID3D11ShaderResourceView;
 
+// Called on the thread that runs ProcessAsyncLoads once the real texture
+// is in its pool slot (texture != nullptr), or when loading failed and the
+// slot keeps its fallback (texture == nullptr, hr = error).
+using TextureLoadCallback = std::function<void(uint32_t index, Texture* texture, HRESULT hr)>;
+
+struct TextureLoadStats
+{
+    uint32_t inFlight        = 0; // requested, not yet swapped in
+    uint32_t decoded         = 0; // decoded, waiting for the upload budget
+    uint32_t completed       = 0; // swapped in since start
+    uint32_t failed          = 0;
+    uint32_t duplicates      = 0; // loads that found the same file content under another path
+    uint32_t uploadsLastCall = 0; // by the last ProcessAsyncLoads
+    uint64_t bytesUploaded   = 0; // texel data (RGBA8 or BC blocks), resident mip levels, since start
+};
+
 // ============================================================
 //  TexturePool  --  vereinter Textur-Manager
 //
 //  Ersetzt TextureManager und den alten TexturePool.
 //  Aufgaben:
 //    - Texturen vom Disk laden (stb_image via Texture)
-//    - Duplikate per Dateiname vermeiden
+//    - Duplikate vermeiden: per kanonischem Pfad, dann per
+//      Inhalts-Hash (ContentHash::Xxh64 der Dateibytes)
 //    - Besitz der Texture-Objekte
 //    - Jedem SRV einen stabilen uint32_t-Index zuweisen
 //    - Default-Fallback-Texturen bereitstellen
+//    - Mip-Level-Streaming innerhalb eines GPU-Budgets (TextureResidency)
 // ============================================================
 class TexturePool
 {
@@ -32,9 +54,77 @@ public:
     TexturePool& operator=(const TexturePool&) = delete;
 
     // Laedt eine Textur vom Disk. Bei bereits geladener Datei
-    // wird das gecachte Objekt zurueckgegeben.
+    // wird das gecachte Objekt zurueckgegeben. usage picks the mip
+    // filtering (see MipBuilder); a cached texture keeps its own.
+    // Files are matched by canonical path, then by content: a copy of a
+    // loaded file (same bytes, same usage) returns the loaded texture
+    // without decoding it again.
     HRESULT LoadTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext,
-                        const wchar_t* filename, LPLPTEXTURE lpTexture);
+                        const wchar_t* filename, LPLPTEXTURE lpTexture,
+                        TextureUsage usage = TextureUsage::Color);
+
+    // Returns a pool index at once. Until the file is decoded (on the
+    // TextureLoader threads) and uploaded by ProcessAsyncLoads, the index
+    // shows the SRV of fallbackIndex (WhiteIndex, FlatNormalIndex,
+    // OrmIndex, ...), and keeps it if loading fails. A file that is already
+    // loaded or in flight returns its existing index (by canonical path);
+    // a copy of a loaded file gets the loaded texture once its bytes were
+    // read and hashed on the loader thread. All pool functions,
+    // including this one, belong to the render thread. The mip chain is
+    // built on the loader thread as well.
+    uint32_t LoadTextureAsync(const wchar_t* filename, uint32_t fallbackIndex,
+                              TextureLoadCallback onLoaded = {},
+                              TextureUsage usage = TextureUsage::Color);
+
+    // Creates D3D textures for finished decodes and swaps them into their
+    // slots, at most SetAsyncUploadsPerFrame per call. Returns the number of
+    // slots swapped. Called by GDXEngine::RenderWorld every frame.
+    uint32_t ProcessAsyncLoads(ID3D11Device* device);
+
+    // Blocks until every async load has been swapped in (loading screens).
+    void WaitAsyncLoads(ID3D11Device* device);
+
+    // Decoder threads, 0 = hardware threads - 1 (at most 4). Takes effect
+    // before the first LoadTextureAsync.
+    void SetAsyncLoadThreads(unsigned int threads) noexcept { m_loadThreads = threads; }
+
+    // Limits texture creation per ProcessAsyncLoads call, 0 = no limit.
+    void SetAsyncUploadsPerFrame(uint32_t uploads) noexcept { m_uploadsPerFrame = uploads; }
+
+    const TextureLoadStats& GetLoadStats() const noexcept { return m_loadStats; }
+
+    // Mip generation for textures loaded from now on (sync and async).
+    // Default: full chain, box filter. maxLevels = 1 turns mips off.
+    void SetMipDesc(const MipDesc& desc) noexcept { m_mipDesc = desc; }
+    const MipDesc& GetMipDesc() const noexcept { return m_mipDesc; }
+
+    // Texture streaming (see TextureResidency). With a budget, textures
+    // loaded from then on keep their mip chain in system memory and start
+    // with their lowest levels on the GPU; UpdateStreaming adds and drops
+    // levels by what the renderer requests, within the budget. Textures
+    // loaded before, or too small to gain from it, count as fixed.
+    void SetStreamingDesc(const TextureStreamingDesc& desc) noexcept { m_residency.SetDesc(desc); }
+    const TextureStreamingDesc& GetStreamingDesc() const noexcept { return m_residency.GetDesc(); }
+    bool HasStreamedTextures() const noexcept { return !m_streamed.empty(); }
+
+    // While a frame is built: the texture in slot index is drawn covering
+    // about `texels` texels (larger side). No-op for fixed textures.
+    void RequestTexels(uint32_t index, float texels) noexcept
+    {
+        if (index < m_streamedBySlot.size() && m_streamedBySlot[index] != NOT_STREAMED)
+            m_residency.Request(m_streamedBySlot[index], texels);
+    }
+
+    // Recreates streamed textures with the levels decided from the
+    // requests since the last call and swaps them into their slots.
+    // Returns the number recreated. Called by GDXEngine::RenderWorld.
+    uint32_t UpdateStreaming(ID3D11Device* device);
+
+    const TextureResidencyStats& GetStreamingStats() const noexcept { return m_residency.GetStats(); }
+
+    // GPU texel bytes of all textures the pool owns (not the defaults and
+    // not SRVs registered from outside).
+    uint64_t GetMemoryUsage() const noexcept;
 
     // Erstellt Default-Fallback-Texturen (weiss, Flat-Normal, ORM).
     // Muss einmalig nach Device-Init aufgerufen werden.
@@ -51,6 +141,9 @@ public:
     uint32_t FlatNormalIndex() const { return m_flatNormalIndex; }
     uint32_t OrmIndex()        const { return m_ormIndex;        }
 
+    // Cache key of a file (ContentHash::CanonicalPath).
+    static std::wstring CanonicalPath(const wchar_t* filename);
+
 private:
     uint32_t AddInternal(ID3D11ShaderResourceView* srv);
 
@@ -58,14 +151,72 @@ private:
                               uint8_t r, uint8_t g, uint8_t b, uint8_t a,
                               ID3D11ShaderResourceView** outSrv);
 
-    int FindByFilename(const std::wstring& filename) const;
+    // Index into m_textures, -1 if not loaded.
+    int FindByPath(const std::wstring& path) const;
+    int FindByContent(uint64_t contentHash, TextureUsage usage) const;
+    // Enters m_textures[textureIndex] into both lookups.
+    void IndexTexture(uint32_t textureIndex, const std::wstring& path,
+                      uint64_t contentHash, TextureUsage usage);
+
+    // Creates a texture from a decoded image and takes ownership of it:
+    // streamed (image kept) with a budget set, otherwise fixed.
+    Texture* CreatePoolTexture(ID3D11Device* device, TextureImage& image,
+                               const std::wstring& filename, HRESULT& hr);
+    // Notes that slot shows tex, so streaming can swap its SRV there.
+    void TrackSlot(Texture* tex, uint32_t slot);
+
+    // Puts srv into a pool slot that so far showed a fallback.
+    void ReplaceSlot(uint32_t index, ID3D11ShaderResourceView* srv);
+    void FinishAsyncLoad(ID3D11Device* device, TextureLoader::Result& result);
+
+    struct PendingLoad
+    {
+        std::wstring                     filename;
+        std::wstring                     path;     // CanonicalPath(filename)
+        TextureUsage                     usage = TextureUsage::Color;
+        std::vector<TextureLoadCallback> callbacks;
+    };
 
     std::vector<ID3D11ShaderResourceView*>                  m_srvs;
     std::unordered_map<ID3D11ShaderResourceView*, uint32_t> m_indexBySrv;
     std::vector<Texture*>                                   m_textures;
 
+    // Loaded textures (index into m_textures) by canonical path, and by
+    // content hash mixed with usage. Several paths may share one texture.
+    std::unordered_map<std::wstring, uint32_t>              m_textureByPath;
+    std::unordered_map<uint64_t, uint32_t>                  m_textureByContent;
+
     uint32_t m_whiteIndex      = 0;
     uint32_t m_flatNormalIndex = 0;
     uint32_t m_ormIndex        = 0;
     bool     m_defaultsReady   = false;
+
+    // Async loading: pending slots by pool index, and by canonical path so
+    // a second request joins the first.
+    std::unique_ptr<TextureLoader>                m_loader;
+    std::unordered_map<uint32_t, PendingLoad>     m_pending;
+    std::unordered_map<std::wstring, uint32_t>    m_pendingByPath;
+    std::vector<TextureLoader::Result>            m_decoded;
+    TextureLoadStats                              m_loadStats;
+    unsigned int                                  m_loadThreads     = 0;
+    uint32_t                                      m_uploadsPerFrame = 0;
+
+    MipDesc m_mipDesc;
+
+    // Streaming: textures by residency id, and residency id per slot.
+    static constexpr uint32_t NOT_STREAMED = 0xFFFFFFFFu;
+
+    struct StreamedTexture
+    {
+        Texture*              texture    = nullptr; // owned by m_textures
+        TextureImage          image;                // every level, system memory
+        uint32_t              firstLevel = 0;       // resident on the GPU
+        std::vector<uint32_t> slots;
+    };
+
+    TextureResidency                        m_residency;
+    std::vector<StreamedTexture>            m_streamed;
+    std::unordered_map<Texture*, uint32_t>  m_streamedByTexture;
+    std::vector<uint32_t>                   m_streamedBySlot;
+    uint64_t                                m_fixedBytes = 0;
 };
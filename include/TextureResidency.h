@@ -0,0 +1,112 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "TextureImage.h"
+
+// Texture streaming settings (TexturePool::SetStreamingDesc).
+struct TextureStreamingDesc
+{
+    uint64_t budgetBytes          = 0;    // GPU bytes for all pool textures, 0 = no streaming
+    uint32_t minResidentSize      = 64;   // levels this size (larger side) and below always stay
+    uint64_t uploadBytesPerUpdate = 0;    // limit for added detail per Update, 0 = no limit
+    float    detailBias           = 1.0f; // scales requested texels (> 1 keeps detail longer)
+};
+
+struct TextureResidencyStats
+{
+    uint64_t budgetBytes    = 0;
+    uint64_t fixedBytes     = 0; // textures that do not stream
+    uint64_t residentBytes  = 0; // streamed textures, levels on the GPU
+    uint64_t requestedBytes = 0; // streamed textures if every request of the last frame were met
+    uint32_t streamed       = 0;
+    uint32_t promoted       = 0; // by the last Update
+    uint32_t demoted        = 0; // by the last Update, evicted included
+    uint32_t evicted        = 0; // by the last Update: unused, dropped to the lowest levels
+    uint64_t bytesUploaded  = 0; // by the last Update (new textures hold all their levels)
+};
+
+// Decides which mip levels of streamed textures are resident on the GPU.
+//
+// No D3D calls and no clock: TexturePool reports per frame which textures
+// were drawn and how many texels they cover on screen (Request), Update
+// returns the new most detailed level per changed texture, and the pool
+// recreates those textures. Equal inputs give equal decisions.
+//
+// Update keeps what fits into the budget:
+//   1. every texture gets the detail requested in the last frame; more
+//      detail than requested stays as long as it fits
+//   2. over budget, textures not drawn in the last frame drop to their
+//      lowest levels, least recently used first
+//   3. then drawn textures lose detail beyond their request
+//   4. then the drawn texture with the largest top level loses one level,
+//      until the rest fits
+// Levels up to minResidentSize never leave, so a texture can always be
+// drawn. BC textures keep top levels with sizes in multiples of 4.
+class TextureResidency
+{
+public:
+    struct Change
+    {
+        uint32_t id         = 0;
+        uint32_t firstLevel = 0; // most detailed resident level
+    };
+
+    void SetDesc(const TextureStreamingDesc& desc) noexcept { m_desc = desc; }
+    const TextureStreamingDesc& GetDesc() const noexcept { return m_desc; }
+
+    // Bytes held by textures outside of streaming; taken from the budget.
+    void SetFixedBytes(uint64_t bytes) noexcept { m_fixedBytes = bytes; }
+
+    // Least detailed level that may be the top one: the first at or below
+    // minResidentSize, or the last one that is whole BC blocks.
+    static uint32_t LowestFirstLevel(const TextureImage& image, uint32_t minResidentSize) noexcept;
+
+    // Tracks a texture with the size, format and levels of image (pixels
+    // are not read). Starts with its lowest levels; returns its id (ids
+    // count up from 0).
+    uint32_t Add(const TextureImage& image);
+
+    // The texture was drawn and covers about `texels` texels of its larger
+    // side on screen. Several requests per frame: the most detailed wins.
+    void Request(uint32_t id, float texels) noexcept;
+
+    // Decides the resident levels from the requests since the last Update
+    // and starts the next frame. Returns the changed textures in id order;
+    // they count as resident at once (see SetResident).
+    const std::vector<Change>& Update();
+
+    // Corrects a texture whose recreation failed.
+    void SetResident(uint32_t id, uint32_t firstLevel) noexcept;
+
+    uint32_t GetFirstLevel(uint32_t id) const noexcept;
+    uint32_t GetLowestFirstLevel(uint32_t id) const noexcept;
+    uint64_t GetResidentBytes(uint32_t id) const noexcept;
+    uint32_t Count() const noexcept { return static_cast<uint32_t>(m_entries.size()); }
+
+    const TextureResidencyStats& GetStats() const noexcept { return m_stats; }
+
+private:
+    struct Entry
+    {
+        uint32_t width     = 0;
+        uint32_t height    = 0;
+        uint32_t first     = 0; // most detailed resident level
+        uint32_t lowest    = 0; // least detailed first level allowed
+        uint32_t wanted    = 0; // requested in usedFrame
+        uint64_t usedFrame = 0; // last frame with a request, 0 = never drawn
+        std::vector<uint64_t> bytes; // bytes[l]: levels l..end, for l <= lowest
+    };
+
+    uint64_t Bytes(const Entry& e, uint32_t first) const noexcept { return e.bytes[first]; }
+    uint32_t LevelFor(const Entry& e, float texels) const noexcept;
+    void UpdateStats();
+
+    TextureStreamingDesc  m_desc;
+    TextureResidencyStats m_stats;
+    uint64_t              m_fixedBytes = 0;
+    uint64_t              m_frame      = 1;
+    std::vector<Entry>    m_entries;
+    std::vector<Change>   m_changes;
+    std::vector<uint32_t> m_targets;  // scratch, per entry
+    std::vector<uint32_t> m_order;    // scratch, entry ids
+};
@@ -3,6 +3,8 @@
 #include <DirectXCollision.h>
 #include "gdxutil.h"
 
+class Entity;
+
 enum class Space {
     Local,
     World
@@ -17,14 +19,16 @@ private:
     DirectX::XMVECTOR scale;             // W=0.0f
 
     // GECACHTE MATRIZEN (mutable für const Getter)
-    mutable DirectX::XMMATRIX rotationMatrix;
-    mutable DirectX::XMMATRIX translationMatrix;
-    mutable DirectX::XMMATRIX scalingMatrix;
+    mutable DirectX::XMMATRIX localMatrix;      // S * R * T (TransformMath::ComposeTRS)
     mutable bool matricesDirty;
 
     // EXTERNE REFERENZ (nicht mutable - nur zum Schreiben)
     DirectX::XMMATRIX* worldMatrix;
 
+    // Owning entity, notified on every change so it can invalidate its
+    // cached world matrix (and those of its children). nullptr = standalone.
+    Entity* owner;
+
     // CACHED DIRECTION VECTORS (mutable für const Getter)
     mutable DirectX::XMVECTOR lookAt;
     mutable DirectX::XMVECTOR up;
@@ -33,6 +37,7 @@ private:
 
     // PRIVATE METHODEN
     void UpdateMatrices() const;
+    void MarkDirty();
     void UpdateDirectionVectors() const;
     DirectX::XMVECTOR EulerToQuaternion(float pitch, float yaw, float roll) const;
     void QuaternionToEuler(const DirectX::XMVECTOR& quat, float& pitch, float& yaw, float& roll) const;
@@ -45,6 +50,7 @@ public:
 
     // =========== EXISTIERENDE API ===========
     void SetWorldMatrix(DirectX::XMMATRIX* world) { worldMatrix = world; matricesDirty = true; }
+    void SetOwner(Entity* entity) noexcept { owner = entity; }
 
     DirectX::XMMATRIX GetLocalTransformationMatrix() const;
     DirectX::XMMATRIX* GetWorldTransformationMatrix() const { return worldMatrix; }
@@ -91,7 +97,7 @@ public:
 
     // 6. HELPER
     bool HasChanged() const { return matricesDirty; }
-    void SetChanged(bool changed = true) { matricesDirty = changed; if (changed) vectorsDirty = true; }
+    void SetChanged(bool changed = true) { if (changed) { MarkDirty(); vectorsDirty = true; } else matricesDirty = false; }
     DirectX::XMMATRIX GetWorldMatrix() const;
 
     // 7. TRANSFORM COMBINATIONS
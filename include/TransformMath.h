@@ -0,0 +1,55 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+
+// TRS -> matrix composition shared by Transform and TransformSystem.
+//
+// ComposeTRS builds S * R * T directly: the rotation rows are scaled and the
+// translation is written into row 3, no 4x4 multiplies.
+//
+// ComposeTRSBatch converts N (position, quaternion, scale) triples given as
+// separate float streams into N row-major matrices. The SIMD path is picked
+// once at runtime (AVX2+FMA, SSE, scalar) and can be forced for benchmarks.
+namespace TransformMath
+{
+    enum class SimdPath : uint8_t
+    {
+        Scalar = 0,
+        SSE    = 1,
+        AVX2   = 2,
+    };
+
+    // Input streams, each holding at least count floats. Quaternions must
+    // be normalized.
+    struct TRSStreams
+    {
+        const float* posX; const float* posY; const float* posZ;
+        const float* rotX; const float* rotY; const float* rotZ; const float* rotW;
+        const float* sclX; const float* sclY; const float* sclZ;
+    };
+
+    inline DirectX::XMMATRIX XM_CALLCONV ComposeTRS(DirectX::FXMVECTOR position,
+                                                    DirectX::FXMVECTOR rotation,
+                                                    DirectX::FXMVECTOR scale)
+    {
+        DirectX::XMMATRIX m = DirectX::XMMatrixRotationQuaternion(rotation);
+        m.r[0] = DirectX::XMVectorScale(m.r[0], DirectX::XMVectorGetX(scale));
+        m.r[1] = DirectX::XMVectorScale(m.r[1], DirectX::XMVectorGetY(scale));
+        m.r[2] = DirectX::XMVectorScale(m.r[2], DirectX::XMVectorGetZ(scale));
+        m.r[3] = DirectX::XMVectorSetW(position, 1.0f);
+        return m;
+    }
+
+    // Best path this CPU/OS supports.
+    SimdPath GetSupportedPath();
+
+    // Path used by ComposeTRSBatch. Defaults to GetSupportedPath().
+    SimdPath GetPath();
+
+    // Forces a path (clamped to GetSupportedPath()). Returns the path set.
+    SimdPath SetPath(SimdPath path);
+
+    const char* GetPathName(SimdPath path);
+
+    void ComposeTRSBatch(const TRSStreams& in, uint32_t count, DirectX::XMFLOAT4X4A* out);
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <DirectXMath.h>
+#include <cstdint>
+#include <vector>
+
+using TransformHandle = uint32_t;
+constexpr TransformHandle INVALID_TRANSFORM = UINT32_MAX;
+
+// Optional data-oriented transform store for large numbers of moving
+// objects (crowds, debris, instanced props).
+//
+// Local TRS is kept as separate float streams (x/y/z, quaternion x/y/z/w,
+// scale x/y/z), world matrices in one contiguous array of XMFLOAT4X4A.
+// Slots are ordered parent-before-child, so Update() resolves the whole
+// hierarchy in one linear pass and only recomposes dirty slots (or slots
+// whose parent changed in the same pass).
+//
+// Callers keep a stable TransformHandle; slots move when the hierarchy is
+// re-sorted after SetParent/Destroy. An Entity can be bound to a handle
+// (Entity::BindTransform) and then takes its world matrix from here.
+class TransformSystem
+{
+public:
+    TransformSystem() = default;
+
+    TransformSystem(const TransformSystem&)            = delete;
+    TransformSystem& operator=(const TransformSystem&) = delete;
+
+    // New transform at the origin, identity rotation, scale 1.
+    TransformHandle Create(TransformHandle parent = INVALID_TRANSFORM);
+
+    // Children of a destroyed transform become roots (their local TRS is kept).
+    void Destroy(TransformHandle handle);
+
+    bool IsValid(TransformHandle handle) const noexcept;
+
+    // Rejects cycles. parent = INVALID_TRANSFORM detaches.
+    bool SetParent(TransformHandle handle, TransformHandle parent);
+    TransformHandle GetParent(TransformHandle handle) const noexcept;
+
+    void SetPosition(TransformHandle handle, float x, float y, float z);
+    void SetRotation(TransformHandle handle, const DirectX::XMVECTOR& quaternion);
+    void SetScale   (TransformHandle handle, float x, float y, float z);
+    void SetLocal   (TransformHandle handle, const DirectX::XMFLOAT3& position,
+                     const DirectX::XMFLOAT4& rotation, const DirectX::XMFLOAT3& scale);
+
+    DirectX::XMVECTOR GetPosition(TransformHandle handle) const noexcept;
+    DirectX::XMVECTOR GetRotation(TransformHandle handle) const noexcept;
+    DirectX::XMVECTOR GetScale   (TransformHandle handle) const noexcept;
+
+    // Valid after the last Update(). Identity for invalid handles.
+    DirectX::XMMATRIX GetWorldMatrix(TransformHandle handle) const noexcept;
+
+    // Re-sorts if the hierarchy changed, then recomputes all dirty world
+    // matrices in slot order. Returns the number of matrices recomputed.
+    uint32_t Update();
+
+    uint32_t GetCount() const noexcept { return static_cast<uint32_t>(m_slotToHandle.size()); }
+
+private:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    uint32_t SlotOf(TransformHandle handle) const noexcept
+    {
+        return handle < m_handleToSlot.size() ? m_handleToSlot[handle] : NO_SLOT;
+    }
+
+    void MarkDirty(uint32_t slot) noexcept { m_dirty[slot] = 1; }
+    void SortHierarchy();
+    void MoveSlot(uint32_t from, uint32_t to);
+
+    // Local TRS streams (one entry per slot)
+    std::vector<float> m_posX, m_posY, m_posZ;
+    std::vector<float> m_rotX, m_rotY, m_rotZ, m_rotW;
+    std::vector<float> m_sclX, m_sclY, m_sclZ;
+
+    std::vector<DirectX::XMFLOAT4X4A> m_world;
+    std::vector<uint32_t>             m_parentSlot;   // NO_SLOT for roots
+    std::vector<uint8_t>              m_dirty;
+
+    // Handle indirection
+    std::vector<uint32_t>        m_handleToSlot;     // NO_SLOT for free handles
+    std::vector<TransformHandle> m_slotToHandle;
+    std::vector<TransformHandle> m_freeHandles;
+
+    bool m_orderDirty = false;
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <DirectXMath.h>
+
+class Surface;
+
+// Interleaved, quantized vertex for SurfaceGpuBuffer::packedBuffer.
+// Every format is expanded by the input assembler, so vertex shaders keep
+// their float3/float4/uint4 inputs and work with both layouts.
+struct PackedVertex
+{
+    float    position[3]; // R32G32B32_FLOAT
+    int8_t   normal[4];   // R8G8B8A8_SNORM, w = 0
+    int8_t   tangent[4];  // R8G8B8A8_SNORM, w = handedness
+    uint8_t  color[4];    // R8G8B8A8_UNORM
+    uint16_t uv1[2];      // R16G16_FLOAT
+    uint16_t uv2[2];      // R16G16_FLOAT
+};
+
+struct PackedSkinnedVertex
+{
+    PackedVertex base;
+    uint8_t      boneIndices[4]; // R8G8B8A8_UINT
+    uint8_t      boneWeights[4]; // R8G8B8A8_UNORM, sum = 255
+};
+
+// Decoded form of a packed vertex (tools and accuracy checks).
+struct UnpackedVertex
+{
+    DirectX::XMFLOAT3 position;
+    DirectX::XMFLOAT3 normal;
+    DirectX::XMFLOAT4 tangent;
+    DirectX::XMFLOAT4 color;
+    DirectX::XMFLOAT2 uv1;
+    DirectX::XMFLOAT2 uv2;
+    DirectX::XMUINT4  boneIndices;
+    DirectX::XMFLOAT4 boneWeights;
+};
+
+// CPU packer for the interleaved layout. The attribute offsets are fixed,
+// so one packed input layout per shader (InputLayoutManager) serves every
+// packed surface; skinned surfaces only append the bone block.
+class VertexPacker
+{
+public:
+    static constexpr uint32_t OFFSET_POSITION     = 0;
+    static constexpr uint32_t OFFSET_NORMAL       = 12;
+    static constexpr uint32_t OFFSET_TANGENT      = 16;
+    static constexpr uint32_t OFFSET_COLOR        = 20;
+    static constexpr uint32_t OFFSET_UV1          = 24;
+    static constexpr uint32_t OFFSET_UV2          = 28;
+    static constexpr uint32_t OFFSET_BONE_INDICES = 32;
+    static constexpr uint32_t OFFSET_BONE_WEIGHTS = 36;
+
+    static constexpr uint32_t STRIDE         = 32;
+    static constexpr uint32_t STRIDE_SKINNED = 40;
+
+    // Packs all vertices of the surface into out and returns the stride.
+    // Missing attributes get defaults (normal +Z, tangent +X, white, uv 0,
+    // full weight on bone 0). Surfaces with bone data use STRIDE_SKINNED.
+    // Returns 0 for an empty surface or bone indices above 255.
+    static uint32_t Pack(const Surface& surface, std::vector<uint8_t>& out);
+
+    // One vertex of either stride; the inverse of Unpack. Normal and
+    // tangent are normalized, tangent w becomes +-1, bone indices above
+    // 255 are clamped (Pack rejects those surfaces beforehand).
+    static void PackVertex(const UnpackedVertex& in, uint32_t stride, uint8_t* out) noexcept;
+    static void Unpack(const uint8_t* vertex, uint32_t stride, UnpackedVertex& out);
+
+    // Scalar codecs, round to nearest.
+    static uint16_t FloatToHalf(float value) noexcept;
+    static float    HalfToFloat(uint16_t value) noexcept;
+    static int8_t   PackSnorm8(float value) noexcept;
+    static float    UnpackSnorm8(int8_t value) noexcept;
+    static uint8_t  PackUnorm8(float value) noexcept;
+    static float    UnpackUnorm8(uint8_t value) noexcept;
+
+    // Quantizes four blend weights so that they sum to exactly 255.
+    static void PackWeights(const DirectX::XMFLOAT4& weights, uint8_t out[4]) noexcept;
+};
+
+static_assert(sizeof(PackedVertex) == VertexPacker::STRIDE, "PackedVertex layout");
+static_assert(sizeof(PackedSkinnedVertex) == VertexPacker::STRIDE_SKINNED, "PackedSkinnedVertex layout");
+static_assert(offsetof(PackedVertex, normal)  == VertexPacker::OFFSET_NORMAL,  "PackedVertex layout");
+static_assert(offsetof(PackedVertex, tangent) == VertexPacker::OFFSET_TANGENT, "PackedVertex layout");
+static_assert(offsetof(PackedVertex, color)   == VertexPacker::OFFSET_COLOR,   "PackedVertex layout");
+static_assert(offsetof(PackedVertex, uv1)     == VertexPacker::OFFSET_UV1,     "PackedVertex layout");
+static_assert(offsetof(PackedVertex, uv2)     == VertexPacker::OFFSET_UV2,     "PackedVertex layout");
+static_assert(offsetof(PackedSkinnedVertex, boneIndices) == VertexPacker::OFFSET_BONE_INDICES, "PackedSkinnedVertex layout");
+static_assert(offsetof(PackedSkinnedVertex, boneWeights) == VertexPacker::OFFSET_BONE_WEIGHTS, "PackedSkinnedVertex layout");
@@ -38,6 +38,10 @@ namespace Core
         // Debug
         bool            debug       = true;
 
+        // Threading: total threads for parallel engine work, including the
+        // render thread. 0 = hardware_concurrency, 1 = serial (no workers).
+        unsigned int    jobThreads  = 0;
+
         // Fenster-Titel und Klassenname
         const wchar_t*  windowTitle = L"giDX\u00b3 Engine";
         const wchar_t*  className   = L"gidx";
@@ -4,15 +4,17 @@
 // gdxdevice.h is included by a lot of engine/public headers.
 // Keep it lean: no <d3d11.h>, no <dxgi.h>, no gdxutil.h.
 
-#ifndef WIN32_LEAN_AND_MEAN
-#define WIN32_LEAN_AND_MEAN
-#endif
-
-#include <windows.h>      // HWND, HRESULT, UINT
+#include "gdxplatform.h" // HWND, HRESULT, UINT
 #include <vector>
 
+#ifdef _WIN32
 #include <d3dcommon.h>    // D3D_FEATURE_LEVEL
 #include <dxgiformat.h>   // DXGI_FORMAT
+#else
+// Opaque off Windows: only the D3D11 sources look inside.
+enum D3D_FEATURE_LEVEL : int;
+enum DXGI_FORMAT : int;
+#endif
 
 #include "gxformat.h"    // GXFORMAT (small, no DX headers)
 
@@ -14,6 +14,7 @@
 #include "ShaderManager.h"
 #include "RenderManager.h"
 #include "TexturePool.h"
+#include "JobSystem.h"
 #include "Camera.h"
 #include "Transform.h"
 #include "Timer.h"
@@ -23,6 +24,7 @@
 #define PIXEL_SHADER_FILE L"..\\..\\shaders\\PixelShader.hlsl"
 #define VERTEX_SKINNING_SHADER_FILE L"..\\..\\shaders\\VertexShaderSkinning.hlsl"
 #define VERTEX_SHADOW_SHADER_FILE   L"..\\..\\shaders\\VertexShader_Shadow.hlsl"
+#define VERTEX_INSTANCED_SHADER_FILE L"..\\..\\shaders\\VertexShaderInstanced.hlsl"
 
 // Forward declaration
 class GDXEngine;
@@ -47,12 +49,11 @@ private:
 	int m_monitorIndex;					// Index of the monitor
 	static GDXEngine* s_instance;		// Singleton-Pointer
 
-	DirectX::XMFLOAT4 m_globalAmbient;  // Globale Ambient-Farbe für die Szene
-
 	std::wstring vs;
 	std::wstring ps;
 
 	// Manager classes
+	JobSystem           m_jobSystem;        // declared before m_renderManager, which holds a pointer to it
 	Scene               m_scene;
 	AssetManager        m_assetManager;
 	ObjectManager       m_objectManager;
@@ -105,7 +106,7 @@ public:
 	void SetAdapter(unsigned int index);
 	void SetOutput(unsigned int index);
 	void SetDirectionalLight(LPENTITY entity);
-	void SetGlobalAmbient(const DirectX::XMFLOAT4& ambient) { m_globalAmbient = ambient; }
+	void SetGlobalAmbient(const DirectX::XMFLOAT4& ambient) { m_renderManager.SetGlobalAmbient(ambient); }
 	void SetCamera(LPENTITY mesh);
 	void SetVSyncInterval(int interval) noexcept;
 
@@ -114,7 +115,7 @@ public:
 	HRESULT InitMaterialBuffer(Material* material);
 
 
-	DirectX::XMFLOAT4 GetGlobalAmbient() const { return m_globalAmbient; }
+	DirectX::XMFLOAT4 GetGlobalAmbient() const { return m_renderManager.GetGlobalAmbient(); }
 	int GetVSyncInterval() const noexcept;
 
 
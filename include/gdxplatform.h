@@ -0,0 +1,33 @@
+#pragma once
+
+// Small standalone header: the Windows base types used by engine headers.
+// On Windows this is <windows.h>. Elsewhere only the scalar types and HRESULT
+// codes are declared, so CPU-side code (scene, queues, RenderManager with
+// RecordingRenderBackend) builds without the Windows SDK. Off Windows no
+// D3D object is ever created; the D3D11 sources stay Windows-only.
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cstddef>
+#include <cstdint>
+
+typedef int32_t        HRESULT;
+typedef int            BOOL;
+typedef uint32_t       UINT;
+typedef uint32_t       UINT32;
+typedef uint32_t       DWORD;
+typedef size_t         SIZE_T;
+typedef void*          LPVOID;
+typedef struct HWND__* HWND;
+
+#define S_OK          ((HRESULT)0)
+#define S_FALSE       ((HRESULT)1)
+#define E_FAIL        ((HRESULT)0x80004005L)
+#define E_INVALIDARG  ((HRESULT)0x80070057L)
+#define E_OUTOFMEMORY ((HRESULT)0x8007000EL)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr)    (((HRESULT)(hr)) < 0)
+#endif
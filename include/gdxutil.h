@@ -3,21 +3,26 @@
 #ifndef GDXUTIL_H_INCLUDED
 #define GDXUTIL_H_INCLUDED
 
-#define WIN32_LEAN_AND_MEAN
-
-#include <windows.h>
+// Windows and D3D parts only under _WIN32. The rest (debug log, constant
+// structs, vertex flags) needs nothing but DirectXMath, so this header
+// alone does not tie a source file to the Windows SDK.
+#include "gdxplatform.h"
 
+#ifdef _WIN32
 #include <wrl/client.h>
 using Microsoft::WRL::ComPtr;
 
+#include <d3d11.h>
+#include <dxgi.h>
+#endif
+
 #include <string>
 #include <sstream>
 #include <iostream>
 #include <mutex>
 #include <iomanip>
 #include <chrono>
-#include <d3d11.h>
-#include <dxgi.h>
+#include <ctime>
 #include <DirectXMath.h>
 #include <unordered_set>
 #include <cstdint>
@@ -73,14 +78,14 @@ enum D3DVERTEX_FLAGS {
     D3DVERTEX_TANGENT       = (1 << 8), // float4 (xyz + handedness)
     D3DVERTEX_BONE_INDICES  = (1 << 9), // uint4  (4 Bone-Indices pro Vertex)
     D3DVERTEX_BONE_WEIGHTS  = (1 << 10),// float4 (4 Bone-Weights pro Vertex)
+    D3DVERTEX_INSTANCE_WORLD = (1 << 11),// float4x4 per instance (INSTANCE_WORLD0..3), slot after the vertex streams
 };
 
 // Maximale Anzahl Bones pro Mesh im Skinning-Shader
 static const int MAX_BONES = 128;
 
 // Constant-Buffer-Layout fuer Bone-Matrizen (Register b4 im Vertex-Shader)
-__declspec(align(16))
-struct BoneBuffer
+struct alignas(16) BoneBuffer
 {
     DirectX::XMMATRIX boneMatrices[128];
 };
@@ -89,17 +94,42 @@ struct BoneBuffer
 
 
 // Common structs
-__declspec(align(16))
-struct MatrixSet
+struct alignas(16) MatrixSet
 {
     DirectX::XMMATRIX viewMatrix;
     DirectX::XMMATRIX projectionMatrix;
     DirectX::XMMATRIX worldMatrix;
 };
 
+// Per-entity constant block (VS/PS b0). Uploaded once per mesh and frame.
+// worldInverseTranspose transforms normals (correct under non-uniform scale).
+struct alignas(16) EntityConstants
+{
+    DirectX::XMMATRIX worldMatrix;
+    DirectX::XMMATRIX worldInverseTranspose;
+};
+
+// Per-pass constant block (VS/PS b5): camera or light view/projection.
+// Uploaded once per pass (shadow, main, RTT), shared by all draws.
+struct alignas(16) PassConstants
+{
+    DirectX::XMMATRIX viewMatrix;
+    DirectX::XMMATRIX projectionMatrix;
+    DirectX::XMFLOAT4 cameraPosition;   // xyz = eye in world space, w = 1
+};
+
+inline EntityConstants MakeEntityConstants(DirectX::FXMMATRIX world)
+{
+    EntityConstants c;
+    c.worldMatrix           = world;
+    c.worldInverseTranspose = DirectX::XMMatrixTranspose(DirectX::XMMatrixInverse(nullptr, world));
+    return c;
+}
+
 // GXUTIL API (Implementierung in gdxutil.cpp)
 namespace GXUTIL
 {
+#ifdef _WIN32
     DXGI_FORMAT   GetDXGIFormat(GXFORMAT format);
     std::wstring  GetTextureFormatName(GXFORMAT format);
 
@@ -111,28 +141,41 @@ namespace GXUTIL
     int           GetFeatureLevel(D3D_FEATURE_LEVEL featureLevel);
     D3D_FEATURE_LEVEL GetFeatureLevelFromDirectXVersion(int version);
     std::wstring  GetFeatureLevelName(D3D_FEATURE_LEVEL featureLevel);
+#endif
 
     // -------- UTF helpers (header-only, kein <codecvt>) --------
     inline std::string WideToUtf8(const wchar_t* wstr)
     {
         if (!wstr) return {};
+#ifdef _WIN32
         int needed = WideCharToMultiByte(CP_UTF8, 0, wstr, -1, nullptr, 0, nullptr, nullptr);
         if (needed <= 0) return {};
         std::string out;
         out.resize(static_cast<size_t>(needed - 1));
         WideCharToMultiByte(CP_UTF8, 0, wstr, -1, out.data(), needed, nullptr, nullptr);
         return out;
+#else
+        // Without Windows this only feeds log output: non-ASCII becomes '?'.
+        std::string out;
+        for (; *wstr; ++wstr)
+            out.push_back(static_cast<uint32_t>(*wstr) < 0x80u ? static_cast<char>(*wstr) : '?');
+        return out;
+#endif
     }
 
     inline std::wstring Utf8ToWide(const std::string& str)
     {
         if (str.empty()) return {};
+#ifdef _WIN32
         int needed = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, nullptr, 0);
         if (needed <= 0) return {};
         std::wstring out;
         out.resize(static_cast<size_t>(needed - 1));
         MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, out.data(), needed);
         return out;
+#else
+        return std::wstring(str.begin(), str.end());
+#endif
     }
 }
 
@@ -183,6 +226,7 @@ public:
         Log(std::forward<Args>(args)...);
     }
 
+#ifdef _WIN32
     static void LogHr(const char* file, int line, HRESULT hr)
     {
         if (SUCCEEDED(hr)) return;
@@ -197,6 +241,7 @@ public:
         LogError(file, ":", line, " -> ", FormatWin32Message(err),
             " (Win32=0x", std::hex, std::uppercase, err, ")");
     }
+#endif
 
 private:
     inline static std::mutex s_mutex;
@@ -217,7 +262,11 @@ private:
         const auto t = system_clock::to_time_t(now);
 
         std::tm tm{};
+#ifdef _WIN32
         localtime_s(&tm, &t);
+#else
+        localtime_r(&t, &tm);
+#endif
 
         const auto ms = duration_cast<milliseconds>(now.time_since_epoch()) % 1000;
 
@@ -230,6 +279,7 @@ private:
         return oss.str();
     }
 
+#ifdef _WIN32
     static std::string FormatWin32Message(DWORD code)
     {
         if (code == 0) return "OK";
@@ -249,6 +299,7 @@ private:
         if (buf) LocalFree(buf);
         return msg;
     }
+#endif
 
     template<typename T>
     static void Append(std::ostringstream& oss, const T& t) { oss << t; }
@@ -277,8 +328,10 @@ private:
             stream << line << "\n";
             stream.flush();
         }
+#ifdef _WIN32
         if (s_outputDebugString)
             OutputDebugStringA((line + "\n").c_str());
+#endif
     }
 };
 
@@ -24,6 +24,14 @@ inline void CreateSphere(LPENTITY* mesh, LPMATERIAL material = nullptr,
     if (material)
         Engine::SetSlotMaterial(*mesh, 0, material);
 
+    const int stride = segments + 1;
+    const unsigned int vertexCount = static_cast<unsigned int>((rings + 1) * stride);
+
+    std::vector<DirectX::XMFLOAT3> positions;  positions.reserve(vertexCount);
+    std::vector<DirectX::XMFLOAT3> normals;    normals.reserve(vertexCount);
+    std::vector<DirectX::XMFLOAT2> uv;         uv.reserve(vertexCount);
+    std::vector<unsigned int>      indices;    indices.reserve(static_cast<size_t>(rings) * segments * 6);
+
     for (int r = 0; r <= rings; ++r)
     {
         const float phi = DirectX::XM_PI * static_cast<float>(r) / static_cast<float>(rings);
@@ -45,29 +53,31 @@ inline void CreateSphere(LPENTITY* mesh, LPMATERIAL material = nullptr,
             const float ny = (len > 0.0f) ? y / len : 1.0f;
             const float nz = (len > 0.0f) ? z / len : 0.0f;
 
-            Engine::AddVertex(surface, x, y, z);
-            Engine::VertexNormal(surface, nx, ny, nz);
-            Engine::VertexColor(surface, 255, 255, 255);
-            Engine::VertexTexCoord(surface,
-                static_cast<float>(s) / static_cast<float>(segments),
-                static_cast<float>(r) / static_cast<float>(rings));
+            positions.emplace_back(x, y, z);
+            normals.emplace_back(nx, ny, nz);
+            uv.emplace_back(static_cast<float>(s) / static_cast<float>(segments),
+                            static_cast<float>(r) / static_cast<float>(rings));
         }
     }
 
-    const int stride = segments + 1;
     for (int r = 0; r < rings; ++r)
     {
         for (int s = 0; s < segments; ++s)
         {
-            const int i0 = r * stride + s;
-            const int i1 = r * stride + s + 1;
-            const int i2 = (r + 1) * stride + s;
-            const int i3 = (r + 1) * stride + s + 1;
+            const unsigned int i0 = r * stride + s;
+            const unsigned int i1 = r * stride + s + 1;
+            const unsigned int i2 = (r + 1) * stride + s;
+            const unsigned int i3 = (r + 1) * stride + s + 1;
 
-            Engine::AddTriangle(surface, i0, i2, i1);
-            Engine::AddTriangle(surface, i1, i2, i3);
+            indices.insert(indices.end(), { i0, i2, i1, i1, i2, i3 });
         }
     }
 
+    Engine::SetVertices(surface, std::move(positions));
+    Engine::SetVertexNormals(surface, std::move(normals));
+    Engine::SetVertexColors(surface, std::vector<DirectX::XMFLOAT4>(vertexCount, DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f)));
+    Engine::SetVertexTexCoords(surface, std::move(uv));
+    Engine::SetTriangles(surface, std::move(indices));
+
     Engine::FillBuffer(*mesh, 0u);
 }
@@ -3,14 +3,19 @@
 #include <windows.h>
 #include <DirectXMath.h>
 #include <fstream>  
+#include <span>
 
 #include "gdxengine.h"
 #include "Dx11MaterialGpuData.h"
 #include "Dx11LightGpuData.h"
 #include "Dx11EntityGpuData.h"
 #include "SurfaceGpuBuffer.h"
+#include "RenderTextureTarget.h"
+#include "VertexPacker.h"
+#include "GeometryHelper.h"
 #include "Surface.h"
 #include "MeshAsset.h"
+#include "MeshFile.h"
 
 namespace Engine
 {
@@ -466,9 +471,10 @@ namespace Engine
         }
 
         if (!m->gpuData) m->gpuData = new EntityGpuData();
+        const EntityConstants initial = MakeEntityConstants(m->matrixSet.worldMatrix);
         HRESULT hr = engine->GetBM().CreateBuffer(
-            &m->matrixSet,
-            sizeof(MatrixSet),
+            &initial,
+            sizeof(EntityConstants),
             1,
             D3D11_BIND_CONSTANT_BUFFER,
             &m->gpuData->constantBuffer
@@ -483,6 +489,44 @@ namespace Engine
         *mesh = m;
     }
 
+    // Creates a mesh from a .oymesh file (MeshFile). Vertex and index
+    // buffers are created straight from the mapped file, so no FillBuffer
+    // is needed. Without desc.keepCpuGeometry the surfaces are GPU only:
+    // no picking, LOD generation, static batching or FillBuffer.
+    inline void LoadMesh(LPENTITY* mesh, const wchar_t* filename, const MeshFileLoadDesc& desc = MeshFileLoadDesc{})
+    {
+        if (mesh == nullptr) {
+            Debug::Log("gidx.h: ERROR: LoadMesh - mesh pointer is nullptr");
+            return;
+        }
+        *mesh = nullptr;
+
+        LPENTITY entity = nullptr;
+        CreateMesh(&entity);
+        if (entity == nullptr) return;
+
+        Mesh* m = entity->AsMesh();
+        if (!MeshFile::Load(filename, *m->BorrowMeshAsset(), engine->GetAM(), engine->GetBM(), desc)
+            && m->GetSlotCount() == 0)
+        {
+            Debug::Log("gidx.h: ERROR: LoadMesh - cannot load mesh file");
+            engine->GetAM().DeleteManagedMesh(engine->GetScene(), m);
+            return;
+        }
+
+        *mesh = m;
+    }
+
+    // Writes the entity's mesh asset as .oymesh. Needs CPU geometry.
+    inline bool SaveMesh(LPENTITY entity, const wchar_t* filename, const MeshFileWriteDesc& desc = MeshFileWriteDesc{})
+    {
+        if (!entity) { Debug::Log("gidx.h: ERROR: SaveMesh - entity is nullptr"); return false; }
+        Mesh* m = (entity->IsMesh() ? entity->AsMesh() : nullptr);
+        if (!m || !m->HasMeshAsset()) { Debug::Log("gidx.h: ERROR: SaveMesh - Entity has no MeshAsset"); return false; }
+
+        return MeshFile::Write(*m->GetMeshAsset(), filename, desc);
+    }
+
     // ==================== SHADER ====================
 
     inline HRESULT CreateShader(LPSHADER* shader,
@@ -787,15 +831,19 @@ namespace Engine
     }
 
 
-    inline void FillBuffer(LPSURFACE surface)
+    // Uploads the vertex streams that shader->flagsVertex requires.
+    inline void FillBuffer(LPSURFACE surface, Shader* shader)
     {
         if (!surface) { Debug::Log("gidx.h: ERROR: FillBuffer - surface is nullptr"); return; }
-
-        Shader* shader = engine->GetAM().GetShader(*engine->GetAM().GetStandardMaterial());
-        if (!shader) { Debug::Log("gidx.h: ERROR: FillBuffer - standard shader missing"); return; }
+        if (!shader) { Debug::Log("gidx.h: ERROR: FillBuffer - shader is nullptr"); return; }
 
         SurfaceGpuBuffer* gpuDX11 = static_cast<SurfaceGpuBuffer*>(surface->gpu.get());
         if (!gpuDX11) { Debug::Log("gidx.h: ERROR: FillBuffer - gpu ist kein SurfaceGpuBuffer"); return; }
+        if (surface->IsGpuOnly()) { Debug::Log("gidx.h: ERROR: FillBuffer - surface has no CPU geometry (LoadMesh)"); return; }
+
+        // New vertices become visible here: retained queues re-cull the
+        // meshes whose bounds moved (once per upload, not per vertex).
+        engine->GetScene().GetRenderRevision().TouchGeometry();
 
         gpuDX11->Release();
         gpuDX11->stridePosition = 0;
@@ -867,29 +915,35 @@ namespace Engine
         }
 
         if (surface->CountIndices() > 0)
-        {
-            if (SUCCEEDED(engine->GetBM().CreateBuffer(surface->GetIndices().data(), sizeof(UINT),
-                surface->CountIndices(), D3D11_BIND_INDEX_BUFFER, &gpuDX11->indexBuffer)))
-            {
-                gpuDX11->indexCount = surface->CountIndices();
-            }
-        }
+            gpuDX11->CreateIndexBuffer(engine->GetBM(), surface->GetIndices().data(), surface->CountIndices());
     }
 
-    inline void FillBuffer(LPENTITY entity, unsigned int slot)
+    inline void FillBuffer(LPSURFACE surface)
     {
-        if (!entity) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - entity is nullptr"); return; }
-        Mesh* mesh = (entity->IsMesh() ? entity->AsMesh() : nullptr);
-        if (!mesh) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - Entity is not a Mesh!"); return; }
-        LPSURFACE surface = mesh->GetSurface(slot);
-        if (!surface) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - invalid slot"); return; }
+        if (!surface) { Debug::Log("gidx.h: ERROR: FillBuffer - surface is nullptr"); return; }
 
-        Material* material = mesh->GetResolvedMaterial(slot, engine->GetAM().GetStandardMaterial());
-        Shader* shader = material ? material->pRenderShader : nullptr;
-        if (!shader) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - cannot resolve shader"); return; }
+        Shader* shader = engine->GetAM().GetShader(*engine->GetAM().GetStandardMaterial());
+        if (!shader) { Debug::Log("gidx.h: ERROR: FillBuffer - standard shader missing"); return; }
+
+        FillBuffer(surface, shader);
+    }
+
+    // Like FillBuffer, but uploads one interleaved, quantized vertex stream
+    // (32 bytes, 40 with bone data; see VertexPacker) instead of up to eight
+    // float streams. Shaders need no change. Meant for static geometry:
+    // Update*Buffer repacks the whole surface.
+    inline void FillBufferPacked(LPSURFACE surface)
+    {
+        if (!surface) { Debug::Log("gidx.h: ERROR: FillBufferPacked - surface is nullptr"); return; }
+
+        Shader* shader = engine->GetAM().GetShader(*engine->GetAM().GetStandardMaterial());
+        if (!shader) { Debug::Log("gidx.h: ERROR: FillBufferPacked - standard shader missing"); return; }
 
         SurfaceGpuBuffer* gpuDX11 = static_cast<SurfaceGpuBuffer*>(surface->gpu.get());
-        if (!gpuDX11) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - gpu ist kein SurfaceGpuBuffer"); return; }
+        if (!gpuDX11) { Debug::Log("gidx.h: ERROR: FillBufferPacked - gpu is not a SurfaceGpuBuffer"); return; }
+        if (surface->IsGpuOnly()) { Debug::Log("gidx.h: ERROR: FillBufferPacked - surface has no CPU geometry (LoadMesh)"); return; }
+
+        engine->GetScene().GetRenderRevision().TouchGeometry();
 
         gpuDX11->Release();
         gpuDX11->stridePosition = 0;
@@ -900,32 +954,41 @@ namespace Engine
         gpuDX11->strideUV2 = 0;
         gpuDX11->indexCount = 0;
 
-        if ((shader->flagsVertex & D3DVERTEX_POSITION) != 0 && surface->CountVertices() > 0) {
-            if (SUCCEEDED(engine->GetBM().CreateBuffer(surface->GetPositions().data(), sizeof(DirectX::XMFLOAT3), surface->CountVertices(), D3D11_BIND_VERTEX_BUFFER, &gpuDX11->positionBuffer))) gpuDX11->stridePosition = sizeof(DirectX::XMFLOAT3);
-        }
-        if ((shader->flagsVertex & D3DVERTEX_NORMAL) != 0 && surface->CountNormals() > 0) {
-            if (SUCCEEDED(engine->GetBM().CreateBuffer(surface->GetNormals().data(), sizeof(DirectX::XMFLOAT3), surface->CountNormals(), D3D11_BIND_VERTEX_BUFFER, &gpuDX11->normalBuffer))) gpuDX11->strideNormal = sizeof(DirectX::XMFLOAT3);
-        }
-        if ((shader->flagsVertex & D3DVERTEX_TANGENT) != 0) {
-            if (surface->CountTangents() != surface->CountVertices()) surface->ComputeTangents();
-            if (surface->CountTangents() > 0) {
-                if (SUCCEEDED(engine->GetBM().CreateBuffer(surface->GetTangents().data(), sizeof(DirectX::XMFLOAT4), surface->CountTangents(), D3D11_BIND_VERTEX_BUFFER, &gpuDX11->tangentBuffer))) gpuDX11->strideTangent = sizeof(DirectX::XMFLOAT4);
-            }
-        }
-        if ((shader->flagsVertex & D3DVERTEX_COLOR) != 0 && surface->CountColors() > 0) {
-            if (SUCCEEDED(engine->GetBM().CreateBuffer(surface->GetColors().data(), sizeof(DirectX::XMFLOAT4), surface->CountColors(), D3D11_BIND_VERTEX_BUFFER, &gpuDX11->colorBuffer))) gpuDX11->strideColor = sizeof(DirectX::XMFLOAT4);
-        }
-        if ((shader->flagsVertex & D3DVERTEX_TEX1) != 0 && surface->CountUV1() > 0) {
-            if (SUCCEEDED(engine->GetBM().CreateBuffer(surface->GetUV1().data(), sizeof(DirectX::XMFLOAT2), surface->CountUV1(), D3D11_BIND_VERTEX_BUFFER, &gpuDX11->uv1Buffer))) gpuDX11->strideUV1 = sizeof(DirectX::XMFLOAT2);
-        }
-        if ((shader->flagsVertex & D3DVERTEX_TEX2) != 0 && surface->CountUV2() > 0) {
-            if (SUCCEEDED(engine->GetBM().CreateBuffer(surface->GetUV2().data(), sizeof(DirectX::XMFLOAT2), surface->CountUV2(), D3D11_BIND_VERTEX_BUFFER, &gpuDX11->uv2Buffer))) gpuDX11->strideUV2 = sizeof(DirectX::XMFLOAT2);
+        if ((shader->flagsVertex & D3DVERTEX_TANGENT) != 0 && surface->CountTangents() != surface->CountVertices())
+            surface->ComputeTangents();
+
+        std::vector<uint8_t> packed;
+        const uint32_t stride = VertexPacker::Pack(*surface, packed);
+        if (stride == 0)
+        {
+            // Not packable (e.g. bone index > 255): separate streams still work.
+            FillBuffer(surface);
+            return;
         }
-        if ((shader->flagsVertex & D3DVERTEX_BONE_INDICES) != 0 && surface->CountBoneData() > 0) engine->GetBM().CreateBuffer(surface->GetBoneIndices().data(), sizeof(DirectX::XMUINT4), surface->CountBoneData(), D3D11_BIND_VERTEX_BUFFER, &gpuDX11->boneIndexBuffer);
-        if ((shader->flagsVertex & D3DVERTEX_BONE_WEIGHTS) != 0 && surface->CountBoneData() > 0) engine->GetBM().CreateBuffer(surface->GetBoneWeights().data(), sizeof(DirectX::XMFLOAT4), surface->CountBoneData(), D3D11_BIND_VERTEX_BUFFER, &gpuDX11->boneWeightBuffer);
-        if (surface->CountIndices() > 0) {
-            if (SUCCEEDED(engine->GetBM().CreateBuffer(surface->GetIndices().data(), sizeof(UINT), surface->CountIndices(), D3D11_BIND_INDEX_BUFFER, &gpuDX11->indexBuffer))) gpuDX11->indexCount = surface->CountIndices();
+
+        if (SUCCEEDED(engine->GetBM().CreateBuffer(packed.data(), stride, surface->CountVertices(),
+            D3D11_BIND_VERTEX_BUFFER, &gpuDX11->packedBuffer)))
+        {
+            gpuDX11->stridePacked = stride;
         }
+
+        if (surface->CountIndices() > 0)
+            gpuDX11->CreateIndexBuffer(engine->GetBM(), surface->GetIndices().data(), surface->CountIndices());
+    }
+
+    inline void FillBuffer(LPENTITY entity, unsigned int slot)
+    {
+        if (!entity) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - entity is nullptr"); return; }
+        Mesh* mesh = (entity->IsMesh() ? entity->AsMesh() : nullptr);
+        if (!mesh) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - Entity is not a Mesh!"); return; }
+        LPSURFACE surface = mesh->GetSurface(slot);
+        if (!surface) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - invalid slot"); return; }
+
+        Material* material = mesh->GetResolvedMaterial(slot, engine->GetAM().GetStandardMaterial());
+        Shader* shader = material ? material->pRenderShader : nullptr;
+        if (!shader) { Debug::Log("gidx.h: ERROR: FillBuffer(entity) - cannot resolve shader"); return; }
+
+        FillBuffer(surface, shader);
     }
 
     inline bool SetSurfaceMaterial(LPENTITY entity, LPSURFACE surface, LPMATERIAL material)
@@ -1018,7 +1081,8 @@ namespace Engine
             return;
         }
         SurfaceGpuBuffer* gpuDX11 = static_cast<SurfaceGpuBuffer*>(surface->gpu.get());
-        if (!gpuDX11) return;
+        if (!gpuDX11 || surface->IsGpuOnly()) return;
+        if (gpuDX11->IsPacked()) { FillBufferPacked(surface); return; }
         engine->GetBM().UpdateBuffer(gpuDX11->colorBuffer, surface->GetColors().data(), sizeof(DirectX::XMFLOAT4) * surface->CountColors());
     }
 
@@ -1029,7 +1093,9 @@ namespace Engine
             return;
         }
         SurfaceGpuBuffer* gpuDX11 = static_cast<SurfaceGpuBuffer*>(surface->gpu.get());
-        if (!gpuDX11) return;
+        if (!gpuDX11 || surface->IsGpuOnly()) return;
+        if (gpuDX11->IsPacked()) { FillBufferPacked(surface); return; }
+        engine->GetScene().GetRenderRevision().TouchGeometry();
         engine->GetBM().UpdateBuffer(gpuDX11->positionBuffer, surface->GetPositions().data(), sizeof(DirectX::XMFLOAT3) * surface->CountVertices());
     }
 
@@ -1040,7 +1106,8 @@ namespace Engine
             return;
         }
         SurfaceGpuBuffer* gpuDX11 = static_cast<SurfaceGpuBuffer*>(surface->gpu.get());
-        if (!gpuDX11) return;
+        if (!gpuDX11 || surface->IsGpuOnly()) return;
+        if (gpuDX11->IsPacked()) { FillBufferPacked(surface); return; }
         engine->GetBM().UpdateNormal(gpuDX11->normalBuffer, surface->GetNormals().data(), surface->CountNormals());
     }
 
@@ -1155,6 +1222,178 @@ namespace Engine
         surface->AddIndex(c);
     }
 
+    // ---- Bulk submission ----
+    // Whole streams in one call (std::vector, std::array or pointer + count
+    // via std::span). Every stream that is used needs one entry per vertex.
+    // Colors are floats 0..1 here, not 0..255 like VertexColor.
+
+    // Reserves room for that many more vertices and indices. vertexFlags
+    // (D3DVERTEX_*) selects the streams besides positions; 0 = normals, UV1.
+    inline void ReserveSurface(LPSURFACE surface, unsigned int vertices, unsigned int indices, DWORD vertexFlags = 0)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: ReserveSurface - surface is nullptr");
+            return;
+        }
+        surface->Reserve(vertices, indices, static_cast<uint32_t>(vertexFlags));
+    }
+
+    inline void AddVertices(LPSURFACE surface, std::span<const DirectX::XMFLOAT3> positions)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: AddVertices - surface is nullptr");
+            return;
+        }
+        surface->AddVertices(positions);
+    }
+
+    inline void VertexNormals(LPSURFACE surface, std::span<const DirectX::XMFLOAT3> normals)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: VertexNormals - surface is nullptr");
+            return;
+        }
+        surface->AddNormals(normals);
+    }
+
+    inline void VertexColors(LPSURFACE surface, std::span<const DirectX::XMFLOAT4> colors)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: VertexColors - surface is nullptr");
+            return;
+        }
+        surface->AddColors(colors);
+    }
+
+    inline void VertexTexCoords(LPSURFACE surface, std::span<const DirectX::XMFLOAT2> uv)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: VertexTexCoords - surface is nullptr");
+            return;
+        }
+        surface->AddTexCoords(uv);
+    }
+
+    inline void VertexTexCoords2(LPSURFACE surface, std::span<const DirectX::XMFLOAT2> uv)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: VertexTexCoords2 - surface is nullptr");
+            return;
+        }
+        surface->AddTexCoords2(uv);
+    }
+
+    inline void VertexTangents(LPSURFACE surface, std::span<const DirectX::XMFLOAT4> tangents)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: VertexTangents - surface is nullptr");
+            return;
+        }
+        surface->AddTangents(tangents);
+    }
+
+    inline void VertexBoneData(LPSURFACE surface, std::span<const DirectX::XMUINT4> indices, std::span<const DirectX::XMFLOAT4> weights)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: VertexBoneData - surface is nullptr");
+            return;
+        }
+        if (indices.size() != weights.size())
+            Debug::Log("gidx.h: VertexBoneData - index and weight counts differ, extra entries ignored");
+        surface->AddBoneData(indices, weights);
+    }
+
+    // Three indices per triangle; baseVertex is added to each of them.
+    inline void AddTriangles(LPSURFACE surface, std::span<const unsigned int> indices, unsigned int baseVertex = 0)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: AddTriangles - surface is nullptr");
+            return;
+        }
+        if (indices.size() % 3 != 0)
+            Debug::Log("gidx.h: AddTriangles - index count is not a multiple of 3");
+        surface->AddIndices(indices, baseVertex);
+    }
+
+    // Replace a whole stream with a prebuilt vector without copying:
+    //   Engine::SetVertices(surface, std::move(positions));
+    inline void SetVertices(LPSURFACE surface, std::vector<DirectX::XMFLOAT3>&& positions)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: SetVertices - surface is nullptr");
+            return;
+        }
+        surface->SetVertices(std::move(positions));
+    }
+
+    inline void SetVertexNormals(LPSURFACE surface, std::vector<DirectX::XMFLOAT3>&& normals)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: SetVertexNormals - surface is nullptr");
+            return;
+        }
+        surface->SetNormals(std::move(normals));
+    }
+
+    inline void SetVertexColors(LPSURFACE surface, std::vector<DirectX::XMFLOAT4>&& colors)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: SetVertexColors - surface is nullptr");
+            return;
+        }
+        surface->SetColors(std::move(colors));
+    }
+
+    inline void SetVertexTexCoords(LPSURFACE surface, std::vector<DirectX::XMFLOAT2>&& uv)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: SetVertexTexCoords - surface is nullptr");
+            return;
+        }
+        surface->SetTexCoords(std::move(uv));
+    }
+
+    inline void SetVertexTexCoords2(LPSURFACE surface, std::vector<DirectX::XMFLOAT2>&& uv)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: SetVertexTexCoords2 - surface is nullptr");
+            return;
+        }
+        surface->SetTexCoords2(std::move(uv));
+    }
+
+    inline void SetVertexTangents(LPSURFACE surface, std::vector<DirectX::XMFLOAT4>&& tangents)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: SetVertexTangents - surface is nullptr");
+            return;
+        }
+        surface->SetTangents(std::move(tangents));
+    }
+
+    inline void SetTriangles(LPSURFACE surface, std::vector<unsigned int>&& indices)
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: SetTriangles - surface is nullptr");
+            return;
+        }
+        if (indices.size() % 3 != 0)
+            Debug::Log("gidx.h: SetTriangles - index count is not a multiple of 3");
+        surface->SetIndices(std::move(indices));
+    }
+
+    // Reorders triangles and vertices of a finished surface for the GPU
+    // vertex cache, overdraw and vertex fetch (GeometryHelper::Optimize).
+    // Vertex numbers change; call before FillBuffer.
+    inline GeometryOptimizeReport OptimizeSurface(LPSURFACE surface, const GeometryOptimizeDesc& desc = GeometryOptimizeDesc{})
+    {
+        if (surface == nullptr) {
+            Debug::Log("gidx.h: ERROR: OptimizeSurface - surface is nullptr");
+            return GeometryOptimizeReport{};
+        }
+        return GeometryHelper::Optimize(*surface, desc);
+    }
+
     // ==================== RENDERING ====================
 
     inline int Cls(int r, int g, int b, int a = 255)
@@ -1195,7 +1434,11 @@ namespace Engine
 
     // ==================== TEXTURE ====================
 
-    inline void LoadTexture(LPLPTEXTURE texture, const wchar_t* filename)
+    // usage picks the mip filtering: TextureUsage::Color (sRGB correct),
+    // Normal (renormalized), Linear (ORM) or Scalar (occlusion, roughness,
+    // metallic). Cooked .dds/.ktx2 files are uploaded as stored.
+    inline void LoadTexture(LPLPTEXTURE texture, const wchar_t* filename,
+                            TextureUsage usage = TextureUsage::Color)
     {
 
         // Prüfe ob Datei existiert
@@ -1211,7 +1454,8 @@ namespace Engine
             engine->m_device.GetDevice(),
             engine->m_device.GetDeviceContext(),
             filename,
-            texture
+            texture,
+            usage
         );
 
         if (FAILED(hr)) {
@@ -1219,6 +1463,65 @@ namespace Engine
         }
     }
 
+    // ---- Asynchronous loading ----
+    // The file is decoded on loader threads and swapped in by RenderWorld.
+    // The returned pool index can be used at once; it shows fallbackIndex
+    // (TextureWhite, TextureFlatNormal, TextureOrm) until then.
+    inline uint32_t TextureWhite()      { return engine->GetTP().WhiteIndex(); }
+    inline uint32_t TextureFlatNormal() { return engine->GetTP().FlatNormalIndex(); }
+    inline uint32_t TextureOrm()        { return engine->GetTP().OrmIndex(); }
+
+    inline uint32_t LoadTextureAsync(const wchar_t* filename, uint32_t fallbackIndex,
+                                     TextureLoadCallback onLoaded = {},
+                                     TextureUsage usage = TextureUsage::Color)
+    {
+        if (!filename) {
+            Debug::Log("gidx.h: ERROR: LoadTextureAsync - filename is nullptr");
+            return engine->GetTP().WhiteIndex();
+        }
+        return engine->GetTP().LoadTextureAsync(filename, fallbackIndex, std::move(onLoaded), usage);
+    }
+
+    // Mip chains for textures loaded from now on: MipFilter::Box or Kaiser,
+    // maxLevels 0 = full chain, 1 = no mips.
+    inline void TextureMipFilter(MipFilter filter, uint32_t maxLevels = 0)
+    {
+        engine->GetTP().SetMipDesc(MipDesc{ filter, maxLevels });
+    }
+
+    // Blocks until all async texture loads are on the GPU (loading screens).
+    inline void WaitTextureLoads()
+    {
+        engine->GetTP().WaitAsyncLoads(engine->m_device.GetDevice());
+    }
+
+    // 0 = no limit (default).
+    inline void TextureUploadsPerFrame(uint32_t uploads)
+    {
+        engine->GetTP().SetAsyncUploadsPerFrame(uploads);
+    }
+
+    inline TextureLoadStats GetTextureLoadStats()
+    {
+        return engine->GetTP().GetLoadStats();
+    }
+
+    // GPU memory budget in bytes for all loaded textures, 0 = off (default).
+    // Textures loaded afterwards stream their mip levels: they start small
+    // and get the detail their on-screen size needs, within the budget.
+    inline void TextureStreaming(uint64_t budgetBytes, uint32_t minResidentSize = 64)
+    {
+        TextureStreamingDesc desc = engine->GetTP().GetStreamingDesc();
+        desc.budgetBytes     = budgetBytes;
+        desc.minResidentSize = minResidentSize;
+        engine->GetTP().SetStreamingDesc(desc);
+    }
+
+    inline TextureResidencyStats GetTextureStreamingStats()
+    {
+        return engine->GetTP().GetStreamingStats();
+    }
+
     // -- MaterialTexture (Legacy-API, bleibt erhalten) --------------------------─
     // Speichert Textur im Material-Slot (slot 0..7) und registriert die SRV
     // automatisch im globalen TexturePool.
@@ -1360,6 +1663,47 @@ namespace Engine
         }
     }
 
+    // -- Async material maps ----------------------------------------------------
+    // Like MaterialSetAlbedo/Normal/ORM/Occlusion/Roughness/Metallic, but
+    // take a filename and load it asynchronously. The material renders with
+    // the matching default texture until the map arrives.
+    inline void MaterialLoadAlbedoAsync(LPMATERIAL material, const wchar_t* filename)
+    {
+        if (!material) return;
+        material->SetAlbedoIndex(LoadTextureAsync(filename, engine->GetTP().WhiteIndex()));
+    }
+
+    inline void MaterialLoadNormalAsync(LPMATERIAL material, const wchar_t* filename)
+    {
+        if (!material) return;
+        material->SetNormalScale(material->GetNormalScale() > 0.0001f ? material->GetNormalScale() : 1.0f);
+        material->SetNormalIndex(LoadTextureAsync(filename, engine->GetTP().FlatNormalIndex(), {}, TextureUsage::Normal));
+    }
+
+    inline void MaterialLoadORMAsync(LPMATERIAL material, const wchar_t* filename)
+    {
+        if (!material) return;
+        material->SetOrmIndex(LoadTextureAsync(filename, engine->GetTP().OrmIndex(), {}, TextureUsage::Linear));
+    }
+
+    inline void MaterialLoadOcclusionAsync(LPMATERIAL material, const wchar_t* filename)
+    {
+        if (!material) return;
+        material->SetOcclusionIndex(LoadTextureAsync(filename, engine->GetTP().WhiteIndex(), {}, TextureUsage::Scalar));
+    }
+
+    inline void MaterialLoadRoughnessAsync(LPMATERIAL material, const wchar_t* filename)
+    {
+        if (!material) return;
+        material->SetRoughnessIndex(LoadTextureAsync(filename, engine->GetTP().WhiteIndex(), {}, TextureUsage::Scalar));
+    }
+
+    inline void MaterialLoadMetallicAsync(LPMATERIAL material, const wchar_t* filename)
+    {
+        if (!material) return;
+        material->SetMetallicIndex(LoadTextureAsync(filename, engine->GetTP().WhiteIndex(), {}, TextureUsage::Scalar));
+    }
+
     // -- MaterialSetDecal ------------------------------------------------------
     // Weist dem Material eine optionale Decal-Textur zu.
     inline void MaterialSetDecal(LPMATERIAL material, LPTEXTURE texture)
@@ -1737,6 +2081,7 @@ namespace Engine
             return nullptr;
         }
 
+        mesh->UpdateOBB();
         return &mesh->obb;
     }
 
@@ -1875,6 +2220,112 @@ namespace Engine
         rtt->SetClearColor(r, g, b, a);
     }
 
+    // ==================== STATIC BATCHING ====================
+
+    // Marks an entity as static (never moves). Only BakeStaticBatches reads it.
+    inline void EntityStatic(LPENTITY entity, bool isStatic)
+    {
+        if (!entity) { Debug::Log("gidx.h: ERROR: EntityStatic - entity is nullptr"); return; }
+        entity->SetStatic(isStatic);
+    }
+
+    inline bool EntityStatic(LPENTITY entity)
+    {
+        if (!entity) { Debug::Log("gidx.h: ERROR: EntityStatic - entity is nullptr"); return false; }
+        return entity->IsStatic();
+    }
+
+    // Merges static meshes with the same material into pre-transformed batch
+    // meshes, split into world grid cells of desc.chunkSize. The source
+    // meshes stay for picking/collision but are no longer drawn. Call after
+    // the level is built; calling again rebuilds all batches.
+    inline StaticBatchStats BakeStaticBatches(const StaticBatchDesc& desc = StaticBatchDesc{})
+    {
+        engine->GetScene().UpdateWorldMatrices();
+        const StaticBatchStats stats = engine->GetAM().BuildStaticBatches(engine->GetScene(), desc);
+
+        for (Mesh* batch : engine->GetAM().GetStaticBatches())
+        {
+            if (!batch->gpuData) batch->gpuData = new EntityGpuData();
+            const EntityConstants initial = MakeEntityConstants(batch->matrixSet.worldMatrix);
+            HRESULT hr = engine->GetBM().CreateBuffer(&initial, sizeof(EntityConstants), 1,
+                D3D11_BIND_CONSTANT_BUFFER, &batch->gpuData->constantBuffer);
+            if (FAILED(hr)) Debug::LogHr(__FILE__, __LINE__, hr);
+
+            for (Surface* surface : batch->GetSurfaces())
+                FillBuffer(surface);
+        }
+        return stats;
+    }
+
+    // Removes all batches; the source meshes are drawn again.
+    inline void ClearStaticBatches()
+    {
+        engine->GetAM().ClearStaticBatches(engine->GetScene());
+    }
+
+    // ==================== LEVEL OF DETAIL ====================
+
+    // Builds reduced levels of the entity's mesh asset (MeshSimplifier) and
+    // uploads them with each slot's shader. Replaces earlier levels; every
+    // entity sharing the asset uses them. Call after the slot materials are
+    // set. Returns the number of reduced levels.
+    inline uint32_t GenerateLods(LPENTITY entity, const MeshLodDesc& desc = MeshLodDesc{})
+    {
+        if (!entity) { Debug::Log("gidx.h: ERROR: GenerateLods - entity is nullptr"); return 0; }
+        Mesh* mesh = (entity->IsMesh() ? entity->AsMesh() : nullptr);
+        if (!mesh || !mesh->HasMeshAsset()) { Debug::Log("gidx.h: ERROR: GenerateLods - Entity has no MeshAsset"); return 0; }
+
+        MeshAsset* asset = mesh->BorrowMeshAsset();
+        const uint32_t levels = engine->GetAM().BuildMeshLods(engine->GetScene(), asset, desc);
+
+        for (const MeshLod& lod : asset->GetLods())
+        {
+            for (unsigned int slot = 0; slot < static_cast<unsigned int>(lod.slots.size()); ++slot)
+            {
+                if (!lod.slots[slot]) continue;
+
+                Material* material = mesh->GetResolvedMaterial(slot, engine->GetAM().GetStandardMaterial());
+                Shader* shader = material ? material->pRenderShader : nullptr;
+                if (shader) FillBuffer(lod.slots[slot], shader);
+                else        FillBuffer(lod.slots[slot]);
+            }
+        }
+        return levels;
+    }
+
+    inline void ClearLods(LPENTITY entity)
+    {
+        if (!entity) { Debug::Log("gidx.h: ERROR: ClearLods - entity is nullptr"); return; }
+        Mesh* mesh = (entity->IsMesh() ? entity->AsMesh() : nullptr);
+        if (!mesh || !mesh->HasMeshAsset()) return;
+        engine->GetAM().ClearMeshLods(engine->GetScene(), mesh->BorrowMeshAsset());
+    }
+
+    // Level the entity was last drawn at by the main camera (0 = full detail).
+    inline uint32_t EntityLod(LPENTITY entity)
+    {
+        if (!entity) { Debug::Log("gidx.h: ERROR: EntityLod - entity is nullptr"); return 0; }
+        Mesh* mesh = (entity->IsMesh() ? entity->AsMesh() : nullptr);
+        return mesh ? mesh->GetLodLevel() : 0;
+    }
+
+    inline void LodSelection(bool enable)
+    {
+        engine->GetRM().SetLodSelection(enable);
+    }
+
+    // > 1 keeps detail longer, < 1 switches to coarser levels earlier.
+    inline void LodBias(float bias)
+    {
+        engine->GetRM().SetLodBias(bias);
+    }
+
+    inline void LodHysteresis(float hysteresis)
+    {
+        engine->GetRM().SetLodHysteresis(hysteresis);
+    }
+
     // ==================== PARENT / CHILD HIERARCHY ====================
 
     // Haengt child als Kind-Entity an parent.
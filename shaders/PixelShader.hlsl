@@ -199,7 +199,10 @@ float4 main(PS_INPUT input) : SV_Target
     if ((flags & MF_USE_NORMAL_MAP) != 0u)
     {
         float3x3 tbn = BuildCotangentFrame(N, input.worldPosition, uv0);
-        float3 nTS = gNormalMap.Sample(gSampler, uv0).xyz * 2.0f - 1.0f;
+        // z is rebuilt from xy, so two channel (BC5) normal maps work as well.
+        float3 nTS;
+        nTS.xy = gNormalMap.Sample(gSampler, uv0).xy * 2.0f - 1.0f;
+        nTS.z = sqrt(saturate(1.0f - dot(nTS.xy, nTS.xy)));
         nTS.xy *= normalScale;
         float3 T = tbn[0];
         float3 B = tbn[1];
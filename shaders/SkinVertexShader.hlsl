@@ -10,15 +10,22 @@
 //   outPos = inPos * boneMatrix * worldMatrix * viewMatrix * projMatrix
 //
 // Register:
-//   b0 = MatrixBuffer  (view, projection, world)
+//   b0 = MatrixBuffer  (world, world inverse transpose)
 //   b1 = LightBuffer   (position, direction, diffuse, ambient)
 //   b4 = BoneBuffer    (128 Bone-Matrizen)
+//   b5 = PassBuffer    (view, projection, camera position)
 
 cbuffer MatrixBuffer : register(b0)
+{
+    row_major matrix worldMatrix;
+    row_major matrix worldInverseTranspose;
+};
+
+cbuffer PassBuffer : register(b5)
 {
     row_major matrix viewMatrix;
     row_major matrix projectionMatrix;
-    row_major matrix worldMatrix;
+    float4 cameraPosition;
 };
 
 cbuffer LightBuffer : register(b1)
@@ -80,7 +87,7 @@ VSOutput main(VSInput input)
     output.position = mul(viewPos,   projectionMatrix);
 
     // ---- Beleuchtung (Lambertian) --------------------------------------
-    float3 worldNor = normalize(mul(skinNor, (float3x3)worldMatrix));
+    float3 worldNor = normalize(mul(skinNor, (float3x3)worldInverseTranspose));
     float3 lightDir = normalize(-lightDirection.xyz);
     float  nDotL    = saturate(dot(worldNor, lightDir));
 
@@ -3,13 +3,19 @@
 // Pflicht-Streams: POSITION, NORMAL, COLOR, TEXCOORD0
 // Optionale Daten wie Tangent / TEXCOORD1 werden nicht mehr vorausgesetzt.
 // Normal-Mapping nutzt im Pixel-Shader eine aus Ableitungen rekonstruierte TBN-Basis.
-// Registers: b0 (Matrices), b3 (Shadow Matrices)
+// Registers: b0 (World), b3 (Shadow Matrices), b5 (Pass: View/Projection)
 
 cbuffer ConstantBuffer : register(b0)
+{
+    row_major float4x4 _worldMatrix;
+    row_major float4x4 _worldInverseTranspose;
+};
+
+cbuffer PassBuffer : register(b5)
 {
     row_major float4x4 _viewMatrix;
     row_major float4x4 _projectionMatrix;
-    row_major float4x4 _worldMatrix;
+    float4             _cameraPosition;
 };
 
 cbuffer ShadowMatrixBuffer : register(b3)
@@ -47,20 +53,13 @@ VS_OUTPUT main(VS_INPUT input)
     o.position = mul(worldPos, _viewMatrix);
     o.position = mul(o.position, _projectionMatrix);
 
-    o.normal = normalize(mul(input.normal, (float3x3)_worldMatrix));
+    o.normal = normalize(mul(input.normal, (float3x3)_worldInverseTranspose));
     o.color = input.color;
     o.texCoord = input.texCoord;
 
     float4 lightViewPos = mul(worldPos, lightViewMatrix);
     o.positionLightSpace = mul(lightViewPos, lightProjectionMatrix);
 
-    float3 vt = float3(_viewMatrix[3][0], _viewMatrix[3][1], _viewMatrix[3][2]);
-    float3 cameraPosition = float3(
-        -dot(float3(_viewMatrix[0][0], _viewMatrix[0][1], _viewMatrix[0][2]), vt),
-        -dot(float3(_viewMatrix[1][0], _viewMatrix[1][1], _viewMatrix[1][2]), vt),
-        -dot(float3(_viewMatrix[2][0], _viewMatrix[2][1], _viewMatrix[2][2]), vt)
-    );
-
-    o.viewDirection = normalize(cameraPosition - worldPos.xyz);
+    o.viewDirection = normalize(_cameraPosition.xyz - worldPos.xyz);
     return o;
 }
@@ -0,0 +1,76 @@
+// VertexShaderInstanced.hlsl - giDX Engine
+// Instanced variant of VertexShader.hlsl (same output, same pixel shader).
+// Streams: POSITION, NORMAL, COLOR, TEXCOORD0 per vertex,
+//          INSTANCE_WORLD0..3 (row-major world matrix) per instance.
+// No entity block (b0): the world matrix comes from the instance stream.
+// Registers: b3 (Shadow Matrices), b5 (Pass: View/Projection)
+
+cbuffer PassBuffer : register(b5)
+{
+    row_major float4x4 _viewMatrix;
+    row_major float4x4 _projectionMatrix;
+    float4             _cameraPosition;
+};
+
+cbuffer ShadowMatrixBuffer : register(b3)
+{
+    row_major float4x4 lightViewMatrix;
+    row_major float4x4 lightProjectionMatrix;
+};
+
+struct VS_INPUT
+{
+    float3 position : POSITION;
+    float3 normal   : NORMAL;
+    float4 color    : COLOR;
+    float2 texCoord : TEXCOORD0;
+
+    float4 world0   : INSTANCE_WORLD0;
+    float4 world1   : INSTANCE_WORLD1;
+    float4 world2   : INSTANCE_WORLD2;
+    float4 world3   : INSTANCE_WORLD3;
+};
+
+struct VS_OUTPUT
+{
+    float4 position           : SV_POSITION;
+    float3 normal             : NORMAL;
+    float3 worldPosition      : TEXCOORD1;
+    float4 color              : COLOR;
+    float2 texCoord           : TEXCOORD0;
+    float4 positionLightSpace : TEXCOORD2;
+    float3 viewDirection      : TEXCOORD3;
+};
+
+VS_OUTPUT main(VS_INPUT input)
+{
+    VS_OUTPUT o;
+
+    // float4x4(a, b, c, d) takes rows, matching the row-major CPU layout.
+    float4x4 worldMatrix = float4x4(input.world0, input.world1, input.world2, input.world3);
+
+    float4 worldPos = mul(float4(input.position, 1.0f), worldMatrix);
+    o.worldPosition = worldPos.xyz;
+
+    o.position = mul(worldPos, _viewMatrix);
+    o.position = mul(o.position, _projectionMatrix);
+
+    // Instances carry no inverse transpose. The cofactor matrix of the
+    // upper 3x3 is the inverse transpose times det, so it is exact for
+    // non-uniform scale; the sign of det keeps mirrored meshes matching
+    // VertexShader.hlsl.
+    float3 r0 = input.world0.xyz;
+    float3 r1 = input.world1.xyz;
+    float3 r2 = input.world2.xyz;
+    float3x3 cofactor = float3x3(cross(r1, r2), cross(r2, r0), cross(r0, r1));
+    float detSign = dot(r0, cofactor[0]) < 0.0f ? -1.0f : 1.0f;
+    o.normal = normalize(mul(input.normal, cofactor) * detSign);
+    o.color = input.color;
+    o.texCoord = input.texCoord;
+
+    float4 lightViewPos = mul(worldPos, lightViewMatrix);
+    o.positionLightSpace = mul(lightViewPos, lightProjectionMatrix);
+
+    o.viewDirection = normalize(_cameraPosition.xyz - worldPos.xyz);
+    return o;
+}
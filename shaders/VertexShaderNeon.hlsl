@@ -1,8 +1,14 @@
 cbuffer MatrixBuffer : register(b0)
+{
+    row_major matrix worldMatrix;
+    row_major matrix worldInverseTranspose;
+};
+
+cbuffer PassBuffer : register(b5)
 {
     row_major matrix viewMatrix;
     row_major matrix projectionMatrix;
-    row_major matrix worldMatrix;
+    float4 cameraPosition;
 };
 
 struct VS_INPUT
@@ -1,9 +1,15 @@
 // VertexShader_PosUv.hlsl
 cbuffer MatrixBuffer : register(b0)
+{
+    row_major float4x4 worldMatrix;
+    row_major float4x4 worldInverseTranspose;
+};
+
+cbuffer PassBuffer : register(b5)
 {
     row_major float4x4 viewMatrix;
     row_major float4x4 projectionMatrix;
-    row_major float4x4 worldMatrix;
+    float4 cameraPosition;
 };
 
 struct VS_INPUT
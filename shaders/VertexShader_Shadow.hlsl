@@ -5,9 +5,8 @@
 
 cbuffer MatrixBuffer : register(b0)
 {
-    row_major float4x4 _viewMatrix;
-    row_major float4x4 _projectionMatrix;
     row_major float4x4 _worldMatrix;
+    row_major float4x4 _worldInverseTranspose;
 };
 
 cbuffer ShadowMatrixBuffer : register(b3)
@@ -6,6 +6,7 @@
 #include "Shader.h"
 #include "Mesh.h"
 #include "Scene.h"
+#include "GeometryHelper.h"
 
 AssetManager::~AssetManager()
 {
@@ -36,6 +37,7 @@ Surface* AssetManager::CreateSurface()
 {
     m_ownedSurfaces.push_back(std::make_unique<Surface>());
     Surface* surface = m_ownedSurfaces.back().get();
+    surface->id = ++m_nextSurfaceId;
     m_surfaces.push_back(surface);
     return surface;
 }
@@ -44,6 +46,7 @@ MeshAsset* AssetManager::CreateMeshAsset()
 {
     m_ownedMeshAssets.push_back(std::make_unique<MeshAsset>());
     MeshAsset* asset = m_ownedMeshAssets.back().get();
+    asset->BindRenderRevision(&m_revisions);
     m_meshAssets.push_back(asset);
     DBLOG("AssetManager.cpp: MeshAsset created");
     return asset;
@@ -54,6 +57,7 @@ Material* AssetManager::CreateMaterial()
     m_ownedMaterials.push_back(std::make_unique<Material>());
     Material* material = m_ownedMaterials.back().get();
     material->id = ++m_nextMaterialId;
+    material->BindRenderRevision(&m_revisions);
     m_materials.push_back(material);
     return material;
 }
@@ -96,6 +100,107 @@ void AssetManager::DeleteManagedMesh(Scene& scene, Mesh* mesh)
     scene.DeleteMesh(mesh);
 }
 
+StaticBatchStats AssetManager::BuildStaticBatches(Scene& scene, const StaticBatchDesc& desc)
+{
+    return m_staticBatcher.Build(scene, *this, desc);
+}
+
+void AssetManager::ClearStaticBatches(Scene& scene)
+{
+    m_staticBatcher.Clear(scene, *this);
+}
+
+uint32_t AssetManager::BuildMeshLods(Scene& scene, MeshAsset* asset, const MeshLodDesc& desc)
+{
+    if (!asset) return 0;
+
+    ClearMeshLods(scene, asset);
+
+    const std::vector<Surface*>& slots = asset->GetSlots();
+
+    // Triangles of the previous level per slot; a slot that no longer
+    // shrinks keeps nullptr and falls back to its finer surface.
+    std::vector<uint32_t> previous(slots.size(), 0);
+    uint32_t previousTotal = 0;
+    for (size_t i = 0; i < slots.size(); ++i)
+    {
+        if (slots[i]) previous[i] = slots[i]->CountIndices() / 3;
+        previousTotal += previous[i];
+    }
+    if (previousTotal == 0) return 0;
+
+    float threshold = desc.screenSize;
+    float ratio     = 1.0f;
+    uint32_t built  = 0;
+
+    for (uint32_t level = 1; level <= desc.levels; ++level)
+    {
+        ratio *= desc.reduction;
+
+        // Each level is simplified from LOD 0; the error budget grows as
+        // the level is drawn smaller.
+        SimplifyDesc simplify;
+        simplify.targetRatio = ratio;
+        simplify.maxError    = desc.maxError * (desc.screenSize / threshold);
+
+        std::vector<Surface*> lodSlots(slots.size(), nullptr);
+        std::vector<uint32_t> counts(previous);
+        uint32_t total = 0;
+
+        for (size_t i = 0; i < slots.size(); ++i)
+        {
+            if (previous[i] > 0)
+            {
+                Surface* lod = CreateSurface();
+                const SimplifyResult result = MeshSimplifier::Simplify(*slots[i], *lod, simplify);
+
+                if (result.triangles > 0 && result.triangles < previous[i])
+                {
+                    GeometryHelper::Optimize(*lod);
+                    lodSlots[i] = lod;
+                    counts[i]   = result.triangles;
+                }
+                else
+                {
+                    DeleteSurface(scene, lod);
+                }
+            }
+            total += counts[i];
+        }
+
+        if (total > desc.minStep * previousTotal)
+        {
+            for (Surface* lod : lodSlots)
+                if (lod) DeleteSurface(scene, lod);
+            break;
+        }
+
+        asset->AddLod(lodSlots, threshold);
+        DBLOG("AssetManager.cpp: BuildMeshLods - level ", level, " triangles=", total,
+              " screenSize=", threshold);
+
+        previous      = counts;
+        previousTotal = total;
+        threshold    *= desc.screenSizeStep;
+        ++built;
+    }
+
+    return built;
+}
+
+void AssetManager::ClearMeshLods(Scene& scene, MeshAsset* asset)
+{
+    if (!asset || asset->NumLods() <= 1) return;
+
+    // Copy first: DeleteSurface clears the pointers inside the asset.
+    const std::vector<MeshLod> lods = asset->GetLods();
+    asset->ClearLods();
+
+    for (const MeshLod& lod : lods)
+        for (Surface* surface : lod.slots)
+            if (surface) DeleteSurface(scene, surface);
+}
+
 bool AssetManager::DetachMeshAsset(Scene& scene, Mesh* mesh, bool deleteOldIfUnused)
 {
     if (!mesh) return false;
@@ -190,6 +295,8 @@ void AssetManager::DeleteMeshAsset(Scene& scene, MeshAsset* asset)
         return;
     }
 
+    ClearMeshLods(scene, asset);
+
     m_meshAssets.erase(std::remove(m_meshAssets.begin(), m_meshAssets.end(), asset), m_meshAssets.end());
     if (RemoveOwned(m_ownedMeshAssets, asset))
         DBLOG("AssetManager.cpp: DeleteMeshAsset - asset deleted");
@@ -211,6 +318,7 @@ void AssetManager::DeleteMaterial(Scene& scene, Material* material)
 
     if (m_defaultMaterial == material)
         m_defaultMaterial = nullptr;
+    m_revisions.TouchAssets();
 
     m_materials.erase(std::remove(m_materials.begin(), m_materials.end(), material), m_materials.end());
     RemoveOwned(m_ownedMaterials, material);
@@ -225,6 +333,7 @@ void AssetManager::DeleteShader(Shader* shader)
         if (mat && mat->pRenderShader == shader)
             mat->pRenderShader = nullptr;
     }
+    m_revisions.TouchAssets();
     shader->materials.clear();
 
     m_shaders.erase(std::remove(m_shaders.begin(), m_shaders.end(), shader), m_shaders.end());
@@ -326,6 +435,8 @@ void AssetManager::AssignShaderToMaterial(Shader* shader, Material* material)
         v.erase(std::remove(v.begin(), v.end(), material), v.end());
     }
 
+    if (material->pRenderShader != shader)
+        m_revisions.TouchAssets();
     material->pRenderShader = shader;
 
     if (shader)
@@ -0,0 +1,1166 @@
+#include "BlockCompressor.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // 4x4 texels, row major, RGBA.
+    using Block = uint8_t[16][4];
+
+    // Texels past the right or bottom edge repeat the last column / row.
+    void FetchBlock(const uint8_t* level, uint32_t width, uint32_t height,
+                    uint32_t bx, uint32_t by, Block& out) noexcept
+    {
+        for (uint32_t y = 0; y < 4; ++y)
+        {
+            const uint32_t sy = std::min(by * 4 + y, height - 1);
+            for (uint32_t x = 0; x < 4; ++x)
+            {
+                const uint32_t sx = std::min(bx * 4 + x, width - 1);
+                std::memcpy(out[y * 4 + x], level + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+            }
+        }
+    }
+
+    void StoreBlock(const Block& block, uint8_t* level, uint32_t width, uint32_t height,
+                    uint32_t bx, uint32_t by) noexcept
+    {
+        for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y)
+            for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x)
+                std::memcpy(level + (static_cast<size_t>(by * 4 + y) * width + bx * 4 + x) * 4, block[y * 4 + x], 4);
+    }
+
+    // Principal axis of n points with `dims` channels (power iteration on
+    // the covariance matrix). Returns false when all points are equal.
+    bool PrincipalAxis(const float (*points)[4], int n, int dims, float mean[4], float axis[4]) noexcept
+    {
+        for (int c = 0; c < 4; ++c) { mean[c] = 0.0f; axis[c] = 0.0f; }
+        for (int i = 0; i < n; ++i)
+            for (int c = 0; c < dims; ++c)
+                mean[c] += points[i][c];
+        for (int c = 0; c < dims; ++c)
+            mean[c] /= static_cast<float>(n);
+
+        float cov[4][4] = {};
+        for (int i = 0; i < n; ++i)
+        {
+            float d[4] = {};
+            for (int c = 0; c < dims; ++c) d[c] = points[i][c] - mean[c];
+            for (int r = 0; r < dims; ++r)
+                for (int c = 0; c < dims; ++c)
+                    cov[r][c] += d[r] * d[c];
+        }
+
+        // Start from the channel with the largest spread.
+        int start = 0;
+        for (int c = 1; c < dims; ++c)
+            if (cov[c][c] > cov[start][start]) start = c;
+        if (cov[start][start] <= 1e-6f)
+            return false;
+
+        float v[4] = {};
+        for (int c = 0; c < dims; ++c) v[c] = cov[start][c];
+        for (int iter = 0; iter < 8; ++iter)
+        {
+            float w[4] = {};
+            for (int r = 0; r < dims; ++r)
+                for (int c = 0; c < dims; ++c)
+                    w[r] += cov[r][c] * v[c];
+            float len = 0.0f;
+            for (int c = 0; c < dims; ++c) len += w[c] * w[c];
+            len = std::sqrt(len);
+            if (len <= 1e-12f) break;
+            for (int c = 0; c < dims; ++c) v[c] = w[c] / len;
+        }
+
+        float len = 0.0f;
+        for (int c = 0; c < dims; ++c) len += v[c] * v[c];
+        if (len <= 1e-12f)
+            return false;
+        len = std::sqrt(len);
+        for (int c = 0; c < dims; ++c) axis[c] = v[c] / len;
+        return true;
+    }
+
+    // Endpoints a, b minimizing sum |(1 - t_i) a + t_i b - p_i|^2 for fixed
+    // interpolation weights t_i. Returns false when all t_i are equal.
+    bool LeastSquaresEndpoints(const float (*points)[4], const float* t, int n, int dims,
+                               float a[4], float b[4]) noexcept
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[4] = {}, bx[4] = {};
+        for (int i = 0; i < n; ++i)
+        {
+            const float s = 1.0f - t[i];
+            aa += s * s; ab += s * t[i]; bb += t[i] * t[i];
+            for (int c = 0; c < dims; ++c)
+            {
+                ax[c] += s * points[i][c];
+                bx[c] += t[i] * points[i][c];
+            }
+        }
+
+        const float det = aa * bb - ab * ab;
+        if (std::fabs(det) < 1e-6f)
+            return false;
+
+        const float inv = 1.0f / det;
+        for (int c = 0; c < dims; ++c)
+        {
+            a[c] = (ax[c] * bb - bx[c] * ab) * inv;
+            b[c] = (bx[c] * aa - ax[c] * ab) * inv;
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------- BC1
+
+    uint16_t Quantize565(const float c[4]) noexcept
+    {
+        const int r = static_cast<int>(std::clamp(c[0], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+        const int g = static_cast<int>(std::clamp(c[1], 0.0f, 255.0f) * 63.0f / 255.0f + 0.5f);
+        const int b = static_cast<int>(std::clamp(c[2], 0.0f, 255.0f) * 31.0f / 255.0f + 0.5f);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void Expand565(uint16_t v, int out[3]) noexcept
+    {
+        const int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+        out[0] = (r << 3) | (r >> 2);
+        out[1] = (g << 2) | (g >> 4);
+        out[2] = (b << 3) | (b >> 2);
+    }
+
+    // Palette of a BC1 color block. fourColor forces the 4 color mode
+    // (BC3 color blocks are always decoded that way).
+    void Bc1Palette(uint16_t c0, uint16_t c1, bool fourColor, int palette[4][4]) noexcept
+    {
+        Expand565(c0, palette[0]);
+        Expand565(c1, palette[1]);
+        palette[0][3] = palette[1][3] = 255;
+        if (fourColor || c0 > c1)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+            }
+            palette[2][3] = palette[3][3] = 255;
+        }
+        else
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+                palette[3][c] = 0;
+            }
+            palette[2][3] = 255;
+            palette[3][3] = 0;
+        }
+    }
+
+    // Picks indices for endpoints c0 >= c1 (4 color mode, or one color when
+    // equal) and returns the squared error.
+    uint32_t Bc1Indices(const float (*points)[4], uint16_t c0, uint16_t c1, uint8_t indices[16]) noexcept
+    {
+        int palette[4][4];
+        Bc1Palette(c0, c1, true, palette);
+        const int count = c0 == c1 ? 1 : 4;
+
+        uint32_t total = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            uint32_t best = UINT32_MAX;
+            for (int k = 0; k < count; ++k)
+            {
+                uint32_t err = 0;
+                for (int c = 0; c < 3; ++c)
+                {
+                    const int d = palette[k][c] - static_cast<int>(points[i][c]);
+                    err += static_cast<uint32_t>(d * d);
+                }
+                if (err < best) { best = err; indices[i] = static_cast<uint8_t>(k); }
+            }
+            total += best;
+        }
+        return total;
+    }
+
+    uint32_t Bc1Try(const float (*points)[4], const float a[4], const float b[4],
+                    uint16_t& c0, uint16_t& c1, uint8_t indices[16]) noexcept
+    {
+        c0 = Quantize565(a);
+        c1 = Quantize565(b);
+        if (c0 < c1) std::swap(c0, c1);
+        return Bc1Indices(points, c0, c1, indices);
+    }
+
+    void EncodeBc1(const Block& block, uint8_t* dst) noexcept
+    {
+        float points[16][4];
+        for (int i = 0; i < 16; ++i)
+            for (int c = 0; c < 4; ++c)
+                points[i][c] = block[i][c];
+
+        float mean[4], axis[4], a[4], b[4];
+        if (PrincipalAxis(points, 16, 3, mean, axis))
+        {
+            float tMin = FLT_MAX, tMax = -FLT_MAX;
+            for (int i = 0; i < 16; ++i)
+            {
+                float t = 0.0f;
+                for (int c = 0; c < 3; ++c) t += (points[i][c] - mean[c]) * axis[c];
+                tMin = std::min(tMin, t);
+                tMax = std::max(tMax, t);
+            }
+            for (int c = 0; c < 3; ++c)
+            {
+                a[c] = mean[c] + axis[c] * tMax;
+                b[c] = mean[c] + axis[c] * tMin;
+            }
+        }
+        else
+        {
+            for (int c = 0; c < 3; ++c) a[c] = b[c] = mean[c];
+        }
+
+        uint16_t c0, c1;
+        uint8_t  indices[16];
+        uint32_t err = Bc1Try(points, a, b, c0, c1, indices);
+
+        // Refit the endpoints to the chosen indices while that helps.
+        static const float T[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        for (int iter = 0; iter < 2 && err > 0 && c0 != c1; ++iter)
+        {
+            float t[16];
+            for (int i = 0; i < 16; ++i) t[i] = T[indices[i]];
+            if (!LeastSquaresEndpoints(points, t, 16, 3, a, b))
+                break;
+
+            uint16_t n0, n1;
+            uint8_t  nIndices[16];
+            const uint32_t nErr = Bc1Try(points, a, b, n0, n1, nIndices);
+            if (nErr >= err)
+                break;
+            err = nErr; c0 = n0; c1 = n1;
+            std::memcpy(indices, nIndices, 16);
+        }
+
+        uint32_t bits = 0;
+        for (int i = 0; i < 16; ++i)
+            bits |= static_cast<uint32_t>(indices[i]) << (i * 2);
+
+        dst[0] = static_cast<uint8_t>(c0); dst[1] = static_cast<uint8_t>(c0 >> 8);
+        dst[2] = static_cast<uint8_t>(c1); dst[3] = static_cast<uint8_t>(c1 >> 8);
+        for (int k = 0; k < 4; ++k)
+            dst[4 + k] = static_cast<uint8_t>(bits >> (k * 8));
+    }
+
+    void DecodeBc1(const uint8_t* src, bool fourColor, Block& out) noexcept
+    {
+        const uint16_t c0 = static_cast<uint16_t>(src[0] | (src[1] << 8));
+        const uint16_t c1 = static_cast<uint16_t>(src[2] | (src[3] << 8));
+        const uint32_t bits = static_cast<uint32_t>(src[4]) | (static_cast<uint32_t>(src[5]) << 8) |
+                              (static_cast<uint32_t>(src[6]) << 16) | (static_cast<uint32_t>(src[7]) << 24);
+
+        int palette[4][4];
+        Bc1Palette(c0, c1, fourColor, palette);
+        for (int i = 0; i < 16; ++i)
+        {
+            const int* p = palette[(bits >> (i * 2)) & 3];
+            for (int c = 0; c < 4; ++c)
+                out[i][c] = static_cast<uint8_t>(p[c]);
+        }
+    }
+
+    // ---------------------------------------------------------------- BC4
+
+    void Bc4Palette(int r0, int r1, int palette[8]) noexcept
+    {
+        palette[0] = r0;
+        palette[1] = r1;
+        if (r0 > r1)
+        {
+            for (int k = 1; k < 7; ++k)
+                palette[k + 1] = ((7 - k) * r0 + k * r1 + 3) / 7;
+        }
+        else
+        {
+            for (int k = 1; k < 5; ++k)
+                palette[k + 1] = ((5 - k) * r0 + k * r1 + 2) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    uint32_t Bc4Indices(const uint8_t values[16], int r0, int r1, uint8_t indices[16]) noexcept
+    {
+        int palette[8];
+        Bc4Palette(r0, r1, palette);
+
+        uint32_t total = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            uint32_t best = UINT32_MAX;
+            for (int k = 0; k < 8; ++k)
+            {
+                const int d = palette[k] - values[i];
+                const uint32_t err = static_cast<uint32_t>(d * d);
+                if (err < best) { best = err; indices[i] = static_cast<uint8_t>(k); }
+            }
+            total += best;
+        }
+        return total;
+    }
+
+    void EncodeBc4(const uint8_t values[16], uint8_t* dst) noexcept
+    {
+        int lo = 255, hi = 0, innerLo = 255, innerHi = 0;
+        for (int i = 0; i < 16; ++i)
+        {
+            lo = std::min<int>(lo, values[i]);
+            hi = std::max<int>(hi, values[i]);
+            if (values[i] != 0 && values[i] != 255)
+            {
+                innerLo = std::min<int>(innerLo, values[i]);
+                innerHi = std::max<int>(innerHi, values[i]);
+            }
+        }
+
+        // 8 value mode spans min..max; 6 value mode spans the texels that
+        // are not exactly 0 or 255, which it stores separately.
+        int r0 = hi, r1 = lo;
+        uint8_t indices[16];
+        uint32_t err = Bc4Indices(values, r0, r1, indices);
+
+        // Refit the 8 value endpoints to the chosen indices while that helps.
+        for (int iter = 0; iter < 3 && err > 0 && r0 > r1; ++iter)
+        {
+            float points[16][4] = {}, t[16], a[4], b[4];
+            for (int i = 0; i < 16; ++i)
+            {
+                points[i][0] = values[i];
+                t[i] = indices[i] == 0 ? 0.0f : indices[i] == 1 ? 1.0f : (indices[i] - 1) / 7.0f;
+            }
+            if (!LeastSquaresEndpoints(points, t, 16, 1, a, b))
+                break;
+
+            const int n0 = std::clamp(static_cast<int>(a[0] + 0.5f), 0, 255);
+            const int n1 = std::clamp(static_cast<int>(b[0] + 0.5f), 0, 255);
+            if (n0 <= n1)
+                break;
+
+            uint8_t nIndices[16];
+            const uint32_t nErr = Bc4Indices(values, n0, n1, nIndices);
+            if (nErr >= err)
+                break;
+            err = nErr; r0 = n0; r1 = n1;
+            std::memcpy(indices, nIndices, 16);
+        }
+
+        if (err > 0 && (lo == 0 || hi == 255))
+        {
+            const int s0 = innerLo <= innerHi ? innerLo : 0;
+            const int s1 = innerLo <= innerHi ? innerHi : 255;
+            uint8_t sIndices[16];
+            const uint32_t sErr = Bc4Indices(values, s0, s1, sIndices);
+            if (sErr < err)
+            {
+                err = sErr; r0 = s0; r1 = s1;
+                std::memcpy(indices, sIndices, 16);
+            }
+        }
+
+        uint64_t bits = 0;
+        for (int i = 0; i < 16; ++i)
+            bits |= static_cast<uint64_t>(indices[i]) << (i * 3);
+
+        dst[0] = static_cast<uint8_t>(r0);
+        dst[1] = static_cast<uint8_t>(r1);
+        for (int k = 0; k < 6; ++k)
+            dst[2 + k] = static_cast<uint8_t>(bits >> (k * 8));
+    }
+
+    void DecodeBc4(const uint8_t* src, Block& out, int channel) noexcept
+    {
+        int palette[8];
+        Bc4Palette(src[0], src[1], palette);
+
+        uint64_t bits = 0;
+        for (int k = 0; k < 6; ++k)
+            bits |= static_cast<uint64_t>(src[2 + k]) << (k * 8);
+
+        for (int i = 0; i < 16; ++i)
+            out[i][channel] = static_cast<uint8_t>(palette[(bits >> (i * 3)) & 7]);
+    }
+
+    // ---------------------------------------------------------------- BC7
+
+    constexpr uint8_t BC7_WEIGHTS2[4]  = { 0, 21, 43, 64 };
+    constexpr uint8_t BC7_WEIGHTS3[8]  = { 0, 9, 18, 27, 37, 46, 55, 64 };
+    constexpr uint8_t BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // Two subset partitions: bit i set = texel i belongs to subset 1.
+    constexpr uint16_t BC7_PARTITIONS2[64] =
+    {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+        0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+        0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+        0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+        0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+    };
+
+    // Anchor texel of subset 1 (subset 0 is anchored at texel 0).
+    constexpr uint8_t BC7_ANCHORS2[64] =
+    {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+        15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+         6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+    };
+
+    // Mode 1 candidates fully encoded per block, best partitions first.
+    constexpr int BC7_PARTITION_TRIES = 4;
+
+    // Mode 6 error (sum of squares over the block) below which the other
+    // modes are not tried: 1 step per channel on every texel.
+    constexpr uint32_t BC7_GOOD_ENOUGH = 16 * 4;
+
+    struct BitWriter
+    {
+        uint8_t* data;
+        uint32_t pos = 0;
+
+        void Write(uint32_t value, uint32_t count) noexcept
+        {
+            for (uint32_t i = 0; i < count; ++i, ++pos)
+                if ((value >> i) & 1u)
+                    data[pos >> 3] |= static_cast<uint8_t>(1u << (pos & 7));
+        }
+    };
+
+    struct BitReader
+    {
+        const uint8_t* data;
+        uint32_t       pos = 0;
+
+        uint32_t Read(uint32_t count) noexcept
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < count; ++i, ++pos)
+                value |= static_cast<uint32_t>((data[pos >> 3] >> (pos & 7)) & 1u) << i;
+            return value;
+        }
+    };
+
+    enum Bc7PBits { BC7_PBIT_NONE, BC7_PBIT_SHARED, BC7_PBIT_UNIQUE };
+
+    struct Bc7ModeInfo
+    {
+        int            channels;   // fitted channels, starting at the first
+        int            bits;       // endpoint bits per channel, without p-bit
+        Bc7PBits       pBits;
+        int            indexBits;
+        const uint8_t* weights;
+    };
+
+    constexpr Bc7ModeInfo BC7_MODE1       = { 3, 6, BC7_PBIT_SHARED, 3, BC7_WEIGHTS3 };
+    constexpr Bc7ModeInfo BC7_MODE5_COLOR = { 3, 7, BC7_PBIT_NONE,   2, BC7_WEIGHTS2 };
+    constexpr Bc7ModeInfo BC7_MODE5_ALPHA = { 1, 8, BC7_PBIT_NONE,   2, BC7_WEIGHTS2 };
+    constexpr Bc7ModeInfo BC7_MODE6       = { 4, 7, BC7_PBIT_UNIQUE, 4, BC7_WEIGHTS4 };
+
+    // Endpoint of `bits` bits per channel, plus a low p-bit when the mode
+    // has one.
+    struct Bc7Endpoint
+    {
+        uint8_t q[4] = {};
+        uint8_t p    = 0;
+    };
+
+    // To 8 bits by replicating the top bits.
+    int Bc7Expand(int q, int p, int bits, bool hasP) noexcept
+    {
+        const int n = hasP ? bits + 1 : bits;
+        const int v = hasP ? (q << 1) | p : q;
+        return n >= 8 ? v : (v << (8 - n)) | (v >> (2 * n - 8));
+    }
+
+    int Bc7Expand(const Bc7Endpoint& e, int c, const Bc7ModeInfo& mode) noexcept
+    {
+        return Bc7Expand(e.q[c], e.p, mode.bits, mode.pBits != BC7_PBIT_NONE);
+    }
+
+    // Best endpoint for a fixed p-bit; returns the squared error.
+    float Bc7QuantizeFixedP(const float e[4], const Bc7ModeInfo& mode, uint8_t p, Bc7Endpoint& out) noexcept
+    {
+        const bool hasP = mode.pBits != BC7_PBIT_NONE;
+        const int  maxQ = (1 << mode.bits) - 1;
+        const int  n    = hasP ? mode.bits + 1 : mode.bits;
+        out.p = p;
+        float total = 0.0f;
+        for (int c = 0; c < mode.channels; ++c)
+        {
+            const float v = std::clamp(e[c], 0.0f, 255.0f);
+            const float scaled = v * static_cast<float>((1 << n) - 1) / 255.0f;
+            const int guess = hasP ? static_cast<int>((scaled - p) * 0.5f + 0.5f) : static_cast<int>(scaled + 0.5f);
+            float best = FLT_MAX;
+            for (int q = std::max(guess - 1, 0); q <= std::min(guess + 1, maxQ); ++q)
+            {
+                const float d = static_cast<float>(Bc7Expand(q, p, mode.bits, hasP)) - v;
+                if (d * d < best) { best = d * d; out.q[c] = static_cast<uint8_t>(q); }
+            }
+            total += best;
+        }
+        return total;
+    }
+
+    void Bc7QuantizePair(const float a[4], const float b[4], const Bc7ModeInfo& mode,
+                         Bc7Endpoint& e0, Bc7Endpoint& e1) noexcept
+    {
+        const uint8_t maxP = mode.pBits == BC7_PBIT_NONE ? 0 : 1;
+        float best = FLT_MAX;
+        for (uint8_t p0 = 0; p0 <= maxP; ++p0)
+        {
+            for (uint8_t p1 = 0; p1 <= maxP; ++p1)
+            {
+                if (mode.pBits == BC7_PBIT_SHARED && p0 != p1)
+                    continue;
+                Bc7Endpoint t0, t1;
+                const float err = Bc7QuantizeFixedP(a, mode, p0, t0) + Bc7QuantizeFixedP(b, mode, p1, t1);
+                if (err < best) { best = err; e0 = t0; e1 = t1; }
+            }
+        }
+    }
+
+    // Fits one subset (the texels listed in `texels`) over the first
+    // mode.channels channels and returns its squared error; indices are
+    // written for those texels only.
+    uint32_t Bc7FitSubset(const float (*points)[4], const int* texels, int count, const Bc7ModeInfo& mode,
+                          Bc7Endpoint& e0, Bc7Endpoint& e1, uint8_t indices[16]) noexcept
+    {
+        const int levels = 1 << mode.indexBits;
+
+        float sub[16][4];
+        for (int i = 0; i < count; ++i)
+            std::memcpy(sub[i], points[texels[i]], sizeof(sub[i]));
+
+        auto evaluate = [&](const Bc7Endpoint& a, const Bc7Endpoint& b, uint8_t* out) {
+            int palette[16][4];
+            for (int c = 0; c < mode.channels; ++c)
+            {
+                const int va = Bc7Expand(a, c, mode);
+                const int vb = Bc7Expand(b, c, mode);
+                for (int k = 0; k < levels; ++k)
+                    palette[k][c] = ((64 - mode.weights[k]) * va + mode.weights[k] * vb + 32) >> 6;
+            }
+
+            uint32_t total = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                uint32_t best = UINT32_MAX;
+                for (int k = 0; k < levels; ++k)
+                {
+                    uint32_t err = 0;
+                    for (int c = 0; c < mode.channels; ++c)
+                    {
+                        const int d = palette[k][c] - static_cast<int>(sub[i][c]);
+                        err += static_cast<uint32_t>(d * d);
+                    }
+                    if (err < best) { best = err; out[i] = static_cast<uint8_t>(k); }
+                }
+                total += best;
+            }
+            return total;
+        };
+
+        float mean[4], axis[4], a[4], b[4];
+        if (PrincipalAxis(sub, count, mode.channels, mean, axis))
+        {
+            float tMin = FLT_MAX, tMax = -FLT_MAX;
+            for (int i = 0; i < count; ++i)
+            {
+                float t = 0.0f;
+                for (int c = 0; c < mode.channels; ++c) t += (sub[i][c] - mean[c]) * axis[c];
+                tMin = std::min(tMin, t);
+                tMax = std::max(tMax, t);
+            }
+            for (int c = 0; c < mode.channels; ++c)
+            {
+                a[c] = mean[c] + axis[c] * tMin;
+                b[c] = mean[c] + axis[c] * tMax;
+            }
+        }
+        else
+        {
+            for (int c = 0; c < mode.channels; ++c) a[c] = b[c] = mean[c];
+        }
+
+        uint8_t subIndices[16];
+        Bc7QuantizePair(a, b, mode, e0, e1);
+        uint32_t err = evaluate(e0, e1, subIndices);
+
+        // Refit the endpoints to the chosen indices while that helps.
+        for (int iter = 0; iter < 2 && err > 0; ++iter)
+        {
+            float t[16];
+            for (int i = 0; i < count; ++i) t[i] = mode.weights[subIndices[i]] / 64.0f;
+            if (!LeastSquaresEndpoints(sub, t, count, mode.channels, a, b))
+                break;
+
+            Bc7Endpoint n0, n1;
+            uint8_t nIndices[16];
+            Bc7QuantizePair(a, b, mode, n0, n1);
+            const uint32_t nErr = evaluate(n0, n1, nIndices);
+            if (nErr >= err)
+                break;
+            err = nErr; e0 = n0; e1 = n1;
+            std::memcpy(subIndices, nIndices, sizeof(nIndices));
+        }
+
+        for (int i = 0; i < count; ++i)
+            indices[texels[i]] = subIndices[i];
+        return err;
+    }
+
+    // Count, sums and sums of products (xx, xy, xz, yy, yz, zz) of RGB.
+    struct RgbMoments
+    {
+        float n = 0.0f;
+        float s[3]  = {};
+        float ss[6] = {};
+
+        void Add(const float p[4]) noexcept
+        {
+            n += 1.0f;
+            s[0] += p[0]; s[1] += p[1]; s[2] += p[2];
+            ss[0] += p[0] * p[0]; ss[1] += p[0] * p[1]; ss[2] += p[0] * p[2];
+            ss[3] += p[1] * p[1]; ss[4] += p[1] * p[2]; ss[5] += p[2] * p[2];
+        }
+
+        RgbMoments operator-(const RgbMoments& o) const noexcept
+        {
+            RgbMoments r;
+            r.n = n - o.n;
+            for (int i = 0; i < 3; ++i) r.s[i] = s[i] - o.s[i];
+            for (int i = 0; i < 6; ++i) r.ss[i] = ss[i] - o.ss[i];
+            return r;
+        }
+    };
+
+    // Squared distance of the points to their best fitting line: trace of
+    // the scatter matrix minus its largest eigenvalue. Partition score.
+    float LineFitError(const RgbMoments& m) noexcept
+    {
+        if (m.n < 2.0f)
+            return 0.0f;
+
+        const float inv = 1.0f / m.n;
+        const float a = m.ss[0] - m.s[0] * m.s[0] * inv, b = m.ss[1] - m.s[0] * m.s[1] * inv;
+        const float c = m.ss[2] - m.s[0] * m.s[2] * inv, d = m.ss[3] - m.s[1] * m.s[1] * inv;
+        const float e = m.ss[4] - m.s[1] * m.s[2] * inv, f = m.ss[5] - m.s[2] * m.s[2] * inv;
+        const float trace = a + d + f;
+        if (trace <= 1e-6f)
+            return 0.0f;
+
+        float v[3] = { a, b, c };
+        if (d > a && d >= f)      { v[0] = b; v[1] = d; v[2] = e; }
+        else if (f > a && f > d)  { v[0] = c; v[1] = e; v[2] = f; }
+
+        float lambda = 0.0f;
+        for (int iter = 0; iter < 4; ++iter)
+        {
+            const float w0 = a * v[0] + b * v[1] + c * v[2];
+            const float w1 = b * v[0] + d * v[1] + e * v[2];
+            const float w2 = c * v[0] + e * v[1] + f * v[2];
+            const float len = std::sqrt(w0 * w0 + w1 * w1 + w2 * w2);
+            if (len <= 1e-12f)
+                return trace;
+            const float vLen = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+            lambda = vLen > 1e-12f ? len / vLen : 0.0f;
+            v[0] = w0 / len; v[1] = w1 / len; v[2] = w2 / len;
+        }
+        return std::max(trace - lambda, 0.0f);
+    }
+
+    // Mode 6: one subset, RGBA 7 bits + p-bit per endpoint, 4 bit indices.
+    uint32_t EncodeBc7Mode6(const float (*points)[4], uint8_t* dst) noexcept
+    {
+        static const int ALL[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+        Bc7Endpoint e0, e1;
+        uint8_t indices[16];
+        const uint32_t err = Bc7FitSubset(points, ALL, 16, BC7_MODE6, e0, e1, indices);
+
+        // The anchor index is stored without its top bit, which must be 0.
+        if (indices[0] & 8)
+        {
+            std::swap(e0, e1);
+            for (int i = 0; i < 16; ++i) indices[i] = static_cast<uint8_t>(15 - indices[i]);
+        }
+
+        std::memset(dst, 0, 16);
+        BitWriter out{ dst };
+        out.Write(1u << 6, 7);
+        for (int c = 0; c < 4; ++c)
+        {
+            out.Write(e0.q[c], 7);
+            out.Write(e1.q[c], 7);
+        }
+        out.Write(e0.p, 1);
+        out.Write(e1.p, 1);
+        for (int i = 0; i < 16; ++i)
+            out.Write(indices[i], i == 0 ? 3 : 4);
+        return err;
+    }
+
+    // Mode 1: two subsets, RGB 6 bits + shared p-bit per subset, 3 bit
+    // indices, alpha 255.
+    uint32_t EncodeBc7Mode1(const float (*points)[4], int partition, uint8_t* dst) noexcept
+    {
+        int texels[2][16], counts[2] = { 0, 0 };
+        for (int i = 0; i < 16; ++i)
+        {
+            const int subset = (BC7_PARTITIONS2[partition] >> i) & 1;
+            texels[subset][counts[subset]++] = i;
+        }
+
+        Bc7Endpoint e[2][2];
+        uint8_t indices[16];
+        uint32_t err = 0;
+        for (int s = 0; s < 2; ++s)
+            err += Bc7FitSubset(points, texels[s], counts[s], BC7_MODE1, e[s][0], e[s][1], indices);
+
+        const int anchors[2] = { 0, BC7_ANCHORS2[partition] };
+        for (int s = 0; s < 2; ++s)
+        {
+            if (indices[anchors[s]] & 4)
+            {
+                std::swap(e[s][0], e[s][1]);
+                for (int i = 0; i < counts[s]; ++i)
+                    indices[texels[s][i]] = static_cast<uint8_t>(7 - indices[texels[s][i]]);
+            }
+        }
+
+        std::memset(dst, 0, 16);
+        BitWriter out{ dst };
+        out.Write(1u << 1, 2);
+        out.Write(static_cast<uint32_t>(partition), 6);
+        for (int c = 0; c < 3; ++c)
+            for (int s = 0; s < 2; ++s)
+            {
+                out.Write(e[s][0].q[c], 6);
+                out.Write(e[s][1].q[c], 6);
+            }
+        out.Write(e[0][0].p, 1);
+        out.Write(e[1][0].p, 1);
+        for (int i = 0; i < 16; ++i)
+            out.Write(indices[i], (i == anchors[0] || i == anchors[1]) ? 2 : 3);
+        return err;
+    }
+
+    // Mode 5: one subset, RGB 7 bits and alpha 8 bits with separate 2 bit
+    // index sets (no channel rotation).
+    uint32_t EncodeBc7Mode5(const float (*points)[4], uint8_t* dst) noexcept
+    {
+        static const int ALL[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+
+        float alpha[16][4] = {};
+        for (int i = 0; i < 16; ++i) alpha[i][0] = points[i][3];
+
+        Bc7Endpoint c0, c1, a0, a1;
+        uint8_t colorIndices[16], alphaIndices[16];
+        const uint32_t err = Bc7FitSubset(points, ALL, 16, BC7_MODE5_COLOR, c0, c1, colorIndices) +
+                             Bc7FitSubset(alpha, ALL, 16, BC7_MODE5_ALPHA, a0, a1, alphaIndices);
+
+        if (colorIndices[0] & 2)
+        {
+            std::swap(c0, c1);
+            for (int i = 0; i < 16; ++i) colorIndices[i] = static_cast<uint8_t>(3 - colorIndices[i]);
+        }
+        if (alphaIndices[0] & 2)
+        {
+            std::swap(a0, a1);
+            for (int i = 0; i < 16; ++i) alphaIndices[i] = static_cast<uint8_t>(3 - alphaIndices[i]);
+        }
+
+        std::memset(dst, 0, 16);
+        BitWriter out{ dst };
+        out.Write(1u << 5, 6);
+        out.Write(0, 2);  // rotation
+        for (int c = 0; c < 3; ++c)
+        {
+            out.Write(c0.q[c], 7);
+            out.Write(c1.q[c], 7);
+        }
+        out.Write(a0.q[0], 8);
+        out.Write(a1.q[0], 8);
+        for (int i = 0; i < 16; ++i)
+            out.Write(colorIndices[i], i == 0 ? 1 : 2);
+        for (int i = 0; i < 16; ++i)
+            out.Write(alphaIndices[i], i == 0 ? 1 : 2);
+        return err;
+    }
+
+    // Mode 6 for every block. Blocks with alpha also try mode 5; opaque
+    // blocks try mode 1 with the partitions whose subsets lie closest to a
+    // line. The block with the smallest error is kept.
+    void EncodeBc7(const Block& block, uint8_t* dst) noexcept
+    {
+        float points[16][4];
+        bool opaque = true;
+        for (int i = 0; i < 16; ++i)
+        {
+            for (int c = 0; c < 4; ++c)
+                points[i][c] = block[i][c];
+            opaque = opaque && block[i][3] == 255;
+        }
+
+        uint32_t err = EncodeBc7Mode6(points, dst);
+        if (err <= BC7_GOOD_ENOUGH)
+            return;
+
+        uint8_t candidate[16];
+        if (!opaque)
+        {
+            if (EncodeBc7Mode5(points, candidate) < err)
+                std::memcpy(dst, candidate, 16);
+            return;
+        }
+
+        RgbMoments all;
+        for (int i = 0; i < 16; ++i)
+            all.Add(points[i]);
+
+        float scores[64];
+        int   order[64];
+        for (int p = 0; p < 64; ++p)
+        {
+            RgbMoments subset1;
+            for (int i = 0; i < 16; ++i)
+                if ((BC7_PARTITIONS2[p] >> i) & 1)
+                    subset1.Add(points[i]);
+            scores[p] = LineFitError(all - subset1) + LineFitError(subset1);
+            order[p]  = p;
+        }
+        std::partial_sort(order, order + BC7_PARTITION_TRIES, order + 64,
+                          [&](int a, int b) { return scores[a] < scores[b]; });
+
+        for (int k = 0; k < BC7_PARTITION_TRIES; ++k)
+        {
+            const uint32_t cErr = EncodeBc7Mode1(points, order[k], candidate);
+            if (cErr < err)
+            {
+                err = cErr;
+                std::memcpy(dst, candidate, 16);
+            }
+        }
+    }
+
+    bool DecodeBc7(const uint8_t* src, Block& out) noexcept
+    {
+        BitReader in{ src };
+
+        if ((src[0] & 0x7F) == 0x40)
+        {
+            in.Read(7);
+            Bc7Endpoint e0, e1;
+            for (int c = 0; c < 4; ++c)
+            {
+                e0.q[c] = static_cast<uint8_t>(in.Read(7));
+                e1.q[c] = static_cast<uint8_t>(in.Read(7));
+            }
+            e0.p = static_cast<uint8_t>(in.Read(1));
+            e1.p = static_cast<uint8_t>(in.Read(1));
+
+            for (int i = 0; i < 16; ++i)
+            {
+                const uint32_t k = in.Read(i == 0 ? 3 : 4);
+                for (int c = 0; c < 4; ++c)
+                    out[i][c] = static_cast<uint8_t>(((64 - BC7_WEIGHTS4[k]) * Bc7Expand(e0, c, BC7_MODE6) +
+                                                      BC7_WEIGHTS4[k] * Bc7Expand(e1, c, BC7_MODE6) + 32) >> 6);
+            }
+            return true;
+        }
+
+        if ((src[0] & 0x3F) == 0x20)
+        {
+            in.Read(6);
+            const uint32_t rotation = in.Read(2);
+            Bc7Endpoint c0, c1, a0, a1;
+            for (int c = 0; c < 3; ++c)
+            {
+                c0.q[c] = static_cast<uint8_t>(in.Read(7));
+                c1.q[c] = static_cast<uint8_t>(in.Read(7));
+            }
+            a0.q[0] = static_cast<uint8_t>(in.Read(8));
+            a1.q[0] = static_cast<uint8_t>(in.Read(8));
+
+            for (int i = 0; i < 16; ++i)
+            {
+                const uint32_t k = in.Read(i == 0 ? 1 : 2);
+                for (int c = 0; c < 3; ++c)
+                    out[i][c] = static_cast<uint8_t>(((64 - BC7_WEIGHTS2[k]) * Bc7Expand(c0, c, BC7_MODE5_COLOR) +
+                                                      BC7_WEIGHTS2[k] * Bc7Expand(c1, c, BC7_MODE5_COLOR) + 32) >> 6);
+            }
+            for (int i = 0; i < 16; ++i)
+            {
+                const uint32_t k = in.Read(i == 0 ? 1 : 2);
+                out[i][3] = static_cast<uint8_t>(((64 - BC7_WEIGHTS2[k]) * a0.q[0] + BC7_WEIGHTS2[k] * a1.q[0] + 32) >> 6);
+                if (rotation > 0)
+                    std::swap(out[i][3], out[i][rotation - 1]);
+            }
+            return true;
+        }
+
+        if ((src[0] & 0x03) == 0x02)
+        {
+            in.Read(2);
+            const int partition = static_cast<int>(in.Read(6));
+            Bc7Endpoint e[2][2];
+            for (int c = 0; c < 3; ++c)
+                for (int s = 0; s < 2; ++s)
+                {
+                    e[s][0].q[c] = static_cast<uint8_t>(in.Read(6));
+                    e[s][1].q[c] = static_cast<uint8_t>(in.Read(6));
+                }
+            for (int s = 0; s < 2; ++s)
+                e[s][0].p = e[s][1].p = static_cast<uint8_t>(in.Read(1));
+
+            const int anchor = BC7_ANCHORS2[partition];
+            for (int i = 0; i < 16; ++i)
+            {
+                const int s = (BC7_PARTITIONS2[partition] >> i) & 1;
+                const uint32_t k = in.Read((i == 0 || i == anchor) ? 2 : 3);
+                for (int c = 0; c < 3; ++c)
+                    out[i][c] = static_cast<uint8_t>(((64 - BC7_WEIGHTS3[k]) * Bc7Expand(e[s][0], c, BC7_MODE1) +
+                                                      BC7_WEIGHTS3[k] * Bc7Expand(e[s][1], c, BC7_MODE1) + 32) >> 6);
+                out[i][3] = 255;
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    // ---------------------------------------------------------------- blocks
+
+    void EncodeBlock(TextureFormat format, const Block& block, uint8_t* dst) noexcept
+    {
+        uint8_t channel[16];
+        switch (format)
+        {
+        case TextureFormat::BC1:
+            EncodeBc1(block, dst);
+            break;
+        case TextureFormat::BC3:
+            for (int i = 0; i < 16; ++i) channel[i] = block[i][3];
+            EncodeBc4(channel, dst);
+            EncodeBc1(block, dst + 8);
+            break;
+        case TextureFormat::BC4:
+            for (int i = 0; i < 16; ++i) channel[i] = block[i][0];
+            EncodeBc4(channel, dst);
+            break;
+        case TextureFormat::BC5:
+            for (int i = 0; i < 16; ++i) channel[i] = block[i][0];
+            EncodeBc4(channel, dst);
+            for (int i = 0; i < 16; ++i) channel[i] = block[i][1];
+            EncodeBc4(channel, dst + 8);
+            break;
+        case TextureFormat::BC7:
+            EncodeBc7(block, dst);
+            break;
+        default:
+            break;
+        }
+    }
+
+    bool DecodeBlock(TextureFormat format, const uint8_t* src, Block& out) noexcept
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            out[i][0] = out[i][1] = out[i][2] = 0;
+            out[i][3] = 255;
+        }
+
+        switch (format)
+        {
+        case TextureFormat::BC1: DecodeBc1(src, false, out); return true;
+        case TextureFormat::BC3: DecodeBc1(src + 8, true, out); DecodeBc4(src, out, 3); return true;
+        case TextureFormat::BC4: DecodeBc4(src, out, 0); return true;
+        case TextureFormat::BC5: DecodeBc4(src, out, 0); DecodeBc4(src + 8, out, 1); return true;
+        case TextureFormat::BC7: return DecodeBc7(src, out);
+        default:                 return false;
+        }
+    }
+
+    // Runs fn(row) for rows [0, rows) on a few threads; blocks are
+    // independent, so the output does not depend on the split.
+    template<class Fn>
+    void ParallelRows(uint32_t rows, Fn&& fn)
+    {
+        const uint32_t threads = std::min<uint32_t>(std::max(1u, std::thread::hardware_concurrency()), rows / 16 + 1);
+        if (threads <= 1)
+        {
+            for (uint32_t row = 0; row < rows; ++row) fn(row);
+            return;
+        }
+
+        std::vector<std::thread> workers;
+        workers.reserve(threads);
+        for (uint32_t t = 0; t < threads; ++t)
+        {
+            workers.emplace_back([&, t] {
+                for (uint32_t row = t; row < rows; row += threads) fn(row);
+            });
+        }
+        for (std::thread& w : workers) w.join();
+    }
+}
+
+TextureFormat BlockCompressor::ChooseFormat(TextureUsage usage, bool hasAlpha, bool preferSmall) noexcept
+{
+    switch (usage)
+    {
+    case TextureUsage::Normal: return TextureFormat::BC5;
+    case TextureUsage::Scalar: return TextureFormat::BC4;
+    default:
+        if (!preferSmall) return TextureFormat::BC7;
+        return hasAlpha ? TextureFormat::BC3 : TextureFormat::BC1;
+    }
+}
+
+bool BlockCompressor::HasAlpha(const TextureImage& rgba) noexcept
+{
+    if (rgba.IsBlockCompressed())
+        return false;
+
+    const size_t texels = std::min(static_cast<size_t>(rgba.width) * rgba.height, rgba.pixels.size() / 4);
+    for (size_t i = 0; i < texels; ++i)
+        if (rgba.pixels[i * 4 + 3] != 255)
+            return true;
+    return false;
+}
+
+bool BlockCompressor::Compress(const TextureImage& rgba, TextureFormat format, TextureImage& out)
+{
+    if (rgba.IsBlockCompressed() || format == TextureFormat::RGBA8 ||
+        rgba.width == 0 || rgba.height == 0 || rgba.mipLevels == 0 ||
+        rgba.pixels.size() < rgba.LevelOffset(rgba.mipLevels))
+        return false;
+
+    TextureImage result;
+    result.width     = rgba.width;
+    result.height    = rgba.height;
+    result.mipLevels = rgba.mipLevels;
+    result.format    = format;
+    result.pixels.resize(result.LevelOffset(result.mipLevels));
+
+    const uint32_t blockBytes = result.BlockBytes();
+    for (uint32_t level = 0; level < rgba.mipLevels; ++level)
+    {
+        const uint8_t* src    = rgba.pixels.data() + rgba.LevelOffset(level);
+        uint8_t*       dst    = result.pixels.data() + result.LevelOffset(level);
+        const uint32_t width  = rgba.LevelWidth(level);
+        const uint32_t height = rgba.LevelHeight(level);
+        const uint32_t pitch  = result.RowPitch(level);
+        const uint32_t blocksX = (width + 3) / 4;
+
+        ParallelRows((height + 3) / 4, [&](uint32_t by) {
+            Block block;
+            for (uint32_t bx = 0; bx < blocksX; ++bx)
+            {
+                FetchBlock(src, width, height, bx, by, block);
+                EncodeBlock(format, block, dst + static_cast<size_t>(by) * pitch + bx * blockBytes);
+            }
+        });
+    }
+
+    out = std::move(result);
+    return true;
+}
+
+bool BlockCompressor::Decompress(const TextureImage& image, TextureImage& out)
+{
+    if (image.width == 0 || image.height == 0 || image.mipLevels == 0 ||
+        image.pixels.size() < image.LevelOffset(image.mipLevels))
+        return false;
+
+    if (!image.IsBlockCompressed())
+    {
+        out = image;
+        return true;
+    }
+
+    TextureImage result;
+    result.width     = image.width;
+    result.height    = image.height;
+    result.mipLevels = image.mipLevels;
+    result.pixels.resize(result.LevelOffset(result.mipLevels));
+
+    const uint32_t blockBytes = image.BlockBytes();
+    for (uint32_t level = 0; level < image.mipLevels; ++level)
+    {
+        const uint8_t* src    = image.pixels.data() + image.LevelOffset(level);
+        uint8_t*       dst    = result.pixels.data() + result.LevelOffset(level);
+        const uint32_t width  = image.LevelWidth(level);
+        const uint32_t height = image.LevelHeight(level);
+        const uint32_t pitch  = image.RowPitch(level);
+
+        Block block;
+        for (uint32_t by = 0; by < (height + 3) / 4; ++by)
+        {
+            for (uint32_t bx = 0; bx < (width + 3) / 4; ++bx)
+            {
+                if (!DecodeBlock(image.format, src + static_cast<size_t>(by) * pitch + bx * blockBytes, block))
+                    return false;
+                StoreBlock(block, dst, width, height, bx, by);
+            }
+        }
+    }
+
+    out = std::move(result);
+    return true;
+}
+
+double BlockCompressor::Psnr(const TextureImage& reference, const TextureImage& test,
+                             uint32_t level, uint32_t channelMask)
+{
+    if (reference.IsBlockCompressed() || test.IsBlockCompressed() ||
+        reference.width != test.width || reference.height != test.height ||
+        level >= reference.mipLevels || level >= test.mipLevels ||
+        reference.pixels.size() < reference.LevelOffset(level + 1) ||
+        test.pixels.size() < test.LevelOffset(level + 1))
+        return 0.0;
+
+    const uint8_t* a      = reference.pixels.data() + reference.LevelOffset(level);
+    const uint8_t* b      = test.pixels.data() + test.LevelOffset(level);
+    const size_t   texels = static_cast<size_t>(reference.LevelWidth(level)) * reference.LevelHeight(level);
+
+    double   sum     = 0.0;
+    uint64_t samples = 0;
+    for (size_t i = 0; i < texels; ++i)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            if (!(channelMask & (1u << c)))
+                continue;
+            const double d = static_cast<double>(a[i * 4 + c]) - static_cast<double>(b[i * 4 + c]);
+            sum += d * d;
+            ++samples;
+        }
+    }
+
+    if (samples == 0 || sum == 0.0)
+        return 99.0;
+    const double mse = sum / static_cast<double>(samples);
+    return 10.0 * std::log10(255.0 * 255.0 / mse);
+}
@@ -0,0 +1,140 @@
+#include "ContentHash.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <filesystem>
+
+namespace
+{
+    constexpr uint64_t PRIME64_1 = 0x9E3779B185EBCA87ull;
+    constexpr uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+    constexpr uint64_t PRIME64_3 = 0x165667B19E3779F9ull;
+    constexpr uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+    constexpr uint64_t PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+    uint64_t Rotl(uint64_t v, int r) noexcept { return (v << r) | (v >> (64 - r)); }
+
+    // Little endian reads byte by byte: any alignment, any host order.
+    uint64_t Read64(const uint8_t* p) noexcept
+    {
+        uint64_t v = 0;
+        for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+        return v;
+    }
+
+    uint32_t Read32(const uint8_t* p) noexcept
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    uint64_t Round(uint64_t acc, uint64_t input) noexcept
+    {
+        acc += input * PRIME64_2;
+        acc  = Rotl(acc, 31);
+        return acc * PRIME64_1;
+    }
+
+    uint64_t MergeRound(uint64_t acc, uint64_t value) noexcept
+    {
+        acc ^= Round(0, value);
+        return acc * PRIME64_1 + PRIME64_4;
+    }
+}
+
+// ============================================================
+uint64_t ContentHash::Xxh64(const void* data, size_t size, uint64_t seed) noexcept
+{
+    const uint8_t* p   = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + size;
+    uint64_t h;
+
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+
+        // 32 byte stripes, four independent lanes.
+        const uint8_t* limit = end - 32;
+        do
+        {
+            v1 = Round(v1, Read64(p));
+            v2 = Round(v2, Read64(p + 8));
+            v3 = Round(v3, Read64(p + 16));
+            v4 = Round(v4, Read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = Rotl(v1, 1) + Rotl(v2, 7) + Rotl(v3, 12) + Rotl(v4, 18);
+        h = MergeRound(h, v1);
+        h = MergeRound(h, v2);
+        h = MergeRound(h, v3);
+        h = MergeRound(h, v4);
+    }
+    else
+    {
+        h = seed + PRIME64_5;
+    }
+
+    h += static_cast<uint64_t>(size);
+
+    for (; p + 8 <= end; p += 8)
+    {
+        h ^= Round(0, Read64(p));
+        h  = Rotl(h, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (p + 4 <= end)
+    {
+        h ^= static_cast<uint64_t>(Read32(p)) * PRIME64_1;
+        h  = Rotl(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; ++p)
+    {
+        h ^= static_cast<uint64_t>(*p) * PRIME64_5;
+        h  = Rotl(h, 11) * PRIME64_1;
+    }
+
+    // Avalanche
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// ============================================================
+//  CanonicalPath
+//
+//  weakly_canonical also resolves paths that do not exist (the load
+//  fails later); on errors the lexically normal path is used.
+// ============================================================
+std::wstring ContentHash::CanonicalPath(const wchar_t* filename)
+{
+    if (!filename || !*filename)
+        return std::wstring();
+
+    // Backslashes are separators only on Windows; unify them first so the
+    // filesystem calls see the same path everywhere.
+    std::wstring name(filename);
+    std::replace(name.begin(), name.end(), L'\\', L'/');
+
+    // Absolute first: weakly_canonical leaves a relative path relative
+    // when none of its prefixes exists, but not when "." does.
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path path = fs::absolute(fs::path(name), ec);
+    if (ec)
+        path = fs::path(name);
+
+    fs::path resolved = fs::weakly_canonical(path, ec);
+    path = ec ? path.lexically_normal() : resolved;
+
+    std::wstring key = path.make_preferred().wstring();
+    std::transform(key.begin(), key.end(), key.begin(),
+        [](wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+    return key;
+}
@@ -0,0 +1,125 @@
+#include "CullingVolume.h"
+#include <cmath>
+
+using namespace DirectX;
+
+void CullingVolume::SetFromViewProjection(const XMMATRIX& view, const XMMATRIX& proj)
+{
+    m_valid = false;
+
+    XMVECTOR det = XMMatrixDeterminant(view);
+    if (std::fabs(XMVectorGetX(det)) < 1e-12f) return;
+    const XMMATRIX invView = XMMatrixInverse(&det, view);
+
+    // LH perspective projections carry 1 in _34 (row 2, w), orthographic ones 0.
+    const bool ortho = (std::fabs(XMVectorGetW(proj.r[2])) < 1e-6f);
+    m_kind = ortho ? Kind::OrientedBox : Kind::Frustum;
+
+    if (!ortho)
+    {
+        BoundingFrustum local;
+        BoundingFrustum::CreateFromMatrix(local, proj);
+        if (!(local.Near < local.Far)) return;
+
+        local.Transform(m_frustum, invView);
+        m_valid = true;
+        return;
+    }
+
+    XMVECTOR projDet = XMMatrixDeterminant(proj);
+    if (std::fabs(XMVectorGetX(projDet)) < 1e-12f) return;
+    const XMMATRIX invProj = XMMatrixInverse(&projDet, proj);
+
+    // Unproject the D3D clip cube (z in [0,1]) into view space.
+    static const XMVECTORF32 ndc[8] =
+    {
+        { { { -1.f, -1.f, 0.f, 1.f } } }, { { {  1.f, -1.f, 0.f, 1.f } } },
+        { { {  1.f,  1.f, 0.f, 1.f } } }, { { { -1.f,  1.f, 0.f, 1.f } } },
+        { { { -1.f, -1.f, 1.f, 1.f } } }, { { {  1.f, -1.f, 1.f, 1.f } } },
+        { { {  1.f,  1.f, 1.f, 1.f } } }, { { { -1.f,  1.f, 1.f, 1.f } } },
+    };
+
+    XMFLOAT3 pts[8];
+    for (int i = 0; i < 8; ++i)
+        XMStoreFloat3(&pts[i], XMVector3TransformCoord(ndc[i], invProj));
+
+    BoundingBox viewBox;
+    BoundingBox::CreateFromPoints(viewBox, 8, pts, sizeof(XMFLOAT3));
+
+    BoundingOrientedBox local;
+    BoundingOrientedBox::CreateFromBoundingBox(local, viewBox);
+    local.Transform(m_box, invView);
+    m_valid = true;
+}
+
+void CullingVolume::SetFromExtrudedReceivers(const CullingVolume& receivers, const XMMATRIX& lightView)
+{
+    m_valid = false;
+
+    XMFLOAT3 corners[8];
+    if (!receivers.GetCorners(corners)) return;
+
+    for (int i = 0; i < 8; ++i)
+        XMStoreFloat3(&corners[i], XMVector3TransformCoord(XMLoadFloat3(&corners[i]), lightView));
+
+    BoundingBox box;
+    BoundingBox::CreateFromPoints(box, 8, corners, sizeof(XMFLOAT3));
+
+    // Extrude towards the light (-z in LH light view space): casters in
+    // front of the receivers, up to the light, still cast into them.
+    constexpr float EXTRUDE = 1.0e6f;
+    const float maxZ = box.Center.z + box.Extents.z;
+    const float minZ = box.Center.z - box.Extents.z - EXTRUDE;
+    box.Center.z  = 0.5f * (maxZ + minZ);
+    box.Extents.z = 0.5f * (maxZ - minZ);
+
+    m_lightBox = box;
+    XMStoreFloat4x4(&m_lightView, lightView);
+    m_kind  = Kind::LightSpaceBox;
+    m_valid = true;
+}
+
+bool CullingVolume::Intersects(const BoundingBox& box) const
+{
+    if (!m_valid) return true;
+
+    switch (m_kind)
+    {
+    case Kind::Frustum:
+        return m_frustum.Intersects(box);
+    case Kind::OrientedBox:
+        return m_box.Intersects(box);
+    case Kind::LightSpaceBox:
+    {
+        BoundingBox lightSpace;
+        box.Transform(lightSpace, XMLoadFloat4x4(&m_lightView));
+        return m_lightBox.Intersects(lightSpace);
+    }
+    }
+    return true;
+}
+
+bool CullingVolume::GetCorners(XMFLOAT3* corners) const
+{
+    if (!m_valid || !corners) return false;
+
+    switch (m_kind)
+    {
+    case Kind::Frustum:
+        m_frustum.GetCorners(corners);
+        return true;
+    case Kind::OrientedBox:
+        m_box.GetCorners(corners);
+        return true;
+    case Kind::LightSpaceBox:
+    {
+        BoundingOrientedBox local;
+        BoundingOrientedBox::CreateFromBoundingBox(local, m_lightBox);
+        BoundingOrientedBox world;
+        local.Transform(world, XMMatrixInverse(nullptr, XMLoadFloat4x4(&m_lightView)));
+        world.GetCorners(corners);
+        return true;
+    }
+    }
+    return false;
+}
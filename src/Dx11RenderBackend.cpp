@@ -13,14 +13,22 @@
 #include "ShadowMapTarget.h"
 #include "BackbufferTarget.h"
 #include "RenderTextureTarget.h"
+#include "Shader.h"
+#include "Surface.h"
+#include "SurfaceGpuBuffer.h"
 
 #include <d3d11.h>
+#include <d3d11_1.h>
 #include <cstring>
 
 #ifndef SHADOW_TEX_SLOT
 #define SHADOW_TEX_SLOT 16   // must match PixelShader.hlsl register(t16)
 #endif
 
+#ifndef PASS_CB_SLOT
+#define PASS_CB_SLOT 5       // must match the shaders' PassBuffer register(b5)
+#endif
+
 #ifndef SHADOW_SMP_SLOT
 #define SHADOW_SMP_SLOT 7    // must match PixelShader.hlsl register(s7)
 #endif
@@ -34,17 +42,26 @@ Dx11RenderBackend::Dx11RenderBackend(GDXDevice& device)
     m_lightCBData  = std::make_unique<LightArrayBuffer>();
 
     CreateFrameStates(device);
+    InitFrameConstants(device);
 
     DBLOG("Dx11RenderBackend.cpp: Backend created");
 }
 
 Dx11RenderBackend::~Dx11RenderBackend()
 {
+    // The backend may be replaced at runtime (RenderManager::SetBackendFactory).
+    if (m_device && m_device->m_dx11Backend == this)
+        m_device->AttachDx11Backend(nullptr);
+
     if (m_shadow) m_shadow->Release();
 
     if (m_defaultSampler)  { m_defaultSampler->Release();  m_defaultSampler  = nullptr; }
     if (m_alphaBlendState) { m_alphaBlendState->Release(); m_alphaBlendState = nullptr; }
     if (m_noBlendState)    { m_noBlendState->Release();    m_noBlendState    = nullptr; }
+    if (m_instanceBuffer)  { m_instanceBuffer->Release();  m_instanceBuffer  = nullptr; }
+    if (m_frameCB)         { m_frameCB->Release();         m_frameCB         = nullptr; }
+    if (m_passCB)          { m_passCB->Release();          m_passCB          = nullptr; }
+    if (m_context1)        { m_context1->Release();        m_context1        = nullptr; }
 }
 
 void Dx11RenderBackend::CreateFrameStates(GDXDevice& device)
@@ -129,6 +146,18 @@ void Dx11RenderBackend::BindEntityConstants(GDXDevice& device, const Entity& ent
 {
     if (!device.IsInitialized()) return;
     if (!entity.gpuData) return;
+
+    if (m_context1 && m_frameCB && entity.gpuData->frameOffset != FrameConstantAllocator::INVALID_OFFSET)
+    {
+        // Offsets and sizes are in 16-byte constants; one block = 16 constants.
+        const UINT first = entity.gpuData->frameOffset / 16u;
+        const UINT count = FrameConstantAllocator::ALIGNMENT / 16u;
+        m_context1->VSSetConstantBuffers1(0, 1, &m_frameCB, &first, &count);
+        m_context1->PSSetConstantBuffers1(0, 1, &m_frameCB, &first, &count);
+        EntityGpuData::CountBind();
+        return;
+    }
+
     entity.gpuData->Bind(&device);
 }
 
@@ -179,7 +208,8 @@ void Dx11RenderBackend::UploadLightConstants(
 IRenderBackend::EntityStats Dx11RenderBackend::GetEntityFrameStats() const
 {
     const EntityGpuData::FrameStats s = EntityGpuData::GetFrameStats();
-    return EntityStats{ s.uploads, s.binds, s.ringRotations };
+    return EntityStats{ s.uploads, s.binds, s.ringRotations,
+                        m_entityConstants.GetUsedBytes(), m_frameCommits };
 }
 
 void Dx11RenderBackend::ResetEntityFrameStats()
@@ -506,3 +536,258 @@ void Dx11RenderBackend::SetAlphaBlend(bool enable)
     else if (!enable && m_noBlendState)
         ctx->OMSetBlendState(m_noBlendState, blendFactor, 0xFFFFFFFF);
 }
+
+// ---------------------------------------------------------------------------
+// Step 6: shader bind, entity upload, surface draw
+// ---------------------------------------------------------------------------
+
+bool Dx11RenderBackend::IsShaderValid(const Shader* shader, ShaderBindMode mode) const
+{
+    return shader && shader->IsValid(mode);
+}
+
+void Dx11RenderBackend::BindShader(GDXDevice& device, Shader* shader, ShaderBindMode mode)
+{
+    if (!shader) return;
+    shader->UpdateShader(&device, mode);
+    m_boundShader       = shader;
+    m_packedLayoutBound = false;
+}
+
+bool Dx11RenderBackend::SelectInputLayout(GDXDevice& device, bool packed)
+{
+    if (packed == m_packedLayoutBound) return true;
+    if (!m_boundShader) return false;
+
+    ID3D11InputLayout* layout = packed ? m_boundShader->inputlayoutPacked : m_boundShader->inputlayoutVertex;
+    if (!layout)
+    {
+        DBLOG_ONCE("Dx11RenderBackend:packed-layout",
+            "Dx11RenderBackend.cpp: packed surface skipped, shader has no packed input layout");
+        return false;
+    }
+
+    device.GetDeviceContext()->IASetInputLayout(layout);
+    m_packedLayoutBound = packed;
+    return true;
+}
+
+void Dx11RenderBackend::UploadEntityConstants(GDXDevice& device, Mesh& mesh, const EntityConstants& constants)
+{
+    if (!mesh.gpuData) return;
+
+    if (!m_context1)
+    {
+        // Fallback: per-entity ring buffer, uploaded right away.
+        mesh.Update(&device, &constants);
+        mesh.gpuData->frameOffset = FrameConstantAllocator::INVALID_OFFSET;
+        return;
+    }
+
+    // Same as Mesh::Update: no upload for inactive meshes. The collision
+    // box is refreshed with the world matrix (Mesh::UpdateOBB), not here.
+    mesh.gpuData->frameOffset = FrameConstantAllocator::INVALID_OFFSET;
+    if (!mesh.IsActive()) return;
+
+    mesh.gpuData->frameOffset = m_entityConstants.Allocate(&constants, sizeof(EntityConstants));
+    EntityGpuData::CountUpload();
+}
+
+void Dx11RenderBackend::DrawSurface(GDXDevice& device, Surface& surface, unsigned int flagsVertex)
+{
+    if (!surface.gpu) return;
+
+    // SurfaceGpuBuffer is the only IGpuResource implementation of this backend.
+    if (!SelectInputLayout(device, static_cast<const SurfaceGpuBuffer*>(surface.gpu.get())->IsPacked()))
+        return;
+    surface.gpu->Draw(&device, flagsVertex);
+}
+
+bool Dx11RenderBackend::UploadInstanceData(GDXDevice& device, const DirectX::XMFLOAT4X4* worlds, uint32_t count)
+{
+    if (!worlds || count == 0) return false;
+
+    ID3D11Device*        dev = device.GetDevice();
+    ID3D11DeviceContext* ctx = device.GetDeviceContext();
+    if (!dev || !ctx) return false;
+
+    if (count > m_instanceCapacity)
+    {
+        if (m_instanceBuffer) { m_instanceBuffer->Release(); m_instanceBuffer = nullptr; }
+        m_instanceCapacity = 0;
+
+        // Grow to the next power of two so a slowly rising instance count
+        // does not recreate the buffer every frame.
+        uint32_t capacity = 256;
+        while (capacity < count) capacity *= 2;
+
+        D3D11_BUFFER_DESC bd{};
+        bd.ByteWidth      = capacity * sizeof(DirectX::XMFLOAT4X4);
+        bd.Usage          = D3D11_USAGE_DYNAMIC;
+        bd.BindFlags      = D3D11_BIND_VERTEX_BUFFER;
+        bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        const HRESULT hr = dev->CreateBuffer(&bd, nullptr, &m_instanceBuffer);
+        if (FAILED(hr))
+        {
+            DBERROR("Dx11RenderBackend.cpp: UploadInstanceData - CreateBuffer failed");
+            return false;
+        }
+        m_instanceCapacity = capacity;
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    if (FAILED(ctx->Map(m_instanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+    {
+        DBERROR("Dx11RenderBackend.cpp: UploadInstanceData - Map failed");
+        return false;
+    }
+    std::memcpy(mapped.pData, worlds, count * sizeof(DirectX::XMFLOAT4X4));
+    ctx->Unmap(m_instanceBuffer, 0);
+    return true;
+}
+
+void Dx11RenderBackend::DrawSurfaceInstanced(GDXDevice& device, Surface& surface, unsigned int flagsVertex,
+                                             uint32_t instanceCount, uint32_t firstInstance)
+{
+    if (!surface.gpu || !m_instanceBuffer) return;
+
+    // SurfaceGpuBuffer is the only IGpuResource implementation of this backend.
+    const SurfaceGpuBuffer* gpu = static_cast<const SurfaceGpuBuffer*>(surface.gpu.get());
+    if (!SelectInputLayout(device, gpu->IsPacked())) return;
+    gpu->DrawInstanced(
+        &device, flagsVertex, m_instanceBuffer, sizeof(DirectX::XMFLOAT4X4),
+        instanceCount, firstInstance);
+}
+
+// ---------------------------------------------------------------------------
+// Step 8: frame constant buffer
+// ---------------------------------------------------------------------------
+
+void Dx11RenderBackend::InitFrameConstants(GDXDevice& device)
+{
+    ID3D11Device*        dev = device.GetDevice();
+    ID3D11DeviceContext* ctx = device.GetDeviceContext();
+    if (!dev || !ctx) return;
+
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options{};
+    if (FAILED(dev->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) ||
+        !options.ConstantBufferOffsetting)
+    {
+        DBLOG("Dx11RenderBackend.cpp: constant buffer offsets not supported, using per-entity buffers");
+        return;
+    }
+
+    if (FAILED(ctx->QueryInterface(__uuidof(ID3D11DeviceContext1), reinterpret_cast<void**>(&m_context1))))
+    {
+        m_context1 = nullptr;
+        DBLOG("Dx11RenderBackend.cpp: ID3D11DeviceContext1 not available, using per-entity buffers");
+        return;
+    }
+
+    m_frameNoOverwrite = options.MapNoOverwriteOnDynamicConstantBuffer != FALSE;
+    DBLOG("Dx11RenderBackend.cpp: entity constants use one frame buffer (no-overwrite append: ",
+          m_frameNoOverwrite ? "yes" : "no", ")");
+}
+
+void Dx11RenderBackend::ResetEntityConstants()
+{
+    m_entityConstants.Reset();
+    m_frameCBWritten = false;
+    m_frameCommits   = 0;
+}
+
+void Dx11RenderBackend::CommitEntityConstants(GDXDevice& device)
+{
+    if (!m_context1 || !m_entityConstants.HasPending()) return;
+
+    ID3D11Device* dev = device.GetDevice();
+    if (!dev) return;
+
+    const uint32_t used = m_entityConstants.GetUsedBytes();
+    bool fullCopy = !m_frameCBWritten || !m_frameNoOverwrite;
+
+    if (used > m_frameCBCapacity)
+    {
+        // Draws already issued this frame keep the old buffer alive.
+        if (m_frameCB) { m_frameCB->Release(); m_frameCB = nullptr; }
+        m_frameCBCapacity = 0;
+
+        uint32_t capacity = 64u * 1024u;
+        while (capacity < used) capacity *= 2;
+
+        D3D11_BUFFER_DESC bd{};
+        bd.ByteWidth      = capacity;
+        bd.Usage          = D3D11_USAGE_DYNAMIC;
+        bd.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
+        bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        if (FAILED(dev->CreateBuffer(&bd, nullptr, &m_frameCB)))
+        {
+            DBERROR("Dx11RenderBackend.cpp: CommitEntityConstants - CreateBuffer failed");
+            return;
+        }
+        m_frameCBCapacity = capacity;
+        fullCopy = true;
+    }
+
+    // First commit of the frame (or no append support): DISCARD and copy
+    // everything staged so far, so earlier offsets stay valid in the new
+    // buffer. Later commits append behind the data in flight.
+    const uint32_t begin = fullCopy ? 0u : m_entityConstants.GetPendingBegin();
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    const D3D11_MAP mapType = fullCopy ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE;
+    if (FAILED(m_context1->Map(m_frameCB, 0, mapType, 0, &mapped)))
+    {
+        DBERROR("Dx11RenderBackend.cpp: CommitEntityConstants - Map failed");
+        return;
+    }
+    std::memcpy(static_cast<uint8_t*>(mapped.pData) + begin,
+                m_entityConstants.GetData() + begin, used - begin);
+    m_context1->Unmap(m_frameCB, 0);
+
+    m_entityConstants.MarkCommitted();
+    m_frameCBWritten = true;
+    ++m_frameCommits;
+}
+
+// ---------------------------------------------------------------------------
+// Step 9: pass constants
+// ---------------------------------------------------------------------------
+
+void Dx11RenderBackend::UploadPassConstants(GDXDevice& device, const PassConstants& constants)
+{
+    if (!device.IsInitialized()) return;
+
+    ID3D11Device*        dev = device.GetDevice();
+    ID3D11DeviceContext* ctx = device.GetDeviceContext();
+    if (!dev || !ctx) return;
+
+    if (!m_passCB)
+    {
+        D3D11_BUFFER_DESC bd{};
+        bd.ByteWidth      = (sizeof(PassConstants) + 15u) & ~15u;
+        bd.Usage          = D3D11_USAGE_DYNAMIC;
+        bd.BindFlags      = D3D11_BIND_CONSTANT_BUFFER;
+        bd.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+
+        if (FAILED(dev->CreateBuffer(&bd, nullptr, &m_passCB)))
+        {
+            DBERROR("Dx11RenderBackend.cpp: UploadPassConstants - CreateBuffer failed");
+            return;
+        }
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    if (FAILED(ctx->Map(m_passCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped)))
+    {
+        DBERROR("Dx11RenderBackend.cpp: UploadPassConstants - Map failed");
+        return;
+    }
+    std::memcpy(mapped.pData, &constants, sizeof(PassConstants));
+    ctx->Unmap(m_passCB, 0);
+
+    ctx->VSSetConstantBuffers(PASS_CB_SLOT, 1, &m_passCB);
+    ctx->PSSetConstantBuffers(PASS_CB_SLOT, 1, &m_passCB);
+}
@@ -1,6 +1,9 @@
-// Entity.cpp: No DX11. GPU upload goes through gpuData->Upload().
+// Entity.cpp: No DX11. GPU upload goes through gpuData->Upload(); off Windows
+// there is no gpuData (see gdxplatform.h).
 #include "Entity.h"
+#ifdef _WIN32
 #include "Dx11EntityGpuData.h"
+#endif
 
 using namespace DirectX;
 
@@ -11,38 +14,97 @@ Entity::Entity(EntityType type)
     m_layerMask(LAYER_DEFAULT)
 {
     transform.SetWorldMatrix(&matrixSet.worldMatrix);
+    transform.SetOwner(this);
 
     matrixSet.worldMatrix = XMMatrixIdentity();
     matrixSet.viewMatrix = XMMatrixIdentity();
     matrixSet.projectionMatrix = XMMatrixIdentity();
+    m_worldCache = XMMatrixIdentity();
 
     viewport = {};
 }
 
 Entity::~Entity()
 {
+    if (m_revisions) m_revisions->TouchState();
+
     // Cleanly detach from parent and notify all children
     DetachFromParent();
     for (Entity* child : m_children)
-        if (child) child->m_parent = nullptr;
+    {
+        if (!child) continue;
+        child->m_parent = nullptr;
+        child->MarkWorldDirty();
+    }
     m_children.clear();
 
+#ifdef _WIN32
     delete gpuData;
+#endif
     gpuData = nullptr;
 }
 
 // Returns the full world matrix.
-// If a parent exists, its world matrix is multiplied in recursively:
+// If a parent exists, its world matrix is multiplied in:
 //   worldMatrix = localMatrix * parent->GetWorldMatrix()
 // Without a parent this equals the local transformation matrix directly.
+// Only dirty entities recompute; clean parents answer from their cache.
 XMMATRIX Entity::GetWorldMatrix() const
 {
-    XMMATRIX local = transform.GetLocalTransformationMatrix();
+    if (m_transformSystem)
+        return m_transformSystem->GetWorldMatrix(m_transformHandle);
 
+    if (!m_worldDirty)
+        return m_worldCache;
+
+    XMMATRIX world = transform.GetLocalTransformationMatrix();
     if (m_parent)
-        return local * m_parent->GetWorldMatrix();
+        world = world * m_parent->GetWorldMatrix();
+
+    m_worldCache = world;
+    m_worldDirty = false;
+    return world;
+}
+
+void Entity::BindTransform(TransformSystem* system, TransformHandle handle) noexcept
+{
+    m_transformSystem = system;
+    m_transformHandle = system ? handle : INVALID_TRANSFORM;
+
+    // Force a recompute from the Transform member after unbinding.
+    m_worldDirty = false;
+    MarkWorldDirty();
+}
+
+void Entity::BindRenderRevision(RenderRevision* revisions) noexcept
+{
+    m_revisions = revisions;
 
-    return local;
+    // Fresh stamps: a new entity at a recycled address never matches a
+    // retained record of the deleted one.
+    MarkRenderDirty();
+    if (m_revisions) m_worldRevision = m_revisions->TouchWorld();
+}
+
+void Entity::MarkWorldDirty() noexcept
+{
+    if (m_worldDirty) return;
+
+    m_worldDirty = true;
+    if (m_entityType == EntityType::Mesh && m_revisions)
+        m_worldRevision = m_revisions->TouchWorld();
+
+    for (Entity* child : m_children)
+        if (child) child->MarkWorldDirty();
+}
+
+void Entity::UpdateWorldMatrices()
+{
+    if (!m_worldDirty) return;
+
+    (void)GetWorldMatrix();
+    for (Entity* child : m_children)
+        if (child) child->UpdateWorldMatrices();
 }
 
 void Entity::Update(const GDXDevice* device)
@@ -51,7 +113,9 @@ void Entity::Update(const GDXDevice* device)
 
     matrixSet.worldMatrix = GetWorldMatrix();
 
-    if (gpuData) gpuData->Upload(device, matrixSet);
+#ifdef _WIN32
+    if (gpuData) gpuData->Upload(device, MakeEntityConstants(matrixSet.worldMatrix));
+#endif
 }
 
 // Attaches this entity as a child of parent.
@@ -82,6 +146,7 @@ void Entity::SetParent(Entity* parent)
     m_parent = parent;
     if (m_parent)
         m_parent->m_children.push_back(this);
+    MarkWorldDirty();
 
     Debug::Log("Entity.cpp: SetParent - parent set");
 }
@@ -94,6 +159,7 @@ void Entity::DetachFromParent()
     siblings.erase(std::remove(siblings.begin(), siblings.end(), this), siblings.end());
 
     m_parent = nullptr;
+    MarkWorldDirty();
     Debug::Log("Entity.cpp: DetachFromParent - entity detached");
 }
 
@@ -0,0 +1,33 @@
+#include "FrameConstantAllocator.h"
+#include <cstring>
+
+void FrameConstantAllocator::Reset() noexcept
+{
+    m_used        = 0;
+    m_committed   = 0;
+    m_allocations = 0;
+}
+
+uint32_t FrameConstantAllocator::Allocate(const void* data, uint32_t size)
+{
+    if (!data || size == 0) return INVALID_OFFSET;
+
+    const uint32_t offset = m_used;
+    const uint32_t block  = AlignedSize(size);
+
+    if (m_data.size() < static_cast<size_t>(offset) + block)
+    {
+        // Doubling keeps growth amortized; the buffer is reused every frame.
+        size_t capacity = m_data.empty() ? 64u * 1024u : m_data.size();
+        while (capacity < static_cast<size_t>(offset) + block) capacity *= 2;
+        m_data.resize(capacity);
+    }
+
+    std::memcpy(m_data.data() + offset, data, size);
+    if (block > size)
+        std::memset(m_data.data() + offset + size, 0, block - size);
+
+    m_used += block;
+    ++m_allocations;
+    return offset;
+}
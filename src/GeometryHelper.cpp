@@ -1,6 +1,10 @@
 #include "GeometryHelper.h"
 #include "Surface.h"
+#include "gdxutil.h"
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <cstring>
 
 using namespace DirectX;
 
@@ -31,3 +35,444 @@ void GeometryHelper::CalculateSize(
     minOut = minPoint;
     maxOut = maxPoint;
 }
+
+// ---------------------------------------------------------------------------
+// Vertex cache / overdraw / vertex fetch optimization
+// ---------------------------------------------------------------------------
+namespace
+{
+    // Forsyth, "Linear-Speed Vertex Cache Optimisation". The scoring cache
+    // is larger than any real FIFO so that the order works across GPUs.
+    constexpr int   FORSYTH_CACHE_SIZE    = 32;
+    constexpr int   FORSYTH_MAX_VALENCE   = 64;
+    constexpr float FORSYTH_DECAY_POWER   = 1.5f;
+    constexpr float FORSYTH_LAST_TRI      = 0.75f;
+    constexpr float FORSYTH_VALENCE_SCALE = 2.0f;
+    constexpr float FORSYTH_VALENCE_POWER = 0.5f;
+
+    struct ForsythTables
+    {
+        float cache[FORSYTH_CACHE_SIZE];
+        float valence[FORSYTH_MAX_VALENCE + 1];
+
+        ForsythTables()
+        {
+            for (int i = 0; i < FORSYTH_CACHE_SIZE; ++i)
+            {
+                if (i < 3)
+                    cache[i] = FORSYTH_LAST_TRI;
+                else
+                    cache[i] = std::pow(1.0f - float(i - 3) / float(FORSYTH_CACHE_SIZE - 3), FORSYTH_DECAY_POWER);
+            }
+            valence[0] = 0.0f;
+            for (int i = 1; i <= FORSYTH_MAX_VALENCE; ++i)
+                valence[i] = FORSYTH_VALENCE_SCALE * std::pow(float(i), -FORSYTH_VALENCE_POWER);
+        }
+    };
+
+    float ForsythScore(const ForsythTables& t, int cachePos, uint32_t liveTris) noexcept
+    {
+        if (liveTris == 0) return -1.0f;
+        float score = (cachePos >= 0) ? t.cache[cachePos] : 0.0f;
+        score += t.valence[(std::min)(liveTris, uint32_t(FORSYTH_MAX_VALENCE))];
+        return score;
+    }
+
+    // Simulates a FIFO cache over one triangle; returns the number of misses.
+    // A vertex hits while fewer than cacheSize misses happened since it was
+    // loaded. Advancing 'time' by cacheSize + 1 empties the cache.
+    uint32_t FifoTriangle(const unsigned int* tri, std::vector<uint32_t>& stamps,
+                          uint32_t& time, uint32_t cacheSize) noexcept
+    {
+        uint32_t misses = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            const unsigned int v = tri[k];
+            if (time - stamps[v] > cacheSize)
+            {
+                stamps[v] = time++;
+                ++misses;
+            }
+        }
+        return misses;
+    }
+
+    bool IndicesValid(const std::vector<unsigned int>& indices, uint32_t vertexCount) noexcept
+    {
+        for (unsigned int i : indices)
+            if (i >= vertexCount) return false;
+        return true;
+    }
+
+    // Stream in the new vertex order; streams of another size (empty)
+    // are returned unchanged.
+    template <typename T>
+    std::vector<T> Remapped(const std::vector<T>& data, const std::vector<uint32_t>& remap)
+    {
+        if (data.size() != remap.size()) return data;
+        std::vector<T> out(data.size());
+        for (size_t i = 0; i < data.size(); ++i)
+            out[remap[i]] = data[i];
+        return out;
+    }
+}
+
+GeometryCacheStats GeometryHelper::AnalyzeVertexCache(
+    const std::vector<unsigned int>& indices,
+    uint32_t                         vertexCount,
+    uint32_t                         cacheSize)
+{
+    GeometryCacheStats stats;
+    stats.triangles = static_cast<uint32_t>(indices.size() / 3);
+    if (stats.triangles == 0 || vertexCount == 0 || cacheSize == 0) return stats;
+    if (!IndicesValid(indices, vertexCount)) return stats;
+
+    std::vector<uint8_t> used(vertexCount, 0);
+    for (size_t i = 0; i < size_t(stats.triangles) * 3; ++i)
+    {
+        if (!used[indices[i]]) { used[indices[i]] = 1; ++stats.vertices; }
+    }
+
+    // Stamps start far enough in the past that every first use misses.
+    std::vector<uint32_t> stamps(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    for (uint32_t t = 0; t < stats.triangles; ++t)
+        stats.transformed += FifoTriangle(&indices[size_t(t) * 3], stamps, time, cacheSize);
+
+    stats.acmr = float(stats.transformed) / float(stats.triangles);
+    stats.atvr = stats.vertices ? float(stats.transformed) / float(stats.vertices) : 0.0f;
+    return stats;
+}
+
+void GeometryHelper::OptimizeVertexCache(std::vector<unsigned int>& indices, uint32_t vertexCount)
+{
+    const size_t triCount = indices.size() / 3;
+    if (triCount < 2 || vertexCount == 0) return;
+
+    static const ForsythTables tables;
+
+    // Vertex -> triangle adjacency (CSR). The first liveTris[v] entries of
+    // a vertex's range are the triangles not yet emitted.
+    std::vector<uint32_t> liveTris(vertexCount, 0);
+    for (size_t i = 0; i < triCount * 3; ++i)
+        ++liveTris[indices[i]];
+
+    std::vector<uint32_t> adjStart(size_t(vertexCount) + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        adjStart[v + 1] = adjStart[v] + liveTris[v];
+
+    std::vector<uint32_t> adjacency(triCount * 3);
+    {
+        std::vector<uint32_t> fill(adjStart.begin(), adjStart.end() - 1);
+        for (size_t t = 0; t < triCount; ++t)
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32_t>(t);
+    }
+
+    std::vector<int>   cachePos(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        vertexScore[v] = ForsythScore(tables, -1, liveTris[v]);
+
+    std::vector<float>   triScore(triCount);
+    std::vector<uint8_t> emitted(triCount, 0);
+    for (size_t t = 0; t < triCount; ++t)
+        triScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    std::vector<unsigned int> result;
+    result.reserve(triCount * 3);
+
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+    int      cacheCount = 0;
+    size_t   inputCursor = 0;
+    int64_t  best       = -1;
+
+    // Vertices of emitted triangles, newest on top. A dead end (no live
+    // triangle around the cache) continues next to recently drawn geometry.
+    std::vector<uint32_t> deadEndStack;
+    deadEndStack.reserve(triCount * 3);
+
+    for (size_t emittedCount = 0; emittedCount < triCount; ++emittedCount)
+    {
+        if (best < 0)
+        {
+            // Popped vertices never get live triangles back, so every stack
+            // entry and every input triangle is visited at most once.
+            while (best < 0 && !deadEndStack.empty())
+            {
+                const uint32_t vert = deadEndStack.back();
+                deadEndStack.pop_back();
+
+                const uint32_t* adj = &adjacency[adjStart[vert]];
+                float bestScore = -1.0f;
+                for (uint32_t a = 0; a < liveTris[vert]; ++a)
+                {
+                    if (triScore[adj[a]] > bestScore)
+                    {
+                        bestScore = triScore[adj[a]];
+                        best = adj[a];
+                    }
+                }
+            }
+
+            // Stack exhausted: next live triangle in input order.
+            if (best < 0)
+            {
+                while (emitted[inputCursor]) ++inputCursor;
+                best = static_cast<int64_t>(inputCursor);
+            }
+        }
+
+        const size_t tri = static_cast<size_t>(best);
+        const unsigned int* v = &indices[tri * 3];
+        result.insert(result.end(), v, v + 3);
+        emitted[tri] = 1;
+        deadEndStack.insert(deadEndStack.end(), v, v + 3);
+
+        // Drop the triangle from its vertices' live lists.
+        for (int k = 0; k < 3; ++k)
+        {
+            const uint32_t vert  = v[k];
+            uint32_t*      adj   = &adjacency[adjStart[vert]];
+            const uint32_t count = liveTris[vert];
+            for (uint32_t a = 0; a < count; ++a)
+            {
+                if (adj[a] == tri)
+                {
+                    std::swap(adj[a], adj[count - 1]);
+                    break;
+                }
+            }
+            --liveTris[vert];
+        }
+
+        // LRU update: the triangle's vertices move to the front.
+        int newCount = 0;
+        for (int k = 0; k < 3; ++k)
+        {
+            bool dup = false;
+            for (int n = 0; n < newCount; ++n) dup |= (newCache[n] == v[k]);
+            if (!dup) newCache[newCount++] = v[k];
+        }
+        for (int c = 0; c < cacheCount; ++c)
+        {
+            const uint32_t vert = cache[c];
+            if (vert != v[0] && vert != v[1] && vert != v[2])
+                newCache[newCount++] = vert;
+        }
+
+        // Rescore every vertex that is or was in the cache, then the live
+        // triangles around them; the best of those is drawn next.
+        for (int c = 0; c < newCount; ++c)
+        {
+            const uint32_t vert = newCache[c];
+            cachePos[vert]    = (c < FORSYTH_CACHE_SIZE) ? c : -1;
+            vertexScore[vert] = ForsythScore(tables, cachePos[vert], liveTris[vert]);
+        }
+
+        best = -1;
+        float bestScore = -1.0f;
+        for (int c = 0; c < newCount; ++c)
+        {
+            const uint32_t vert = newCache[c];
+            const uint32_t* adj = &adjacency[adjStart[vert]];
+            for (uint32_t a = 0; a < liveTris[vert]; ++a)
+            {
+                const uint32_t t = adj[a];
+                const float score = vertexScore[indices[size_t(t) * 3]] +
+                                    vertexScore[indices[size_t(t) * 3 + 1]] +
+                                    vertexScore[indices[size_t(t) * 3 + 2]];
+                triScore[t] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+
+        cacheCount = (std::min)(newCount, FORSYTH_CACHE_SIZE);
+        std::memcpy(cache, newCache, sizeof(uint32_t) * cacheCount);
+    }
+
+    // A trailing partial triangle is kept as it was.
+    result.insert(result.end(), indices.begin() + triCount * 3, indices.end());
+    indices.swap(result);
+}
+
+void GeometryHelper::OptimizeOverdraw(
+    std::vector<unsigned int>&     indices,
+    const std::vector<XMFLOAT3>&   positions,
+    uint32_t                       cacheSize,
+    float                          threshold)
+{
+    // Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality
+    // and Reduced Overdraw": split the cache-ordered list into clusters
+    // where the cache restarts anyway, then draw clusters that face away
+    // from the mesh center first, so they occlude the inner ones.
+    const size_t   triCount    = indices.size() / 3;
+    const uint32_t vertexCount = static_cast<uint32_t>(positions.size());
+    if (triCount < 2 || vertexCount == 0 || cacheSize == 0) return;
+
+    std::vector<uint32_t> stamps(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+
+    // Hard boundaries: a triangle whose three vertices all miss.
+    std::vector<uint32_t> hard;
+    for (size_t t = 0; t < triCount; ++t)
+    {
+        if (FifoTriangle(&indices[t * 3], stamps, time, cacheSize) == 3)
+            hard.push_back(static_cast<uint32_t>(t));
+    }
+    if (hard.empty() || hard[0] != 0) hard.insert(hard.begin(), 0u);
+
+    // Soft boundaries: split inside a hard cluster where the running ACMR
+    // is already as good as the cluster's ACMR (times the threshold).
+    std::vector<uint32_t> clusters;
+    for (size_t h = 0; h < hard.size(); ++h)
+    {
+        const uint32_t begin = hard[h];
+        const uint32_t end   = (h + 1 < hard.size()) ? hard[h + 1] : static_cast<uint32_t>(triCount);
+
+        time += cacheSize + 1;
+        uint32_t clusterMisses = 0;
+        for (uint32_t t = begin; t < end; ++t)
+            clusterMisses += FifoTriangle(&indices[size_t(t) * 3], stamps, time, cacheSize);
+        const float limit = threshold * float(clusterMisses) / float(end - begin);
+
+        clusters.push_back(begin);
+        time += cacheSize + 1;
+        uint32_t runMisses = 0, runTris = 0;
+        for (uint32_t t = begin; t < end; ++t)
+        {
+            runMisses += FifoTriangle(&indices[size_t(t) * 3], stamps, time, cacheSize);
+            ++runTris;
+            if (t + 1 < end && float(runMisses) / float(runTris) <= limit)
+            {
+                clusters.push_back(t + 1);
+                time += cacheSize + 1;
+                runMisses = runTris = 0;
+            }
+        }
+    }
+    if (clusters.size() < 2) return;
+
+    XMVECTOR meshCenter = XMVectorZero();
+    for (const XMFLOAT3& p : positions) meshCenter = XMVectorAdd(meshCenter, XMLoadFloat3(&p));
+    meshCenter = XMVectorScale(meshCenter, 1.0f / float(vertexCount));
+
+    std::vector<float> sortKey(clusters.size());
+    for (size_t c = 0; c < clusters.size(); ++c)
+    {
+        const uint32_t begin = clusters[c];
+        const uint32_t end   = (c + 1 < clusters.size()) ? clusters[c + 1] : static_cast<uint32_t>(triCount);
+
+        XMVECTOR center = XMVectorZero();
+        XMVECTOR normal = XMVectorZero();
+        float    area   = 0.0f;
+        for (uint32_t t = begin; t < end; ++t)
+        {
+            const XMVECTOR p0 = XMLoadFloat3(&positions[indices[size_t(t) * 3]]);
+            const XMVECTOR p1 = XMLoadFloat3(&positions[indices[size_t(t) * 3 + 1]]);
+            const XMVECTOR p2 = XMLoadFloat3(&positions[indices[size_t(t) * 3 + 2]]);
+            const XMVECTOR n  = XMVector3Cross(XMVectorSubtract(p1, p0), XMVectorSubtract(p2, p0));
+            const float    a  = XMVectorGetX(XMVector3Length(n));
+
+            center = XMVectorAdd(center, XMVectorScale(XMVectorAdd(XMVectorAdd(p0, p1), p2), a / 3.0f));
+            normal = XMVectorAdd(normal, n);
+            area  += a;
+        }
+        if (area > 0.0f) center = XMVectorScale(center, 1.0f / area);
+
+        sortKey[c] = XMVectorGetX(XMVector3Dot(XMVectorSubtract(center, meshCenter), XMVector3Normalize(normal)));
+    }
+
+    std::vector<uint32_t> order(clusters.size());
+    for (uint32_t c = 0; c < order.size(); ++c) order[c] = c;
+    std::stable_sort(order.begin(), order.end(),
+        [&](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (uint32_t c : order)
+    {
+        const size_t begin = clusters[c];
+        const size_t end   = (c + 1 < clusters.size()) ? clusters[c + 1] : triCount;
+        result.insert(result.end(), indices.begin() + begin * 3, indices.begin() + end * 3);
+    }
+    result.insert(result.end(), indices.begin() + triCount * 3, indices.end());
+    indices.swap(result);
+}
+
+std::vector<uint32_t> GeometryHelper::OptimizeVertexFetch(std::vector<unsigned int>& indices, uint32_t vertexCount)
+{
+    constexpr uint32_t UNASSIGNED = 0xFFFFFFFFu;
+
+    std::vector<uint32_t> remap(vertexCount, UNASSIGNED);
+    uint32_t next = 0;
+    for (unsigned int& i : indices)
+    {
+        if (remap[i] == UNASSIGNED) remap[i] = next++;
+        i = remap[i];
+    }
+    for (uint32_t& r : remap)
+        if (r == UNASSIGNED) r = next++;
+    return remap;
+}
+
+GeometryOptimizeReport GeometryHelper::Optimize(Surface& surface, const GeometryOptimizeDesc& desc)
+{
+    GeometryOptimizeReport report;
+
+    std::vector<unsigned int> indices = surface.GetIndices();
+    const uint32_t vertexCount = surface.CountVertices();
+    if (indices.size() < 3 || vertexCount == 0) return report;
+
+    if (!IndicesValid(indices, vertexCount))
+    {
+        DBLOG("GeometryHelper.cpp: Optimize - index out of range, surface left unchanged");
+        return report;
+    }
+
+    report.before = AnalyzeVertexCache(indices, vertexCount, desc.cacheSize);
+
+    if (desc.vertexCache)
+        OptimizeVertexCache(indices, vertexCount);
+    if (desc.overdraw)
+        OptimizeOverdraw(indices, surface.GetPositions(), desc.cacheSize, desc.overdrawThreshold);
+
+    if (desc.vertexFetch)
+    {
+        // Attribute arrays that do not match the vertex count cannot be
+        // renumbered consistently; keep the vertex order in that case.
+        auto fits = [vertexCount](size_t n) { return n == 0 || n == vertexCount; };
+        if (fits(surface.CountNormals()) && fits(surface.CountColors()) &&
+            fits(surface.CountUV1()) && fits(surface.CountUV2()) &&
+            fits(surface.CountTangents()) &&
+            fits(surface.GetBoneIndices().size()) && fits(surface.GetBoneWeights().size()))
+        {
+            const std::vector<uint32_t> remap = OptimizeVertexFetch(indices, vertexCount);
+            surface.SetVertices(Remapped(surface.GetPositions(), remap));
+            surface.SetNormals(Remapped(surface.GetNormals(), remap));
+            surface.SetColors(Remapped(surface.GetColors(), remap));
+            surface.SetTexCoords(Remapped(surface.GetUV1(), remap));
+            surface.SetTexCoords2(Remapped(surface.GetUV2(), remap));
+            surface.SetTangents(Remapped(surface.GetTangents(), remap));
+            surface.SetBoneData(Remapped(surface.GetBoneIndices(), remap),
+                                Remapped(surface.GetBoneWeights(), remap));
+        }
+        else
+        {
+            DBLOG("GeometryHelper.cpp: Optimize - attribute count differs from vertex count, vertex fetch pass skipped");
+        }
+    }
+
+    report.after     = AnalyzeVertexCache(indices, vertexCount, desc.cacheSize);
+    report.optimized = true;
+    surface.SetIndices(std::move(indices));
+
+    DBLOG("GeometryHelper.cpp: Optimize - ", (int)report.before.triangles, " triangles, ACMR ",
+          report.before.acmr, " -> ", report.after.acmr, ", ATVR ", report.before.atvr, " -> ", report.after.atvr);
+    return report;
+}
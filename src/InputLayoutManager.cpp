@@ -1,4 +1,5 @@
 #include "InputLayoutManager.h"
+#include "VertexPacker.h"
 
 InputLayoutManager::InputLayoutManager() : m_device(nullptr) {}
 
@@ -64,6 +65,12 @@ HRESULT InputLayoutManager::CreateInputLayoutVertex(ID3D11InputLayout** layout,
         layoutElements.push_back({ "BLENDWEIGHT", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, cnt, D3D11_APPEND_ALIGNED_ELEMENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
         cnt++;
     }
+    // Per-instance world matrix: four float4 rows in one extra slot, advanced once per instance
+    if (flags & D3DVERTEX_INSTANCE_WORLD) {
+        for (unsigned int row = 0; row < 4; ++row)
+            layoutElements.push_back({ "INSTANCE_WORLD", row, DXGI_FORMAT_R32G32B32A32_FLOAT, cnt, static_cast<UINT>(row * sizeof(DirectX::XMFLOAT4)), D3D11_INPUT_PER_INSTANCE_DATA, 1 });
+        cnt++;
+    }
 
     void* bytecode = shader->blobVS->GetBufferPointer();
     unsigned int size = (unsigned int)shader->blobVS->GetBufferSize();
@@ -81,5 +88,48 @@ HRESULT InputLayoutManager::CreateInputLayoutVertex(ID3D11InputLayout** layout,
         return hr;
     }
 
+    // Packed variant while the VS blob is still alive; surfaces without
+    // packed buffers never need it, so a failure is not fatal.
+    Memory::SafeRelease(shader->inputlayoutPacked);
+    if (FAILED(CreateInputLayoutPacked(&shader->inputlayoutPacked, shader, flags)))
+        DBLOG("CreateInputLayout: packed layout not available for this shader");
+
+    return hr;
+}
+
+HRESULT InputLayoutManager::CreateInputLayoutPacked(ID3D11InputLayout** layout, SHADER* shader, DWORD flags)
+{
+    if (!layout || !shader || !shader->blobVS || shader->blobVS->GetBufferSize() == 0)
+        return E_INVALIDARG;
+
+    std::vector<D3D11_INPUT_ELEMENT_DESC> layoutElements;
+
+    if (flags & D3DVERTEX_POSITION)
+        layoutElements.push_back({ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, VertexPacker::OFFSET_POSITION, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+    if (flags & D3DVERTEX_NORMAL)
+        layoutElements.push_back({ "NORMAL", 0, DXGI_FORMAT_R8G8B8A8_SNORM, 0, VertexPacker::OFFSET_NORMAL, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+    if (flags & D3DVERTEX_TANGENT)
+        layoutElements.push_back({ "TANGENT", 0, DXGI_FORMAT_R8G8B8A8_SNORM, 0, VertexPacker::OFFSET_TANGENT, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+    if (flags & D3DVERTEX_COLOR)
+        layoutElements.push_back({ "COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, VertexPacker::OFFSET_COLOR, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+    if (flags & D3DVERTEX_TEX1)
+        layoutElements.push_back({ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, VertexPacker::OFFSET_UV1, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+    if (flags & D3DVERTEX_TEX2)
+        layoutElements.push_back({ "TEXCOORD", 1, DXGI_FORMAT_R16G16_FLOAT, 0, VertexPacker::OFFSET_UV2, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+    if (flags & D3DVERTEX_BONE_INDICES)
+        layoutElements.push_back({ "BLENDINDICES", 0, DXGI_FORMAT_R8G8B8A8_UINT, 0, VertexPacker::OFFSET_BONE_INDICES, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+    if (flags & D3DVERTEX_BONE_WEIGHTS)
+        layoutElements.push_back({ "BLENDWEIGHT", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, VertexPacker::OFFSET_BONE_WEIGHTS, D3D11_INPUT_PER_VERTEX_DATA, 0 });
+    if (flags & D3DVERTEX_INSTANCE_WORLD)
+    {
+        for (unsigned int row = 0; row < 4; ++row)
+            layoutElements.push_back({ "INSTANCE_WORLD", row, DXGI_FORMAT_R32G32B32A32_FLOAT, 1, static_cast<UINT>(row * sizeof(DirectX::XMFLOAT4)), D3D11_INPUT_PER_INSTANCE_DATA, 1 });
+    }
+
+    HRESULT hr = m_device->CreateInputLayout(layoutElements.data(), (unsigned int)layoutElements.size(),
+        shader->blobVS->GetBufferPointer(), (unsigned int)shader->blobVS->GetBufferSize(), layout);
+    if (FAILED(hr))
+        DBLOG_HR(hr);
+
     return hr;
 }
\ No newline at end of file
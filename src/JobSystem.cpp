@@ -0,0 +1,151 @@
+#include "JobSystem.h"
+#include "gdxutil.h"
+
+JobSystem::~JobSystem()
+{
+    Stop();
+}
+
+void JobSystem::Start(unsigned int threadCount)
+{
+    Stop();
+
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0)
+        threadCount = 1;
+
+    m_queues.clear();
+    for (unsigned int i = 0; i < threadCount; ++i)
+        m_queues.push_back(std::make_unique<JobQueue>());
+
+    m_running.store(true, std::memory_order_release);
+
+    for (unsigned int i = 1; i < threadCount; ++i)
+        m_workers.emplace_back(&JobSystem::WorkerMain, this, i);
+
+    DBLOG("JobSystem.cpp: started with ", threadCount, " thread(s)");
+}
+
+void JobSystem::Stop()
+{
+    if (!m_running.exchange(false)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wakeCv.notify_all();
+
+    for (std::thread& t : m_workers)
+        if (t.joinable()) t.join();
+
+    m_workers.clear();
+    m_queues.clear();
+    m_queued.store(0);
+}
+
+bool JobSystem::PopLocal(unsigned int queueIndex, Job& out)
+{
+    JobQueue& q = *m_queues[queueIndex];
+    std::lock_guard<std::mutex> lock(q.mutex);
+    if (q.jobs.empty()) return false;
+
+    out = q.jobs.back();
+    q.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::Steal(unsigned int thiefIndex, Job& out)
+{
+    const unsigned int count = static_cast<unsigned int>(m_queues.size());
+    for (unsigned int n = 1; n < count; ++n)
+    {
+        JobQueue& q = *m_queues[(thiefIndex + n) % count];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.jobs.empty()) continue;
+
+        out = q.jobs.front();
+        q.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::TryRunOne(unsigned int queueIndex)
+{
+    Job job;
+    if (!PopLocal(queueIndex, job) && !Steal(queueIndex, job))
+        return false;
+
+    m_queued.fetch_sub(1, std::memory_order_acq_rel);
+    (*job.func)(job.begin, job.end, job.chunk);
+    job.pending->fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void JobSystem::WorkerMain(unsigned int queueIndex)
+{
+    while (m_running.load(std::memory_order_acquire))
+    {
+        if (TryRunOne(queueIndex))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCv.wait(lock, [this] {
+            return !m_running.load(std::memory_order_acquire) ||
+                   m_queued.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+void JobSystem::ParallelFor(uint32_t count, uint32_t chunkCount, const RangeFunc& func)
+{
+    if (count == 0) return;
+    if (chunkCount == 0) chunkCount = 1;
+    if (chunkCount > count) chunkCount = count;
+
+    // No workers: run inline, same chunking so per-chunk outputs stay identical.
+    if (m_queues.size() <= 1 || chunkCount == 1)
+    {
+        for (uint32_t c = 0; c < chunkCount; ++c)
+        {
+            const uint32_t begin = static_cast<uint32_t>((uint64_t)count * c / chunkCount);
+            const uint32_t end   = static_cast<uint32_t>((uint64_t)count * (c + 1) / chunkCount);
+            func(begin, end, c);
+        }
+        return;
+    }
+
+    std::atomic<uint32_t> pending{ chunkCount };
+    const unsigned int queueCount = static_cast<unsigned int>(m_queues.size());
+
+    // Count first so a fast thief never decrements below zero.
+    m_queued.fetch_add(chunkCount, std::memory_order_acq_rel);
+
+    for (uint32_t c = 0; c < chunkCount; ++c)
+    {
+        Job job;
+        job.func    = &func;
+        job.begin   = static_cast<uint32_t>((uint64_t)count * c / chunkCount);
+        job.end     = static_cast<uint32_t>((uint64_t)count * (c + 1) / chunkCount);
+        job.chunk   = c;
+        job.pending = &pending;
+
+        JobQueue& q = *m_queues[c % queueCount];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        q.jobs.push_back(job);
+    }
+
+    {
+        // Pairs with the predicate check in WorkerMain (no lost wake-up).
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+    }
+    m_wakeCv.notify_all();
+
+    // The calling thread works as queue 0 until every chunk has finished.
+    while (pending.load(std::memory_order_acquire) > 0)
+    {
+        if (!TryRunOne(0))
+            std::this_thread::yield();
+    }
+}
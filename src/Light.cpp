@@ -1,6 +1,8 @@
 // Light.cpp: No DX11. GPU upload goes through lightGpuData->Upload().
 #include "Light.h"
+#ifdef _WIN32
 #include "Dx11LightGpuData.h"
+#endif
 
 Light::Light() : Entity(EntityType::Light), lightType(LightType::Directional)
 {
@@ -14,7 +16,9 @@ Light::Light() : Entity(EntityType::Light), lightType(LightType::Directional)
 
 Light::~Light()
 {
+#ifdef _WIN32
     delete lightGpuData;
+#endif
     lightGpuData = nullptr;
 }
 
@@ -136,5 +140,7 @@ void Light::UpdateLight(const GDXDevice* device, DirectX::XMVECTOR position, Dir
 
     DirectX::XMStoreFloat4(&cbLight.lightDirection, lookAt);
 
+#ifdef _WIN32
     if (lightGpuData) lightGpuData->Upload(device, cbLight);
+#endif
 }
@@ -1,7 +1,9 @@
 // Material.cpp: Pure data container. No DX11.
 #include "gdxutil.h"
 #include "Material.h"
+#ifdef _WIN32
 #include "Dx11MaterialGpuData.h"
+#endif
 
 static float Clamp01(float v)
 {
@@ -42,7 +44,9 @@ Material::Material() :
 
 Material::~Material()
 {
+#ifdef _WIN32
     delete gpuData;
+#endif
     gpuData = nullptr;
 }
 
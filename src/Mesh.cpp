@@ -3,9 +3,13 @@
 #include "Surface.h"
 #include "MeshAsset.h"
 #include "GeometryHelper.h"
+#ifdef _WIN32
 #include "Dx11EntityGpuData.h"
+#endif
 using namespace DirectX;
 
+uint32_t Mesh::s_frame = 1;
+
 Mesh::Mesh() :
     Entity(EntityType::Mesh)
 {
@@ -13,30 +17,29 @@ Mesh::Mesh() :
 
 Mesh::~Mesh()
 {
+#ifdef _WIN32
     if (boneConstantBuffer)
     {
         boneConstantBuffer->Release();
         boneConstantBuffer = nullptr;
     }
+#endif
 }
 
 void Mesh::Update(const GDXDevice* device)
 {
     Entity::Update(device);
-
-    if (collisionType != COLLISION::NONE)
-        CalculateOBB(0);
+    UpdateOBB();
 }
 
-void Mesh::Update(const GDXDevice* device, const MatrixSet* inMatrixSet)
+void Mesh::Update(const GDXDevice* device, const EntityConstants* constants)
 {
     if (!isActive) return;
-    if (!device || !inMatrixSet) return;
+    if (!device || !constants) return;
 
-    if (collisionType != COLLISION::NONE)
-        CalculateOBB(0);
-
-    if (gpuData) gpuData->Upload(device, *inMatrixSet);
+#ifdef _WIN32
+    if (gpuData) gpuData->Upload(device, *constants);
+#endif
 }
 
 Surface* Mesh::GetSurface(unsigned int n)
@@ -71,46 +74,102 @@ void Mesh::RemoveSurface(Surface* surface)
 void Mesh::SetCollisionMode(COLLISION collision)
 {
     collisionType = collision;
+    UpdateOBB();
 }
 
 void Mesh::CalculateOBB(unsigned int index)
 {
-    XMFLOAT3 minSize{ 0.0f, 0.0f, 0.0f };
-    XMFLOAT3 maxSize{ 0.0f, 0.0f, 0.0f };
+    (void)index;
+    m_obbValid = false;
+    RefreshOBB();
+}
+
+void Mesh::UpdateOBB()
+{
+    if (collisionType != COLLISION::NONE)
+        RefreshOBB();
+}
 
-    Surface* s0 = m_meshRenderer.GetAsset() ? m_meshRenderer.GetAsset()->GetSlot(0) : nullptr;
+void Mesh::RefreshOBB()
+{
+    const MeshAsset* asset = m_meshRenderer.GetAsset();
+    Surface* s0 = asset ? asset->GetSlot(0) : nullptr;
     if (!s0) return;
 
-    GeometryHelper::CalculateSize(*s0, XMMatrixIdentity(), minSize, maxSize);
+    const XMMATRIX world     = GetWorldMatrix();
+    const uint64_t signature = asset->GetGeometrySignature();
+    const bool sameGeometry  = m_obbValid && asset == m_obbAsset && signature == m_obbSignature;
 
-    XMFLOAT3 extents{
-        (maxSize.x - minSize.x) / 2.0f,
-        (maxSize.y - minSize.y) / 2.0f,
-        (maxSize.z - minSize.z) / 2.0f
-    };
+    if (sameGeometry &&
+        XMVector4Equal(world.r[0], m_obbWorld.r[0]) &&
+        XMVector4Equal(world.r[1], m_obbWorld.r[1]) &&
+        XMVector4Equal(world.r[2], m_obbWorld.r[2]) &&
+        XMVector4Equal(world.r[3], m_obbWorld.r[3]))
+        return;
 
-    XMMATRIX scalingMatrix = transform.GetScaling();
-    float scaleX = XMVectorGetX(scalingMatrix.r[0]);
-    float scaleY = XMVectorGetY(scalingMatrix.r[1]);
-    float scaleZ = XMVectorGetZ(scalingMatrix.r[2]);
+    if (!sameGeometry)
+    {
+        XMFLOAT3 minSize{ 0.0f, 0.0f, 0.0f };
+        XMFLOAT3 maxSize{ 0.0f, 0.0f, 0.0f };
+        GeometryHelper::CalculateSize(*s0, XMMatrixIdentity(), minSize, maxSize);
+
+        m_obbExtents = XMFLOAT3(
+            (maxSize.x - minSize.x) / 2.0f,
+            (maxSize.y - minSize.y) / 2.0f,
+            (maxSize.z - minSize.z) / 2.0f);
+        m_obbAsset     = asset;
+        m_obbSignature = signature;
+    }
 
-    extents.x *= scaleX;
-    extents.y *= scaleY;
-    extents.z *= scaleZ;
+    // Centered on the pivot; Transform takes rotation, per-axis scale and
+    // translation from the world matrix.
+    const BoundingOrientedBox local(XMFLOAT3(0.0f, 0.0f, 0.0f), m_obbExtents, XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f));
+    local.Transform(obb, world);
 
-    XMFLOAT3 pos;
-    XMStoreFloat3(&pos, transform.GetPosition());
-    XMVECTOR quat = XMQuaternionRotationMatrix(transform.GetRotation());
-    XMFLOAT4 quatFloat;
-    XMStoreFloat4(&quatFloat, quat);
+    m_obbWorld = world;
+    m_obbValid = true;
+}
+
+bool Mesh::GetWorldBounds(const XMMATRIX& world, BoundingBox& outBounds)
+{
+    const MeshAsset* asset = m_meshRenderer.GetAsset();
+    if (!asset) return false;
+
+    const uint64_t signature = asset->GetGeometrySignature();
+    if (!m_localBoundsValid || asset != m_boundsAsset || signature != m_boundsSignature)
+    {
+        m_hasGeometry      = asset->ComputeLocalBounds(m_localBounds);
+        m_boundsAsset      = asset;
+        m_boundsSignature  = signature;
+        m_localBoundsValid = true;
+        m_worldBoundsValid = false;
+    }
 
-    obb = BoundingOrientedBox(pos, extents,
-        XMFLOAT4(quatFloat.x, quatFloat.y, quatFloat.z, quatFloat.w));
+    if (!m_hasGeometry) return false;
+
+    const bool sameWorld =
+        XMVector4Equal(world.r[0], m_boundsWorld.r[0]) &&
+        XMVector4Equal(world.r[1], m_boundsWorld.r[1]) &&
+        XMVector4Equal(world.r[2], m_boundsWorld.r[2]) &&
+        XMVector4Equal(world.r[3], m_boundsWorld.r[3]);
+
+    if (!m_worldBoundsValid || !sameWorld)
+    {
+        m_localBounds.Transform(m_worldBounds, world);
+        m_boundsWorld      = world;
+        m_worldBoundsValid = true;
+    }
+
+    outBounds = m_worldBounds;
+    return true;
 }
 
 bool Mesh::CheckCollision(Mesh* mesh)
 {
     if (collisionType == COLLISION::NONE || mesh->collisionType == COLLISION::NONE)
         return false;
+
+    UpdateOBB();
+    mesh->UpdateOBB();
     return obb.Intersects(mesh->obb);
 }
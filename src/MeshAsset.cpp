@@ -1,12 +1,22 @@
 #include "MeshAsset.h"
 #include "Surface.h"
+#include "RenderRevision.h"
 #include <algorithm>
+#include <cfloat>
+
+using namespace DirectX;
+
+void MeshAsset::TouchAssets() noexcept
+{
+    if (m_revisions) m_revisions->TouchAssets();
+}
 
 void MeshAsset::AddSlot(Surface* surface)
 {
     if (!surface) return;
 
     m_slots.push_back(surface);
+    TouchAssets();
 }
 
 void MeshAsset::RemoveSlot(Surface* surface)
@@ -16,9 +26,60 @@ void MeshAsset::RemoveSlot(Surface* surface)
         if (slot == surface)
         {
             slot = nullptr;
+            TouchAssets();
             return;
         }
     }
+
+    for (auto& lod : m_lods)
+    {
+        for (auto& slot : lod.slots)
+        {
+            if (slot == surface)
+            {
+                slot = nullptr;
+                TouchAssets();
+                return;
+            }
+        }
+    }
+}
+
+void MeshAsset::AddLod(const std::vector<Surface*>& slots, float screenSize)
+{
+    m_lods.push_back({ slots, screenSize });
+    TouchAssets();
+}
+
+void MeshAsset::ClearLods()
+{
+    if (m_lods.empty()) return;
+    m_lods.clear();
+    TouchAssets();
+}
+
+Surface* MeshAsset::GetLodSlot(uint32_t lod, unsigned int slot) const
+{
+    for (uint32_t level = (std::min)(lod, static_cast<uint32_t>(m_lods.size())); level > 0; --level)
+    {
+        const std::vector<Surface*>& slots = m_lods[level - 1].slots;
+        if (slot < slots.size() && slots[slot])
+            return slots[slot];
+    }
+    return GetSlot(slot);
+}
+
+uint32_t MeshAsset::SelectLod(float screenSize, uint32_t current, float hysteresis) const noexcept
+{
+    const uint32_t count = static_cast<uint32_t>(m_lods.size());
+    uint32_t lod = (std::min)(current, count);
+
+    // m_lods[lod] holds the threshold of level lod + 1.
+    while (lod < count && screenSize < m_lods[lod].screenSize * (1.0f - hysteresis))
+        ++lod;
+    while (lod > 0 && screenSize > m_lods[lod - 1].screenSize * (1.0f + hysteresis))
+        --lod;
+    return lod;
 }
 
 Surface* MeshAsset::GetSlot(unsigned int i) const
@@ -56,3 +117,49 @@ unsigned int MeshAsset::NumActiveSlots() const
         if (s) ++count;
     return count;
 }
+
+bool MeshAsset::ComputeLocalBounds(BoundingBox& outBounds) const
+{
+    XMFLOAT3 minP(FLT_MAX, FLT_MAX, FLT_MAX);
+    XMFLOAT3 maxP(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    bool any = false;
+
+    for (const Surface* s : m_slots)
+    {
+        if (!s) continue;
+        if (s->IsGpuOnly() && s->CountGpuVertices() > 0)
+        {
+            const XMFLOAT3& lo = s->GetGpuBoundsMin();
+            const XMFLOAT3& hi = s->GetGpuBoundsMax();
+            minP.x = (std::min)(minP.x, lo.x);  maxP.x = (std::max)(maxP.x, hi.x);
+            minP.y = (std::min)(minP.y, lo.y);  maxP.y = (std::max)(maxP.y, hi.y);
+            minP.z = (std::min)(minP.z, lo.z);  maxP.z = (std::max)(maxP.z, hi.z);
+            any = true;
+        }
+        for (const XMFLOAT3& p : s->GetPositions())
+        {
+            minP.x = (std::min)(minP.x, p.x);  maxP.x = (std::max)(maxP.x, p.x);
+            minP.y = (std::min)(minP.y, p.y);  maxP.y = (std::max)(maxP.y, p.y);
+            minP.z = (std::min)(minP.z, p.z);  maxP.z = (std::max)(maxP.z, p.z);
+            any = true;
+        }
+    }
+
+    if (!any) return false;
+
+    BoundingBox::CreateFromPoints(outBounds, XMLoadFloat3(&minP), XMLoadFloat3(&maxP));
+    return true;
+}
+
+uint64_t MeshAsset::GetGeometrySignature() const
+{
+    uint64_t sig = static_cast<uint64_t>(m_slots.size()) << 48;
+    for (const Surface* s : m_slots)
+    {
+        sig = sig * 1099511628211ull;
+        if (s) sig ^= static_cast<uint64_t>(s->CountVertices() + s->CountGpuVertices()) + (static_cast<uint64_t>(s->id) << 32);
+        sig = sig * 1099511628211ull;
+        if (s) sig ^= s->GetGeometryRevision();
+    }
+    return sig;
+}
@@ -0,0 +1,556 @@
+#include "MeshFile.h"
+#include "MeshAsset.h"
+#include "Surface.h"
+#include "SurfaceGpuBuffer.h"
+#include "AssetManager.h"
+#include "BufferManager.h"
+#include "VertexPacker.h"
+#include "gdxutil.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+    constexpr uint32_t ELEMENT_SIZE[MESHFILE_STREAM_COUNT] =
+    {
+        sizeof(XMFLOAT3), // position
+        sizeof(XMFLOAT3), // normal
+        sizeof(XMFLOAT4), // tangent
+        sizeof(XMFLOAT4), // color
+        sizeof(XMFLOAT2), // uv1
+        sizeof(XMFLOAT2), // uv2
+        sizeof(XMUINT4),  // bone indices
+        sizeof(XMFLOAT4), // bone weights
+        0,                // packed: MeshFileSlot::packedStride
+        0,                // index:  MeshFileSlot::indexSize
+    };
+
+    uint64_t AlignOffset(uint64_t offset) noexcept
+    {
+        return (offset + MESHFILE_ALIGNMENT - 1) & ~static_cast<uint64_t>(MESHFILE_ALIGNMENT - 1);
+    }
+
+    // A mapped block as a span for the Surface bulk API (keepCpuGeometry).
+    // Empty when the slot has no such stream.
+    template<typename T>
+    std::span<const T> StreamSpan(const MappedMeshFile& file, uint32_t slot, MeshFileStream stream,
+                                  uint32_t count)
+    {
+        const T* data = static_cast<const T*>(file.GetStream(slot, stream));
+        return data ? std::span<const T>(data, count) : std::span<const T>();
+    }
+}
+
+// ==================== MappedMeshFile ====================
+
+MappedMeshFile::~MappedMeshFile()
+{
+    Close();
+}
+
+bool MappedMeshFile::Open(const wchar_t* filename)
+{
+    Close();
+    if (!filename) return false;
+
+    m_file = CreateFileW(filename, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+    {
+        DBLOG_WIN32();
+        DBERROR("MeshFile.cpp: Open - cannot open file");
+        return false;
+    }
+
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(m_file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(MeshFileHeader)) ||
+        static_cast<uint64_t>(size.QuadPart) > SIZE_MAX)
+    {
+        DBERROR("MeshFile.cpp: Open - file too small or too large");
+        Close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping)
+        m_view = static_cast<const uint8_t*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_view)
+    {
+        DBLOG_WIN32();
+        DBERROR("MeshFile.cpp: Open - cannot map file");
+        Close();
+        return false;
+    }
+
+    if (!Validate(static_cast<uint64_t>(size.QuadPart)))
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedMeshFile::Close()
+{
+    if (m_view)    UnmapViewOfFile(m_view);
+    if (m_mapping) CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE) CloseHandle(m_file);
+
+    m_file    = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+    m_view    = nullptr;
+    m_header  = nullptr;
+    m_slots   = nullptr;
+}
+
+// Everything the accessors and the loader rely on is checked here once, so
+// a truncated or foreign file is rejected before any pointer is handed out.
+bool MappedMeshFile::Validate(uint64_t size)
+{
+    m_header = reinterpret_cast<const MeshFileHeader*>(m_view);
+
+    if (m_header->magic != MESHFILE_MAGIC || m_header->version != MESHFILE_VERSION ||
+        m_header->headerSize != sizeof(MeshFileHeader) || m_header->slotSize != sizeof(MeshFileSlot))
+    {
+        DBERROR("MeshFile.cpp: Open - not a .oymesh file of version ", MESHFILE_VERSION);
+        return false;
+    }
+    if (m_header->fileSize != size)
+    {
+        DBERROR("MeshFile.cpp: Open - file size mismatch (truncated?)");
+        return false;
+    }
+
+    const uint64_t tableEnd = sizeof(MeshFileHeader) + static_cast<uint64_t>(m_header->slotCount) * sizeof(MeshFileSlot);
+    if (tableEnd > size)
+    {
+        DBERROR("MeshFile.cpp: Open - slot table out of range");
+        return false;
+    }
+    m_slots = reinterpret_cast<const MeshFileSlot*>(m_view + sizeof(MeshFileHeader));
+
+    for (uint32_t i = 0; i < m_header->slotCount; ++i)
+    {
+        const MeshFileSlot& slot = m_slots[i];
+
+        const bool packedOk = slot.packedStride == 0 ||
+                              slot.packedStride == VertexPacker::STRIDE ||
+                              slot.packedStride == VertexPacker::STRIDE_SKINNED;
+        if ((slot.indexSize != 2 && slot.indexSize != 4) || !packedOk || slot.indexCount % 3 != 0)
+        {
+            DBERROR("MeshFile.cpp: Open - slot ", i, " has an invalid format");
+            return false;
+        }
+
+        if (slot.vertexCount > 0 &&
+            (slot.indexCount == 0 || !slot.offsets[MESHFILE_STREAM_INDEX] ||
+             (!slot.offsets[MESHFILE_STREAM_POSITION] && !slot.offsets[MESHFILE_STREAM_PACKED])))
+        {
+            DBERROR("MeshFile.cpp: Open - slot ", i, " lacks positions or indices");
+            return false;
+        }
+        if ((slot.offsets[MESHFILE_STREAM_PACKED] != 0) != (slot.packedStride != 0))
+        {
+            DBERROR("MeshFile.cpp: Open - slot ", i, " packed stride mismatch");
+            return false;
+        }
+
+        for (uint32_t s = 0; s < MESHFILE_STREAM_COUNT; ++s)
+        {
+            const uint64_t offset = slot.offsets[s];
+            if (offset == 0) continue;
+
+            const uint64_t bytes = GetStreamSize(slot, static_cast<MeshFileStream>(s));
+            if (offset < tableEnd || offset % MESHFILE_ALIGNMENT != 0 || bytes == 0 ||
+                bytes > size || offset > size - bytes)
+            {
+                DBERROR("MeshFile.cpp: Open - slot ", i, " stream ", s, " out of range");
+                return false;
+            }
+        }
+
+        // The GPU tolerates stray indices, CPU geometry users (picking,
+        // MeshSimplifier, StaticBatcher) would read past the vertices.
+        if (slot.offsets[MESHFILE_STREAM_INDEX] != 0 && MaxIndex(slot) >= slot.vertexCount)
+        {
+            DBERROR("MeshFile.cpp: Open - slot ", i, " has an index beyond its ", slot.vertexCount, " vertices");
+            return false;
+        }
+    }
+    return true;
+}
+
+uint32_t MappedMeshFile::MaxIndex(const MeshFileSlot& slot) const noexcept
+{
+    const uint8_t* data = m_view + slot.offsets[MESHFILE_STREAM_INDEX];
+    uint32_t maxIndex = 0;
+    if (slot.indexSize == 2)
+    {
+        const uint16_t* indices = reinterpret_cast<const uint16_t*>(data);
+        for (uint32_t k = 0; k < slot.indexCount; ++k)
+            maxIndex = (std::max)(maxIndex, static_cast<uint32_t>(indices[k]));
+    }
+    else
+    {
+        const uint32_t* indices = reinterpret_cast<const uint32_t*>(data);
+        for (uint32_t k = 0; k < slot.indexCount; ++k)
+            maxIndex = (std::max)(maxIndex, indices[k]);
+    }
+    return maxIndex;
+}
+
+const void* MappedMeshFile::GetStream(uint32_t slot, MeshFileStream stream) const noexcept
+{
+    if (!m_view || slot >= GetSlotCount() || stream >= MESHFILE_STREAM_COUNT) return nullptr;
+    const uint64_t offset = m_slots[slot].offsets[stream];
+    return offset ? m_view + offset : nullptr;
+}
+
+uint64_t MappedMeshFile::GetStreamSize(const MeshFileSlot& slot, MeshFileStream stream) noexcept
+{
+    switch (stream)
+    {
+    case MESHFILE_STREAM_PACKED: return static_cast<uint64_t>(slot.vertexCount) * slot.packedStride;
+    case MESHFILE_STREAM_INDEX:  return static_cast<uint64_t>(slot.indexCount) * slot.indexSize;
+    default:
+        return stream < MESHFILE_STREAM_COUNT ? static_cast<uint64_t>(slot.vertexCount) * ELEMENT_SIZE[stream] : 0;
+    }
+}
+
+// ==================== MeshFile ====================
+
+bool MeshFile::Write(const MeshAsset& asset, const wchar_t* filename, const MeshFileWriteDesc& desc)
+{
+    if (!filename) return false;
+    if (!desc.floatStreams && !desc.packedStream)
+    {
+        DBERROR("MeshFile.cpp: Write - no stream kind selected");
+        return false;
+    }
+
+    struct Block
+    {
+        const void* data   = nullptr;
+        uint64_t    size   = 0;
+        uint64_t    offset = 0;
+    };
+
+    const std::vector<Surface*>& surfaces = asset.GetSlots();
+    const uint32_t slotCount = static_cast<uint32_t>(surfaces.size());
+
+    MeshFileHeader header;
+    header.slotSize  = sizeof(MeshFileSlot);
+    header.slotCount = slotCount;
+
+    std::vector<MeshFileSlot> slots(slotCount);
+    std::vector<Block>        blocks;
+
+    // Tangent copies, packed vertices and 16-bit indices live here until the
+    // file is written (moving a vector keeps its data pointer).
+    std::vector<std::unique_ptr<Surface>> tangentSources;
+    std::vector<std::vector<uint8_t>>     scratch;
+
+    uint64_t offset = AlignOffset(sizeof(MeshFileHeader) + static_cast<uint64_t>(slotCount) * sizeof(MeshFileSlot));
+
+    auto addBlock = [&](MeshFileSlot& slot, MeshFileStream stream, const void* data, uint64_t size)
+    {
+        slot.offsets[stream] = offset;
+        blocks.push_back({ data, size, offset });
+        offset = AlignOffset(offset + size);
+    };
+
+    XMFLOAT3 assetMin( FLT_MAX,  FLT_MAX,  FLT_MAX);
+    XMFLOAT3 assetMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+    for (uint32_t i = 0; i < slotCount; ++i)
+    {
+        const Surface* surface = surfaces[i];
+        if (!surface || surface->CountVertices() == 0 || surface->CountIndices() < 3)
+        {
+            if (surface && surface->IsGpuOnly())
+                DBLOG("MeshFile.cpp: Write - slot ", i, " has no CPU geometry, stored empty");
+            continue;
+        }
+
+        const uint32_t vertexCount = surface->CountVertices();
+        MeshFileSlot&  slot        = slots[i];
+        slot.vertexCount = vertexCount;
+        slot.indexCount  = surface->CountIndices() - surface->CountIndices() % 3;
+
+        // Normal mapping needs tangents, and a GPU-only load cannot compute
+        // them later: write computed ones when the surface has none.
+        if (surface->CountTangents() != vertexCount)
+        {
+            auto copy = std::make_unique<Surface>();
+            copy->AddVertices(surface->GetPositions());
+            copy->AddNormals(surface->GetNormals());
+            copy->AddColors(surface->GetColors());
+            copy->AddTexCoords(surface->GetUV1());
+            copy->AddTexCoords2(surface->GetUV2());
+            copy->AddIndices(surface->GetIndices());
+            copy->AddBoneData(surface->GetBoneIndices(), surface->GetBoneWeights());
+            copy->ComputeTangents();
+            surface = copy.get();
+            tangentSources.push_back(std::move(copy));
+        }
+
+        XMFLOAT3 lo( FLT_MAX,  FLT_MAX,  FLT_MAX);
+        XMFLOAT3 hi(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (const XMFLOAT3& p : surface->GetPositions())
+        {
+            lo.x = (std::min)(lo.x, p.x);  hi.x = (std::max)(hi.x, p.x);
+            lo.y = (std::min)(lo.y, p.y);  hi.y = (std::max)(hi.y, p.y);
+            lo.z = (std::min)(lo.z, p.z);  hi.z = (std::max)(hi.z, p.z);
+        }
+        slot.boundsMin[0] = lo.x;  slot.boundsMin[1] = lo.y;  slot.boundsMin[2] = lo.z;
+        slot.boundsMax[0] = hi.x;  slot.boundsMax[1] = hi.y;  slot.boundsMax[2] = hi.z;
+        assetMin.x = (std::min)(assetMin.x, lo.x);  assetMax.x = (std::max)(assetMax.x, hi.x);
+        assetMin.y = (std::min)(assetMin.y, lo.y);  assetMax.y = (std::max)(assetMax.y, hi.y);
+        assetMin.z = (std::min)(assetMin.z, lo.z);  assetMax.z = (std::max)(assetMax.z, hi.z);
+
+        bool floatStreams = desc.floatStreams;
+        if (desc.packedStream)
+        {
+            scratch.emplace_back();
+            const uint32_t stride = VertexPacker::Pack(*surface, scratch.back());
+            if (stride > 0)
+            {
+                slot.packedStride = stride;
+                addBlock(slot, MESHFILE_STREAM_PACKED, scratch.back().data(), scratch.back().size());
+            }
+            else
+            {
+                floatStreams = true; // not packable: the slot still needs vertices
+            }
+        }
+
+        if (floatStreams)
+        {
+            auto addVertexStream = [&](MeshFileStream stream, const void* data, uint32_t count)
+            {
+                if (count == vertexCount)
+                    addBlock(slot, stream, data, static_cast<uint64_t>(count) * ELEMENT_SIZE[stream]);
+            };
+            addVertexStream(MESHFILE_STREAM_POSITION,     surface->GetPositions().data(),   surface->CountVertices());
+            addVertexStream(MESHFILE_STREAM_NORMAL,       surface->GetNormals().data(),     surface->CountNormals());
+            addVertexStream(MESHFILE_STREAM_TANGENT,      surface->GetTangents().data(),    surface->CountTangents());
+            addVertexStream(MESHFILE_STREAM_COLOR,        surface->GetColors().data(),      surface->CountColors());
+            addVertexStream(MESHFILE_STREAM_UV1,          surface->GetUV1().data(),         surface->CountUV1());
+            addVertexStream(MESHFILE_STREAM_UV2,          surface->GetUV2().data(),         surface->CountUV2());
+            addVertexStream(MESHFILE_STREAM_BONE_INDICES, surface->GetBoneIndices().data(), surface->CountBoneData());
+            addVertexStream(MESHFILE_STREAM_BONE_WEIGHTS, surface->GetBoneWeights().data(), surface->CountBoneData());
+        }
+
+        // Same rule as SurfaceGpuBuffer::CreateIndexBuffer: 16 bit whenever
+        // every index fits, so the loader uploads the block unchanged.
+        const std::vector<unsigned int>& indices = surface->GetIndices();
+        const unsigned int maxIndex = *std::max_element(indices.begin(), indices.begin() + slot.indexCount);
+        if (maxIndex >= vertexCount)
+        {
+            DBERROR("MeshFile.cpp: Write - slot ", i, " has an index past its vertices");
+            return false;
+        }
+
+        if (maxIndex <= 0xFFFFu)
+        {
+            scratch.emplace_back(static_cast<size_t>(slot.indexCount) * sizeof(uint16_t));
+            uint16_t* out = reinterpret_cast<uint16_t*>(scratch.back().data());
+            for (uint32_t k = 0; k < slot.indexCount; ++k)
+                out[k] = static_cast<uint16_t>(indices[k]);
+            slot.indexSize = 2;
+            addBlock(slot, MESHFILE_STREAM_INDEX, out, scratch.back().size());
+        }
+        else
+        {
+            slot.indexSize = 4;
+            addBlock(slot, MESHFILE_STREAM_INDEX, indices.data(), static_cast<uint64_t>(slot.indexCount) * sizeof(uint32_t));
+        }
+    }
+
+    if (assetMin.x <= assetMax.x)
+    {
+        header.boundsMin[0] = assetMin.x;  header.boundsMin[1] = assetMin.y;  header.boundsMin[2] = assetMin.z;
+        header.boundsMax[0] = assetMax.x;  header.boundsMax[1] = assetMax.y;  header.boundsMax[2] = assetMax.z;
+    }
+    header.fileSize = blocks.empty() ? AlignOffset(sizeof(MeshFileHeader) + static_cast<uint64_t>(slotCount) * sizeof(MeshFileSlot))
+                                     : blocks.back().offset + blocks.back().size;
+
+    std::ofstream file(std::filesystem::path(filename), std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        DBERROR("MeshFile.cpp: Write - cannot create file");
+        return false;
+    }
+
+    static const char zeros[MESHFILE_ALIGNMENT] = {};
+    uint64_t written = 0;
+    auto write = [&](const void* data, uint64_t size)
+    {
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+        written += size;
+    };
+
+    write(&header, sizeof(header));
+    if (slotCount > 0) write(slots.data(), static_cast<uint64_t>(slotCount) * sizeof(MeshFileSlot));
+    for (const Block& block : blocks)
+    {
+        write(zeros, block.offset - written);
+        write(block.data, block.size);
+    }
+    write(zeros, header.fileSize - written);
+
+    if (!file)
+    {
+        DBERROR("MeshFile.cpp: Write - write failed");
+        return false;
+    }
+
+    DBLOG("MeshFile.cpp: Write - ", slotCount, " slot(s), ", header.fileSize, " bytes");
+    return true;
+}
+
+bool MeshFile::Load(const wchar_t* filename, MeshAsset& asset, AssetManager& assets,
+                    BufferManager& buffers, const MeshFileLoadDesc& desc)
+{
+    MappedMeshFile file;
+    if (!file.Open(filename)) return false;
+
+    bool ok = true;
+    for (uint32_t i = 0; i < file.GetSlotCount(); ++i)
+    {
+        const MeshFileSlot& info    = file.GetSlot(i);
+        Surface*            surface = assets.CreateSurface();
+        SurfaceGpuBuffer*   gpu     = static_cast<SurfaceGpuBuffer*>(surface->gpu.get());
+
+        if (info.vertexCount > 0)
+        {
+            const uint32_t vertexCount = info.vertexCount;
+            HRESULT hr = S_OK;
+
+            // D3D11 reads the initial data straight from the mapped view;
+            // the pages are faulted in by the copy into the GPU buffer.
+            auto upload = [&](MeshFileStream stream, ID3D11Buffer** buffer, unsigned int* stride)
+            {
+                const void* data = file.GetStream(i, stream);
+                if (!data || FAILED(hr)) return;
+                hr = buffers.CreateBuffer(data, ELEMENT_SIZE[stream], vertexCount, D3D11_BIND_VERTEX_BUFFER, buffer);
+                if (SUCCEEDED(hr) && stride) *stride = ELEMENT_SIZE[stream];
+            };
+
+            const bool hasFloat = file.GetStream(i, MESHFILE_STREAM_POSITION) != nullptr;
+            if (info.packedStride > 0 && (desc.packed || !hasFloat))
+            {
+                hr = buffers.CreateBuffer(file.GetStream(i, MESHFILE_STREAM_PACKED), info.packedStride,
+                                          vertexCount, D3D11_BIND_VERTEX_BUFFER, &gpu->packedBuffer);
+                if (SUCCEEDED(hr)) gpu->stridePacked = info.packedStride;
+            }
+            else
+            {
+                upload(MESHFILE_STREAM_POSITION,     &gpu->positionBuffer,   &gpu->stridePosition);
+                upload(MESHFILE_STREAM_NORMAL,       &gpu->normalBuffer,     &gpu->strideNormal);
+                upload(MESHFILE_STREAM_TANGENT,      &gpu->tangentBuffer,    &gpu->strideTangent);
+                upload(MESHFILE_STREAM_COLOR,        &gpu->colorBuffer,      &gpu->strideColor);
+                upload(MESHFILE_STREAM_UV1,          &gpu->uv1Buffer,        &gpu->strideUV1);
+                upload(MESHFILE_STREAM_UV2,          &gpu->uv2Buffer,        &gpu->strideUV2);
+                upload(MESHFILE_STREAM_BONE_INDICES, &gpu->boneIndexBuffer,  nullptr);
+                upload(MESHFILE_STREAM_BONE_WEIGHTS, &gpu->boneWeightBuffer, nullptr);
+            }
+
+            const void* indices = file.GetStream(i, MESHFILE_STREAM_INDEX);
+            if (SUCCEEDED(hr))
+            {
+                hr = (info.indexSize == 2)
+                    ? gpu->CreateIndexBuffer(buffers, static_cast<const uint16_t*>(indices), info.indexCount)
+                    : gpu->CreateIndexBuffer(buffers, static_cast<const unsigned int*>(indices), info.indexCount);
+            }
+
+            if (FAILED(hr))
+            {
+                DBLOG_HR(hr);
+                DBERROR("MeshFile.cpp: Load - GPU buffers for slot ", i, " failed");
+                gpu->Release();
+                ok = false;
+            }
+
+            if (desc.keepCpuGeometry)
+            {
+                if (hasFloat)
+                {
+                    surface->AddVertices(StreamSpan<XMFLOAT3>(file, i, MESHFILE_STREAM_POSITION, vertexCount));
+                    surface->AddNormals(StreamSpan<XMFLOAT3>(file, i, MESHFILE_STREAM_NORMAL, vertexCount));
+                    surface->AddTangents(StreamSpan<XMFLOAT4>(file, i, MESHFILE_STREAM_TANGENT, vertexCount));
+                    surface->AddColors(StreamSpan<XMFLOAT4>(file, i, MESHFILE_STREAM_COLOR, vertexCount));
+                    surface->AddTexCoords(StreamSpan<XMFLOAT2>(file, i, MESHFILE_STREAM_UV1, vertexCount));
+                    surface->AddTexCoords2(StreamSpan<XMFLOAT2>(file, i, MESHFILE_STREAM_UV2, vertexCount));
+                    surface->AddBoneData(StreamSpan<XMUINT4>(file, i, MESHFILE_STREAM_BONE_INDICES, vertexCount),
+                                         StreamSpan<XMFLOAT4>(file, i, MESHFILE_STREAM_BONE_WEIGHTS, vertexCount));
+                }
+                else
+                {
+                    const uint8_t* packed = static_cast<const uint8_t*>(file.GetStream(i, MESHFILE_STREAM_PACKED));
+                    const bool skinned = info.packedStride >= VertexPacker::STRIDE_SKINNED;
+                    std::vector<XMFLOAT3> positions(vertexCount);
+                    std::vector<XMFLOAT3> normals(vertexCount);
+                    std::vector<XMFLOAT4> tangents(vertexCount);
+                    std::vector<XMFLOAT4> colors(vertexCount);
+                    std::vector<XMFLOAT2> uv1(vertexCount);
+                    std::vector<XMFLOAT2> uv2(vertexCount);
+                    std::vector<XMUINT4>  boneIndices(skinned ? vertexCount : 0);
+                    std::vector<XMFLOAT4> boneWeights(skinned ? vertexCount : 0);
+                    for (uint32_t v = 0; v < vertexCount; ++v)
+                    {
+                        UnpackedVertex u;
+                        VertexPacker::Unpack(packed + static_cast<size_t>(v) * info.packedStride, info.packedStride, u);
+                        positions[v] = u.position;
+                        normals[v]   = u.normal;
+                        tangents[v]  = u.tangent;
+                        colors[v]    = u.color;
+                        uv1[v]       = u.uv1;
+                        uv2[v]       = u.uv2;
+                        if (skinned)
+                        {
+                            boneIndices[v] = u.boneIndices;
+                            boneWeights[v] = u.boneWeights;
+                        }
+                    }
+                    surface->SetVertices(std::move(positions));
+                    surface->SetNormals(std::move(normals));
+                    surface->SetTangents(std::move(tangents));
+                    surface->SetColors(std::move(colors));
+                    surface->SetTexCoords(std::move(uv1));
+                    surface->SetTexCoords2(std::move(uv2));
+                    surface->SetBoneData(std::move(boneIndices), std::move(boneWeights));
+                }
+
+                if (info.indexSize == 2)
+                {
+                    const uint16_t* src = static_cast<const uint16_t*>(indices);
+                    surface->SetIndices(std::vector<unsigned int>(src, src + info.indexCount));
+                }
+                else
+                {
+                    surface->AddIndices(std::span<const unsigned int>(static_cast<const unsigned int*>(indices), info.indexCount));
+                }
+            }
+            else
+            {
+                surface->SetGpuOnly(vertexCount, info.indexCount,
+                    XMFLOAT3(info.boundsMin[0], info.boundsMin[1], info.boundsMin[2]),
+                    XMFLOAT3(info.boundsMax[0], info.boundsMax[1], info.boundsMax[2]));
+            }
+        }
+
+        asset.AddSlot(surface);
+    }
+
+    DBLOG("MeshFile.cpp: Load - ", file.GetSlotCount(), " slot(s), ", file.GetHeader().fileSize, " bytes");
+    return ok;
+}
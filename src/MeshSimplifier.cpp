@@ -0,0 +1,374 @@
+#include "MeshSimplifier.h"
+#include "Surface.h"
+#include "gdxutil.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+using namespace DirectX;
+
+namespace
+{
+    // Symmetric 4x4 plane quadric, accumulated with area weights. w is the
+    // total weight, so Eval()/w is a mean squared distance.
+    struct Quadric
+    {
+        double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+        double b0 = 0, b1 = 0, b2 = 0, c = 0, w = 0;
+
+        void AddPlane(double nx, double ny, double nz, double d, double weight) noexcept
+        {
+            a00 += weight * nx * nx; a01 += weight * nx * ny; a02 += weight * nx * nz;
+            a11 += weight * ny * ny; a12 += weight * ny * nz; a22 += weight * nz * nz;
+            b0  += weight * nx * d;  b1  += weight * ny * d;  b2  += weight * nz * d;
+            c   += weight * d * d;
+            w   += weight;
+        }
+
+        void Add(const Quadric& q) noexcept
+        {
+            a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+            b0 += q.b0; b1 += q.b1; b2 += q.b2; c += q.c; w += q.w;
+        }
+
+        double Eval(const XMFLOAT3& p) const noexcept
+        {
+            const double x = p.x, y = p.y, z = p.z;
+            const double r = a00 * x * x + a11 * y * y + a22 * z * z +
+                             2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                             2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            return r > 0.0 ? r : 0.0;
+        }
+    };
+
+    struct Collapse
+    {
+        uint32_t from = 0;   // vertex index
+        uint32_t to   = 0;   // vertex index
+        float    cost = 0.0f;
+    };
+
+    XMFLOAT3 Sub(const XMFLOAT3& a, const XMFLOAT3& b) noexcept { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+
+    XMFLOAT3 Cross(const XMFLOAT3& a, const XMFLOAT3& b) noexcept
+    {
+        return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+
+    float Dot(const XMFLOAT3& a, const XMFLOAT3& b) noexcept { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    uint64_t EdgeKey(uint32_t a, uint32_t b) noexcept { return (uint64_t(a) << 32) | b; }
+
+    template <typename T>
+    std::vector<T> CopyReferenced(const std::vector<T>& src,
+                                  const std::vector<uint32_t>& order, size_t vertexCount)
+    {
+        std::vector<T> dst;
+        if (src.size() != vertexCount) return dst;
+        dst.reserve(order.size());
+        for (uint32_t v : order) dst.push_back(src[v]);
+        return dst;
+    }
+}
+
+SimplifyResult MeshSimplifier::SimplifyIndices(
+    const Surface&             source,
+    const SimplifyDesc&        desc,
+    std::vector<unsigned int>& outIndices)
+{
+    SimplifyResult result;
+
+    const std::vector<XMFLOAT3>&     positions   = source.GetPositions();
+    const std::vector<unsigned int>& srcIndices  = source.GetIndices();
+    const uint32_t                   vertexCount = source.CountVertices();
+
+    outIndices.assign(srcIndices.begin(), srcIndices.begin() + (srcIndices.size() / 3) * 3);
+    result.sourceTriangles = static_cast<uint32_t>(outIndices.size() / 3);
+
+    for (unsigned int i : outIndices)
+    {
+        if (i >= vertexCount)
+        {
+            DBLOG("MeshSimplifier.cpp: SimplifyIndices - index out of range, surface not simplified");
+            outIndices.clear();
+            return result;
+        }
+    }
+
+    double worstCost = 0.0;
+    float  diagonal  = 0.0f;
+    auto finish = [&]() -> SimplifyResult
+    {
+        std::vector<uint8_t> used(vertexCount, 0);
+        for (unsigned int i : outIndices)
+            if (!used[i]) { used[i] = 1; ++result.vertices; }
+
+        result.triangles = static_cast<uint32_t>(outIndices.size() / 3);
+        result.error     = diagonal > 0.0f ? static_cast<float>(std::sqrt(worstCost) / diagonal) : 0.0f;
+        return result;
+    };
+
+    if (result.sourceTriangles < 2) return finish();
+
+    // ---- weld positions: seams are several vertices at one position ------
+    std::vector<uint32_t> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+        const XMFLOAT3& p = positions[a];
+        const XMFLOAT3& q = positions[b];
+        if (p.x != q.x) return p.x < q.x;
+        if (p.y != q.y) return p.y < q.y;
+        return p.z < q.z;
+    });
+
+    std::vector<uint32_t> posId(vertexCount);
+    std::vector<uint32_t> posVertexCount;
+    XMFLOAT3 minP = positions[order[0]], maxP = positions[order[0]];
+    for (uint32_t i = 0; i < vertexCount; ++i)
+    {
+        const XMFLOAT3& p = positions[order[i]];
+        const bool same = i > 0 && p.x == positions[order[i - 1]].x &&
+                          p.y == positions[order[i - 1]].y && p.z == positions[order[i - 1]].z;
+        if (!same) posVertexCount.push_back(0);
+        posId[order[i]] = static_cast<uint32_t>(posVertexCount.size() - 1);
+        ++posVertexCount.back();
+
+        minP.x = (std::min)(minP.x, p.x); maxP.x = (std::max)(maxP.x, p.x);
+        minP.y = (std::min)(minP.y, p.y); maxP.y = (std::max)(maxP.y, p.y);
+        minP.z = (std::min)(minP.z, p.z); maxP.z = (std::max)(maxP.z, p.z);
+    }
+    const uint32_t posCount = static_cast<uint32_t>(posVertexCount.size());
+
+    const XMFLOAT3 extent = Sub(maxP, minP);
+    diagonal = std::sqrt(Dot(extent, extent));
+    if (diagonal <= 0.0f) return finish();
+
+    // Triangles that are already degenerate in position (e.g. the pole
+    // caps of a UV sphere) cover no area and are dropped up front.
+    {
+        size_t write = 0;
+        for (size_t t = 0; t < outIndices.size(); t += 3)
+        {
+            const unsigned int a = outIndices[t], b = outIndices[t + 1], c = outIndices[t + 2];
+            if (posId[a] == posId[b] || posId[b] == posId[c] || posId[c] == posId[a]) continue;
+            outIndices[write++] = a;
+            outIndices[write++] = b;
+            outIndices[write++] = c;
+        }
+        outIndices.resize(write);
+    }
+
+    // ---- classify: seam, border and non-manifold positions are locked -----
+    std::vector<uint8_t> locked(posCount, 0);
+    for (uint32_t p = 0; p < posCount; ++p)
+        if (posVertexCount[p] > 1) locked[p] = 1;
+
+    std::unordered_map<uint64_t, uint32_t> edges;
+    edges.reserve(outIndices.size());
+    for (size_t t = 0; t < outIndices.size(); t += 3)
+    {
+        const uint32_t p[3] = { posId[outIndices[t]], posId[outIndices[t + 1]], posId[outIndices[t + 2]] };
+        for (int k = 0; k < 3; ++k)
+            ++edges[EdgeKey(p[k], p[(k + 1) % 3])];
+    }
+    for (const auto& e : edges)
+    {
+        const uint32_t a = static_cast<uint32_t>(e.first >> 32);
+        const uint32_t b = static_cast<uint32_t>(e.first & 0xFFFFFFFFu);
+        auto opposite = edges.find(EdgeKey(b, a));
+        if (e.second > 1 || opposite == edges.end() || opposite->second != 1)
+            locked[a] = locked[b] = 1;
+    }
+
+    // ---- quadrics: area weighted planes of the adjacent triangles ---------
+    std::vector<Quadric> quadrics(posCount);
+    for (size_t t = 0; t < outIndices.size(); t += 3)
+    {
+        const XMFLOAT3& p0 = positions[outIndices[t]];
+        const XMFLOAT3& p1 = positions[outIndices[t + 1]];
+        const XMFLOAT3& p2 = positions[outIndices[t + 2]];
+        XMFLOAT3 n = Cross(Sub(p1, p0), Sub(p2, p0));
+        const float len = std::sqrt(Dot(n, n));
+        if (len <= 0.0f) continue;
+        n = XMFLOAT3(n.x / len, n.y / len, n.z / len);
+        const double d = -double(Dot(n, p0));
+        const double area = 0.5 * len;
+        for (size_t k = 0; k < 3; ++k)
+            quadrics[posId[outIndices[t + k]]].AddPlane(n.x, n.y, n.z, d, area);
+    }
+
+    const size_t   targetIndices = static_cast<size_t>(
+        (std::max)(0.0f, (std::min)(1.0f, desc.targetRatio)) * float(outIndices.size() / 3)) * 3;
+    const double   maxCost = double(desc.maxError) * diagonal * double(desc.maxError) * diagonal;
+
+    std::vector<uint32_t> adjStart(size_t(posCount) + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint8_t>  passLocked(posCount);
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> ringU, ringV;
+
+    auto ring = [&](uint32_t p, std::vector<uint32_t>& out)
+    {
+        out.clear();
+        for (uint32_t a = adjStart[p]; a < adjStart[p + 1]; ++a)
+        {
+            const size_t t = size_t(adjacency[a]) * 3;
+            for (int k = 0; k < 3; ++k)
+            {
+                const uint32_t q = posId[outIndices[t + k]];
+                if (q != p && std::find(out.begin(), out.end(), q) == out.end()) out.push_back(q);
+            }
+        }
+    };
+
+    // Each pass collapses an independent set of edges in cost order, then
+    // rewrites the index list.
+    while (outIndices.size() > targetIndices)
+    {
+        const uint32_t triCount = static_cast<uint32_t>(outIndices.size() / 3);
+
+        std::fill(adjStart.begin(), adjStart.end(), 0u);
+        for (unsigned int i : outIndices) ++adjStart[posId[i] + 1];
+        for (uint32_t p = 0; p < posCount; ++p) adjStart[p + 1] += adjStart[p];
+        adjacency.resize(outIndices.size());
+        {
+            std::vector<uint32_t> fill(adjStart.begin(), adjStart.end() - 1);
+            for (uint32_t t = 0; t < triCount; ++t)
+                for (int k = 0; k < 3; ++k)
+                    adjacency[fill[posId[outIndices[size_t(t) * 3 + k]]]++] = t;
+        }
+
+        candidates.clear();
+        for (uint32_t t = 0; t < triCount; ++t)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                for (int dir = 1; dir <= 2; ++dir)
+                {
+                    const uint32_t from = outIndices[size_t(t) * 3 + k];
+                    const uint32_t to   = outIndices[size_t(t) * 3 + (k + dir) % 3];
+                    const uint32_t pf = posId[from], pt = posId[to];
+                    if (locked[pf] || pf == pt) continue;
+
+                    Quadric q = quadrics[pf];
+                    q.Add(quadrics[pt]);
+                    const double cost = q.w > 0.0 ? q.Eval(positions[to]) / q.w : 0.0;
+                    if (cost > maxCost) continue;
+                    candidates.push_back({ from, to, static_cast<float>(cost) });
+                }
+            }
+        }
+        if (candidates.empty()) break;
+
+        std::sort(candidates.begin(), candidates.end(),
+            [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        std::fill(passLocked.begin(), passLocked.end(), 0);
+        std::iota(remap.begin(), remap.end(), 0u);
+
+        const size_t trisToRemove = (outIndices.size() - targetIndices) / 3;
+        size_t       removed      = 0;
+
+        for (const Collapse& c : candidates)
+        {
+            if (removed >= trisToRemove) break;
+
+            const uint32_t pu = posId[c.from];
+            const uint32_t pv = posId[c.to];
+            if (passLocked[pu] || passLocked[pv]) continue;
+
+            // Link condition: an interior edge has exactly two opposite vertices.
+            ring(pu, ringU);
+            ring(pv, ringV);
+            uint32_t shared = 0;
+            for (uint32_t q : ringU)
+                if (std::find(ringV.begin(), ringV.end(), q) != ringV.end()) ++shared;
+            if (shared != 2) continue;
+
+            // No triangle around u may flip or turn by more than ~75 degrees
+            // when u moves onto v; small turns add up over several passes.
+            const XMFLOAT3& target = positions[c.to];
+            bool flips = false;
+            uint32_t collapsedTris = 0;
+            for (uint32_t a = adjStart[pu]; a < adjStart[pu + 1] && !flips; ++a)
+            {
+                const size_t t = size_t(adjacency[a]) * 3;
+                const uint32_t p[3] = { posId[outIndices[t]], posId[outIndices[t + 1]], posId[outIndices[t + 2]] };
+                if (p[0] == pv || p[1] == pv || p[2] == pv) { ++collapsedTris; continue; }
+
+                XMFLOAT3 v[3], w[3];
+                for (int k = 0; k < 3; ++k)
+                {
+                    v[k] = positions[outIndices[t + k]];
+                    w[k] = (p[k] == pu) ? target : v[k];
+                }
+                const XMFLOAT3 n0 = Cross(Sub(v[1], v[0]), Sub(v[2], v[0]));
+                const XMFLOAT3 n1 = Cross(Sub(w[1], w[0]), Sub(w[2], w[0]));
+                const float d = Dot(n0, n1);
+                flips = Dot(n0, n0) > 0.0f && (d <= 0.0f || d * d < 0.0625f * Dot(n0, n0) * Dot(n1, n1));
+            }
+            if (flips) continue;
+
+            remap[c.from] = c.to;
+            quadrics[pv].Add(quadrics[pu]);
+            worstCost = (std::max)(worstCost, double(c.cost));
+            removed  += collapsedTris;
+
+            passLocked[pu] = passLocked[pv] = 1;
+            for (uint32_t q : ringU) passLocked[q] = 1;
+        }
+        if (removed == 0) break;
+
+        size_t write = 0;
+        for (size_t t = 0; t < outIndices.size(); t += 3)
+        {
+            const unsigned int a = remap[outIndices[t]];
+            const unsigned int b = remap[outIndices[t + 1]];
+            const unsigned int c = remap[outIndices[t + 2]];
+            if (posId[a] == posId[b] || posId[b] == posId[c] || posId[c] == posId[a]) continue;
+            outIndices[write++] = a;
+            outIndices[write++] = b;
+            outIndices[write++] = c;
+        }
+        outIndices.resize(write);
+    }
+
+    return finish();
+}
+
+SimplifyResult MeshSimplifier::Simplify(const Surface& source, Surface& target, const SimplifyDesc& desc)
+{
+    std::vector<unsigned int> indices;
+    const SimplifyResult result = SimplifyIndices(source, desc, indices);
+
+    // Compact: keep referenced vertices in order of first use.
+    const uint32_t vertexCount = source.CountVertices();
+    std::vector<uint32_t> newIndex(vertexCount, UINT32_MAX);
+    std::vector<uint32_t> order;
+    order.reserve(result.vertices);
+    for (unsigned int& i : indices)
+    {
+        if (newIndex[i] == UINT32_MAX)
+        {
+            newIndex[i] = static_cast<uint32_t>(order.size());
+            order.push_back(i);
+        }
+        i = newIndex[i];
+    }
+
+    target.SetVertices(CopyReferenced(source.GetPositions(), order, vertexCount));
+    target.SetNormals(CopyReferenced(source.GetNormals(), order, vertexCount));
+    target.SetColors(CopyReferenced(source.GetColors(), order, vertexCount));
+    target.SetTexCoords(CopyReferenced(source.GetUV1(), order, vertexCount));
+    target.SetTexCoords2(CopyReferenced(source.GetUV2(), order, vertexCount));
+    target.SetTangents(CopyReferenced(source.GetTangents(), order, vertexCount));
+    target.SetBoneData(CopyReferenced(source.GetBoneIndices(), order, vertexCount),
+                       CopyReferenced(source.GetBoneWeights(), order, vertexCount));
+    target.SetIndices(std::move(indices));
+
+    return result;
+}
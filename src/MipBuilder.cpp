@@ -0,0 +1,333 @@
+#include "MipBuilder.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    constexpr float KAISER_WIDTH = 3.0f;  // half width in destination texels
+    constexpr float KAISER_ALPHA = 4.0f;
+    constexpr float PI           = 3.14159265358979f;
+
+    // Linear -> sRGB8 lookup steps; fine enough that the darkest codes
+    // (where the curve is steepest) still round correctly.
+    constexpr uint32_t LINEAR_TO_SRGB_STEPS = 16384;
+
+    float SrgbToLinear(float c) noexcept
+    {
+        return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float LinearToSrgb(float c) noexcept
+    {
+        return c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+    }
+
+    struct SrgbTables
+    {
+        float   toLinear[256];
+        uint8_t toSrgb[LINEAR_TO_SRGB_STEPS + 1];
+
+        SrgbTables() noexcept
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+                toLinear[i] = SrgbToLinear(static_cast<float>(i) / 255.0f);
+            for (uint32_t i = 0; i <= LINEAR_TO_SRGB_STEPS; ++i)
+            {
+                const float s = LinearToSrgb(static_cast<float>(i) / LINEAR_TO_SRGB_STEPS);
+                toSrgb[i] = static_cast<uint8_t>(std::clamp(s * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+        }
+    };
+
+    const SrgbTables& GetSrgbTables() noexcept
+    {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+    uint8_t ToUnorm8(float v) noexcept
+    {
+        return static_cast<uint8_t>(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    // Zeroth order modified Bessel function of the first kind (series).
+    float BesselI0(float x) noexcept
+    {
+        float sum  = 1.0f;
+        float term = 1.0f;
+        const float q = x * x * 0.25f;
+        for (int k = 1; k < 32 && term > sum * 1e-8f; ++k)
+        {
+            term *= q / static_cast<float>(k * k);
+            sum  += term;
+        }
+        return sum;
+    }
+
+    float KaiserSinc(float t) noexcept
+    {
+        const float r = t / KAISER_WIDTH;
+        if (r <= -1.0f || r >= 1.0f)
+            return 0.0f;
+
+        const float window = BesselI0(KAISER_ALPHA * std::sqrt(1.0f - r * r)) / BesselI0(KAISER_ALPHA);
+        const float sinc   = std::fabs(t) < 1e-5f ? 1.0f : std::sin(PI * t) / (PI * t);
+        return window * sinc;
+    }
+
+    // Source texels [first, first + count) and their weights for one
+    // destination texel along one axis. Weights are normalized to sum 1.
+    struct Tap
+    {
+        uint32_t first  = 0;
+        uint32_t count  = 0;
+        uint32_t weight = 0;  // offset into Kernel::weights
+    };
+
+    struct Kernel
+    {
+        std::vector<Tap>   taps;
+        std::vector<float> weights;
+        uint32_t           maxCount = 0;
+    };
+
+    Kernel BuildKernel(uint32_t srcSize, uint32_t dstSize, MipFilter filter)
+    {
+        Kernel kernel;
+        kernel.taps.resize(dstSize);
+
+        const float scale = static_cast<float>(srcSize) / static_cast<float>(dstSize);
+        const int   last  = static_cast<int>(srcSize) - 1;
+
+        for (uint32_t x = 0; x < dstSize; ++x)
+        {
+            Tap& tap = kernel.taps[x];
+            tap.weight = static_cast<uint32_t>(kernel.weights.size());
+
+            if (filter == MipFilter::Box)
+            {
+                // Overlap of every source texel with the destination footprint.
+                const float lo = static_cast<float>(x) * scale;
+                const float hi = static_cast<float>(x + 1) * scale;
+                const int   i0 = static_cast<int>(std::floor(lo));
+                const int   i1 = std::min(static_cast<int>(std::ceil(hi)) - 1, last);
+
+                tap.first = static_cast<uint32_t>(i0);
+                for (int i = i0; i <= i1; ++i)
+                {
+                    const float w = std::min(hi, static_cast<float>(i + 1)) - std::max(lo, static_cast<float>(i));
+                    kernel.weights.push_back(std::max(w, 0.0f));
+                }
+            }
+            else
+            {
+                // Windowed sinc in destination texel units, clamped at the edges:
+                // taps outside the image add their weight to the border texel.
+                const float center = (static_cast<float>(x) + 0.5f) * scale;
+                const float radius = KAISER_WIDTH * scale;
+                const int   i0     = static_cast<int>(std::floor(center - radius));
+                const int   i1     = static_cast<int>(std::ceil(center + radius));
+                const int   c0     = std::clamp(i0, 0, last);
+                const int   c1     = std::clamp(i1, 0, last);
+
+                tap.first = static_cast<uint32_t>(c0);
+                kernel.weights.resize(kernel.weights.size() + static_cast<size_t>(c1 - c0 + 1), 0.0f);
+                for (int i = i0; i <= i1; ++i)
+                {
+                    const float t = (static_cast<float>(i) + 0.5f - center) / scale;
+                    kernel.weights[tap.weight + static_cast<uint32_t>(std::clamp(i, 0, last) - c0)] += KaiserSinc(t);
+                }
+            }
+
+            tap.count = static_cast<uint32_t>(kernel.weights.size()) - tap.weight;
+
+            float sum = 0.0f;
+            for (uint32_t k = 0; k < tap.count; ++k)
+                sum += kernel.weights[tap.weight + k];
+            if (sum > 1e-6f)
+            {
+                for (uint32_t k = 0; k < tap.count; ++k)
+                    kernel.weights[tap.weight + k] /= sum;
+            }
+            else
+            {
+                // Degenerate window: nearest texel.
+                tap.first = static_cast<uint32_t>(std::clamp(static_cast<int>((static_cast<float>(x) + 0.5f) * scale), 0, last));
+                tap.count = 1;
+                kernel.weights.resize(tap.weight);
+                kernel.weights.push_back(1.0f);
+            }
+
+            kernel.maxCount = std::max(kernel.maxCount, tap.count);
+        }
+        return kernel;
+    }
+
+    // Decodes one RGBA8 row into filter space (see MipBuilder).
+    void DecodeRow(const uint8_t* src, uint32_t width, TextureUsage usage, float* out) noexcept
+    {
+        const SrgbTables& srgb = GetSrgbTables();
+        for (uint32_t x = 0; x < width; ++x, src += 4, out += 4)
+        {
+            switch (usage)
+            {
+            case TextureUsage::Color:
+                out[0] = srgb.toLinear[src[0]];
+                out[1] = srgb.toLinear[src[1]];
+                out[2] = srgb.toLinear[src[2]];
+                break;
+            case TextureUsage::Normal:
+                out[0] = static_cast<float>(src[0]) * (2.0f / 255.0f) - 1.0f;
+                out[1] = static_cast<float>(src[1]) * (2.0f / 255.0f) - 1.0f;
+                out[2] = static_cast<float>(src[2]) * (2.0f / 255.0f) - 1.0f;
+                break;
+            default:
+                out[0] = static_cast<float>(src[0]) / 255.0f;
+                out[1] = static_cast<float>(src[1]) / 255.0f;
+                out[2] = static_cast<float>(src[2]) / 255.0f;
+                break;
+            }
+            out[3] = static_cast<float>(src[3]) / 255.0f;
+        }
+    }
+
+    void EncodeRow(const float* in, uint32_t width, TextureUsage usage, uint8_t* dst) noexcept
+    {
+        const SrgbTables& srgb = GetSrgbTables();
+        for (uint32_t x = 0; x < width; ++x, in += 4, dst += 4)
+        {
+            switch (usage)
+            {
+            case TextureUsage::Color:
+                for (int c = 0; c < 3; ++c)
+                {
+                    const float v = std::clamp(in[c], 0.0f, 1.0f);
+                    dst[c] = srgb.toSrgb[static_cast<uint32_t>(v * LINEAR_TO_SRGB_STEPS + 0.5f)];
+                }
+                break;
+            case TextureUsage::Normal:
+            {
+                float nx = in[0], ny = in[1], nz = in[2];
+                const float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+                if (len > 1e-4f)
+                {
+                    nx /= len; ny /= len; nz /= len;
+                }
+                else
+                {
+                    nx = 0.0f; ny = 0.0f; nz = 1.0f;
+                }
+                dst[0] = ToUnorm8(nx * 0.5f + 0.5f);
+                dst[1] = ToUnorm8(ny * 0.5f + 0.5f);
+                dst[2] = ToUnorm8(nz * 0.5f + 0.5f);
+                break;
+            }
+            default:
+                dst[0] = ToUnorm8(in[0]);
+                dst[1] = ToUnorm8(in[1]);
+                dst[2] = ToUnorm8(in[2]);
+                break;
+            }
+            dst[3] = ToUnorm8(in[3]);
+        }
+    }
+
+    void Downsample(const uint8_t* src, uint32_t srcWidth, uint32_t srcHeight,
+                    uint8_t* dst, uint32_t dstWidth, uint32_t dstHeight,
+                    TextureUsage usage, MipFilter filter)
+    {
+        const Kernel kx = BuildKernel(srcWidth, dstWidth, filter);
+        const Kernel ky = BuildKernel(srcHeight, dstHeight, filter);
+
+        // Horizontally filtered source rows. The rows one destination row
+        // needs are contiguous and move down monotonically, so a ring of
+        // ky.maxCount rows computes every source row exactly once.
+        const uint32_t ringSize = ky.maxCount;
+        std::vector<float>    ring(static_cast<size_t>(ringSize) * dstWidth * 4);
+        std::vector<uint32_t> ringRow(ringSize, UINT32_MAX);
+        std::vector<float>    decoded(static_cast<size_t>(srcWidth) * 4);
+        std::vector<float>    accum(static_cast<size_t>(dstWidth) * 4);
+
+        auto filteredRow = [&](uint32_t row) -> const float*
+        {
+            const uint32_t slot = row % ringSize;
+            float* out = ring.data() + static_cast<size_t>(slot) * dstWidth * 4;
+            if (ringRow[slot] == row)
+                return out;
+
+            DecodeRow(src + static_cast<size_t>(row) * srcWidth * 4, srcWidth, usage, decoded.data());
+            for (uint32_t x = 0; x < dstWidth; ++x)
+            {
+                const Tap&   tap = kx.taps[x];
+                const float* w   = kx.weights.data() + tap.weight;
+                const float* in  = decoded.data() + static_cast<size_t>(tap.first) * 4;
+                float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+                for (uint32_t k = 0; k < tap.count; ++k, in += 4)
+                {
+                    r += w[k] * in[0];
+                    g += w[k] * in[1];
+                    b += w[k] * in[2];
+                    a += w[k] * in[3];
+                }
+                float* o = out + static_cast<size_t>(x) * 4;
+                o[0] = r; o[1] = g; o[2] = b; o[3] = a;
+            }
+            ringRow[slot] = row;
+            return out;
+        };
+
+        for (uint32_t y = 0; y < dstHeight; ++y)
+        {
+            const Tap&   tap = ky.taps[y];
+            const float* w   = ky.weights.data() + tap.weight;
+
+            std::fill(accum.begin(), accum.end(), 0.0f);
+            for (uint32_t k = 0; k < tap.count; ++k)
+            {
+                const float* row = filteredRow(tap.first + k);
+                for (size_t i = 0; i < accum.size(); ++i)
+                    accum[i] += w[k] * row[i];
+            }
+
+            EncodeRow(accum.data(), dstWidth, usage, dst + static_cast<size_t>(y) * dstWidth * 4);
+        }
+    }
+}
+
+uint32_t MipBuilder::CountLevels(uint32_t width, uint32_t height) noexcept
+{
+    uint32_t size   = std::max(width, height);
+    uint32_t levels = 1;
+    while (size > 1)
+    {
+        size >>= 1;
+        ++levels;
+    }
+    return levels;
+}
+
+bool MipBuilder::Build(TextureImage& image, TextureUsage usage, const MipDesc& desc)
+{
+    const size_t baseSize = static_cast<size_t>(image.width) * image.height * 4;
+    if (image.IsBlockCompressed() || baseSize == 0 || image.pixels.size() < baseSize)
+        return false;
+
+    uint32_t levels = CountLevels(image.width, image.height);
+    if (desc.maxLevels > 0)
+        levels = std::min(levels, desc.maxLevels);
+
+    image.pixels.resize(image.LevelOffset(levels));
+    image.mipLevels = levels;
+
+    for (uint32_t level = 1; level < levels; ++level)
+    {
+        Downsample(image.pixels.data() + image.LevelOffset(level - 1),
+                   image.LevelWidth(level - 1), image.LevelHeight(level - 1),
+                   image.pixels.data() + image.LevelOffset(level),
+                   image.LevelWidth(level), image.LevelHeight(level),
+                   usage, desc.filter);
+    }
+    return true;
+}
@@ -0,0 +1,252 @@
+// RecordingRenderBackend.cpp: headless IRenderBackend, no D3D11 calls.
+#include "RecordingRenderBackend.h"
+#include "Shader.h"
+#include "Material.h"
+#include "Mesh.h"
+#include "Surface.h"
+
+#include <cstring>
+
+void RecordingRenderBackend::Append(RecordType type, const void* object, uint32_t id, uint32_t arg)
+{
+    ++m_counts[static_cast<size_t>(type)];
+    if (!m_recordCommands) return;
+
+    Record r;
+    r.object = object;
+    r.id     = id;
+    r.arg    = arg;
+    r.type   = type;
+    m_records.push_back(r);
+}
+
+unsigned int RecordingRenderBackend::GetCount(RecordType type) const noexcept
+{
+    const size_t i = static_cast<size_t>(type);
+    return (i < static_cast<size_t>(RecordType::Count)) ? m_counts[i] : 0u;
+}
+
+void RecordingRenderBackend::Clear()
+{
+    m_records.clear();
+    m_instanceData.clear();
+    std::memset(m_counts, 0, sizeof(m_counts));
+}
+
+// ---------------------------------------------------------------------------
+// Step 4: entity constants
+// ---------------------------------------------------------------------------
+
+void RecordingRenderBackend::BindEntityConstants(GDXDevice& device, const Entity& entity)
+{
+    (void)device;
+    Append(RecordType::BindEntity, &entity);
+}
+
+void RecordingRenderBackend::BindBoneConstants(GDXDevice& device, const Mesh& mesh)
+{
+    (void)device;
+    if (!mesh.hasSkinning) return;
+    Append(RecordType::BindBones, &mesh);
+}
+
+// ---------------------------------------------------------------------------
+// Step 5: light constants + entity frame stats
+// ---------------------------------------------------------------------------
+
+void RecordingRenderBackend::UploadLightConstants(
+    const std::vector<Light*>& lights,
+    const DirectX::XMFLOAT4&  globalAmbient)
+{
+    (void)globalAmbient;
+    Append(RecordType::UploadLights, nullptr, 0, static_cast<uint32_t>(lights.size()));
+}
+
+IRenderBackend::EntityStats RecordingRenderBackend::GetEntityFrameStats() const
+{
+    EntityStats s;
+    s.uploads       = GetCount(RecordType::UploadEntity);
+    s.binds         = GetCount(RecordType::BindEntity);
+    s.ringRotations = 0;
+    s.frameBytes    = m_entityConstants.GetUsedBytes();
+    s.frameCommits  = GetCount(RecordType::CommitEntityConstants);
+    return s;
+}
+
+void RecordingRenderBackend::ResetEntityFrameStats()
+{
+    // Called once per frame by RenderManager::InvalidateFrame: start a new stream.
+    Clear();
+}
+
+// ---------------------------------------------------------------------------
+// Step 1: shadow constants/resources
+// ---------------------------------------------------------------------------
+
+void RecordingRenderBackend::UpdateShadowMatrixBuffer(
+    GDXDevice& device,
+    const DirectX::XMMATRIX& lightViewMatrix,
+    const DirectX::XMMATRIX& lightProjMatrix)
+{
+    (void)device; (void)lightViewMatrix; (void)lightProjMatrix;
+    Append(RecordType::UpdateShadowMatrices);
+}
+
+void RecordingRenderBackend::BindShadowMatrixConstantBufferVS(GDXDevice& device)
+{
+    (void)device;
+    Append(RecordType::BindShadowMatrices);
+}
+
+void RecordingRenderBackend::BindShadowResourcesPS(GDXDevice& device, ShadowMapTarget& shadowTarget)
+{
+    (void)device;
+    Append(RecordType::BindShadowResources, &shadowTarget);
+}
+
+// ---------------------------------------------------------------------------
+// Step 2: passes
+// ---------------------------------------------------------------------------
+
+void RecordingRenderBackend::BeginShadowPass()
+{
+    Append(RecordType::BeginShadowPass);
+}
+
+void RecordingRenderBackend::EndShadowPass()
+{
+    Append(RecordType::EndShadowPass);
+}
+
+void RecordingRenderBackend::BeginMainPass(
+    GDXDevice& device,
+    BackbufferTarget& backbufferTarget,
+    const Viewport& cameraViewport)
+{
+    (void)device; (void)cameraViewport;
+    Append(RecordType::BeginMainPass, &backbufferTarget);
+}
+
+void RecordingRenderBackend::EndMainPass()
+{
+    Append(RecordType::EndMainPass);
+}
+
+void RecordingRenderBackend::BeginRttPass(GDXDevice& device, RenderTextureTarget& rttTarget)
+{
+    (void)device;
+    Append(RecordType::BeginRttPass, &rttTarget);
+}
+
+void RecordingRenderBackend::EndRttPass()
+{
+    Append(RecordType::EndRttPass);
+}
+
+// ---------------------------------------------------------------------------
+// Step 3: material bind path
+// ---------------------------------------------------------------------------
+
+void RecordingRenderBackend::ResetMaterialCache()
+{
+    Append(RecordType::ResetMaterialCache);
+}
+
+void RecordingRenderBackend::BindFrameSampler()
+{
+    Append(RecordType::BindFrameSampler);
+}
+
+void RecordingRenderBackend::BindMaterial(const Material* material, const TexturePool* texturePool)
+{
+    (void)texturePool;
+    if (!material) return;
+    Append(RecordType::BindMaterial, material, material->id);
+}
+
+void RecordingRenderBackend::SetAlphaBlend(bool enable)
+{
+    Append(RecordType::SetAlphaBlend, nullptr, 0, enable ? 1u : 0u);
+}
+
+// ---------------------------------------------------------------------------
+// Step 6: shader bind, entity upload, surface draw
+// ---------------------------------------------------------------------------
+
+bool RecordingRenderBackend::IsShaderValid(const Shader* shader, ShaderBindMode mode) const
+{
+    // No GPU objects exist headless; any shader that was created is bindable.
+    (void)mode;
+    return shader != nullptr;
+}
+
+void RecordingRenderBackend::BindShader(GDXDevice& device, Shader* shader, ShaderBindMode mode)
+{
+    (void)device;
+    if (!shader) return;
+    Append(RecordType::BindShader, shader, shader->id, static_cast<uint32_t>(mode));
+}
+
+void RecordingRenderBackend::UploadEntityConstants(GDXDevice& device, Mesh& mesh, const EntityConstants& constants)
+{
+    (void)device;
+    const uint32_t offset = m_entityConstants.Allocate(&constants, sizeof(EntityConstants));
+    Append(RecordType::UploadEntity, &mesh, offset);
+}
+
+void RecordingRenderBackend::DrawSurface(GDXDevice& device, Surface& surface, unsigned int flagsVertex)
+{
+    (void)device;
+    Append(RecordType::DrawSurface, &surface, surface.id, flagsVertex);
+}
+
+// ---------------------------------------------------------------------------
+// Step 7: instancing
+// ---------------------------------------------------------------------------
+
+bool RecordingRenderBackend::UploadInstanceData(GDXDevice& device, const DirectX::XMFLOAT4X4* worlds, uint32_t count)
+{
+    (void)device;
+    if (!worlds || count == 0) return false;
+
+    m_instanceData.assign(worlds, worlds + count);
+    Append(RecordType::UploadInstances, nullptr, 0, count);
+    return true;
+}
+
+void RecordingRenderBackend::DrawSurfaceInstanced(GDXDevice& device, Surface& surface, unsigned int flagsVertex,
+                                                  uint32_t instanceCount, uint32_t firstInstance)
+{
+    (void)device; (void)flagsVertex;
+    Append(RecordType::DrawSurfaceInstanced, &surface, firstInstance, instanceCount);
+}
+
+// ---------------------------------------------------------------------------
+// Step 8: frame constants
+// ---------------------------------------------------------------------------
+
+void RecordingRenderBackend::ResetEntityConstants()
+{
+    m_entityConstants.Reset();
+}
+
+void RecordingRenderBackend::CommitEntityConstants(GDXDevice& device)
+{
+    (void)device;
+    if (!m_entityConstants.HasPending()) return;
+
+    Append(RecordType::CommitEntityConstants, nullptr, m_entityConstants.GetPendingBegin(),
+           m_entityConstants.GetUsedBytes() - m_entityConstants.GetPendingBegin());
+    m_entityConstants.MarkCommitted();
+}
+
+// ---------------------------------------------------------------------------
+// Step 9: pass constants
+// ---------------------------------------------------------------------------
+
+void RecordingRenderBackend::UploadPassConstants(GDXDevice& device, const PassConstants& constants)
+{
+    (void)device;
+    m_passConstants = constants;
+    Append(RecordType::UploadPass);
+}
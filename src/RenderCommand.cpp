@@ -11,19 +11,23 @@ void RenderCommand::Execute(const GDXDevice* device) const
 
     GDXDevice& dev = *const_cast<GDXDevice*>(device);
 
-    // Upload the entity matrix CB (b0) on first draw this frame;
-    // for subsequent draws of the same mesh only re-bind the existing buffer.
-    // The ring buffer inside EntityGpuData ensures no GPU hazard between passes.
+    // RenderManager stages and commits the entity constants (b0) of a whole
+    // queue before flushing it, so normally this only re-binds. A mesh not
+    // staged yet is uploaded and committed here on its own.
     if (!mesh->IsUpdatedThisFrame())
     {
-        // matrixSet is written by RenderManager before the flush.
-        mesh->Update(device, &mesh->matrixSet);
+        const EntityConstants constants = MakeEntityConstants(mesh->GetWorldMatrix());
+        if (backend)
+        {
+            backend->UploadEntityConstants(dev, *mesh, constants);
+            backend->CommitEntityConstants(dev);
+        }
+        else
+            mesh->Update(device, &constants);
         mesh->MarkUpdated();
     }
-    else
-    {
-        if (backend) backend->BindEntityConstants(dev, *mesh);
-    }
+
+    if (backend) backend->BindEntityConstants(dev, *mesh);
 
     // Bone palette CB (b4) — routed through the backend, no DX11 in Execute.
     if (mesh->hasSkinning)
@@ -31,5 +35,9 @@ void RenderCommand::Execute(const GDXDevice* device) const
         if (backend) backend->BindBoneConstants(dev, *mesh);
     }
 
-    surface->gpu->Draw(device, flagsVertex);
+    // Draw goes through the backend as well so a headless backend can record it.
+    if (backend)
+        backend->DrawSurface(dev, *surface, static_cast<unsigned int>(flagsVertex));
+    else if (surface->gpu)
+        surface->gpu->Draw(device, flagsVertex);
 }
@@ -1,9 +1,15 @@
-#include "gdxengine.h"
 #include "RenderManager.h"
+#include "IRenderBackend.h"
+#include "gdxdevice.h"
+#include "TexturePool.h"
+#include "RenderTextureTarget.h"
 #include "Viewport.h"
 #include "Light.h"
-#include "Dx11RenderBackend.h"
+#include "JobSystem.h"
 #include <unordered_map>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 RenderManager::RenderManager(Scene& scene, AssetManager& assetManager, GDXDevice& device)
     : m_scene(scene), m_assetManager(assetManager), m_device(device),
@@ -47,8 +53,14 @@ void RenderManager::LogFrameStatsIfChanged()
     m_frameStats.entityUploads       = e.uploads;
     m_frameStats.entityConstantBinds = e.binds;
     m_frameStats.entityRingRotations = e.ringRotations;
+    m_frameStats.entityFrameBytes    = e.frameBytes;
+    m_frameStats.entityFrameCommits  = e.frameCommits;
 
-    if (!m_hasLastLoggedFrameStats || m_frameStats != m_lastLoggedFrameStats)
+    const bool changed = m_verboseFrameStats
+        ? m_frameStats != m_lastLoggedFrameStats
+        : !m_frameStats.SameDrawStats(m_lastLoggedFrameStats);
+
+    if (!m_hasLastLoggedFrameStats || changed)
     {
         DBLOG("RenderManager.cpp: Frame stats"
             " shadowDrawCalls=",      m_frameStats.shadowDrawCalls,
@@ -58,7 +70,17 @@ void RenderManager::LogFrameStatsIfChanged()
             " materialBinds=",        m_frameStats.materialBinds,
             " entityUploads=",        m_frameStats.entityUploads,
             " entityCBBinds=",        m_frameStats.entityConstantBinds,
-            " ringRotations=",        m_frameStats.entityRingRotations);
+            " ringRotations=",        m_frameStats.entityRingRotations,
+            " frameCBBytes=",         m_frameStats.entityFrameBytes,
+            " frameCBCommits=",       m_frameStats.entityFrameCommits,
+            " visibleMeshes=",        m_frameStats.visibleMeshes,
+            " culledMeshes=",         m_frameStats.culledMeshes,
+            " shadowCulled=",         m_frameStats.shadowCulled,
+            " instancedDraws=",       m_frameStats.instancedDrawCalls,
+            " instancedMeshes=",      m_frameStats.instancedMeshes,
+            " queueRebuilds=",        m_frameStats.queueRebuilds,
+            " queuePatched=",         m_frameStats.queuePatchedMeshes,
+            " lodMeshes=",            m_frameStats.lodMeshes);
 
         m_lastLoggedFrameStats    = m_frameStats;
         m_hasLastLoggedFrameStats = true;
@@ -67,7 +89,7 @@ void RenderManager::LogFrameStatsIfChanged()
 
 void RenderManager::RenderShadowPass()
 {
-    if (!m_currentCam || !m_directionLight || !m_device.IsInitialized() || !m_backend)
+    if (!m_currentCam || !m_directionLight || !IsBackendReady())
         return;
 
     Light* light = (m_directionLight->IsLight() ? m_directionLight->AsLight() : nullptr);
@@ -80,8 +102,12 @@ void RenderManager::RenderShadowPass()
     UpdateShadowMatrixBuffer(lightViewMatrix, lightProjMatrix);
     m_backend->BindShadowMatrixConstantBufferVS(m_device);
 
-    BuildShadowQueue();
-    FlushShadowQueue(lightViewMatrix, lightProjMatrix);
+    // Pass block = light view; shaders drawn in VS_ONLY mode (skinned
+    // casters) project with it like the dedicated shadow VS.
+    UploadPassConstants(lightViewMatrix, lightProjMatrix);
+
+    BuildShadowQueue(*light, lightViewMatrix, lightProjMatrix);
+    FlushShadowQueue();
 
     m_backend->EndShadowPass();
 }
@@ -94,7 +120,7 @@ void RenderManager::RenderNormalPass()
 
 void RenderManager::RenderMainPassAtomic()
 {
-    if (!m_currentCam || !m_device.IsInitialized() || !m_backend)
+    if (!m_currentCam || !IsBackendReady())
         return;
 
     const bool isRtt = (m_activeRTT != nullptr);
@@ -124,17 +150,21 @@ void RenderManager::RenderMainPassAtomic()
         }
     }
 
-    // 3) Light array constant buffer (b1)
-    {
-        DirectX::XMFLOAT4 globalAmbient(0.2f, 0.2f, 0.2f, 1.0f);
-        if (GDXEngine::GetInstance())
-            globalAmbient = GDXEngine::GetInstance()->GetGlobalAmbient();
+    // Pass block (b5): camera view/projection for all draws of this pass
+    UploadPassConstants(m_currentCam->matrixSet.viewMatrix, m_currentCam->matrixSet.projectionMatrix);
 
-        m_backend->UploadLightConstants(m_scene.GetLights(), globalAmbient);
-    }
+    // 3) Light array constant buffer (b1)
+    m_backend->UploadLightConstants(m_scene.GetLights(), m_globalAmbient);
 
     // 4) Queue build + draw
     BuildRenderQueue();
+    if (m_texturePool && m_texturePool->HasStreamedTextures())
+    {
+        const float viewportHeight = isRtt ? static_cast<float>(m_activeRTT->GetHeight())
+                                           : m_currentCam->viewport.height;
+        RequestTextureDetail(m_opaque, viewportHeight);
+        RequestTextureDetail(m_transparent, viewportHeight);
+    }
     FlushRenderQueue();
     FlushTransparentQueue();
 
@@ -147,62 +177,128 @@ void RenderManager::RenderMainPassAtomic()
 
 void RenderManager::InvalidateFrame()
 {
-    m_opaque.Clear();
-    m_shadow.Clear();
-    m_transFrame.clear();
+    // Queues are retained across frames; BuildRenderQueue/BuildShadowQueue
+    // decide whether to reuse, patch or rebuild them.
     m_frameStats = {};
     m_flushOnce  = false;
 
     // Entity frame stats are backend-owned; reset through the interface.
     m_backend->ResetEntityFrameStats();
+    m_backend->ResetEntityConstants();
 
-    for (Mesh* mesh : m_scene.GetMeshes())
-        if (mesh) mesh->ResetFrameFlag();
+    Mesh::BeginFrame();
 }
 
-void RenderManager::BuildShadowQueue()
+void RenderManager::BuildShadowQueue(const Light& light,
+                                     const DirectX::XMMATRIX& lightViewMatrix,
+                                     const DirectX::XMMATRIX& lightProjMatrix)
 {
-    m_shadow.Clear();
-
-    uint32_t cameraCullMask = LAYER_ALL;
+    m_buildCullMask = LAYER_ALL;
     if (Camera* cam = (m_currentCam->IsCamera() ? m_currentCam->AsCamera() : nullptr))
-        cameraCullMask = cam->cullMask;
+        m_buildCullMask = cam->cullMask;
+
+    // Caster culling: the mesh must overlap the light volume (ortho box or
+    // perspective frustum). Directional lights additionally require overlap
+    // with the camera frustum extruded towards the light, i.e. the mesh can
+    // actually shadow something the camera sees.
+    m_useLightVolume  = false;
+    m_useCasterVolume = false;
+    if (m_frustumCulling)
+    {
+        m_lightVolume.SetFromViewProjection(lightViewMatrix, lightProjMatrix);
+        m_useLightVolume = m_lightVolume.IsValid();
+
+        if (light.GetLightType() == LightType::Directional)
+        {
+            m_cameraVolume.SetFromViewProjection(m_currentCam->matrixSet.viewMatrix,
+                                                 m_currentCam->matrixSet.projectionMatrix);
+            m_casterVolume.SetFromExtrudedReceivers(m_cameraVolume, lightViewMatrix);
+            m_useCasterVolume = m_casterVolume.IsValid();
+        }
+    }
 
-    for (Mesh* mesh : m_scene.GetMeshes())
+    m_drawList.Sync(m_scene, m_assetManager.GetStandardMaterial());
+
+    QueueKey key;
+    DirectX::XMStoreFloat4x4(&key.view, lightViewMatrix);
+    DirectX::XMStoreFloat4x4(&key.proj, lightProjMatrix);
+    if (m_useCasterVolume)
+    {
+        DirectX::XMStoreFloat4x4(&key.cameraView, m_currentCam->matrixSet.viewMatrix);
+        DirectX::XMStoreFloat4x4(&key.cameraProj, m_currentCam->matrixSet.projectionMatrix);
+    }
+    key.backend  = m_backend.get();
+    key.cullMask = m_buildCullMask;
+    key.flags    = (m_useLightVolume ? 1u : 0u) | (m_useCasterVolume ? 2u : 0u) | (m_lodSelection ? 4u : 0u);
+    key.layout   = m_drawList.GetLayoutRevision();
+    key.bulk     = m_scene.GetRenderRevision().GetBulk();
+
+    RetainedQueueState& state = m_shadowState;
+    const uint32_t stateRevision    = m_scene.GetRenderRevision().GetState();
+    const uint32_t worldRevision    = m_scene.GetRenderRevision().GetWorld();
+    const uint32_t geometryRevision = m_scene.GetRenderRevision().GetGeometry();
+    const uint32_t lodRevision      = m_lodRevision.load(std::memory_order_relaxed);
+
+    // Casters draw the level the main camera picked, so level changes
+    // patch the shadow queue like scene changes.
+    if (m_retainedQueues && state.valid && state.key == key)
+    {
+        const bool geometryChanged = state.geometryRevision != geometryRevision;
+        if (state.stateRevision != stateRevision || state.worldRevision != worldRevision ||
+            state.lodRevision != lodRevision || geometryChanged)
+            m_frameStats.queuePatchedMeshes += PatchShadowQueue(state, geometryChanged);
+    }
+    else
     {
-        if (!mesh || !mesh->HasMeshAsset()) continue;
-        if (mesh->GetSurfaces().empty())    continue;
-        if (!mesh->IsActive())              continue;
-        if (!mesh->IsVisible())             continue;
-        if (!mesh->GetCastShadows())        continue;
-        if (!(mesh->GetLayerMask() & cameraCullMask)) continue;
+        m_shadow.Clear();
 
-        const DirectX::XMMATRIX world = mesh->GetWorldMatrix();
+        const uint32_t recordCount = m_drawList.GetRecordCount();
+        const uint32_t chunkCount  = GetBuildChunkCount(recordCount);
 
-        const auto& shadowSlots = mesh->GetSurfaces();
-        for (unsigned int si = 0; si < static_cast<unsigned int>(shadowSlots.size()); ++si)
-        {
-            Surface* surface = shadowSlots[si];
-            if (!surface) continue;
+        state.stamps.resize(recordCount);
+        m_buildStamps = state.stamps.data();
+
+        unsigned int culled = 0;
 
-            Material* material = mesh->GetResolvedMaterial(si,
-                m_assetManager.GetStandardMaterial());
-            if (!material || !material->GetCastShadows()) continue;
+        if (chunkCount <= 1)
+        {
+            BuildShadowRange(0, recordCount, m_shadow, culled);
+        }
+        else
+        {
+            PrepareParallelBuild(chunkCount);
 
-            Shader* shader = material->pRenderShader;
-            if (!shader) continue;
+            m_jobSystem->ParallelFor(recordCount, chunkCount,
+                [this](uint32_t begin, uint32_t end, uint32_t chunk)
+                {
+                    BuildChunk& c = m_buildChunks[chunk];
+                    BuildShadowRange(begin, end, c.shadow, c.shadowCulled);
+                });
 
-            if (!shader->IsValid(ShaderBindMode::VS_ONLY))
+            // Merge in chunk order: identical command order to the serial path.
+            for (uint32_t i = 0; i < chunkCount; ++i)
             {
-                DBERROR("RenderManager.cpp: BuildShadowQueue - invalid shader, draw skipped");
-                continue;
+                m_shadow.Append(m_buildChunks[i].shadow);
+                culled += m_buildChunks[i].shadowCulled;
             }
-
-            m_shadow.Submit(shader, shader->flagsVertex, material, mesh, surface, world, m_backend.get());
         }
+
+        m_buildStamps = nullptr;
+        m_shadow.Sort();
+
+        state.key    = key;
+        state.valid  = true;
+        state.culled = culled;
+        ++m_frameStats.queueRebuilds;
     }
 
-    m_shadow.Sort();
+    state.stateRevision    = stateRevision;
+    state.worldRevision    = worldRevision;
+    state.geometryRevision = geometryRevision;
+    state.lodRevision      = lodRevision;
+    m_frameStats.shadowCulled += state.culled;
+
+    if (!m_verboseQueueLog) return;
 
     static size_t s_lastShadowCount = static_cast<size_t>(-1);
     if (m_shadow.Count() != s_lastShadowCount)
@@ -224,78 +320,114 @@ void RenderManager::BuildShadowQueue()
 
 void RenderManager::BuildRenderQueue()
 {
-    m_opaque.Clear();
-    m_transFrame.clear();
-
-    // Skinned meshes: reset frame flag because their shadow pass writes light
-    // matrices to b0. Non-skinned meshes keep the flag (camera matrices are
-    // already correct from the shadow VS pass).
-    for (Mesh* mesh : m_scene.GetMeshes())
-        if (mesh && mesh->hasSkinning) mesh->ResetFrameFlag();
-
-    uint32_t cameraCullMask = LAYER_ALL;
+    m_buildCullMask = LAYER_ALL;
     if (Camera* cam = (m_currentCam->IsCamera() ? m_currentCam->AsCamera() : nullptr))
-        cameraCullMask = cam->cullMask;
-
-    DirectX::XMVECTOR camPos = m_currentCam->GetWorldMatrix().r[3];
-
-    for (Mesh* mesh : m_scene.GetMeshes())
+        m_buildCullMask = cam->cullMask;
+
+    DirectX::XMStoreFloat3(&m_buildCamPos, m_currentCam->GetWorldMatrix().r[3]);
+
+    m_cameraVolume.SetFromViewProjection(m_currentCam->matrixSet.viewMatrix,
+                                         m_currentCam->matrixSet.projectionMatrix);
+    m_useCameraVolume = m_frustumCulling && m_cameraVolume.IsValid();
+
+    // Projected size = radius * _22 / distance (perspective) or
+    // radius * _22 (orthographic), as a fraction of the viewport height.
+    const DirectX::XMMATRIX& proj = m_currentCam->matrixSet.projectionMatrix;
+    m_buildLod       = m_lodSelection;
+    m_buildLodOwner  = (m_activeRTT == nullptr);
+    m_buildProjScale = DirectX::XMVectorGetY(proj.r[1]);
+    m_buildOrtho     = DirectX::XMVectorGetW(proj.r[3]) == 1.0f;
+
+    DBLOG_ONCE("STD_MAT_CHECK",
+        "STD=",     (void*)m_assetManager.GetStandardMaterial(),
+        " shader=", (void*)(m_assetManager.GetStandardMaterial() ? m_assetManager.GetStandardMaterial()->pRenderShader : nullptr),
+        " gpu=",    (void*)(m_assetManager.GetStandardMaterial() ? m_assetManager.GetStandardMaterial()->gpuData : nullptr));
+
+    m_drawList.Sync(m_scene, m_assetManager.GetStandardMaterial());
+    SelectView(m_currentCam);
+
+    // The camera world matrix (depth origin) is implied by the view matrix.
+    QueueKey key;
+    DirectX::XMStoreFloat4x4(&key.view, m_currentCam->matrixSet.viewMatrix);
+    DirectX::XMStoreFloat4x4(&key.proj, m_currentCam->matrixSet.projectionMatrix);
+    key.backend  = m_backend.get();
+    key.cullMask = m_buildCullMask;
+    key.flags    = (m_useCameraVolume ? 1u : 0u) | (m_buildLod ? 2u : 0u);
+    key.lodBias  = m_buildLod ? m_lodBias : 0.0f;
+    key.layout   = m_drawList.GetLayoutRevision();
+    key.bulk     = m_scene.GetRenderRevision().GetBulk();
+
+    RetainedQueueState& state = m_views[m_activeView].state;
+    const uint32_t stateRevision    = m_scene.GetRenderRevision().GetState();
+    const uint32_t worldRevision    = m_scene.GetRenderRevision().GetWorld();
+    const uint32_t geometryRevision = m_scene.GetRenderRevision().GetGeometry();
+
+    if (m_retainedQueues && state.valid && state.key == key)
     {
-        if (!mesh || !mesh->HasMeshAsset()) continue;
-        if (mesh->GetSurfaces().empty())    continue;
-        if (!mesh->IsActive())              continue;
-        if (!mesh->IsVisible())             continue;
-        if (!(mesh->GetLayerMask() & cameraCullMask)) continue;
-
-        const DirectX::XMMATRIX world = mesh->GetWorldMatrix();
-        mesh->matrixSet.worldMatrix   = world;
+        const bool geometryChanged = state.geometryRevision != geometryRevision;
+        if (state.stateRevision != stateRevision || state.worldRevision != worldRevision || geometryChanged)
+            m_frameStats.queuePatchedMeshes += PatchRenderQueue(state, geometryChanged);
+    }
+    else
+    {
+        m_opaque.Clear();
+        m_transparent.Clear();
 
-        const auto& queueSlots = mesh->GetSurfaces();
-        for (unsigned int qi = 0; qi < static_cast<unsigned int>(queueSlots.size()); ++qi)
-        {
-            Surface* surface = queueSlots[qi];
-            if (!surface) continue;
+        const uint32_t recordCount = m_drawList.GetRecordCount();
+        const uint32_t chunkCount  = GetBuildChunkCount(recordCount);
 
-            Material* material = mesh->GetResolvedMaterial(qi,
-                m_assetManager.GetStandardMaterial());
-            if (!material) continue;
+        state.stamps.resize(recordCount);
+        m_buildStamps = state.stamps.data();
 
-            Shader* shader = material->pRenderShader;
+        unsigned int visible   = 0;
+        unsigned int culled    = 0;
+        unsigned int lodMeshes = 0;
 
-            DBLOG_ONCE("STD_MAT_CHECK",
-                "STD=",     (void*)m_assetManager.GetStandardMaterial(),
-                " shader=", (void*)(m_assetManager.GetStandardMaterial() ? m_assetManager.GetStandardMaterial()->pRenderShader : nullptr),
-                " gpu=",    (void*)(m_assetManager.GetStandardMaterial() ? m_assetManager.GetStandardMaterial()->gpuData : nullptr));
+        if (chunkCount <= 1)
+        {
+            BuildRenderRange(0, recordCount, m_opaque, m_transparent, visible, culled, lodMeshes);
+        }
+        else
+        {
+            PrepareParallelBuild(chunkCount);
 
-            if (!shader) continue;
+            m_jobSystem->ParallelFor(recordCount, chunkCount,
+                [this](uint32_t begin, uint32_t end, uint32_t chunk)
+                {
+                    BuildChunk& c = m_buildChunks[chunk];
+                    BuildRenderRange(begin, end, c.opaque, c.transparent, c.visible, c.culled, c.lodMeshes);
+                });
 
-            if (material->IsTransparent())
+            for (uint32_t i = 0; i < chunkCount; ++i)
             {
-                DirectX::XMVECTOR meshPos = world.r[3];
-                DirectX::XMVECTOR diff    = DirectX::XMVectorSubtract(meshPos, camPos);
-                float depth = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(diff));
-
-                RenderCommand cmd;
-                cmd.mesh        = mesh;
-                cmd.surface     = surface;
-                cmd.world       = world;
-                cmd.shader      = shader;
-                cmd.material    = material;
-                cmd.flagsVertex = shader->flagsVertex;
-                cmd.backend     = m_backend.get();
-                m_transFrame.emplace_back(depth, cmd);
-            }
-            else
-            {
-                m_opaque.Submit(shader, shader->flagsVertex, material, mesh, surface, world, m_backend.get());
+                m_opaque.Append(m_buildChunks[i].opaque);
+                m_transparent.Append(m_buildChunks[i].transparent);
+                visible   += m_buildChunks[i].visible;
+                culled    += m_buildChunks[i].culled;
+                lodMeshes += m_buildChunks[i].lodMeshes;
             }
         }
+
+        m_buildStamps = nullptr;
+        m_opaque.Sort();
+        m_transparent.Sort();
+
+        state.key     = key;
+        state.valid   = true;
+        state.visible   = visible;
+        state.culled    = culled;
+        state.lodMeshes = lodMeshes;
+        ++m_frameStats.queueRebuilds;
     }
 
-    m_opaque.Sort();
+    state.stateRevision    = stateRevision;
+    state.worldRevision    = worldRevision;
+    state.geometryRevision = geometryRevision;
+    m_frameStats.visibleMeshes += state.visible;
+    m_frameStats.culledMeshes  += state.culled;
+    m_frameStats.lodMeshes     += state.lodMeshes;
 
-    std::sort(m_transFrame.begin(), m_transFrame.end(),
-        [](const auto& a, const auto& b) { return a.first > b.first; });
+    if (!m_verboseQueueLog) return;
 
     static std::unordered_map<void*, size_t> s_lastOpaque;
     static std::unordered_map<void*, size_t> s_lastTrans;
@@ -303,14 +435,14 @@ void RenderManager::BuildRenderQueue()
     void* camKey = static_cast<void*>(m_currentCam);
 
     if (m_opaque.Count() != s_lastOpaque[camKey] ||
-        m_transFrame.size() != s_lastTrans[camKey])
+        m_transparent.Count() != s_lastTrans[camKey])
     {
         s_lastOpaque[camKey] = m_opaque.Count();
-        s_lastTrans[camKey]  = m_transFrame.size();
+        s_lastTrans[camKey]  = m_transparent.Count();
 
         DBLOG("RenderManager.cpp: BuildRenderQueue [cam=", camKey, "]"
             " opaque=",      m_opaque.Count(),
-            " transparent=", m_transFrame.size());
+            " transparent=", m_transparent.Count());
 
         for (size_t i = 0; i < m_opaque.commands.size(); ++i)
         {
@@ -322,23 +454,465 @@ void RenderManager::BuildRenderQueue()
                 " surface=",(void*)cmd.surface);
         }
 
-        for (size_t i = 0; i < m_transFrame.size(); ++i)
+        for (size_t i = 0; i < m_transparent.commands.size(); ++i)
         {
-            const RenderCommand& cmd = m_transFrame[i].second;
+            const RenderCommand& cmd = m_transparent.commands[i];
             DBLOG("RenderManager.cpp:   trans[", (int)i, "]"
-                " depth=", m_transFrame[i].first,
+                " key=",   cmd.sortKey,
                 " mat=",   (void*)cmd.material,
                 " mesh=",  (void*)cmd.mesh);
         }
     }
 }
 
-void RenderManager::FlushShadowQueue(const DirectX::XMMATRIX& lightViewMatrix,
-                                      const DirectX::XMMATRIX& lightProjMatrix)
+uint32_t RenderManager::GetBuildChunkCount(uint32_t meshCount) const
+{
+    if (!m_jobSystem || m_jobSystem->GetThreadCount() <= 1) return 1;
+    if (meshCount < PARALLEL_BUILD_MIN_MESHES)              return 1;
+
+    // A few chunks per thread so stealing can balance uneven ranges.
+    const uint32_t byThreads = m_jobSystem->GetThreadCount() * 4u;
+    const uint32_t bySize    = meshCount / PARALLEL_BUILD_MIN_CHUNK;
+    return (std::max)(1u, (std::min)(byThreads, bySize));
+}
+
+void RenderManager::PrepareParallelBuild(uint32_t chunkCount)
+{
+    if (m_buildChunks.size() < chunkCount)
+        m_buildChunks.resize(chunkCount);
+
+    for (uint32_t i = 0; i < chunkCount; ++i)
+    {
+        BuildChunk& c = m_buildChunks[i];
+        c.opaque.Clear();
+        c.transparent.Clear();
+        c.shadow.Clear();
+        c.visible      = 0;
+        c.culled       = 0;
+        c.shadowCulled = 0;
+        c.lodMeshes    = 0;
+    }
+
+    // World matrix caches are filled lazily. The caller (RenderScene) ran
+    // Scene::UpdateWorldMatrices once this frame, so workers only read them
+    // and never write a cache shared through a parent.
+}
+
+void RenderManager::BuildShadowRange(uint32_t begin, uint32_t end,
+                                     RenderQueue& out, unsigned int& culled)
+{
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        uint8_t lod = 0;
+        const uint8_t result = BuildShadowRecord(i, out, lod);
+        if (result == RECORD_CULLED) ++culled;
+        StampRecord(m_buildStamps[i], i, result, lod);
+    }
+}
+
+void RenderManager::BuildRenderRange(uint32_t begin, uint32_t end,
+                                     RenderQueue& opaque, RenderQueue& transparent,
+                                     unsigned int& visible, unsigned int& culled, unsigned int& lodMeshes)
+{
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        uint8_t lod = m_buildStamps[i].lod;
+        const uint8_t result = BuildRenderRecord(i, opaque, transparent, lod);
+        if      (result == RECORD_VISIBLE) ++visible;
+        else if (result == RECORD_CULLED)  ++culled;
+        if (result == RECORD_VISIBLE && lod > 0) ++lodMeshes;
+        StampRecord(m_buildStamps[i], i, result, lod);
+    }
+}
+
+// Culls one draw record against the light volumes and submits its shadow
+// casting items. Materials and shaders were resolved by RetainedDrawList.
+// lod receives the mesh's current level, which the casters are drawn at.
+uint8_t RenderManager::BuildShadowRecord(uint32_t index, RenderQueue& out, uint8_t& lod)
+{
+    const RetainedDrawList::Record& record = m_drawList.GetRecords()[index];
+    Mesh* mesh = record.mesh;
+    if (!record.drawable || !mesh)                 return RECORD_SKIPPED;
+
+    lod = m_lodSelection ? static_cast<uint8_t>(mesh->GetLodLevel()) : 0;
+
+    if (!mesh->GetCastShadows())                   return RECORD_SKIPPED;
+    if (!(mesh->GetLayerMask() & m_buildCullMask)) return RECORD_SKIPPED;
+
+    const DirectX::XMMATRIX world = mesh->GetWorldMatrix();
+
+    if (m_useLightVolume || m_useCasterVolume)
+    {
+        DirectX::BoundingBox bounds;
+        if (mesh->GetWorldBounds(world, bounds))
+        {
+            if ((m_useLightVolume  && !m_lightVolume.Intersects(bounds)) ||
+                (m_useCasterVolume && !m_casterVolume.Intersects(bounds)))
+                return RECORD_CULLED;
+        }
+    }
+
+    // Written once per mesh; commands reference it by index.
+    uint32_t worldIndex = UINT32_MAX;
+
+    for (const RetainedDrawList::Item& item : record.items)
+    {
+        if (!item.castShadows) continue;
+
+        if (!m_backend->IsShaderValid(item.shader, ShaderBindMode::VS_ONLY))
+        {
+            DBERROR("RenderManager.cpp: BuildShadowQueue - invalid shader, draw skipped");
+            continue;
+        }
+
+        Surface* surface = lod ? mesh->GetMeshAsset()->GetLodSlot(lod, item.slot) : item.surface;
+        if (!surface) continue;
+
+        if (worldIndex == UINT32_MAX) worldIndex = out.AddWorld(world);
+        out.Submit(item.shader, item.flagsVertex, item.material, mesh, surface,
+                   worldIndex, m_backend.get(), 0.0f, index);
+    }
+    return RECORD_VISIBLE;
+}
+
+// Culls one draw record against the camera frustum and submits its items
+// to the opaque or transparent queue. lod passes in the level this queue
+// drew last and receives the level drawn now (unchanged when not visible).
+uint8_t RenderManager::BuildRenderRecord(uint32_t index, RenderQueue& opaque, RenderQueue& transparent, uint8_t& lod)
+{
+    const RetainedDrawList::Record& record = m_drawList.GetRecords()[index];
+    Mesh* mesh = record.mesh;
+    if (!record.drawable || !mesh)                 return RECORD_SKIPPED;
+    if (!(mesh->GetLayerMask() & m_buildCullMask)) return RECORD_SKIPPED;
+
+    const DirectX::XMMATRIX world = mesh->GetWorldMatrix();
+
+    if (m_useCameraVolume)
+    {
+        DirectX::BoundingBox bounds;
+        if (mesh->GetWorldBounds(world, bounds) && !m_cameraVolume.Intersects(bounds))
+            return RECORD_CULLED;
+    }
+
+    const MeshAsset* asset = mesh->GetMeshAsset();
+    uint32_t level = 0;
+    if (m_buildLod && asset->NumLods() > 1)
+    {
+        // The main camera keeps its level in the mesh (shared with the shadow
+        // pass); other cameras keep theirs in the queue stamps.
+        const uint32_t current = m_buildLodOwner ? mesh->GetLodLevel() : lod;
+        level = SelectRecordLod(*mesh, world, current);
+    }
+    if (m_buildLodOwner && mesh->GetLodLevel() != level)
+    {
+        mesh->SetLodLevel(level);
+        m_lodRevision.fetch_add(1, std::memory_order_relaxed);
+    }
+    lod = static_cast<uint8_t>(level);
+
+    // World matrix goes into each queue's table at most once per mesh.
+    uint32_t opaqueWorld = UINT32_MAX;
+    uint32_t transWorld  = UINT32_MAX;
+
+    // Squared camera distance: front-to-back for opaque, back-to-front for transparent.
+    const DirectX::XMVECTOR camPos = DirectX::XMLoadFloat3(&m_buildCamPos);
+    const DirectX::XMVECTOR diff   = DirectX::XMVectorSubtract(world.r[3], camPos);
+    const float             depth  = DirectX::XMVectorGetX(DirectX::XMVector3LengthSq(diff));
+
+    for (const RetainedDrawList::Item& item : record.items)
+    {
+        Surface* surface = level ? asset->GetLodSlot(level, item.slot) : item.surface;
+        if (!surface) continue;
+
+        if (item.transparent)
+        {
+            if (transWorld == UINT32_MAX) transWorld = transparent.AddWorld(world);
+            transparent.Submit(item.shader, item.flagsVertex, item.material, mesh, surface,
+                               transWorld, m_backend.get(), depth, index);
+        }
+        else
+        {
+            if (opaqueWorld == UINT32_MAX) opaqueWorld = opaque.AddWorld(world);
+            opaque.Submit(item.shader, item.flagsVertex, item.material, mesh, surface,
+                          opaqueWorld, m_backend.get(), depth, index);
+        }
+    }
+    return RECORD_VISIBLE;
+}
+
+// Projected bounding sphere radius of the last build's camera.
+float RenderManager::ProjectedSize(const DirectX::BoundingBox& bounds) const
+{
+    const float radius = DirectX::XMVectorGetX(DirectX::XMVector3Length(DirectX::XMLoadFloat3(&bounds.Extents)));
+    float size = radius * m_buildProjScale;
+    if (!m_buildOrtho)
+    {
+        const DirectX::XMVECTOR diff = DirectX::XMVectorSubtract(DirectX::XMLoadFloat3(&bounds.Center),
+                                                                 DirectX::XMLoadFloat3(&m_buildCamPos));
+        const float distance = DirectX::XMVectorGetX(DirectX::XMVector3Length(diff));
+        size /= (std::max)(distance, radius);
+    }
+    return size;
+}
+
+// Level for the mesh's projected bounding sphere, starting from current.
+uint32_t RenderManager::SelectRecordLod(Mesh& mesh, const DirectX::XMMATRIX& world, uint32_t current) const
+{
+    DirectX::BoundingBox bounds;
+    if (!mesh.GetWorldBounds(world, bounds)) return 0;
+
+    return mesh.GetMeshAsset()->SelectLod(ProjectedSize(bounds) * m_lodBias, current, m_lodHysteresis);
+}
+
+// Texture streaming input: each texture of a drawn command asks for as many
+// texels as its mesh's bounding sphere covers pixels (diameter = size times
+// the viewport height), times the material's UV tiling.
+void RenderManager::RequestTextureDetail(const RenderQueue& queue, float viewportHeight)
+{
+    for (const RenderCommand& cmd : queue.commands)
+    {
+        if (!cmd.mesh || !cmd.material) continue;
+
+        DirectX::BoundingBox bounds;
+        if (!cmd.mesh->GetWorldBounds(queue.GetWorld(cmd.worldIndex), bounds)) continue;
+
+        const DirectX::XMFLOAT4 tiling = cmd.material->GetUVTilingOffset();
+        const float repeat = (std::max)(std::fabs(tiling.x), std::fabs(tiling.y));
+        const float texels = ProjectedSize(bounds) * viewportHeight * (repeat > 0.0f ? repeat : 1.0f);
+
+        const Material& m = *cmd.material;
+        for (uint32_t index : { m.albedoIndex, m.decalIndex, m.normalIndex, m.ormIndex,
+                                m.occlusionIndex, m.roughnessIndex, m.metallicIndex })
+            m_texturePool->RequestTexels(index, texels);
+    }
+}
+
+void RenderManager::StampRecord(RecordStamp& stamp, uint32_t index, uint8_t result, uint8_t lod) const
+{
+    const RetainedDrawList::Record& record = m_drawList.GetRecords()[index];
+    const MeshAsset* asset = record.mesh ? record.mesh->GetMeshAsset() : nullptr;
+    stamp.geometry = asset ? asset->GetGeometrySignature() : 0;
+    stamp.resolve  = record.resolveStamp;
+    stamp.world    = record.mesh ? record.mesh->GetWorldRevision() : 0;
+    stamp.result   = result;
+    stamp.lod      = lod;
+}
+
+// checkGeometry: a surface was uploaded since the last build. Only then is
+// the asset signature compared, so other patches stay two loads per record.
+bool RenderManager::IsRecordChanged(const RecordStamp& stamp, uint32_t index, bool checkGeometry) const
+{
+    const RetainedDrawList::Record& record = m_drawList.GetRecords()[index];
+    if (stamp.resolve != record.resolveStamp ||
+        stamp.world   != (record.mesh ? record.mesh->GetWorldRevision() : 0))
+        return true;
+    if (!checkGeometry) return false;
+
+    const MeshAsset* asset = record.mesh ? record.mesh->GetMeshAsset() : nullptr;
+    return stamp.geometry != (asset ? asset->GetGeometrySignature() : 0);
+}
+
+bool RenderManager::QueueKey::operator==(const QueueKey& other) const noexcept
+{
+    return std::memcmp(&view,       &other.view,       sizeof(view))       == 0 &&
+           std::memcmp(&proj,       &other.proj,       sizeof(proj))       == 0 &&
+           std::memcmp(&cameraView, &other.cameraView, sizeof(cameraView)) == 0 &&
+           std::memcmp(&cameraProj, &other.cameraProj, sizeof(cameraProj)) == 0 &&
+           backend  == other.backend  &&
+           cullMask == other.cullMask &&
+           flags    == other.flags    &&
+           lodBias  == other.lodBias  &&
+           layout   == other.layout   &&
+           bulk     == other.bulk;
+}
+
+// Incremental update of a valid retained queue. Only records whose resolve,
+// world or geometry stamp changed since the last build are culled and
+// submitted again; their old commands are removed and the sorted new ones merged in,
+// so the rest of the queue is neither rebuilt nor re-sorted.
+uint32_t RenderManager::PatchRenderQueue(RetainedQueueState& state, bool checkGeometry)
+{
+    const uint32_t recordCount = m_drawList.GetRecordCount();
+    m_patchRemoved.assign(recordCount, 0);
+    m_patchOpaque.Clear();
+    m_patchTransparent.Clear();
+
+    uint32_t patched = 0;
+    for (uint32_t i = 0; i < recordCount; ++i)
+    {
+        RecordStamp& stamp = state.stamps[i];
+        if (!IsRecordChanged(stamp, i, checkGeometry)) continue;
+
+        if      (stamp.result == RECORD_VISIBLE) --state.visible;
+        else if (stamp.result == RECORD_CULLED)  --state.culled;
+        if (stamp.result == RECORD_VISIBLE && stamp.lod > 0) --state.lodMeshes;
+
+        uint8_t lod = stamp.lod;
+        const uint8_t result = BuildRenderRecord(i, m_patchOpaque, m_patchTransparent, lod);
+        if      (result == RECORD_VISIBLE) ++state.visible;
+        else if (result == RECORD_CULLED)  ++state.culled;
+        if (result == RECORD_VISIBLE && lod > 0) ++state.lodMeshes;
+
+        StampRecord(stamp, i, result, lod);
+        m_patchRemoved[i] = 1;
+        ++patched;
+    }
+    if (patched == 0) return 0;
+
+    m_opaque.RemoveRecords(m_patchRemoved);
+    m_transparent.RemoveRecords(m_patchRemoved);
+
+    m_patchOpaque.Sort();
+    m_patchTransparent.Sort();
+    m_opaque.MergeSorted(m_patchOpaque);
+    m_transparent.MergeSorted(m_patchTransparent);
+
+    m_opaque.CompactWorlds();
+    m_transparent.CompactWorlds();
+    return patched;
+}
+
+uint32_t RenderManager::PatchShadowQueue(RetainedQueueState& state, bool checkGeometry)
+{
+    const uint32_t recordCount = m_drawList.GetRecordCount();
+    m_patchRemoved.assign(recordCount, 0);
+    m_patchShadow.Clear();
+
+    uint32_t patched = 0;
+    for (uint32_t i = 0; i < recordCount; ++i)
+    {
+        RecordStamp& stamp = state.stamps[i];
+        const Mesh*  mesh  = m_drawList.GetRecords()[i].mesh;
+        const bool lodChanged = stamp.result == RECORD_VISIBLE && mesh &&
+                                stamp.lod != (m_lodSelection ? mesh->GetLodLevel() : 0u);
+        if (!lodChanged && !IsRecordChanged(stamp, i, checkGeometry)) continue;
+
+        if (stamp.result == RECORD_CULLED) --state.culled;
+
+        uint8_t lod = 0;
+        const uint8_t result = BuildShadowRecord(i, m_patchShadow, lod);
+        if (result == RECORD_CULLED) ++state.culled;
+
+        StampRecord(stamp, i, result, lod);
+        m_patchRemoved[i] = 1;
+        ++patched;
+    }
+    if (patched == 0) return 0;
+
+    m_shadow.RemoveRecords(m_patchRemoved);
+    m_patchShadow.Sort();
+    m_shadow.MergeSorted(m_patchShadow);
+    m_shadow.CompactWorlds();
+    return patched;
+}
+
+// Makes the retained queues of camera current in m_opaque/m_transparent.
+// The previously active view gets its queues back first, so every camera
+// keeps its own sorted queues across frames.
+void RenderManager::SelectView(const Entity* camera)
+{
+    ++m_viewUseCounter;
+
+    int index = -1;
+    for (int i = 0; i < static_cast<int>(m_views.size()); ++i)
+        if (m_views[i].camera == camera) { index = i; break; }
+
+    if (index >= 0 && index == m_activeView)
+    {
+        m_views[index].lastUse = m_viewUseCounter;
+        return;
+    }
+
+    if (m_activeView >= 0)
+    {
+        std::swap(m_opaque,      m_views[m_activeView].opaque);
+        std::swap(m_transparent, m_views[m_activeView].transparent);
+        m_activeView = -1;
+    }
+
+    if (index < 0)
+    {
+        if (m_views.size() < MAX_RETAINED_VIEWS)
+        {
+            m_views.emplace_back();
+            index = static_cast<int>(m_views.size()) - 1;
+        }
+        else
+        {
+            index = 0;
+            for (int i = 1; i < static_cast<int>(m_views.size()); ++i)
+                if (m_views[i].lastUse < m_views[index].lastUse) index = i;
+        }
+
+        m_views[index].camera      = camera;
+        m_views[index].state.valid = false;
+    }
+
+    std::swap(m_opaque,      m_views[index].opaque);
+    std::swap(m_transparent, m_views[index].transparent);
+    m_views[index].lastUse = m_viewUseCounter;
+    m_activeView = index;
+}
+
+void RenderManager::InvalidateRetainedQueues()
+{
+    for (RetainedView& view : m_views)
+        view.state.valid = false;
+    m_shadowState.valid = false;
+    m_drawList.Invalidate();
+}
+
+// Stages the entity block (b0) of every mesh in the queue that was not
+// uploaded earlier this frame, then commits them with one backend call.
+// Blocks hold only world data, so the first pass that draws a mesh uploads
+// it and every later pass re-binds. Members of an instance run are skipped
+// (the instanced VS takes its world from the instance stream); nothing else
+// depends on this upload, collision boxes follow the world matrix in
+// Scene::UpdateWorldMatrices.
+void RenderManager::StageEntityConstants(RenderQueue& queue, bool skipInstanceRuns)
+{
+    size_t nextRun = 0;
+    const uint32_t count = static_cast<uint32_t>(queue.commands.size());
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        if (skipInstanceRuns && nextRun < m_instanceRuns.size() &&
+            m_instanceRuns[nextRun].firstCommand == i)
+        {
+            i += m_instanceRuns[nextRun++].count - 1;
+            continue;
+        }
+
+        RenderCommand& cmd = queue.commands[i];
+        if (!cmd.mesh || cmd.mesh->IsUpdatedThisFrame()) continue;
+
+        m_backend->UploadEntityConstants(m_device, *cmd.mesh,
+                                         MakeEntityConstants(queue.GetWorld(cmd.worldIndex)));
+        cmd.mesh->MarkUpdated();
+    }
+    m_backend->CommitEntityConstants(m_device);
+}
+
+void RenderManager::UploadPassConstants(const DirectX::XMMATRIX& viewMatrix,
+                                        const DirectX::XMMATRIX& projMatrix)
+{
+    PassConstants pass;
+    pass.viewMatrix       = viewMatrix;
+    pass.projectionMatrix = projMatrix;
+
+    const DirectX::XMMATRIX invView = DirectX::XMMatrixInverse(nullptr, viewMatrix);
+    DirectX::XMStoreFloat4(&pass.cameraPosition, DirectX::XMVectorSetW(invView.r[3], 1.0f));
+
+    m_backend->UploadPassConstants(m_device, pass);
+}
+
+void RenderManager::FlushShadowQueue()
 {
     unsigned int shaderBinds = 0;
     unsigned int drawCalls   = 0;
 
+    StageEntityConstants(m_shadow);
+
     Shader* lastShader = nullptr;
 
     for (auto& cmd : m_shadow.commands)
@@ -346,36 +920,23 @@ void RenderManager::FlushShadowQueue(const DirectX::XMMATRIX& lightViewMatrix,
         if (!cmd.shader || !cmd.mesh || !cmd.surface) continue;
 
         // Non-skinned: dedicated shadow VS reads world from b0, light VP from b3.
-        // Skinned: material VS in VS_ONLY mode writes light matrices to b0.
+        // Skinned: material VS in VS_ONLY mode; b5 holds the light VP in this pass.
         const bool useShadowVS  = (m_shadowShader != nullptr && !cmd.mesh->hasSkinning);
         Shader*    activeShader = useShadowVS ? m_shadowShader : cmd.shader;
 
         if (activeShader != lastShader)
         {
-            if (!activeShader->IsValid(ShaderBindMode::VS_ONLY))
+            if (!m_backend->IsShaderValid(activeShader, ShaderBindMode::VS_ONLY))
             {
                 DBERROR("RenderManager.cpp: FlushShadowQueue - invalid shader, draw skipped");
                 continue;
             }
 
-            activeShader->UpdateShader(&m_device, ShaderBindMode::VS_ONLY);
+            m_backend->BindShader(m_device, activeShader, ShaderBindMode::VS_ONLY);
             lastShader = activeShader;
             ++shaderBinds;
         }
 
-        if (useShadowVS)
-        {
-            cmd.mesh->matrixSet = m_currentCam->matrixSet;
-            cmd.mesh->matrixSet.worldMatrix = cmd.world;
-        }
-        else
-        {
-            cmd.mesh->matrixSet = m_currentCam->matrixSet;
-            cmd.mesh->matrixSet.viewMatrix       = lightViewMatrix;
-            cmd.mesh->matrixSet.projectionMatrix = lightProjMatrix;
-            cmd.mesh->matrixSet.worldMatrix      = cmd.world;
-        }
-
         cmd.Execute(&m_device);
         ++drawCalls;
     }
@@ -384,11 +945,76 @@ void RenderManager::FlushShadowQueue(const DirectX::XMMATRIX& lightViewMatrix,
     m_frameStats.shadowDrawCalls += drawCalls;
 }
 
+bool RenderManager::CanInstance(const RenderCommand& cmd) const
+{
+    // Skinned meshes need their own bone palette per draw.
+    return cmd.shader && cmd.material && cmd.mesh && cmd.surface &&
+           cmd.shader->instancedVariant && !cmd.mesh->hasSkinning &&
+           m_backend->IsShaderValid(cmd.shader->instancedVariant, ShaderBindMode::VS_PS);
+}
+
+// Finds runs of commands with identical shader, material and surface. The
+// sort key orders by exactly these fields, so such runs are contiguous.
+// Their world matrices are packed into m_instanceWorlds in command order.
+void RenderManager::BuildInstanceRuns()
+{
+    m_instanceRuns.clear();
+    m_instanceWorlds.clear();
+    if (!m_instancing) return;
+
+    const auto& cmds  = m_opaque.commands;
+    const uint32_t n  = static_cast<uint32_t>(cmds.size());
+
+    for (uint32_t begin = 0; begin < n; )
+    {
+        const RenderCommand& first = cmds[begin];
+        if (!CanInstance(first)) { ++begin; continue; }
+
+        uint32_t end = begin + 1;
+        while (end < n &&
+               cmds[end].shader   == first.shader   &&
+               cmds[end].material == first.material &&
+               cmds[end].surface  == first.surface  &&
+               cmds[end].mesh && !cmds[end].mesh->hasSkinning)
+            ++end;
+
+        if (end - begin >= INSTANCING_MIN_RUN)
+        {
+            InstanceRun run;
+            run.firstCommand  = begin;
+            run.count         = end - begin;
+            run.firstInstance = static_cast<uint32_t>(m_instanceWorlds.size());
+            m_instanceRuns.push_back(run);
+
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                DirectX::XMFLOAT4X4 world;
+                DirectX::XMStoreFloat4x4(&world, m_opaque.GetWorld(cmds[i].worldIndex));
+                m_instanceWorlds.push_back(world);
+            }
+        }
+        begin = end;
+    }
+
+    if (m_instanceRuns.empty()) return;
+
+    // One upload per flush; on failure every run falls back to per-mesh draws.
+    if (!m_backend->UploadInstanceData(m_device, m_instanceWorlds.data(),
+                                       static_cast<uint32_t>(m_instanceWorlds.size())))
+    {
+        DBLOG_ONCE("RenderManager.cpp:instancing-upload",
+            "RenderManager.cpp: BuildInstanceRuns - instance upload failed, drawing per mesh");
+        m_instanceRuns.clear();
+    }
+}
+
 void RenderManager::FlushRenderQueue()
 {
-    unsigned int shaderBinds   = 0;
-    unsigned int materialBinds = 0;
-    unsigned int drawCalls     = 0;
+    unsigned int shaderBinds     = 0;
+    unsigned int materialBinds   = 0;
+    unsigned int drawCalls       = 0;
+    unsigned int instancedDraws  = 0;
+    unsigned int instancedMeshes = 0;
 
     Shader*   lastShader   = nullptr;
     Material* lastMaterial = nullptr;
@@ -396,19 +1022,57 @@ void RenderManager::FlushRenderQueue()
     m_backend->ResetMaterialCache();
     m_backend->BindFrameSampler();
 
-    for (auto& cmd : m_opaque.commands)
+    BuildInstanceRuns();
+    StageEntityConstants(m_opaque, true);
+    size_t nextRun = 0;
+
+    auto& cmds = m_opaque.commands;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(cmds.size()); ++i)
     {
+        auto& cmd = cmds[i];
+
+        if (nextRun < m_instanceRuns.size() && m_instanceRuns[nextRun].firstCommand == i)
+        {
+            const InstanceRun& run = m_instanceRuns[nextRun++];
+            Shader* variant = cmd.shader->instancedVariant;
+
+            if (variant != lastShader)
+            {
+                m_backend->BindShader(m_device, variant, ShaderBindMode::VS_PS);
+                lastShader = variant;
+                ++shaderBinds;
+            }
+
+            if (cmd.material != lastMaterial)
+            {
+                m_backend->BindMaterial(cmd.material, m_texturePool);
+                lastMaterial = cmd.material;
+                ++materialBinds;
+            }
+
+            // View/projection come from the pass block (b5), worlds from
+            // the instance stream: no entity block needed.
+            m_backend->DrawSurfaceInstanced(m_device, *cmd.surface, variant->flagsVertex,
+                                            run.count, run.firstInstance);
+            ++drawCalls;
+            ++instancedDraws;
+            instancedMeshes += run.count;
+
+            i += run.count - 1;
+            continue;
+        }
+
         if (!cmd.shader || !cmd.material || !cmd.mesh || !cmd.surface) continue;
 
         if (cmd.shader != lastShader)
         {
-            if (!cmd.shader->IsValid(ShaderBindMode::VS_PS))
+            if (!m_backend->IsShaderValid(cmd.shader, ShaderBindMode::VS_PS))
             {
                 DBERROR("RenderManager.cpp: FlushRenderQueue - invalid shader, draw skipped");
                 continue;
             }
 
-            cmd.shader->UpdateShader(&m_device);
+            m_backend->BindShader(m_device, cmd.shader, ShaderBindMode::VS_PS);
             lastShader = cmd.shader;
             ++shaderBinds;
         }
@@ -421,25 +1085,26 @@ void RenderManager::FlushRenderQueue()
         }
 
         ++drawCalls;
-
-        cmd.mesh->matrixSet = m_currentCam->matrixSet;
-        cmd.mesh->matrixSet.worldMatrix = cmd.world;
         cmd.Execute(&m_device);
     }
 
-    m_frameStats.shaderBinds     += shaderBinds;
-    m_frameStats.materialBinds   += materialBinds;
-    m_frameStats.opaqueDrawCalls += drawCalls;
+    m_frameStats.shaderBinds        += shaderBinds;
+    m_frameStats.materialBinds      += materialBinds;
+    m_frameStats.opaqueDrawCalls    += drawCalls;
+    m_frameStats.instancedDrawCalls += instancedDraws;
+    m_frameStats.instancedMeshes    += instancedMeshes;
 }
 
 void RenderManager::FlushTransparentQueue()
 {
-    if (m_transFrame.empty()) return;
+    if (m_transparent.commands.empty()) return;
 
     unsigned int shaderBinds   = 0;
     unsigned int materialBinds = 0;
     unsigned int drawCalls     = 0;
 
+    StageEntityConstants(m_transparent);
+
     m_backend->ResetMaterialCache();
     m_backend->BindFrameSampler();
     m_backend->SetAlphaBlend(true);
@@ -447,16 +1112,14 @@ void RenderManager::FlushTransparentQueue()
     Shader*   lastShader   = nullptr;
     Material* lastMaterial = nullptr;
 
-    for (auto& [depth, cmd] : m_transFrame)
+    for (auto& cmd : m_transparent.commands)
     {
-        (void)depth;
-
         if (!cmd.shader || !cmd.material || !cmd.mesh || !cmd.surface) continue;
 
         if (cmd.shader != lastShader)
         {
-            if (!cmd.shader->IsValid(ShaderBindMode::VS_PS)) continue;
-            cmd.shader->UpdateShader(&m_device);
+            if (!m_backend->IsShaderValid(cmd.shader, ShaderBindMode::VS_PS)) continue;
+            m_backend->BindShader(m_device, cmd.shader, ShaderBindMode::VS_PS);
             lastShader = cmd.shader;
             ++shaderBinds;
         }
@@ -469,9 +1132,6 @@ void RenderManager::FlushTransparentQueue()
         }
 
         ++drawCalls;
-
-        cmd.mesh->matrixSet = m_currentCam->matrixSet;
-        cmd.mesh->matrixSet.worldMatrix = cmd.world;
         cmd.Execute(&m_device);
     }
 
@@ -493,6 +1153,10 @@ void RenderManager::RenderScene()
 
     InvalidateFrame();
 
+    // One top-down pass over changed transforms; both queue builds then
+    // only read cached world matrices.
+    m_scene.UpdateWorldMatrices();
+
     LPENTITY savedCam = m_currentCam;
     if (m_activeRTT && m_rttCamera)
         m_currentCam = m_rttCamera;
@@ -509,11 +1173,27 @@ void RenderManager::EnsureBackend()
 {
     if (m_backend) return;
 
-    if (!m_device.IsInitialized())
+    if (!m_backendFactory)
     {
-        DBERROR("RenderManager.cpp: EnsureBackend - device not ready");
+        DBERROR("RenderManager.cpp: EnsureBackend - no backend factory set");
         return;
     }
 
-    m_backend = std::make_unique<Dx11RenderBackend>(m_device);
+    m_backend = m_backendFactory(m_device);
+    if (!m_backend)
+        DBERROR("RenderManager.cpp: EnsureBackend - backend factory returned nullptr");
+    InvalidateRetainedQueues();
+}
+
+void RenderManager::SetBackendFactory(BackendFactory factory)
+{
+    m_backendFactory = std::move(factory);
+    m_backend.reset();
+    InvalidateRetainedQueues();
+}
+
+bool RenderManager::IsBackendReady() const
+{
+    if (!m_backend) return false;
+    return !m_backend->RequiresDevice() || m_device.IsInitialized();
 }
@@ -0,0 +1,131 @@
+#include "RenderQueue.h"
+
+void RenderQueue::Sort()
+{
+    const size_t count = commands.size();
+    if (count < 2) return;
+
+    m_sortA.resize(count);
+    m_sortB.resize(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_sortA[i].key   = commands[i].sortKey;
+        m_sortA[i].index = static_cast<uint32_t>(i);
+    }
+
+    // One histogram sweep for all 8 digits.
+    uint32_t histogram[8][256] = {};
+    for (size_t i = 0; i < count; ++i)
+    {
+        const uint64_t key = m_sortA[i].key;
+        for (unsigned int d = 0; d < 8; ++d)
+            ++histogram[d][(key >> (d * 8)) & 0xFFu];
+    }
+
+    SortEntry* src = m_sortA.data();
+    SortEntry* dst = m_sortB.data();
+
+    for (unsigned int d = 0; d < 8; ++d)
+    {
+        uint32_t* h = histogram[d];
+
+        // All entries share this digit: pass would be an identity copy.
+        const uint32_t firstDigit = static_cast<uint32_t>((src[0].key >> (d * 8)) & 0xFFu);
+        if (h[firstDigit] == count) continue;
+
+        uint32_t offset = 0;
+        for (unsigned int b = 0; b < 256; ++b)
+        {
+            const uint32_t n = h[b];
+            h[b]    = offset;
+            offset += n;
+        }
+
+        const unsigned int shift = d * 8;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32_t digit = static_cast<uint32_t>((src[i].key >> shift) & 0xFFu);
+            dst[h[digit]++] = src[i];
+        }
+
+        SortEntry* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    // Gather commands in key order (one move per command).
+    m_sorted.resize(count);
+    for (size_t i = 0; i < count; ++i)
+        m_sorted[i] = commands[src[i].index];
+
+    commands.swap(m_sorted);
+}
+
+void RenderQueue::RemoveRecords(const std::vector<uint8_t>& removed)
+{
+    size_t out = 0;
+    for (size_t i = 0; i < commands.size(); ++i)
+    {
+        const uint32_t record = commands[i].drawRecord;
+        if (record < removed.size() && removed[record]) continue;
+        commands[out++] = commands[i];
+    }
+    commands.resize(out);
+}
+
+void RenderQueue::MergeSorted(const RenderQueue& other)
+{
+    if (other.commands.empty()) return;
+
+    const uint32_t base = static_cast<uint32_t>(m_worlds.size());
+    m_worlds.insert(m_worlds.end(), other.m_worlds.begin(), other.m_worlds.end());
+
+    const size_t countA = commands.size();
+    const size_t countB = other.commands.size();
+    m_sorted.resize(countA + countB);
+
+    size_t a = 0, b = 0, out = 0;
+    while (a < countA && b < countB)
+    {
+        if (other.commands[b].sortKey < commands[a].sortKey)
+        {
+            m_sorted[out] = other.commands[b++];
+            m_sorted[out++].worldIndex += base;
+        }
+        else
+        {
+            m_sorted[out++] = commands[a++];
+        }
+    }
+    while (a < countA) m_sorted[out++] = commands[a++];
+    while (b < countB)
+    {
+        m_sorted[out] = other.commands[b++];
+        m_sorted[out++].worldIndex += base;
+    }
+
+    commands.swap(m_sorted);
+}
+
+void RenderQueue::CompactWorlds()
+{
+    // Patching only appends; rebuild the table once dead entries dominate.
+    if (m_worlds.size() <= 2 * commands.size() + 64) return;
+
+    m_worldRemap.assign(m_worlds.size(), 0xFFFFFFFFu);
+    m_worldScratch.clear();
+
+    for (RenderCommand& cmd : commands)
+    {
+        uint32_t& mapped = m_worldRemap[cmd.worldIndex];
+        if (mapped == 0xFFFFFFFFu)
+        {
+            mapped = static_cast<uint32_t>(m_worldScratch.size());
+            m_worldScratch.push_back(m_worlds[cmd.worldIndex]);
+        }
+        cmd.worldIndex = mapped;
+    }
+
+    m_worlds.swap(m_worldScratch);
+}
@@ -0,0 +1,125 @@
+#include "RetainedDrawList.h"
+#include "Scene.h"
+#include "Mesh.h"
+#include "Material.h"
+#include "Shader.h"
+
+bool RetainedDrawList::Sync(const Scene& scene, Material* standardMaterial)
+{
+    const uint32_t state  = scene.GetRenderRevision().GetState();
+    const uint32_t assets = scene.GetRenderRevision().GetAssets();
+
+    const bool resolveAll = m_invalid || assets != m_syncedAssets ||
+                            standardMaterial != m_standardMaterial;
+    if (!resolveAll && state == m_syncedState)
+        return false;
+
+    m_resolvedCount = 0;
+
+    const std::vector<Mesh*>& meshes = scene.GetMeshes();
+
+    // Create/delete keeps the relative mesh order, so records usually still
+    // line up with the scene list and are checked by index.
+    bool sameLayout = (meshes.size() == m_records.size());
+    for (size_t i = 0; sameLayout && i < meshes.size(); ++i)
+        sameLayout = (m_records[i].mesh == meshes[i]);
+
+    if (sameLayout)
+    {
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            Record& record = m_records[i];
+            Mesh*   mesh   = meshes[i];
+            if (resolveAll || !mesh || record.renderRevision != mesh->GetRenderRevision())
+                Resolve(record, mesh, standardMaterial);
+        }
+    }
+    else
+    {
+        Relayout(meshes, standardMaterial, resolveAll);
+    }
+
+    if (resolveAll || !sameLayout)
+        ++m_layoutRevision;
+
+    m_standardMaterial = standardMaterial;
+    m_syncedState      = state;
+    m_syncedAssets     = assets;
+    m_invalid          = false;
+
+    return m_resolvedCount > 0 || !sameLayout;
+}
+
+void RetainedDrawList::Relayout(const std::vector<Mesh*>& meshes, Material* standardMaterial, bool resolveAll)
+{
+    // Old records are looked up by pointer only. Deleted meshes may have left
+    // dangling keys; a new mesh at the same address has a fresh render
+    // revision and is resolved again.
+    m_index.clear();
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_records.size()); ++i)
+        if (m_records[i].mesh) m_index[m_records[i].mesh] = i;
+
+    m_scratch.clear();
+    m_scratch.resize(meshes.size());
+
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        Mesh* mesh = meshes[i];
+        Record& record = m_scratch[i];
+
+        auto it = m_index.find(mesh);
+        if (it != m_index.end())
+        {
+            record = std::move(m_records[it->second]);
+            m_index.erase(it);
+        }
+
+        if (resolveAll || !mesh || record.mesh != mesh ||
+            record.renderRevision != mesh->GetRenderRevision())
+            Resolve(record, mesh, standardMaterial);
+    }
+
+    m_records.swap(m_scratch);
+    m_scratch.clear();
+}
+
+void RetainedDrawList::Resolve(Record& record, Mesh* mesh, Material* standardMaterial)
+{
+    record.mesh           = mesh;
+    record.renderRevision = mesh ? mesh->GetRenderRevision() : 0;
+    record.resolveStamp   = ++m_resolveCounter;
+    record.drawable       = false;
+    record.items.clear();
+    ++m_resolvedCount;
+
+    if (!mesh || !mesh->HasMeshAsset()) return;
+    if (mesh->GetSurfaces().empty())    return;
+    if (!mesh->IsActive())              return;
+    if (!mesh->IsVisible())             return;
+    if (mesh->IsStaticBatched())        return;
+
+    record.drawable = true;
+
+    const auto& slots = mesh->GetSurfaces();
+    for (unsigned int si = 0; si < static_cast<unsigned int>(slots.size()); ++si)
+    {
+        Surface* surface = slots[si];
+        if (!surface) continue;
+
+        Material* material = mesh->GetResolvedMaterial(si, standardMaterial);
+        if (!material) continue;
+
+        Shader* shader = material->pRenderShader;
+        if (!shader) continue;
+
+        Item item;
+        item.surface     = surface;
+        item.material    = material;
+        item.shader      = shader;
+        item.slot        = si;
+        item.flagsVertex = static_cast<int>(shader->flagsVertex);
+        item.transparent = material->IsTransparent();
+        item.castShadows = material->GetCastShadows();
+        record.items.push_back(item);
+    }
+}
@@ -14,6 +14,7 @@ Camera* Scene::CreateCamera()
 {
     m_ownedCameras.push_back(std::make_unique<Camera>());
     Camera* camera = m_ownedCameras.back().get();
+    camera->BindRenderRevision(&m_renderRevision);
     m_cameras.push_back(camera);
     return camera;
 }
@@ -33,6 +34,7 @@ Light* Scene::CreateLight(LightType type)
 
     m_ownedLights.push_back(std::make_unique<Light>());
     Light* light = m_ownedLights.back().get();
+    light->BindRenderRevision(&m_renderRevision);
     light->SetLightType(type);
 
     if (type == LightType::Point)
@@ -47,6 +49,7 @@ Mesh* Scene::CreateMesh()
 {
     m_ownedMeshes.push_back(std::make_unique<Mesh>());
     Mesh* mesh = m_ownedMeshes.back().get();
+    mesh->BindRenderRevision(&m_renderRevision);
     m_meshes.push_back(mesh);
     return mesh;
 }
@@ -72,6 +75,23 @@ void Scene::DeleteLight(Light* light)
     RemoveOwned(m_ownedLights, light);
 }
 
+void Scene::UpdateWorldMatrices()
+{
+    // System-bound entities carry no per-entity world stamp; any recomputed
+    // slot forces a full rebuild of the retained render queues.
+    if (m_transformSystem.Update() > 0)
+        m_renderRevision.TouchBulk();
+
+    UpdateWorldRoots(m_meshes);
+    UpdateWorldRoots(m_cameras);
+    UpdateWorldRoots(m_lights);
+
+    // Collision boxes follow the world matrices here, culled or not.
+    // Unchanged boxes cost one matrix compare.
+    for (Mesh* mesh : m_meshes)
+        if (mesh && mesh->HasCollision()) mesh->UpdateOBB();
+}
+
 Mesh* Scene::GetPreviousMesh(Mesh* currentMesh)
 {
     for (auto it = m_meshes.begin(); it != m_meshes.end(); ++it)
@@ -14,17 +14,31 @@ Shader::Shader() :
 }
 
 Shader::~Shader() {
+#ifdef _WIN32
     Memory::SafeRelease(inputlayoutVertex);
+    Memory::SafeRelease(inputlayoutPacked);
     Memory::SafeRelease(vertexShader);
     Memory::SafeRelease(pixelShader);
     Memory::SafeRelease(blobVS);
     Memory::SafeRelease(blobPS);
+#endif
 
     // materials Vector wird automatisch aufgeräumt
     // The material objects themselves are managed by AssetManager, do not delete here.
     materials.clear();
 }
 
+#ifdef _WIN32
+void* Shader::GetVertexBytecode() const
+{
+    return blobVS ? blobVS->GetBufferPointer() : nullptr;
+}
+
+SIZE_T Shader::GetVertexBytecodeSize() const
+{
+    return blobVS ? blobVS->GetBufferSize() : 0;
+}
+
 void Shader::UpdateShader(const GDXDevice* device, ShaderBindMode mode)
 {
     // Fehlerbehandlung: Prüfe auf nullptr
@@ -69,5 +83,9 @@ void Shader::UpdateShader(const GDXDevice* device, ShaderBindMode mode)
     // Markiere als aktiv
     isActive = true;
 }
-
-
+#else
+// Off Windows a shader never holds D3D objects (see gdxplatform.h).
+void* Shader::GetVertexBytecode() const { return nullptr; }
+SIZE_T Shader::GetVertexBytecodeSize() const { return 0; }
+void Shader::UpdateShader(const GDXDevice*, ShaderBindMode) {}
+#endif
@@ -0,0 +1,326 @@
+#include "StaticBatcher.h"
+#include "AssetManager.h"
+#include "Scene.h"
+#include "Mesh.h"
+#include "Surface.h"
+#include "Material.h"
+#include "gdxutil.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <unordered_set>
+
+using namespace DirectX;
+
+namespace
+{
+    enum : uint32_t
+    {
+        ATTR_NORMAL  = 1u << 0,
+        ATTR_COLOR   = 1u << 1,
+        ATTR_UV1     = 1u << 2,
+        ATTR_UV2     = 1u << 3,
+        ATTR_TANGENT = 1u << 4,
+    };
+
+    // One source surface slot.
+    struct Part
+    {
+        Mesh*     mesh      = nullptr;
+        Surface*  surface   = nullptr;
+        Material* material  = nullptr;
+        uint32_t  layerMask = 0;
+        bool      shadows   = false;
+        int32_t   cell[3]   = {};
+        uint32_t  attribs   = 0;
+    };
+
+    bool SameBatch(const Part& a, const Part& b) noexcept
+    {
+        return a.layerMask == b.layerMask && a.shadows == b.shadows &&
+               a.cell[0] == b.cell[0] && a.cell[1] == b.cell[1] && a.cell[2] == b.cell[2];
+    }
+
+    bool SameSurface(const Part& a, const Part& b) noexcept
+    {
+        return SameBatch(a, b) && a.material == b.material && a.attribs == b.attribs;
+    }
+
+    bool PartLess(const Part& a, const Part& b) noexcept
+    {
+        if (a.layerMask != b.layerMask) return a.layerMask < b.layerMask;
+        if (a.shadows   != b.shadows)   return a.shadows < b.shadows;
+        for (int i = 0; i < 3; ++i)
+            if (a.cell[i] != b.cell[i]) return a.cell[i] < b.cell[i];
+        if (a.material != b.material)
+            return a.material->id != b.material->id ? a.material->id < b.material->id
+                                                    : std::less<Material*>()(a.material, b.material);
+        if (a.attribs  != b.attribs)    return a.attribs < b.attribs;
+        return a.surface->id < b.surface->id;
+    }
+
+    uint32_t AttribMask(const Surface& s) noexcept
+    {
+        const unsigned int n = s.CountVertices();
+        uint32_t mask = 0;
+        if (s.CountNormals()  == n) mask |= ATTR_NORMAL;
+        if (s.CountColors()   == n) mask |= ATTR_COLOR;
+        if (s.CountUV1()      == n) mask |= ATTR_UV1;
+        if (s.CountUV2()      == n) mask |= ATTR_UV2;
+        if (s.CountTangents() == n) mask |= ATTR_TANGENT;
+        return mask;
+    }
+
+    int32_t CellCoord(float v, float chunkSize) noexcept
+    {
+        if (chunkSize <= 0.0f) return 0;
+        return static_cast<int32_t>(std::floor(v / chunkSize));
+    }
+}
+
+StaticBatchStats StaticBatcher::Build(Scene& scene, AssetManager& assets, const StaticBatchDesc& desc)
+{
+    Clear(scene, assets);
+
+    Material* standardMaterial = assets.GetStandardMaterial();
+    const uint32_t maxVertices = (std::max)(desc.maxVertices, 3u);
+
+    // ---- collect candidate slots ------------------------------------------
+    std::vector<Part> parts;
+    for (Mesh* mesh : scene.GetMeshes())
+    {
+        if (!mesh || !mesh->IsStatic()) continue;
+        if (!mesh->IsActive() || !mesh->IsVisible()) continue;
+        if (mesh->hasSkinning || !mesh->HasMeshAsset()) continue;
+
+        const XMMATRIX world = mesh->GetWorldMatrix();
+        BoundingBox bounds;
+        if (!mesh->GetWorldBounds(world, bounds)) continue;
+
+        Part base;
+        base.mesh      = mesh;
+        base.layerMask = mesh->GetLayerMask();
+        base.shadows   = mesh->GetCastShadows();
+        base.cell[0]   = CellCoord(bounds.Center.x, desc.chunkSize);
+        base.cell[1]   = CellCoord(bounds.Center.y, desc.chunkSize);
+        base.cell[2]   = CellCoord(bounds.Center.z, desc.chunkSize);
+
+        // A mesh is batched completely or not at all: it is hidden as a whole.
+        const size_t first = parts.size();
+        bool batchable = true;
+        const auto& slots = mesh->GetSurfaces();
+        for (unsigned int si = 0; si < static_cast<unsigned int>(slots.size()) && batchable; ++si)
+        {
+            Surface* surface = slots[si];
+            if (!surface || !surface->isActive) continue;
+
+            // No CPU geometry to merge: the mesh keeps drawing on its own.
+            if (surface->IsGpuOnly()) { batchable = false; break; }
+            if (surface->CountVertices() == 0 || surface->CountIndices() < 3) continue;
+
+            Material* material = mesh->GetResolvedMaterial(si, standardMaterial);
+            if (!material || material->IsTransparent() || surface->CountBoneData() > 0 ||
+                surface->CountVertices() > maxVertices)
+            {
+                batchable = false;
+                break;
+            }
+
+            Part part     = base;
+            part.surface  = surface;
+            part.material = material;
+            part.attribs  = AttribMask(*surface);
+            parts.push_back(part);
+        }
+
+        if (!batchable || parts.size() == first)
+            parts.resize(first);
+    }
+
+    std::sort(parts.begin(), parts.end(), PartLess);
+
+    // ---- emit one batch mesh per (layer, shadow flag, cell) ---------------
+    for (size_t begin = 0; begin < parts.size();)
+    {
+        size_t end = begin + 1;
+        while (end < parts.size() && SameBatch(parts[begin], parts[end])) ++end;
+
+        std::vector<Mesh*> sources;
+        for (size_t i = begin; i < end; ++i)
+            sources.push_back(parts[i].mesh);
+        std::sort(sources.begin(), sources.end());
+        sources.erase(std::unique(sources.begin(), sources.end()), sources.end());
+
+        if (sources.size() < desc.minMeshes)
+        {
+            begin = end;
+            continue;
+        }
+
+        Mesh* batch = assets.CreateManagedMesh(scene);
+        if (!batch)
+        {
+            DBERROR("StaticBatcher.cpp: Build - failed to create batch mesh");
+            break;
+        }
+        batch->SetStatic(true);
+        batch->SetLayerMask(parts[begin].layerMask);
+        batch->SetCastShadows(parts[begin].shadows);
+
+        // Counted into m_stats only once the whole group is merged.
+        StaticBatchStats added;
+        added.batchMeshes = 1;
+        bool complete = true;
+
+        Surface* target      = nullptr;
+        uint32_t targetAttrs = 0;
+
+        // Transformed streams of one part, appended to the target in bulk.
+        std::vector<XMFLOAT3>     positions;
+        std::vector<XMFLOAT3>     normals;
+        std::vector<XMFLOAT4>     tangents;
+        std::vector<unsigned int> indices;
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            const Part&    part   = parts[i];
+            const Surface& source = *part.surface;
+            const uint32_t vcount = source.CountVertices();
+
+            // New surface per material/format, or when the vertex limit is hit.
+            if (!target || !SameSurface(parts[i - 1], part) ||
+                target->CountVertices() + vcount > maxVertices)
+            {
+                target = assets.CreateSurface();
+                if (!target) { complete = false; break; }
+                assets.AddSurfaceToMesh(batch, target);
+                assets.SetSlotMaterial(batch, batch->GetSlotCount() - 1, part.material);
+                targetAttrs = part.attribs;
+                ++added.batchSurfaces;
+            }
+
+            const XMMATRIX world   = part.mesh->GetWorldMatrix();
+            const XMMATRIX normalM = XMMatrixTranspose(XMMatrixInverse(nullptr, world));
+            const bool     mirror  = XMVectorGetX(XMMatrixDeterminant(world)) < 0.0f;
+            const uint32_t baseVertex = target->CountVertices();
+
+            const std::vector<XMFLOAT3>& srcPositions = source.GetPositions();
+            positions.resize(vcount);
+            for (uint32_t v = 0; v < vcount; ++v)
+                XMStoreFloat3(&positions[v], XMVector3TransformCoord(XMLoadFloat3(&srcPositions[v]), world));
+            target->AddVertices(positions);
+
+            if (targetAttrs & ATTR_NORMAL)
+            {
+                const std::vector<XMFLOAT3>& srcNormals = source.GetNormals();
+                normals.resize(vcount);
+                for (uint32_t v = 0; v < vcount; ++v)
+                    XMStoreFloat3(&normals[v], XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&srcNormals[v]), normalM)));
+                target->AddNormals(normals);
+            }
+            if (targetAttrs & ATTR_TANGENT)
+            {
+                const std::vector<XMFLOAT4>& srcTangents = source.GetTangents();
+                tangents.resize(vcount);
+                for (uint32_t v = 0; v < vcount; ++v)
+                {
+                    const XMFLOAT4& t = srcTangents[v];
+                    XMFLOAT3 dir;
+                    XMStoreFloat3(&dir, XMVector3Normalize(XMVector3TransformNormal(XMVectorSet(t.x, t.y, t.z, 0.0f), world)));
+                    tangents[v] = XMFLOAT4(dir.x, dir.y, dir.z, mirror ? -t.w : t.w);
+                }
+                target->AddTangents(tangents);
+            }
+            if (targetAttrs & ATTR_COLOR)
+                target->AddColors(source.GetColors());
+            if (targetAttrs & ATTR_UV1)
+                target->AddTexCoords(source.GetUV1());
+            if (targetAttrs & ATTR_UV2)
+                target->AddTexCoords2(source.GetUV2());
+
+            // A mirroring transform flips the winding; swap two corners back.
+            const std::vector<unsigned int>& srcIndices = source.GetIndices();
+            const size_t triCount = srcIndices.size() / 3;
+            indices.resize(triCount * 3);
+            for (size_t t = 0; t < triCount; ++t)
+            {
+                const unsigned int a = srcIndices[t * 3 + 0];
+                const unsigned int b = srcIndices[t * 3 + 1];
+                const unsigned int c = srcIndices[t * 3 + 2];
+                indices[t * 3 + 0] = a;
+                indices[t * 3 + 1] = mirror ? c : b;
+                indices[t * 3 + 2] = mirror ? b : c;
+            }
+            target->AddIndices(indices, baseVertex);
+
+            ++added.sourceSurfaces;
+            added.vertices += vcount;
+            added.indices  += static_cast<uint32_t>(triCount * 3);
+        }
+
+        // A partly merged group would hide the geometry that is missing from
+        // it: drop the batch and leave its sources drawing on their own.
+        if (!complete)
+        {
+            DBERROR("StaticBatcher.cpp: Build - failed to create batch surface");
+            std::vector<Surface*> surfaces(batch->GetSurfaces().begin(), batch->GetSurfaces().end());
+            assets.DeleteManagedMesh(scene, batch);
+            for (Surface* surface : surfaces)
+                assets.DeleteSurface(scene, surface);
+            break;
+        }
+
+        // Sources leave the render queues but keep colliding: make sure
+        // their boxes are current without relying on a draw.
+        for (Mesh* source : sources)
+        {
+            source->SetStaticBatched(true);
+            source->UpdateOBB();
+            m_sources.push_back(source);
+        }
+        added.sourceMeshes = static_cast<uint32_t>(sources.size());
+
+        m_batches.push_back(batch);
+        m_stats.sourceMeshes   += added.sourceMeshes;
+        m_stats.sourceSurfaces += added.sourceSurfaces;
+        m_stats.batchMeshes    += added.batchMeshes;
+        m_stats.batchSurfaces  += added.batchSurfaces;
+        m_stats.vertices       += added.vertices;
+        m_stats.indices        += added.indices;
+
+        batch->InvalidateBounds();
+        begin = end;
+    }
+
+    DBLOG("StaticBatcher.cpp: ", (int)m_stats.sourceMeshes, " meshes / ", (int)m_stats.sourceSurfaces,
+          " surfaces merged into ", (int)m_stats.batchMeshes, " batches / ", (int)m_stats.batchSurfaces, " surfaces");
+    return m_stats;
+}
+
+void StaticBatcher::Clear(Scene& scene, AssetManager& assets)
+{
+    if (!m_batches.empty() || !m_sources.empty())
+    {
+        // Sources or batches may have been deleted by the application since.
+        const std::vector<Mesh*>& meshes = scene.GetMeshes();
+        const std::unordered_set<Mesh*> alive(meshes.begin(), meshes.end());
+
+        for (Mesh* source : m_sources)
+            if (alive.count(source)) source->SetStaticBatched(false);
+
+        std::vector<Surface*> surfaces;
+        for (Mesh* batch : m_batches)
+        {
+            if (!alive.count(batch)) continue;
+            surfaces.assign(batch->GetSurfaces().begin(), batch->GetSurfaces().end());
+            assets.DeleteManagedMesh(scene, batch);
+            for (Surface* surface : surfaces)
+                assets.DeleteSurface(scene, surface);
+        }
+    }
+
+    m_batches.clear();
+    m_sources.clear();
+    m_stats = StaticBatchStats{};
+}
@@ -1,12 +1,20 @@
 #include "Surface.h"
+#include "gdxutil.h"
+#ifdef _WIN32
 #include "SurfaceGpuBuffer.h"
+#endif
+
+#include <algorithm>
 
 using namespace DirectX;
 
 Surface::Surface()
     : isActive(true)
-    , gpu(std::make_unique<SurfaceGpuBuffer>())
 {
+#ifdef _WIN32
+    // Off Windows a surface keeps its CPU data only (see gdxplatform.h).
+    gpu = std::make_unique<SurfaceGpuBuffer>();
+#endif
 }
 
 float Surface::GetVertexX(unsigned int index) const
@@ -30,6 +38,8 @@ void Surface::AddVertex(int index, float x, float y, float z)
         m_positions[index] = XMFLOAT3(x, y, z);
     else
         m_positions.push_back(XMFLOAT3(x, y, z));
+
+    PositionsChanged();
 }
 
 void Surface::VertexColor(int index, float r, float g, float b)
@@ -66,6 +76,94 @@ void Surface::AddIndex(unsigned int index)
     m_indices.push_back(index);
 }
 
+namespace
+{
+    template<typename T>
+    void AppendStream(std::vector<T>& stream, std::span<const T> data)
+    {
+        stream.insert(stream.end(), data.begin(), data.end());
+    }
+}
+
+void Surface::AddVertices(std::span<const XMFLOAT3> positions)
+{
+    if (positions.empty()) return;
+    AppendStream(m_positions, positions);
+    PositionsChanged();
+}
+
+void Surface::AddNormals(std::span<const XMFLOAT3> normals)     { AppendStream(m_normals, normals); }
+void Surface::AddColors(std::span<const XMFLOAT4> colors)       { AppendStream(m_colors, colors); }
+void Surface::AddTexCoords(std::span<const XMFLOAT2> uv)        { AppendStream(m_uv1, uv); }
+void Surface::AddTexCoords2(std::span<const XMFLOAT2> uv)       { AppendStream(m_uv2, uv); }
+void Surface::AddTangents(std::span<const XMFLOAT4> tangents)   { AppendStream(m_tangents, tangents); }
+
+void Surface::AddBoneData(std::span<const XMUINT4> indices, std::span<const XMFLOAT4> weights)
+{
+    // Both streams stay the same length (CountBoneData uses the indices).
+    const size_t count = (std::min)(indices.size(), weights.size());
+    AppendStream(m_boneIndices, indices.first(count));
+    AppendStream(m_boneWeights, weights.first(count));
+}
+
+void Surface::AddIndices(std::span<const unsigned int> indices, unsigned int baseVertex)
+{
+    if (baseVertex == 0)
+    {
+        AppendStream(m_indices, indices);
+        return;
+    }
+
+    const size_t first = m_indices.size();
+    m_indices.resize(first + indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+        m_indices[first + i] = indices[i] + baseVertex;
+}
+
+void Surface::SetVertices(std::vector<XMFLOAT3>&& positions)
+{
+    m_positions = std::move(positions);
+    PositionsChanged();
+}
+
+void Surface::SetNormals(std::vector<XMFLOAT3>&& normals)     { m_normals  = std::move(normals); }
+void Surface::SetColors(std::vector<XMFLOAT4>&& colors)       { m_colors   = std::move(colors); }
+void Surface::SetTexCoords(std::vector<XMFLOAT2>&& uv)        { m_uv1      = std::move(uv); }
+void Surface::SetTexCoords2(std::vector<XMFLOAT2>&& uv)       { m_uv2      = std::move(uv); }
+void Surface::SetTangents(std::vector<XMFLOAT4>&& tangents)   { m_tangents = std::move(tangents); }
+void Surface::SetIndices(std::vector<unsigned int>&& indices) { m_indices  = std::move(indices); }
+
+void Surface::SetBoneData(std::vector<XMUINT4>&& indices, std::vector<XMFLOAT4>&& weights)
+{
+    // Same length rule as AddBoneData.
+    const size_t count = (std::min)(indices.size(), weights.size());
+    indices.resize(count);
+    weights.resize(count);
+    m_boneIndices = std::move(indices);
+    m_boneWeights = std::move(weights);
+}
+
+void Surface::Reserve(unsigned int vertices, unsigned int indices, uint32_t vertexFlags)
+{
+    if (vertexFlags == 0)
+        vertexFlags = D3DVERTEX_NORMAL | D3DVERTEX_TEX1;
+
+    const size_t v = m_positions.size() + vertices;
+    m_positions.reserve(v);
+    m_indices.reserve(m_indices.size() + indices);
+
+    if (vertexFlags & D3DVERTEX_NORMAL)  m_normals.reserve(v);
+    if (vertexFlags & D3DVERTEX_COLOR)   m_colors.reserve(v);
+    if (vertexFlags & D3DVERTEX_TEX1)    m_uv1.reserve(v);
+    if (vertexFlags & D3DVERTEX_TEX2)    m_uv2.reserve(v);
+    if (vertexFlags & D3DVERTEX_TANGENT) m_tangents.reserve(v);
+    if (vertexFlags & (D3DVERTEX_BONE_INDICES | D3DVERTEX_BONE_WEIGHTS))
+    {
+        m_boneIndices.reserve(v);
+        m_boneWeights.reserve(v);
+    }
+}
+
 
 // ---------------------------------------------------------------------------
 // Tangent-Berechnung (Tangent-Space Normalmapping)
@@ -173,3 +271,23 @@ void Surface::ComputeTangents()
         m_tangents[a] = XMFLOAT4(tf3.x, tf3.y, tf3.z, handed);
     }
 }
+
+void Surface::SetGpuOnly(uint32_t vertexCount, uint32_t indexCount,
+                         const XMFLOAT3& boundsMin, const XMFLOAT3& boundsMax) noexcept
+{
+    m_gpuOnly        = true;
+    m_gpuVertexCount = vertexCount;
+    m_gpuIndexCount  = indexCount;
+    m_gpuBoundsMin   = boundsMin;
+    m_gpuBoundsMax   = boundsMax;
+    PositionsChanged();
+}
+
+void Surface::PositionsChanged() noexcept
+{
+    // Bounds may change: MeshAsset::GetGeometrySignature folds this in, so
+    // cached mesh bounds and retained queue stamps notice it. Nothing global
+    // is touched per vertex; the upload (FillBuffer/UpdateVertexBuffer)
+    // tells the retained queues once per edit.
+    ++m_geometryRevision;
+}
@@ -1,6 +1,9 @@
 #include "SurfaceGpuBuffer.h"
 #include <cstdint>
+#include <vector>
 #include "gdxdevice.h"
+#include "BufferManager.h"
+#include "VertexPacker.h"
 
 SurfaceGpuBuffer::~SurfaceGpuBuffer()
 {
@@ -18,20 +21,67 @@ void SurfaceGpuBuffer::Release()
     Memory::SafeRelease(boneIndexBuffer);
     Memory::SafeRelease(boneWeightBuffer);
     Memory::SafeRelease(indexBuffer);
+    Memory::SafeRelease(packedBuffer);
+    stridePacked = 0;
+    indexFormat  = DXGI_FORMAT_R32_UINT;
 }
 
-void SurfaceGpuBuffer::Draw(const GDXDevice* device, unsigned int flagsVertex) const
+HRESULT SurfaceGpuBuffer::CreateIndexBuffer(BufferManager& bufferManager, const unsigned int* indices, unsigned int count)
 {
-    if (!device) return;
+    Memory::SafeRelease(indexBuffer);
+    indexCount  = 0;
+    indexFormat = DXGI_FORMAT_R32_UINT;
 
-    ID3D11DeviceContext* ctx = device->GetDeviceContext();
-    if (!ctx) return;
+    if (!indices || count == 0) return E_INVALIDARG;
+
+    // Check the indices rather than the vertex count, so an index that
+    // points past the vertex data is not silently wrapped.
+    unsigned int maxIndex = 0;
+    for (unsigned int i = 0; i < count; ++i)
+        if (indices[i] > maxIndex) maxIndex = indices[i];
+
+    HRESULT hr;
+    if (maxIndex <= 0xFFFFu)
+    {
+        const std::vector<uint16_t> indices16(indices, indices + count);
+        hr = bufferManager.CreateBuffer(indices16.data(), sizeof(uint16_t), count, D3D11_BIND_INDEX_BUFFER, &indexBuffer);
+        if (SUCCEEDED(hr)) indexFormat = DXGI_FORMAT_R16_UINT;
+    }
+    else
+    {
+        hr = bufferManager.CreateBuffer(indices, sizeof(uint32_t), count, D3D11_BIND_INDEX_BUFFER, &indexBuffer);
+    }
+
+    if (SUCCEEDED(hr)) indexCount = count;
+    return hr;
+}
+
+HRESULT SurfaceGpuBuffer::CreateIndexBuffer(BufferManager& bufferManager, const uint16_t* indices, unsigned int count)
+{
+    Memory::SafeRelease(indexBuffer);
+    indexCount  = 0;
+    indexFormat = DXGI_FORMAT_R32_UINT;
+
+    if (!indices || count == 0) return E_INVALIDARG;
+
+    const HRESULT hr = bufferManager.CreateBuffer(indices, sizeof(uint16_t), count, D3D11_BIND_INDEX_BUFFER, &indexBuffer);
+    if (SUCCEEDED(hr))
+    {
+        indexCount  = count;
+        indexFormat = DXGI_FORMAT_R16_UINT;
+    }
+    return hr;
+}
+
+bool SurfaceGpuBuffer::BindStreams(ID3D11DeviceContext* ctx, unsigned int flagsVertex, UINT& streamCount) const
+{
+    streamCount = 0;
 
     if (!indexBuffer || indexCount == 0)
     {
         DBLOG_ONCE("SurfaceGpuBuffer::Draw:no-index",
             "SurfaceGpuBuffer::Draw skipped: missing index buffer or indexCount == 0");
-        return;
+        return false;
     }
 
     ID3D11Buffer* buffers[8] = {};
@@ -39,9 +89,25 @@ void SurfaceGpuBuffer::Draw(const GDXDevice* device, unsigned int flagsVertex) c
     UINT          offsets[8] = {};
     UINT          slot = 0;
 
+    if (packedBuffer)
+    {
+        // One interleaved stream holds every attribute; only bone data is optional.
+        const bool needsBones = (flagsVertex & (D3DVERTEX_BONE_INDICES | D3DVERTEX_BONE_WEIGHTS)) != 0;
+        if (needsBones && stridePacked < VertexPacker::STRIDE_SKINNED)
+        {
+            DBLOG_ONCE("SurfaceGpuBuffer::Draw:packed-bones",
+                "SurfaceGpuBuffer::Draw skipped: packed surface has no bone data");
+            return false;
+        }
+
+        buffers[0] = packedBuffer;
+        strides[0] = stridePacked;
+        slot = 1;
+    }
+
     auto bindRequired = [&](bool enabled, ID3D11Buffer* buffer, UINT stride, const char* name)
     {
-        if (!enabled) return true;
+        if (!enabled || packedBuffer) return true;
         if (!buffer || stride == 0)
         {
             DBLOG_ONCE(name, "SurfaceGpuBuffer::Draw skipped: missing required vertex stream ", name);
@@ -55,14 +121,14 @@ void SurfaceGpuBuffer::Draw(const GDXDevice* device, unsigned int flagsVertex) c
         return true;
     };
 
-    if (!bindRequired((flagsVertex & D3DVERTEX_POSITION) != 0, positionBuffer,   stridePosition,              "POSITION"))     return;
-    if (!bindRequired((flagsVertex & D3DVERTEX_NORMAL) != 0,   normalBuffer,     strideNormal,                "NORMAL"))       return;
-    if (!bindRequired((flagsVertex & D3DVERTEX_TANGENT) != 0,  tangentBuffer,    strideTangent,               "TANGENT"))      return;
-    if (!bindRequired((flagsVertex & D3DVERTEX_COLOR) != 0,    colorBuffer,      strideColor,                 "COLOR"))        return;
-    if (!bindRequired((flagsVertex & D3DVERTEX_TEX1) != 0,     uv1Buffer,        strideUV1,                   "TEXCOORD0"))    return;
-    if (!bindRequired((flagsVertex & D3DVERTEX_TEX2) != 0,     uv2Buffer,        strideUV2,                   "TEXCOORD1"))    return;
-    if (!bindRequired((flagsVertex & D3DVERTEX_BONE_INDICES) != 0, boneIndexBuffer,  sizeof(uint32_t) * 4,   "BLENDINDICES")) return;
-    if (!bindRequired((flagsVertex & D3DVERTEX_BONE_WEIGHTS) != 0, boneWeightBuffer, sizeof(float) * 4,      "BLENDWEIGHT"))  return;
+    if (!bindRequired((flagsVertex & D3DVERTEX_POSITION) != 0, positionBuffer,   stridePosition,              "POSITION"))     return false;
+    if (!bindRequired((flagsVertex & D3DVERTEX_NORMAL) != 0,   normalBuffer,     strideNormal,                "NORMAL"))       return false;
+    if (!bindRequired((flagsVertex & D3DVERTEX_TANGENT) != 0,  tangentBuffer,    strideTangent,               "TANGENT"))      return false;
+    if (!bindRequired((flagsVertex & D3DVERTEX_COLOR) != 0,    colorBuffer,      strideColor,                 "COLOR"))        return false;
+    if (!bindRequired((flagsVertex & D3DVERTEX_TEX1) != 0,     uv1Buffer,        strideUV1,                   "TEXCOORD0"))    return false;
+    if (!bindRequired((flagsVertex & D3DVERTEX_TEX2) != 0,     uv2Buffer,        strideUV2,                   "TEXCOORD1"))    return false;
+    if (!bindRequired((flagsVertex & D3DVERTEX_BONE_INDICES) != 0, boneIndexBuffer,  sizeof(uint32_t) * 4,   "BLENDINDICES")) return false;
+    if (!bindRequired((flagsVertex & D3DVERTEX_BONE_WEIGHTS) != 0, boneWeightBuffer, sizeof(float) * 4,      "BLENDWEIGHT"))  return false;
 
     // Vorherige Bindings sauber leeren, damit keine alten Streams in hoehere Slots hineinragen.
     ID3D11Buffer* nullBuffers[8] = {};
@@ -73,18 +139,45 @@ void SurfaceGpuBuffer::Draw(const GDXDevice* device, unsigned int flagsVertex) c
     if (slot > 0)
         ctx->IASetVertexBuffers(0, slot, buffers, strides, offsets);
 
-    ctx->IASetIndexBuffer(indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    ctx->IASetIndexBuffer(indexBuffer, indexFormat, 0);
+    ctx->IASetPrimitiveTopology(m_wireframe ? D3D11_PRIMITIVE_TOPOLOGY_LINELIST
+                                            : D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    if (!m_wireframe)
-    {
-        ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-        ctx->DrawIndexed(indexCount, 0, 0);
-    }
-    else
-    {
-        // Achtung: Das ist nur eine einfache Linien-Ausgabe auf Basis des vorhandenen Index-Buffers.
-        // Echter GPU-Wireframe gehoert in einen Rasterizer-State, nicht in den Topology-Wechsel.
-        ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_LINELIST);
-        ctx->DrawIndexed(indexCount, 0, 0);
-    }
+    streamCount = slot;
+    return true;
+}
+
+void SurfaceGpuBuffer::Draw(const GDXDevice* device, unsigned int flagsVertex) const
+{
+    if (!device) return;
+
+    ID3D11DeviceContext* ctx = device->GetDeviceContext();
+    if (!ctx) return;
+
+    UINT streamCount = 0;
+    if (!BindStreams(ctx, flagsVertex, streamCount)) return;
+
+    // Achtung: Wireframe ist nur eine einfache Linien-Ausgabe auf Basis des vorhandenen Index-Buffers
+    // (Topology in BindStreams). Echter GPU-Wireframe gehoert in einen Rasterizer-State.
+    ctx->DrawIndexed(indexCount, 0, 0);
+}
+
+void SurfaceGpuBuffer::DrawInstanced(const GDXDevice* device, unsigned int flagsVertex,
+                                     ID3D11Buffer* instanceBuffer, UINT instanceStride,
+                                     UINT instanceCount, UINT firstInstance) const
+{
+    if (!device || !instanceBuffer || instanceCount == 0) return;
+
+    ID3D11DeviceContext* ctx = device->GetDeviceContext();
+    if (!ctx) return;
+
+    UINT streamCount = 0;
+    if (!BindStreams(ctx, flagsVertex, streamCount)) return;
+
+    // Instance stream follows the vertex streams (see InputLayoutManager,
+    // D3DVERTEX_INSTANCE_WORLD). firstInstance is applied through
+    // StartInstanceLocation, which offsets per-instance buffer reads.
+    const UINT offset = 0;
+    ctx->IASetVertexBuffers(streamCount, 1, &instanceBuffer, &instanceStride, &offset);
+    ctx->DrawIndexedInstanced(indexCount, instanceCount, 0, 0, firstInstance);
 }
@@ -1,11 +1,31 @@
 #include "Texture.h"
+#include "TextureFile.h"
+#include "BlockCompressor.h"
+#include "ContentHash.h"
+
+#include <climits>
+#include <filesystem>
+#include <fstream>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../stb_image.h"
 
 #define RGBA(r, g, b, a) ((r << 24) | (g << 16) | (b << 8) | a)
 
-Texture::Texture() : m_texture(nullptr), m_textureView(nullptr), m_isLocked(false)
+static DXGI_FORMAT ToDxgiFormat(TextureFormat format)
+{
+    switch (format)
+    {
+    case TextureFormat::BC1: return DXGI_FORMAT_BC1_UNORM;
+    case TextureFormat::BC3: return DXGI_FORMAT_BC3_UNORM;
+    case TextureFormat::BC4: return DXGI_FORMAT_BC4_UNORM;
+    case TextureFormat::BC5: return DXGI_FORMAT_BC5_UNORM;
+    case TextureFormat::BC7: return DXGI_FORMAT_BC7_UNORM;
+    default:                 return DXGI_FORMAT_R8G8B8A8_UNORM; // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    }
+}
+
+Texture::Texture() : m_pixels(nullptr), m_isLocked(false), m_memorySize(0), m_texture(nullptr), m_textureView(nullptr), m_imageSamplerState(nullptr)
 {
     m_sFilename = L"";
 }
@@ -19,39 +39,141 @@ Texture::~Texture()
     m_isLocked = false;
 }
 
-HRESULT Texture::AddTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext, const wchar_t* filename)
+HRESULT Texture::AddTexture(ID3D11Device* device, ID3D11DeviceContext* deviceContext, const wchar_t* filename,
+                            TextureUsage usage, const MipDesc& mips)
 {
-    Memory::SafeRelease(m_imageSamplerState);
-    Memory::SafeRelease(m_textureView);
-    Memory::SafeRelease(m_texture);
+    TextureImage image;
+    HRESULT hr = DecodeFile(filename, image);
+    if (FAILED(hr))
+        return hr;
+
+    if (image.mipLevels == 1)
+        MipBuilder::Build(image, usage, mips);
+
+    return CreateFromImage(device, image, filename);
+}
+
+HRESULT Texture::DecodeFile(const wchar_t* filename, TextureImage& out, uint64_t* contentHash)
+{
+    out = TextureImage{};
+    if (!filename)
+        return E_INVALIDARG;
+
+    std::vector<uint8_t> bytes;
+    HRESULT hr = ReadFileBytes(filename, bytes);
+    if (FAILED(hr))
+        return hr;
+
+    if (contentHash)
+        *contentHash = ContentHash::Xxh64(bytes.data(), bytes.size());
+
+    return DecodeMemory(bytes.data(), bytes.size(), filename, out);
+}
+
+HRESULT Texture::ReadFileBytes(const wchar_t* filename, std::vector<uint8_t>& out)
+{
+    out.clear();
+    if (!filename)
+        return E_INVALIDARG;
+
+    std::ifstream file(std::filesystem::path(filename), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        DBLOG("Texture.cpp: FAIL OPEN FILE ", __FILE__, __LINE__);
+        return E_FAIL;
+    }
+
+    const std::streamsize size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    out.resize(static_cast<size_t>(size > 0 ? size : 0));
+    if (size > 0 && !file.read(reinterpret_cast<char*>(out.data()), size))
+    {
+        out.clear();
+        DBLOG("Texture.cpp: FAIL READ FILE ", __FILE__, __LINE__);
+        return E_FAIL;
+    }
+    return S_OK;
+}
+
+HRESULT Texture::DecodeMemory(const uint8_t* data, size_t size, const wchar_t* filename, TextureImage& out)
+{
+    out = TextureImage{};
+    if (!data || size == 0)
+        return E_INVALIDARG;
+
+    // Cooked textures (tools/texcook) keep their blocks and mip levels.
+    TextureFileType fileType;
+    if (filename && TextureFile::TypeFromPath(filename, fileType))
+    {
+        if (!TextureFile::ReadMemory(data, size, out))
+        {
+            DBLOG("Texture.cpp: FAIL LOAD DDS/KTX2 ", __FILE__, __LINE__);
+            return E_FAIL;
+        }
+        return S_OK;
+    }
 
     // Bilddaten laden
     int imageWidth, imageHeight, imageChannels;
     int desiredChannels = 4;
 
-    char* narrowFilename = nullptr;
-    size_t length = wcslen(filename) + 1; // +1 for null terminator
-    narrowFilename = new char[length];
-    size_t convertedChars = 0;
-    wcstombs_s(&convertedChars, narrowFilename, length, filename, length);
-    unsigned char* imageData = stbi_load(narrowFilename, &imageWidth, &imageHeight, &imageChannels, desiredChannels);
-    delete[] narrowFilename;
+    if (size > static_cast<size_t>(INT_MAX))
+        return E_INVALIDARG;
 
+    unsigned char* imageData = stbi_load_from_memory(data, static_cast<int>(size),
+                                                     &imageWidth, &imageHeight, &imageChannels, desiredChannels);
     if (!imageData)
     {
         DBLOG("Texture.cpp: FAIL LOAD IMAGE ", __FILE__, __LINE__);
         return E_FAIL;
     }
 
-    // Berechnung der maximalen Groee
-    UINT maxSize = imageWidth > imageHeight ? imageWidth : imageHeight;
+    out.width  = static_cast<uint32_t>(imageWidth);
+    out.height = static_cast<uint32_t>(imageHeight);
+    out.pixels.assign(imageData, imageData + static_cast<size_t>(imageWidth) * imageHeight * 4);
+    stbi_image_free(imageData);
+
+    return S_OK;
+}
+
+HRESULT Texture::CreateFromImage(ID3D11Device* device, const TextureImage& image, const wchar_t* filename,
+                                 uint32_t firstLevel)
+{
+    Memory::SafeRelease(m_imageSamplerState);
+    Memory::SafeRelease(m_textureView);
+    Memory::SafeRelease(m_texture);
+    m_memorySize = 0;
+
+    if (!device || image.width == 0 || image.height == 0 || image.mipLevels == 0 ||
+        image.mipLevels > MipBuilder::CountLevels(image.width, image.height) ||
+        firstLevel >= image.mipLevels ||
+        image.pixels.size() < image.LevelOffset(image.mipLevels))
+        return E_INVALIDARG;
+
+    // Feature levels below 11.0 cannot sample BC7 (below 10.0 no BC4/BC5):
+    // decode such textures on the CPU and upload them as RGBA8.
+    const DXGI_FORMAT format = ToDxgiFormat(image.format);
+    UINT formatSupport = 0;
+    if (image.IsBlockCompressed() &&
+        (FAILED(device->CheckFormatSupport(format, &formatSupport)) ||
+         (formatSupport & D3D11_FORMAT_SUPPORT_TEXTURE2D) == 0))
+    {
+        TextureImage decoded;
+        if (!BlockCompressor::Decompress(image, decoded))
+        {
+            DBLOG("Texture.cpp: block format not supported by device and not decodable ", __FILE__, __LINE__);
+            return E_FAIL;
+        }
+        return CreateFromImage(device, decoded, filename, firstLevel);
+    }
 
     // Texturbeschreibung erstellen
-    m_desc.Width = imageWidth;
-    m_desc.Height = imageHeight;
-    m_desc.MipLevels = 1;
+    const uint32_t levels = image.mipLevels - firstLevel;
+    m_desc.Width = image.LevelWidth(firstLevel);
+    m_desc.Height = image.LevelHeight(firstLevel);
+    m_desc.MipLevels = levels;
     m_desc.ArraySize = 1;
-    m_desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM; // DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+    m_desc.Format = format;
     m_desc.SampleDesc.Count = 1;
     m_desc.SampleDesc.Quality = 0;
     m_desc.Usage = D3D11_USAGE_DEFAULT;
@@ -59,33 +181,38 @@ HRESULT Texture::AddTexture(ID3D11Device* device, ID3D11DeviceContext* deviceCon
     m_desc.CPUAccessFlags = 0;
     m_desc.MiscFlags = 0;
 
-    // Subressource-Daten einrichten
-    D3D11_SUBRESOURCE_DATA subresourceData = {};
-    subresourceData.pSysMem = imageData;
-    subresourceData.SysMemPitch = imageWidth * 4;
+    // Subressource-Daten einrichten, eine pro Mip-Level ab firstLevel
+    std::vector<D3D11_SUBRESOURCE_DATA> subresourceData(levels);
+    size_t offset = image.LevelOffset(firstLevel);
+    for (uint32_t i = 0; i < levels; ++i)
+    {
+        const uint32_t level = firstLevel + i;
+        subresourceData[i].pSysMem = image.pixels.data() + offset;
+        subresourceData[i].SysMemPitch = image.RowPitch(level);
+        subresourceData[i].SysMemSlicePitch = 0;
+        offset += image.LevelSize(level);
+    }
 
     // Textur erstellen
-    HRESULT hr = device->CreateTexture2D(&m_desc, &subresourceData, &m_texture);
+    HRESULT hr = device->CreateTexture2D(&m_desc, subresourceData.data(), &m_texture);
     if (FAILED(hr))
     {
         DBLOG_HR(hr);
-        stbi_image_free(imageData); 
-        return hr; 
+        return hr;
     }
 
     // Shader Resource View erstellen
     D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
     srvDesc.Format = m_desc.Format;
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-    srvDesc.Texture2D.MipLevels = 1;
+    srvDesc.Texture2D.MipLevels = levels;
 
     hr = device->CreateShaderResourceView(m_texture, &srvDesc, &m_textureView);
     if (FAILED(hr))
     {
         DBLOG_HR(hr);
-        Memory::SafeRelease(m_texture); 
-        stbi_image_free(imageData); 
-        return hr; 
+        Memory::SafeRelease(m_texture);
+        return hr;
     }
 
     D3D11_SAMPLER_DESC ImageSamplerDesc = {};
@@ -108,15 +235,14 @@ HRESULT Texture::AddTexture(ID3D11Device* device, ID3D11DeviceContext* deviceCon
     if (FAILED(hr))
     {
         DBLOG_HR(hr);
+        Memory::SafeRelease(m_textureView);
         Memory::SafeRelease(m_texture);
-        stbi_image_free(imageData); 
-        return hr; 
+        return hr;
     }
 
-    stbi_image_free(imageData); 
-
     // Dateinamen speichern
-    m_sFilename = filename;
+    m_sFilename = filename ? filename : L"";
+    m_memorySize = offset - image.LevelOffset(firstLevel);
 
     return S_OK; // Erfolg
 
@@ -191,6 +317,7 @@ HRESULT Texture::CreateTexture(ID3D11Device* device, int width, int height)
     }
 
     m_texture->GetDesc(&m_desc);
+    m_memorySize = static_cast<uint64_t>(width) * height * 4;
 
     return S_OK;
 }
@@ -0,0 +1,514 @@
+#include "TextureFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cwctype>
+#include <fstream>
+#include <vector>
+
+namespace
+{
+    // ---------------------------------------------------------------- DDS
+
+    constexpr uint32_t DDS_MAGIC = 0x20534444u;  // "DDS "
+
+    constexpr uint32_t DDSD_CAPS        = 0x1;
+    constexpr uint32_t DDSD_HEIGHT      = 0x2;
+    constexpr uint32_t DDSD_WIDTH       = 0x4;
+    constexpr uint32_t DDSD_PITCH       = 0x8;
+    constexpr uint32_t DDSD_PIXELFORMAT = 0x1000;
+    constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+    constexpr uint32_t DDSD_LINEARSIZE  = 0x80000;
+
+    constexpr uint32_t DDPF_ALPHAPIXELS = 0x1;
+    constexpr uint32_t DDPF_FOURCC      = 0x4;
+    constexpr uint32_t DDPF_RGB         = 0x40;
+
+    constexpr uint32_t DDSCAPS_COMPLEX  = 0x8;
+    constexpr uint32_t DDSCAPS_TEXTURE  = 0x1000;
+    constexpr uint32_t DDSCAPS_MIPMAP   = 0x400000;
+    constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+    constexpr uint32_t DDSCAPS2_VOLUME  = 0x200000;
+
+    constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+    constexpr uint32_t DDS_MISC_TEXTURECUBE    = 0x4;
+
+    constexpr uint32_t FourCC(char a, char b, char c, char d) noexcept
+    {
+        return static_cast<uint32_t>(static_cast<uint8_t>(a)) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(b)) << 8) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(c)) << 16) |
+               (static_cast<uint32_t>(static_cast<uint8_t>(d)) << 24);
+    }
+
+    // DXGI_FORMAT values.
+    constexpr uint32_t DXGI_RGBA8      = 28;
+    constexpr uint32_t DXGI_RGBA8_SRGB = 29;
+    constexpr uint32_t DXGI_BC1        = 71;
+    constexpr uint32_t DXGI_BC1_SRGB   = 72;
+    constexpr uint32_t DXGI_BC3        = 77;
+    constexpr uint32_t DXGI_BC3_SRGB   = 78;
+    constexpr uint32_t DXGI_BC4        = 80;
+    constexpr uint32_t DXGI_BC5        = 83;
+    constexpr uint32_t DXGI_BC7        = 98;
+    constexpr uint32_t DXGI_BC7_SRGB   = 99;
+
+    struct DdsPixelFormat
+    {
+        uint32_t size;
+        uint32_t flags;
+        uint32_t fourCC;
+        uint32_t rgbBitCount;
+        uint32_t rMask, gMask, bMask, aMask;
+    };
+
+    struct DdsHeader
+    {
+        uint32_t       size;
+        uint32_t       flags;
+        uint32_t       height;
+        uint32_t       width;
+        uint32_t       pitchOrLinearSize;
+        uint32_t       depth;
+        uint32_t       mipMapCount;
+        uint32_t       reserved1[11];
+        DdsPixelFormat pixelFormat;
+        uint32_t       caps, caps2, caps3, caps4;
+        uint32_t       reserved2;
+    };
+
+    struct DdsHeaderDxt10
+    {
+        uint32_t dxgiFormat;
+        uint32_t resourceDimension;
+        uint32_t miscFlag;
+        uint32_t arraySize;
+        uint32_t miscFlags2;
+    };
+
+    static_assert(sizeof(DdsHeader) == 124, "DDS_HEADER layout");
+    static_assert(sizeof(DdsHeaderDxt10) == 20, "DDS_HEADER_DXT10 layout");
+
+    uint32_t ToDxgi(TextureFormat format) noexcept
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1: return DXGI_BC1;
+        case TextureFormat::BC3: return DXGI_BC3;
+        case TextureFormat::BC4: return DXGI_BC4;
+        case TextureFormat::BC5: return DXGI_BC5;
+        case TextureFormat::BC7: return DXGI_BC7;
+        default:                 return DXGI_RGBA8;
+        }
+    }
+
+    bool FromDxgi(uint32_t dxgi, TextureFormat& format) noexcept
+    {
+        switch (dxgi)
+        {
+        case DXGI_RGBA8: case DXGI_RGBA8_SRGB: format = TextureFormat::RGBA8; return true;
+        case DXGI_BC1:   case DXGI_BC1_SRGB:   format = TextureFormat::BC1;   return true;
+        case DXGI_BC3:   case DXGI_BC3_SRGB:   format = TextureFormat::BC3;   return true;
+        case DXGI_BC4:                         format = TextureFormat::BC4;   return true;
+        case DXGI_BC5:                         format = TextureFormat::BC5;   return true;
+        case DXGI_BC7:   case DXGI_BC7_SRGB:   format = TextureFormat::BC7;   return true;
+        default:                               return false;
+        }
+    }
+
+    // ---------------------------------------------------------------- KTX2
+
+    constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+
+    // VkFormat values.
+    constexpr uint32_t VK_RGBA8          = 37;
+    constexpr uint32_t VK_RGBA8_SRGB     = 43;
+    constexpr uint32_t VK_BC1_RGB        = 131;
+    constexpr uint32_t VK_BC1_RGBA_SRGB  = 134;
+    constexpr uint32_t VK_BC3            = 137;
+    constexpr uint32_t VK_BC3_SRGB       = 138;
+    constexpr uint32_t VK_BC4            = 139;
+    constexpr uint32_t VK_BC5            = 141;
+    constexpr uint32_t VK_BC7            = 145;
+    constexpr uint32_t VK_BC7_SRGB       = 146;
+
+    // Khronos data format descriptor values.
+    constexpr uint32_t KHR_DF_MODEL_RGBSDA       = 1;
+    constexpr uint32_t KHR_DF_MODEL_BC1A         = 128;
+    constexpr uint32_t KHR_DF_MODEL_BC3          = 130;
+    constexpr uint32_t KHR_DF_MODEL_BC4          = 131;
+    constexpr uint32_t KHR_DF_MODEL_BC5          = 132;
+    constexpr uint32_t KHR_DF_MODEL_BC7          = 134;
+    constexpr uint32_t KHR_DF_PRIMARIES_BT709    = 1;
+    constexpr uint32_t KHR_DF_TRANSFER_LINEAR    = 1;
+    constexpr uint32_t KHR_DF_CHANNEL_ALPHA      = 15;
+
+    struct Ktx2Header
+    {
+        uint8_t  identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    struct Ktx2Level
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    static_assert(sizeof(Ktx2Header) == 80, "KTX2 header layout");
+    static_assert(sizeof(Ktx2Level) == 24, "KTX2 level index layout");
+
+    uint32_t ToVk(TextureFormat format) noexcept
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1: return VK_BC1_RGB;
+        case TextureFormat::BC3: return VK_BC3;
+        case TextureFormat::BC4: return VK_BC4;
+        case TextureFormat::BC5: return VK_BC5;
+        case TextureFormat::BC7: return VK_BC7;
+        default:                 return VK_RGBA8;
+        }
+    }
+
+    bool FromVk(uint32_t vk, TextureFormat& format) noexcept
+    {
+        if (vk >= VK_BC1_RGB && vk <= VK_BC1_RGBA_SRGB) { format = TextureFormat::BC1; return true; }
+        switch (vk)
+        {
+        case VK_RGBA8: case VK_RGBA8_SRGB: format = TextureFormat::RGBA8; return true;
+        case VK_BC3:   case VK_BC3_SRGB:   format = TextureFormat::BC3;   return true;
+        case VK_BC4:                       format = TextureFormat::BC4;   return true;
+        case VK_BC5:                       format = TextureFormat::BC5;   return true;
+        case VK_BC7:   case VK_BC7_SRGB:   format = TextureFormat::BC7;   return true;
+        default:                           return false;
+        }
+    }
+
+    // Basic data format descriptor (one block), as 32 bit words.
+    std::vector<uint32_t> BuildDfd(TextureFormat format)
+    {
+        struct Sample { uint32_t bitOffset, bitLength, channel, upper; };
+
+        uint32_t model = KHR_DF_MODEL_RGBSDA, blockDim = 0, bytes = 4;
+        std::vector<Sample> samples;
+        switch (format)
+        {
+        case TextureFormat::BC1: model = KHR_DF_MODEL_BC1A; samples = { { 0, 64, 0, UINT32_MAX } }; break;
+        case TextureFormat::BC3: model = KHR_DF_MODEL_BC3;  samples = { { 0, 64, KHR_DF_CHANNEL_ALPHA, UINT32_MAX }, { 64, 64, 0, UINT32_MAX } }; break;
+        case TextureFormat::BC4: model = KHR_DF_MODEL_BC4;  samples = { { 0, 64, 0, UINT32_MAX } }; break;
+        case TextureFormat::BC5: model = KHR_DF_MODEL_BC5;  samples = { { 0, 64, 0, UINT32_MAX }, { 64, 64, 1, UINT32_MAX } }; break;
+        case TextureFormat::BC7: model = KHR_DF_MODEL_BC7;  samples = { { 0, 128, 0, UINT32_MAX } }; break;
+        default:
+            samples = { { 0, 8, 0, 255 }, { 8, 8, 1, 255 }, { 16, 8, 2, 255 }, { 24, 8, KHR_DF_CHANNEL_ALPHA, 255 } };
+            break;
+        }
+        if (format != TextureFormat::RGBA8)
+        {
+            blockDim = 3 | (3 << 8);  // 4x4 texels, stored minus one
+            bytes    = (format == TextureFormat::BC1 || format == TextureFormat::BC4) ? 8 : 16;
+        }
+
+        const uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+        std::vector<uint32_t> dfd;
+        dfd.push_back(4 + blockSize);                         // dfdTotalSize
+        dfd.push_back(0);                                     // vendorId, descriptorType
+        dfd.push_back(2 | (blockSize << 16));                 // versionNumber, descriptorBlockSize
+        dfd.push_back(model | (KHR_DF_PRIMARIES_BT709 << 8) | (KHR_DF_TRANSFER_LINEAR << 16));
+        dfd.push_back(blockDim);
+        dfd.push_back(bytes);                                 // bytesPlane0
+        dfd.push_back(0);
+        for (const Sample& s : samples)
+        {
+            dfd.push_back(s.bitOffset | ((s.bitLength - 1) << 16) | (s.channel << 24));
+            dfd.push_back(0);                                 // samplePosition
+            dfd.push_back(0);                                 // sampleLower
+            dfd.push_back(s.upper);
+        }
+        return dfd;
+    }
+
+    // ---------------------------------------------------------------- shared
+
+    uint32_t MaxLevels(uint32_t width, uint32_t height) noexcept
+    {
+        uint32_t size = std::max(width, height), levels = 1;
+        while (size > 1) { size >>= 1; ++levels; }
+        return levels;
+    }
+
+    bool ValidImage(const TextureImage& image) noexcept
+    {
+        return image.width > 0 && image.height > 0 && image.mipLevels > 0 &&
+               image.mipLevels <= MaxLevels(image.width, image.height) &&
+               image.pixels.size() >= image.LevelOffset(image.mipLevels);
+    }
+
+    template<class T>
+    void Append(std::vector<uint8_t>& out, const T& value)
+    {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), p, p + sizeof(T));
+    }
+
+    bool WriteBytes(const std::filesystem::path& path, const std::vector<uint8_t>& bytes)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+            return false;
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(file);
+    }
+
+    bool ReadDds(const uint8_t* data, size_t size, TextureImage& out)
+    {
+        if (size < 4 + sizeof(DdsHeader))
+            return false;
+
+        DdsHeader header;
+        std::memcpy(&header, data + 4, sizeof(header));
+        if (header.size != sizeof(DdsHeader) || header.pixelFormat.size != sizeof(DdsPixelFormat) ||
+            (header.caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) != 0)
+            return false;
+
+        size_t offset = 4 + sizeof(DdsHeader);
+        TextureFormat format = TextureFormat::RGBA8;
+        const DdsPixelFormat& pf = header.pixelFormat;
+
+        if ((pf.flags & DDPF_FOURCC) && pf.fourCC == FourCC('D', 'X', '1', '0'))
+        {
+            if (size < offset + sizeof(DdsHeaderDxt10))
+                return false;
+            DdsHeaderDxt10 dxt10;
+            std::memcpy(&dxt10, data + offset, sizeof(dxt10));
+            offset += sizeof(dxt10);
+
+            if (dxt10.resourceDimension != DDS_DIMENSION_TEXTURE2D || dxt10.arraySize > 1 ||
+                (dxt10.miscFlag & DDS_MISC_TEXTURECUBE) || !FromDxgi(dxt10.dxgiFormat, format))
+                return false;
+        }
+        else if (pf.flags & DDPF_FOURCC)
+        {
+            if      (pf.fourCC == FourCC('D', 'X', 'T', '1')) format = TextureFormat::BC1;
+            else if (pf.fourCC == FourCC('D', 'X', 'T', '5')) format = TextureFormat::BC3;
+            else if (pf.fourCC == FourCC('A', 'T', 'I', '1') || pf.fourCC == FourCC('B', 'C', '4', 'U')) format = TextureFormat::BC4;
+            else if (pf.fourCC == FourCC('A', 'T', 'I', '2') || pf.fourCC == FourCC('B', 'C', '5', 'U')) format = TextureFormat::BC5;
+            else return false;
+        }
+        else if ((pf.flags & DDPF_RGB) && pf.rgbBitCount == 32 &&
+                 pf.rMask == 0x000000FFu && pf.gMask == 0x0000FF00u && pf.bMask == 0x00FF0000u &&
+                 (!(pf.flags & DDPF_ALPHAPIXELS) || pf.aMask == 0xFF000000u))
+        {
+            format = TextureFormat::RGBA8;
+        }
+        else
+        {
+            return false;
+        }
+
+        TextureImage image;
+        image.width     = header.width;
+        image.height    = header.height;
+        image.format    = format;
+        image.mipLevels = (header.flags & DDSD_MIPMAPCOUNT) && header.mipMapCount > 0 ? header.mipMapCount : 1;
+        if (image.width == 0 || image.height == 0 || image.mipLevels > MaxLevels(image.width, image.height))
+            return false;
+
+        const size_t bytes = image.LevelOffset(image.mipLevels);
+        if (size - offset < bytes)
+            return false;
+
+        image.pixels.assign(data + offset, data + offset + bytes);
+        out = std::move(image);
+        return true;
+    }
+
+    bool ReadKtx2(const uint8_t* data, size_t size, TextureImage& out)
+    {
+        if (size < sizeof(Ktx2Header))
+            return false;
+
+        Ktx2Header header;
+        std::memcpy(&header, data, sizeof(header));
+
+        TextureImage image;
+        if (header.supercompressionScheme != 0 || header.pixelDepth != 0 || header.layerCount > 1 ||
+            header.faceCount != 1 || !FromVk(header.vkFormat, image.format))
+            return false;
+
+        image.width     = header.pixelWidth;
+        image.height    = header.pixelHeight;
+        image.mipLevels = std::max(header.levelCount, 1u);
+        if (image.width == 0 || image.height == 0 || image.mipLevels > MaxLevels(image.width, image.height) ||
+            size < sizeof(Ktx2Header) + static_cast<size_t>(image.mipLevels) * sizeof(Ktx2Level))
+            return false;
+
+        // Validate the whole level index against the file before allocating,
+        // so a corrupt header cannot request more memory than the file holds.
+        std::vector<Ktx2Level> levels(image.mipLevels);
+        std::memcpy(levels.data(), data + sizeof(Ktx2Header), levels.size() * sizeof(Ktx2Level));
+
+        uint64_t total = 0;
+        for (uint32_t level = 0; level < image.mipLevels; ++level)
+        {
+            const Ktx2Level& entry = levels[level];
+            if (entry.byteLength != image.LevelSize(level) || entry.byteOffset > size ||
+                size - entry.byteOffset < entry.byteLength)
+                return false;
+            total += entry.byteLength;
+        }
+
+        const size_t bytes = image.LevelOffset(image.mipLevels);
+        if (total != bytes || size < bytes)
+            return false;
+
+        image.pixels.resize(bytes);
+        for (uint32_t level = 0; level < image.mipLevels; ++level)
+            std::memcpy(image.pixels.data() + image.LevelOffset(level), data + levels[level].byteOffset,
+                        static_cast<size_t>(levels[level].byteLength));
+
+        out = std::move(image);
+        return true;
+    }
+}
+
+bool TextureFile::TypeFromPath(const std::filesystem::path& path, TextureFileType& type)
+{
+    std::wstring ext = path.extension().wstring();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](wchar_t c) { return static_cast<wchar_t>(std::towlower(c)); });
+
+    if (ext == L".dds")  { type = TextureFileType::Dds;  return true; }
+    if (ext == L".ktx2") { type = TextureFileType::Ktx2; return true; }
+    return false;
+}
+
+bool TextureFile::Write(const std::filesystem::path& path, const TextureImage& image, TextureFileType type)
+{
+    if (!ValidImage(image))
+        return false;
+
+    std::vector<uint8_t> bytes;
+    const size_t dataSize = image.LevelOffset(image.mipLevels);
+
+    if (type == TextureFileType::Dds)
+    {
+        DdsHeader header = {};
+        header.size              = sizeof(DdsHeader);
+        header.flags             = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT |
+                                   (image.IsBlockCompressed() ? DDSD_LINEARSIZE : DDSD_PITCH);
+        header.height            = image.height;
+        header.width             = image.width;
+        header.pitchOrLinearSize = image.IsBlockCompressed() ? static_cast<uint32_t>(image.LevelSize(0)) : image.RowPitch(0);
+        header.mipMapCount       = image.mipLevels;
+        header.pixelFormat.size   = sizeof(DdsPixelFormat);
+        header.pixelFormat.flags  = DDPF_FOURCC;
+        header.pixelFormat.fourCC = FourCC('D', 'X', '1', '0');
+        header.caps              = DDSCAPS_TEXTURE | (image.mipLevels > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0u);
+
+        DdsHeaderDxt10 dxt10 = {};
+        dxt10.dxgiFormat        = ToDxgi(image.format);
+        dxt10.resourceDimension = DDS_DIMENSION_TEXTURE2D;
+        dxt10.arraySize         = 1;
+
+        bytes.reserve(4 + sizeof(header) + sizeof(dxt10) + dataSize);
+        Append(bytes, DDS_MAGIC);
+        Append(bytes, header);
+        Append(bytes, dxt10);
+        bytes.insert(bytes.end(), image.pixels.begin(), image.pixels.begin() + static_cast<std::ptrdiff_t>(dataSize));
+        return WriteBytes(path, bytes);
+    }
+
+    // KTX2: header, level index, DFD, then the levels smallest first, each
+    // aligned to the block size (at least 4).
+    const std::vector<uint32_t> dfd = BuildDfd(image.format);
+    const uint32_t dfdOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + image.mipLevels * sizeof(Ktx2Level));
+    const uint32_t dfdLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+    const uint64_t alignment = std::max<uint32_t>(image.BlockBytes(), 4);
+
+    std::vector<Ktx2Level> levels(image.mipLevels);
+    uint64_t offset = dfdOffset + dfdLength;
+    for (uint32_t i = image.mipLevels; i-- > 0;)
+    {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        levels[i].byteOffset             = offset;
+        levels[i].byteLength             = image.LevelSize(i);
+        levels[i].uncompressedByteLength = image.LevelSize(i);
+        offset += levels[i].byteLength;
+    }
+
+    Ktx2Header header = {};
+    std::memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    header.vkFormat      = ToVk(image.format);
+    header.typeSize      = 1;
+    header.pixelWidth    = image.width;
+    header.pixelHeight   = image.height;
+    header.faceCount     = 1;
+    header.levelCount    = image.mipLevels;
+    header.dfdByteOffset = dfdOffset;
+    header.dfdByteLength = dfdLength;
+
+    bytes.reserve(static_cast<size_t>(offset));
+    Append(bytes, header);
+    for (const Ktx2Level& level : levels)
+        Append(bytes, level);
+    for (uint32_t word : dfd)
+        Append(bytes, word);
+
+    for (uint32_t i = image.mipLevels; i-- > 0;)
+    {
+        bytes.resize(static_cast<size_t>(levels[i].byteOffset), 0);
+        const uint8_t* src = image.pixels.data() + image.LevelOffset(i);
+        bytes.insert(bytes.end(), src, src + image.LevelSize(i));
+    }
+    return WriteBytes(path, bytes);
+}
+
+bool TextureFile::Read(const std::filesystem::path& path, TextureImage& out)
+{
+    out = TextureImage{};
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+        return false;
+
+    const std::streamoff size = file.tellg();
+    if (size <= 0)
+        return false;
+
+    std::vector<uint8_t> bytes(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(bytes.data()), size))
+        return false;
+
+    return ReadMemory(bytes.data(), bytes.size(), out);
+}
+
+bool TextureFile::ReadMemory(const uint8_t* data, size_t size, TextureImage& out)
+{
+    out = TextureImage{};
+    if (!data || size < 4)
+        return false;
+
+    uint32_t magic;
+    std::memcpy(&magic, data, sizeof(magic));
+    if (magic == DDS_MAGIC)
+        return ReadDds(data, size, out);
+    if (size >= sizeof(KTX2_IDENTIFIER) && std::memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0)
+        return ReadKtx2(data, size, out);
+    return false;
+}
@@ -0,0 +1,111 @@
+#include "TextureLoader.h"
+#include "gdxutil.h"
+
+#include <algorithm>
+
+TextureLoader::~TextureLoader()
+{
+    Stop();
+}
+
+void TextureLoader::Start(unsigned int threadCount)
+{
+    Stop();
+
+    if (threadCount == 0)
+    {
+        const unsigned int hw = std::thread::hardware_concurrency();
+        threadCount = (std::min)(hw > 1 ? hw - 1 : 1u, 4u);
+    }
+
+    m_running.store(true, std::memory_order_release);
+    for (unsigned int i = 0; i < threadCount; ++i)
+        m_workers.emplace_back(&TextureLoader::WorkerMain, this);
+
+    DBLOG("TextureLoader.cpp: started with ", threadCount, " thread(s)");
+}
+
+void TextureLoader::Stop()
+{
+    if (!m_running.exchange(false)) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_pending.fetch_sub(static_cast<uint32_t>(m_requests.size()), std::memory_order_acq_rel);
+        m_requests.clear();
+    }
+    m_requestCv.notify_all();
+
+    for (std::thread& t : m_workers)
+        if (t.joinable()) t.join();
+    m_workers.clear();
+
+    // Results nobody collected are dropped with the loader.
+    std::lock_guard<std::mutex> lock(m_resultMutex);
+    m_pending.fetch_sub(static_cast<uint32_t>(m_results.size()), std::memory_order_acq_rel);
+    m_results.clear();
+    m_resultCv.notify_all();
+}
+
+void TextureLoader::Submit(uint32_t ticket, const std::wstring& filename, TextureUsage usage, const MipDesc& mips)
+{
+    if (!IsRunning()) return;
+
+    m_pending.fetch_add(1, std::memory_order_acq_rel);
+    {
+        std::lock_guard<std::mutex> lock(m_requestMutex);
+        m_requests.push_back({ ticket, filename, usage, mips });
+    }
+    m_requestCv.notify_one();
+}
+
+void TextureLoader::Collect(std::vector<Result>& out)
+{
+    std::lock_guard<std::mutex> lock(m_resultMutex);
+    if (m_results.empty()) return;
+
+    m_pending.fetch_sub(static_cast<uint32_t>(m_results.size()), std::memory_order_acq_rel);
+    for (Result& r : m_results)
+        out.push_back(std::move(r));
+    m_results.clear();
+}
+
+void TextureLoader::WaitForResult()
+{
+    std::unique_lock<std::mutex> lock(m_resultMutex);
+    m_resultCv.wait(lock, [this] {
+        return !m_results.empty() ||
+               m_pending.load(std::memory_order_acquire) == 0 ||
+               !IsRunning();
+    });
+}
+
+void TextureLoader::WorkerMain()
+{
+    for (;;)
+    {
+        Request request;
+        {
+            std::unique_lock<std::mutex> lock(m_requestMutex);
+            m_requestCv.wait(lock, [this] {
+                return !m_running.load(std::memory_order_acquire) || !m_requests.empty();
+            });
+            if (!m_running.load(std::memory_order_acquire)) return;
+
+            request = std::move(m_requests.front());
+            m_requests.pop_front();
+        }
+
+        Result result;
+        result.ticket = request.ticket;
+        result.hr     = Texture::DecodeFile(request.filename.c_str(), result.image, &result.contentHash);
+        if (SUCCEEDED(result.hr) && result.image.mipLevels == 1)
+            MipBuilder::Build(result.image, request.usage, request.mips);
+
+        {
+            std::lock_guard<std::mutex> lock(m_resultMutex);
+            m_results.push_back(std::move(result));
+        }
+        m_resultCv.notify_all();
+    }
+}
@@ -4,16 +4,41 @@
 #include <d3d11.h>
 #include "TexturePool.h"
 #include "Texture.h"
+#include "ContentHash.h"
 #include "gdxutil.h"
 
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+    // Content key: the same bytes loaded with another usage get other mips.
+    uint64_t ContentKey(uint64_t contentHash, TextureUsage usage) noexcept
+    {
+        return contentHash ^ (static_cast<uint64_t>(usage) + 1) * 0x9E3779B97F4A7C15ull;
+    }
+}
+
 // ============================================================
 TexturePool::~TexturePool()
 {
+    // Join the decoder threads first; pending slots only hold fallback refs.
+    m_loader.reset();
+    m_pending.clear();
+    m_pendingByPath.clear();
+    m_decoded.clear();
+
+    m_streamed.clear();
+    m_streamedByTexture.clear();
+    m_streamedBySlot.clear();
+
     for (ID3D11ShaderResourceView* srv : m_srvs)
         if (srv) srv->Release();
 
     m_srvs.clear();
     m_indexBySrv.clear();
+    m_textureByPath.clear();
+    m_textureByContent.clear();
 
     for (Texture* t : m_textures)
         Memory::SafeDelete(t);
@@ -24,21 +49,24 @@ TexturePool::~TexturePool()
 // ============================================================
 //  LoadTexture
 //
-//  Prueft per Dateiname ob die Textur bereits geladen ist.
+//  Prueft per kanonischem Pfad ob die Textur bereits geladen ist,
+//  sonst per Hash der Dateibytes (Kopie unter anderem Namen).
 //  If so: return the cached texture object.
-//  Wenn nein: laden, SRV im Pool registrieren, speichern.
+//  Wenn nein: dekodieren, SRV im Pool registrieren, speichern.
 // ============================================================
 HRESULT TexturePool::LoadTexture(ID3D11Device* device,
                                   ID3D11DeviceContext* deviceContext,
                                   const wchar_t* filename,
-                                  LPLPTEXTURE lpTexture)
+                                  LPLPTEXTURE lpTexture,
+                                  TextureUsage usage)
 {
-    if (!lpTexture)
+    if (!lpTexture || !filename || !*filename)
         return E_INVALIDARG;
 
     *lpTexture = nullptr;
 
-    int existing = FindByFilename(filename);
+    const std::wstring path = CanonicalPath(filename);
+    int existing = FindByPath(path);
     if (existing >= 0)
     {
         *lpTexture = m_textures[existing];
@@ -47,21 +75,41 @@ HRESULT TexturePool::LoadTexture(ID3D11Device* device,
         return S_OK;
     }
 
-    Texture* tex = new Texture;
-    HRESULT hr = tex->AddTexture(device, deviceContext, filename);
-    if (FAILED(hr))
+    std::vector<uint8_t> bytes;
+    HRESULT hr = Texture::ReadFileBytes(filename, bytes);
+    const uint64_t contentHash = SUCCEEDED(hr) ? ContentHash::Xxh64(bytes.data(), bytes.size()) : 0;
+
+    existing = SUCCEEDED(hr) ? FindByContent(contentHash, usage) : -1;
+    if (existing >= 0)
+    {
+        m_textureByPath.emplace(path, static_cast<uint32_t>(existing));
+        ++m_loadStats.duplicates;
+        *lpTexture = m_textures[existing];
+        DBLOG("texturepool.cpp: Same content as ",
+            m_textures[existing]->m_sFilename.c_str(), ": ", std::wstring(filename).c_str());
+        return S_OK;
+    }
+
+    TextureImage image;
+    if (SUCCEEDED(hr))
+        hr = Texture::DecodeMemory(bytes.data(), bytes.size(), filename, image);
+    std::vector<uint8_t>().swap(bytes);
+    if (SUCCEEDED(hr) && image.mipLevels == 1)
+        MipBuilder::Build(image, usage, m_mipDesc);
+
+    Texture* tex = SUCCEEDED(hr) ? CreatePoolTexture(device, image, filename, hr) : nullptr;
+    if (!tex)
     {
         DBLOG("texturepool.cpp: Laden fehlgeschlagen: ",
             std::wstring(filename).c_str());
-        Memory::SafeDelete(tex);
         return hr;
     }
+    IndexTexture(static_cast<uint32_t>(m_textures.size() - 1), path, contentHash, usage);
 
     // SRV im Pool registrieren
     if (tex->m_textureView)
-        GetOrAdd(tex->m_textureView);
+        TrackSlot(tex, GetOrAdd(tex->m_textureView));
 
-    m_textures.push_back(tex);
     *lpTexture = tex;
 
     DBLOG("texturepool.cpp: Textur geladen (Pool-Groesse: ",
@@ -70,12 +118,310 @@ HRESULT TexturePool::LoadTexture(ID3D11Device* device,
 }
 
 // ============================================================
-int TexturePool::FindByFilename(const std::wstring& filename) const
+//  LoadTextureAsync
+//
+//  Der Slot zeigt bis zum Upload den SRV des Fallback-Index.
+//  Der Fallback wird dabei nicht in m_indexBySrv eingetragen,
+//  GetOrAdd(fallback) liefert weiter seinen eigenen Index.
+// ============================================================
+uint32_t TexturePool::LoadTextureAsync(const wchar_t* filename, uint32_t fallbackIndex,
+                                       TextureLoadCallback onLoaded, TextureUsage usage)
+{
+    if (!m_defaultsReady)
+    {
+        DBERROR("texturepool.cpp: LoadTextureAsync - InitializeDefaults has not been called");
+        return 0;
+    }
+    if (fallbackIndex >= m_srvs.size() || !m_srvs[fallbackIndex])
+        fallbackIndex = m_whiteIndex;
+    if (!filename || !*filename)
+        return fallbackIndex;
+
+    const std::wstring name(filename);
+    const std::wstring path = CanonicalPath(filename);
+
+    const int existing = FindByPath(path);
+    if (existing >= 0)
+    {
+        Texture* tex = m_textures[existing];
+        const uint32_t idx = GetOrAdd(tex->m_textureView);
+        if (onLoaded) onLoaded(idx, tex, S_OK);
+        return idx;
+    }
+
+    auto inFlight = m_pendingByPath.find(path);
+    if (inFlight != m_pendingByPath.end())
+    {
+        if (onLoaded) m_pending[inFlight->second].callbacks.push_back(std::move(onLoaded));
+        return inFlight->second;
+    }
+
+    if (!m_loader)
+        m_loader = std::make_unique<TextureLoader>();
+    if (!m_loader->IsRunning())
+        m_loader->Start(m_loadThreads);
+
+    ID3D11ShaderResourceView* fallback = m_srvs[fallbackIndex];
+    const uint32_t idx = static_cast<uint32_t>(m_srvs.size());
+    fallback->AddRef();
+    m_srvs.push_back(fallback);
+
+    PendingLoad& pending = m_pending[idx];
+    pending.filename = name;
+    pending.path     = path;
+    pending.usage    = usage;
+    if (onLoaded) pending.callbacks.push_back(std::move(onLoaded));
+    m_pendingByPath[path] = idx;
+
+    ++m_loadStats.inFlight;
+    m_loader->Submit(idx, name, usage, m_mipDesc);
+    return idx;
+}
+
+// ============================================================
+uint32_t TexturePool::ProcessAsyncLoads(ID3D11Device* device)
+{
+    m_loadStats.uploadsLastCall = 0;
+    if (m_pending.empty()) return 0;
+
+    m_loader->Collect(m_decoded);
+    if (m_decoded.empty()) return 0;
+
+    // Take the batch out first: callbacks may start new loads.
+    size_t count = m_decoded.size();
+    if (m_uploadsPerFrame > 0)
+        count = (std::min)(count, static_cast<size_t>(m_uploadsPerFrame));
+
+    std::vector<TextureLoader::Result> batch(std::make_move_iterator(m_decoded.begin()),
+                                             std::make_move_iterator(m_decoded.begin() + count));
+    m_decoded.erase(m_decoded.begin(), m_decoded.begin() + count);
+    m_loadStats.decoded = static_cast<uint32_t>(m_decoded.size());
+
+    for (TextureLoader::Result& result : batch)
+        FinishAsyncLoad(device, result);
+
+    m_loadStats.uploadsLastCall = static_cast<uint32_t>(count);
+    return static_cast<uint32_t>(count);
+}
+
+// ============================================================
+void TexturePool::WaitAsyncLoads(ID3D11Device* device)
+{
+    const uint32_t budget = m_uploadsPerFrame;
+    m_uploadsPerFrame = 0;
+
+    while (!m_pending.empty())
+    {
+        if (m_decoded.empty() && m_loader->GetPending() == 0)
+        {
+            DBERROR("texturepool.cpp: WaitAsyncLoads - ", m_pending.size(), " load(s) lost");
+            break;
+        }
+        if (m_decoded.empty())
+            m_loader->WaitForResult();
+        ProcessAsyncLoads(device);
+    }
+
+    m_uploadsPerFrame = budget;
+}
+
+// ============================================================
+void TexturePool::FinishAsyncLoad(ID3D11Device* device, TextureLoader::Result& result)
+{
+    auto it = m_pending.find(result.ticket);
+    if (it == m_pending.end()) return;
+
+    const uint32_t idx = result.ticket;
+    PendingLoad pending = std::move(it->second);
+    m_pending.erase(it);
+    m_pendingByPath.erase(pending.path);
+    --m_loadStats.inFlight;
+
+    Texture* tex = nullptr;
+    HRESULT  hr  = result.hr;
+
+    // A synchronous LoadTexture may have loaded the file in the meantime,
+    // or the file is a copy of a loaded one.
+    int existing = FindByPath(pending.path);
+    if (existing < 0 && SUCCEEDED(hr))
+    {
+        existing = FindByContent(result.contentHash, pending.usage);
+        if (existing >= 0)
+        {
+            m_textureByPath.emplace(pending.path, static_cast<uint32_t>(existing));
+            ++m_loadStats.duplicates;
+        }
+    }
+
+    if (existing >= 0)
+    {
+        tex = m_textures[existing];
+        hr  = S_OK;
+    }
+    else if (SUCCEEDED(hr))
+    {
+        tex = CreatePoolTexture(device, result.image, pending.filename, hr);
+        if (tex)
+        {
+            IndexTexture(static_cast<uint32_t>(m_textures.size() - 1),
+                         pending.path, result.contentHash, pending.usage);
+            m_loadStats.bytesUploaded += tex->GetMemorySize();
+        }
+    }
+
+    if (tex && tex->m_textureView)
+    {
+        ReplaceSlot(idx, tex->m_textureView);
+        TrackSlot(tex, idx);
+        ++m_loadStats.completed;
+    }
+    else
+    {
+        tex = nullptr;
+        if (SUCCEEDED(hr)) hr = E_FAIL;
+        ++m_loadStats.failed;
+        DBLOG("texturepool.cpp: Async laden fehlgeschlagen: ", pending.filename.c_str());
+    }
+
+    for (TextureLoadCallback& callback : pending.callbacks)
+        callback(idx, tex, hr);
+}
+
+// ============================================================
+Texture* TexturePool::CreatePoolTexture(ID3D11Device* device, TextureImage& image,
+                                        const std::wstring& filename, HRESULT& hr)
+{
+    const TextureStreamingDesc& desc = m_residency.GetDesc();
+    const uint32_t lowest = desc.budgetBytes > 0
+        ? TextureResidency::LowestFirstLevel(image, desc.minResidentSize) : 0;
+
+    Texture* tex = new Texture;
+    hr = tex->CreateFromImage(device, image, filename.c_str(), lowest);
+    if (FAILED(hr))
+    {
+        Memory::SafeDelete(tex);
+        return nullptr;
+    }
+    m_textures.push_back(tex);
+
+    if (lowest == 0)
+    {
+        m_fixedBytes += tex->GetMemorySize();
+        return tex;
+    }
+
+    const uint32_t id = m_residency.Add(image);
+    m_streamedByTexture[tex] = id;
+
+    StreamedTexture& streamed = m_streamed.emplace_back();
+    streamed.texture    = tex;
+    streamed.image      = std::move(image);
+    streamed.firstLevel = lowest;
+    return tex;
+}
+
+// ============================================================
+void TexturePool::TrackSlot(Texture* tex, uint32_t slot)
+{
+    auto it = m_streamedByTexture.find(tex);
+    if (it == m_streamedByTexture.end())
+        return;
+
+    std::vector<uint32_t>& slots = m_streamed[it->second].slots;
+    if (std::find(slots.begin(), slots.end(), slot) == slots.end())
+        slots.push_back(slot);
+
+    if (slot >= m_streamedBySlot.size())
+        m_streamedBySlot.resize(slot + 1, NOT_STREAMED);
+    m_streamedBySlot[slot] = it->second;
+}
+
+// ============================================================
+//  UpdateStreaming
+//
+//  Each changed texture is created again from its system memory
+//  copy with the new top level. Its slots get the new SRV; the old
+//  one lives until the last slot let go of it.
+// ============================================================
+uint32_t TexturePool::UpdateStreaming(ID3D11Device* device)
+{
+    if (m_streamed.empty()) return 0;
+
+    m_residency.SetFixedBytes(m_fixedBytes);
+    const std::vector<TextureResidency::Change>& changes = m_residency.Update();
+
+    uint32_t recreated = 0;
+    for (const TextureResidency::Change& change : changes)
+    {
+        StreamedTexture& streamed = m_streamed[change.id];
+        Texture* tex = streamed.texture;
+        ID3D11ShaderResourceView* old = tex->m_textureView;
+
+        uint32_t level = change.firstLevel;
+        HRESULT hr = tex->CreateFromImage(device, streamed.image, tex->m_sFilename.c_str(), level);
+        if (FAILED(hr))
+        {
+            DBERROR("texturepool.cpp: UpdateStreaming - level ", level, " failed: ",
+                tex->m_sFilename.c_str());
+            level = streamed.firstLevel;
+            m_residency.SetResident(change.id, level);
+            hr = tex->CreateFromImage(device, streamed.image, tex->m_sFilename.c_str(), level);
+            if (FAILED(hr))
+                continue; // the slots keep showing the old SRV
+        }
+        streamed.firstLevel = level;
+
+        m_indexBySrv.erase(old);
+        for (uint32_t slot : streamed.slots)
+            ReplaceSlot(slot, tex->m_textureView);
+        ++recreated;
+    }
+    return recreated;
+}
+
+// ============================================================
+uint64_t TexturePool::GetMemoryUsage() const noexcept
+{
+    uint64_t bytes = 0;
+    for (const Texture* t : m_textures)
+        if (t) bytes += t->GetMemorySize();
+    return bytes;
+}
+
+// ============================================================
+void TexturePool::ReplaceSlot(uint32_t index, ID3D11ShaderResourceView* srv)
+{
+    srv->AddRef();
+    if (m_srvs[index]) m_srvs[index]->Release();
+    m_srvs[index] = srv;
+
+    // Keeps an earlier index when the SRV is already registered.
+    m_indexBySrv.emplace(srv, index);
+}
+
+std::wstring TexturePool::CanonicalPath(const wchar_t* filename)
+{
+    return ContentHash::CanonicalPath(filename);
+}
+
+// ============================================================
+int TexturePool::FindByPath(const std::wstring& path) const
+{
+    auto it = m_textureByPath.find(path);
+    return it != m_textureByPath.end() ? static_cast<int>(it->second) : -1;
+}
+
+int TexturePool::FindByContent(uint64_t contentHash, TextureUsage usage) const
+{
+    auto it = m_textureByContent.find(ContentKey(contentHash, usage));
+    return it != m_textureByContent.end() ? static_cast<int>(it->second) : -1;
+}
+
+void TexturePool::IndexTexture(uint32_t textureIndex, const std::wstring& path,
+                               uint64_t contentHash, TextureUsage usage)
 {
-    for (int i = 0; i < static_cast<int>(m_textures.size()); ++i)
-        if (m_textures[i] && m_textures[i]->m_sFilename == filename)
-            return i;
-    return -1;
+    m_textureByPath.emplace(path, textureIndex);
+    m_textureByContent.emplace(ContentKey(contentHash, usage), textureIndex);
 }
 
 // ============================================================
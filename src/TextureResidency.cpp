@@ -0,0 +1,301 @@
+#include "TextureResidency.h"
+
+#include <algorithm>
+#include <limits>
+
+// ============================================================
+uint32_t TextureResidency::LowestFirstLevel(const TextureImage& image, uint32_t minResidentSize) noexcept
+{
+    const uint32_t levels = std::max(image.mipLevels, 1u);
+    uint32_t lowest = levels - 1;
+    for (uint32_t l = 0; l < levels; ++l)
+    {
+        if (std::max(image.LevelWidth(l), image.LevelHeight(l)) <= minResidentSize)
+        {
+            lowest = l;
+            break;
+        }
+    }
+
+    // D3D wants the top level of a BC texture in whole blocks. Sizes halve,
+    // so the levels that qualify are a prefix of the chain.
+    if (image.IsBlockCompressed())
+    {
+        uint32_t last = 0;
+        while (last < lowest && image.LevelWidth(last + 1) % 4 == 0 && image.LevelHeight(last + 1) % 4 == 0)
+            ++last;
+        lowest = last;
+    }
+    return lowest;
+}
+
+// ============================================================
+uint32_t TextureResidency::Add(const TextureImage& image)
+{
+    Entry e;
+    e.width  = image.width;
+    e.height = image.height;
+    e.lowest = LowestFirstLevel(image, m_desc.minResidentSize);
+
+    const uint32_t levels = std::max(image.mipLevels, 1u);
+    e.bytes.assign(e.lowest + 1, 0);
+    uint64_t sum = 0;
+    for (uint32_t l = levels; l-- > 0;)
+    {
+        sum += image.LevelSize(l);
+        if (l <= e.lowest)
+            e.bytes[l] = sum;
+    }
+
+    e.first  = e.lowest;
+    e.wanted = e.lowest;
+    m_entries.push_back(std::move(e));
+    UpdateStats();
+    return static_cast<uint32_t>(m_entries.size() - 1);
+}
+
+// ============================================================
+uint32_t TextureResidency::LevelFor(const Entry& e, float texels) const noexcept
+{
+    texels *= m_desc.detailBias;
+    if (!(texels > 0.0f))
+        return e.lowest;
+
+    // Least detailed level that still has at least `texels` texels.
+    uint32_t level = 0;
+    while (level < e.lowest)
+    {
+        const uint32_t w = std::max(e.width  >> (level + 1), 1u);
+        const uint32_t h = std::max(e.height >> (level + 1), 1u);
+        if (static_cast<float>(std::max(w, h)) < texels)
+            break;
+        ++level;
+    }
+    return level;
+}
+
+// ============================================================
+void TextureResidency::Request(uint32_t id, float texels) noexcept
+{
+    if (id >= m_entries.size())
+        return;
+
+    Entry& e = m_entries[id];
+    const uint32_t level = LevelFor(e, texels);
+    if (e.usedFrame != m_frame)
+    {
+        e.usedFrame = m_frame;
+        e.wanted    = level;
+    }
+    else
+    {
+        e.wanted = std::min(e.wanted, level);
+    }
+}
+
+// ============================================================
+const std::vector<TextureResidency::Change>& TextureResidency::Update()
+{
+    m_changes.clear();
+
+    const uint32_t count = static_cast<uint32_t>(m_entries.size());
+    const uint64_t budget = m_desc.budgetBytes;
+    const uint64_t available = budget == 0 ? std::numeric_limits<uint64_t>::max()
+                                           : (budget > m_fixedBytes ? budget - m_fixedBytes : 0);
+
+    auto used = [this](const Entry& e) { return e.usedFrame == m_frame; };
+
+    // 1. Requested detail; extra detail stays while it fits.
+    m_targets.resize(count);
+    uint64_t total     = 0;
+    uint64_t requested = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const Entry& e = m_entries[i];
+        m_targets[i] = used(e) ? std::min(e.wanted, e.first) : e.first;
+        total     += Bytes(e, m_targets[i]);
+        requested += Bytes(e, used(e) ? e.wanted : e.lowest);
+    }
+
+    // 2. Not drawn in the last frame: least recently used first.
+    uint32_t evicted = 0;
+    if (total > available)
+    {
+        m_order.clear();
+        for (uint32_t i = 0; i < count; ++i)
+            if (!used(m_entries[i]) && m_targets[i] < m_entries[i].lowest)
+                m_order.push_back(i);
+
+        std::sort(m_order.begin(), m_order.end(), [this](uint32_t a, uint32_t b)
+        {
+            const Entry& ea = m_entries[a];
+            const Entry& eb = m_entries[b];
+            if (ea.usedFrame != eb.usedFrame) return ea.usedFrame < eb.usedFrame;
+            const uint64_t ba = Bytes(ea, m_targets[a]), bb = Bytes(eb, m_targets[b]);
+            if (ba != bb) return ba > bb;
+            return a < b;
+        });
+
+        for (uint32_t id : m_order)
+        {
+            const Entry& e = m_entries[id];
+            total -= Bytes(e, m_targets[id]) - Bytes(e, e.lowest);
+            m_targets[id] = e.lowest;
+            ++evicted;
+            if (total <= available)
+                break;
+        }
+    }
+
+    // 3. Drawn, with more detail than requested: largest saving first.
+    if (total > available)
+    {
+        m_order.clear();
+        for (uint32_t i = 0; i < count; ++i)
+            if (used(m_entries[i]) && m_targets[i] < m_entries[i].wanted)
+                m_order.push_back(i);
+
+        auto saving = [this](uint32_t id)
+        {
+            const Entry& e = m_entries[id];
+            return Bytes(e, m_targets[id]) - Bytes(e, e.wanted);
+        };
+        std::sort(m_order.begin(), m_order.end(), [&saving](uint32_t a, uint32_t b)
+        {
+            const uint64_t sa = saving(a), sb = saving(b);
+            return sa != sb ? sa > sb : a < b;
+        });
+
+        for (uint32_t id : m_order)
+        {
+            total -= saving(id);
+            m_targets[id] = m_entries[id].wanted;
+            if (total <= available)
+                break;
+        }
+    }
+
+    // 4. Drawn: the largest top level loses one level at a time.
+    if (total > available)
+    {
+        auto topBytes = [this](uint32_t id)
+        {
+            const Entry& e = m_entries[id];
+            return Bytes(e, m_targets[id]) - Bytes(e, m_targets[id] + 1);
+        };
+        // Heap order: largest top level first, then lowest id.
+        auto lower = [&topBytes](uint32_t a, uint32_t b)
+        {
+            const uint64_t ta = topBytes(a), tb = topBytes(b);
+            return ta != tb ? ta < tb : a > b;
+        };
+
+        m_order.clear();
+        for (uint32_t i = 0; i < count; ++i)
+            if (used(m_entries[i]) && m_targets[i] < m_entries[i].lowest)
+                m_order.push_back(i);
+        std::make_heap(m_order.begin(), m_order.end(), lower);
+
+        while (total > available && !m_order.empty())
+        {
+            std::pop_heap(m_order.begin(), m_order.end(), lower);
+            const uint32_t id = m_order.back();
+            m_order.pop_back();
+
+            total -= topBytes(id);
+            ++m_targets[id];
+            if (m_targets[id] < m_entries[id].lowest)
+            {
+                m_order.push_back(id);
+                std::push_heap(m_order.begin(), m_order.end(), lower);
+            }
+        }
+    }
+
+    // Added detail within the upload limit, most levels gained first.
+    const uint64_t uploadLimit = m_desc.uploadBytesPerUpdate;
+    if (uploadLimit > 0)
+    {
+        m_order.clear();
+        for (uint32_t i = 0; i < count; ++i)
+            if (m_targets[i] < m_entries[i].first)
+                m_order.push_back(i);
+
+        std::sort(m_order.begin(), m_order.end(), [this](uint32_t a, uint32_t b)
+        {
+            const uint32_t ga = m_entries[a].first - m_targets[a];
+            const uint32_t gb = m_entries[b].first - m_targets[b];
+            return ga != gb ? ga > gb : a < b;
+        });
+
+        uint64_t uploaded = 0;
+        for (uint32_t id : m_order)
+        {
+            const uint64_t cost = Bytes(m_entries[id], m_targets[id]);
+            if (uploaded > 0 && uploaded + cost > uploadLimit)
+                m_targets[id] = m_entries[id].first;
+            else
+                uploaded += cost;
+        }
+    }
+
+    m_stats.promoted      = 0;
+    m_stats.demoted       = 0;
+    m_stats.evicted       = evicted;
+    m_stats.bytesUploaded = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Entry& e = m_entries[i];
+        if (m_targets[i] == e.first)
+            continue;
+
+        if (m_targets[i] < e.first) ++m_stats.promoted;
+        else                        ++m_stats.demoted;
+        m_stats.bytesUploaded += Bytes(e, m_targets[i]);
+
+        e.first = m_targets[i];
+        m_changes.push_back(Change{ i, e.first });
+    }
+
+    UpdateStats();
+    m_stats.requestedBytes = requested;
+    ++m_frame;
+    return m_changes;
+}
+
+// ============================================================
+void TextureResidency::SetResident(uint32_t id, uint32_t firstLevel) noexcept
+{
+    if (id >= m_entries.size())
+        return;
+
+    m_entries[id].first = std::min(firstLevel, m_entries[id].lowest);
+    UpdateStats();
+}
+
+// ============================================================
+uint32_t TextureResidency::GetFirstLevel(uint32_t id) const noexcept
+{
+    return id < m_entries.size() ? m_entries[id].first : 0;
+}
+
+uint32_t TextureResidency::GetLowestFirstLevel(uint32_t id) const noexcept
+{
+    return id < m_entries.size() ? m_entries[id].lowest : 0;
+}
+
+uint64_t TextureResidency::GetResidentBytes(uint32_t id) const noexcept
+{
+    return id < m_entries.size() ? Bytes(m_entries[id], m_entries[id].first) : 0;
+}
+
+// ============================================================
+void TextureResidency::UpdateStats()
+{
+    m_stats.budgetBytes   = m_desc.budgetBytes;
+    m_stats.fixedBytes    = m_fixedBytes;
+    m_stats.streamed      = static_cast<uint32_t>(m_entries.size());
+    m_stats.residentBytes = 0;
+    for (const Entry& e : m_entries)
+        m_stats.residentBytes += Bytes(e, e.first);
+}
@@ -1,4 +1,6 @@
 #include "Transform.h"
+#include "Entity.h"
+#include "TransformMath.h"
 using namespace DirectX;
 
 static const XMVECTOR forwardVector = XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
@@ -11,11 +13,10 @@ Transform::Transform() :
     scale(XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f)),
     matricesDirty(true),
     worldMatrix(nullptr),
+    owner(nullptr),
     vectorsDirty(true)
 {
-    rotationMatrix = XMMatrixIdentity();
-    translationMatrix = XMMatrixIdentity();
-    scalingMatrix = XMMatrixIdentity();
+    localMatrix = XMMatrixIdentity();
     lookAt = forwardVector;
     up = upVector;
     right = rightVector;
@@ -34,18 +35,23 @@ void Transform::UpdateMatrices() const
 {
     if (!matricesDirty) return;
 
-    scalingMatrix = XMMatrixScalingFromVector(scale);
-    rotationMatrix = XMMatrixRotationQuaternion(rotationQuat);
-    translationMatrix = XMMatrixTranslationFromVector(position);
+    localMatrix = TransformMath::ComposeTRS(position, rotationQuat, scale);
 
     matricesDirty = false;
     vectorsDirty = true;
 
     if (worldMatrix) {
-        *worldMatrix = scalingMatrix * rotationMatrix * translationMatrix;
+        *worldMatrix = localMatrix;
     }
 }
 
+void Transform::MarkDirty()
+{
+    matricesDirty = true;
+    vectorsDirty = true; // direction vectors follow the rotation
+    if (owner) owner->MarkWorldDirty();
+}
+
 void Transform::UpdateDirectionVectors() const
 {
     if (!vectorsDirty) return;
@@ -103,7 +109,7 @@ void Transform::Rotate(float fRotateX, float fRotateY, float fRotateZ, Space spa
     }
 
     rotationQuat = XMQuaternionNormalize(rotationQuat);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::Turn(float fRotateX, float fRotateY, float fRotateZ, Space space)
@@ -114,7 +120,7 @@ void Transform::Turn(float fRotateX, float fRotateY, float fRotateZ, Space space
 void Transform::Position(float x, float y, float z)
 {
     position = XMVectorSet(x, y, z, 1.0f);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::Move(float x, float y, float z, Space space)
@@ -126,13 +132,13 @@ void Transform::Move(float x, float y, float z, Space space)
     }
 
     position = XMVectorAdd(position, trans);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::Scale(float x, float y, float z)
 {
     scale = XMVectorSet(x, y, z, 0.0f);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::LookAt(const XMVECTOR& target, const XMVECTOR& upVec)
@@ -161,7 +167,7 @@ void Transform::LookAt(const XMVECTOR& target, const XMVECTOR& upVec)
     rotMatrix.r[3] = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
 
     rotationQuat = XMQuaternionNormalize(XMQuaternionRotationMatrix(rotMatrix));
-    matricesDirty = true;
+    MarkDirty();
     vectorsDirty = true;
 }
 
@@ -174,7 +180,7 @@ float Transform::Distance(const XMVECTOR& target) const
 XMMATRIX Transform::GetLocalTransformationMatrix() const
 {
     UpdateMatrices();
-    return scalingMatrix * rotationMatrix * translationMatrix;
+    return localMatrix;
 }
 
 XMVECTOR Transform::GetLookAt() const
@@ -195,22 +201,21 @@ XMVECTOR Transform::GetRight() const
     return right;
 }
 
+// The separate matrices are built on request only; UpdateMatrices composes
+// the local matrix without them.
 XMMATRIX Transform::GetRotation() const
 {
-    UpdateMatrices();
-    return rotationMatrix;
+    return XMMatrixRotationQuaternion(rotationQuat);
 }
 
 XMMATRIX Transform::GetTranslation() const
 {
-    UpdateMatrices();
-    return translationMatrix;
+    return XMMatrixTranslationFromVector(position);
 }
 
 XMMATRIX Transform::GetScaling() const
 {
-    UpdateMatrices();
-    return scalingMatrix;
+    return XMMatrixScalingFromVector(scale);
 }
 
 float Transform::GetRoll(const XMMATRIX* XMMatrix_p_Rotation) const
@@ -239,7 +244,7 @@ float Transform::GetPitch(const XMMATRIX* XMMatrix_p_Rotation) const
 void Transform::SetRotationQuaternion(const XMVECTOR& quaternion)
 {
     rotationQuat = XMQuaternionNormalize(quaternion);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::RotateQuaternion(const XMVECTOR& quaternion, Space space)
@@ -254,7 +259,7 @@ void Transform::RotateQuaternion(const XMVECTOR& quaternion, Space space)
     }
 
     rotationQuat = XMQuaternionNormalize(rotationQuat);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 float Transform::GetPitch() const
@@ -281,13 +286,13 @@ float Transform::GetRoll() const
 void Transform::SetScale(float x, float y, float z)
 {
     scale = XMVectorSet(x, y, z, 0.0f);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::SetScale(float uniformScale)
 {
     scale = XMVectorSet(uniformScale, uniformScale, uniformScale, 0.0f);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::Translate(const XMVECTOR& translation, Space space)
@@ -298,13 +303,13 @@ void Transform::Translate(const XMVECTOR& translation, Space space)
     else {
         position = XMVectorAdd(position, translation);
     }
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::SetPosition(const XMVECTOR& pos)
 {
     position = XMVectorSetW(pos, 1.0f);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::Lerp(const Transform& target, float t)
@@ -313,7 +318,7 @@ void Transform::Lerp(const Transform& target, float t)
     position = XMVectorLerp(position, target.position, t);
     scale = XMVectorLerp(scale, target.scale, t);
     rotationQuat = XMQuaternionSlerp(rotationQuat, target.rotationQuat, t);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 void Transform::Slerp(const Transform& target, float t)
@@ -341,13 +346,13 @@ void Transform::Slerp(const Transform& target, float t)
     scale = XMVectorSet(scaleX, scaleY, scaleZ, 0.0f);
 
     rotationQuat = XMQuaternionSlerp(rotationQuat, target.rotationQuat, t);
-    matricesDirty = true;
+    MarkDirty();
 }
 
 XMMATRIX Transform::GetWorldMatrix() const
 {
     UpdateMatrices();
-    return scalingMatrix * rotationMatrix * translationMatrix;
+    return localMatrix;
 }
 
 Transform Transform::Combine(const Transform& other) const
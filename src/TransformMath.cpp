@@ -0,0 +1,280 @@
+#include "TransformMath.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define TRANSFORM_MATH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TRANSFORM_MATH_TARGET_AVX2
+#else
+#define TRANSFORM_MATH_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+using namespace DirectX;
+
+namespace TransformMath
+{
+    namespace
+    {
+        // One object, plain floats. Reference for the SIMD kernels and tail loop.
+        inline void ComposeOne(const TRSStreams& in, uint32_t i, XMFLOAT4X4A& o)
+        {
+            const float x = in.rotX[i], y = in.rotY[i], z = in.rotZ[i], w = in.rotW[i];
+            const float x2 = x + x, y2 = y + y, z2 = z + z;
+            const float xx = x * x2, yy = y * y2, zz = z * z2;
+            const float xy = x * y2, xz = x * z2, yz = y * z2;
+            const float wx = w * x2, wy = w * y2, wz = w * z2;
+
+            const float sx = in.sclX[i], sy = in.sclY[i], sz = in.sclZ[i];
+
+            o.m[0][0] = sx * (1.0f - (yy + zz)); o.m[0][1] = sx * (xy + wz); o.m[0][2] = sx * (xz - wy); o.m[0][3] = 0.0f;
+            o.m[1][0] = sy * (xy - wz); o.m[1][1] = sy * (1.0f - (xx + zz)); o.m[1][2] = sy * (yz + wx); o.m[1][3] = 0.0f;
+            o.m[2][0] = sz * (xz + wy); o.m[2][1] = sz * (yz - wx); o.m[2][2] = sz * (1.0f - (xx + yy)); o.m[2][3] = 0.0f;
+            o.m[3][0] = in.posX[i];     o.m[3][1] = in.posY[i];     o.m[3][2] = in.posZ[i];     o.m[3][3] = 1.0f;
+        }
+
+        void ComposeScalar(const TRSStreams& in, uint32_t begin, uint32_t count, XMFLOAT4X4A* out)
+        {
+            for (uint32_t i = begin; i < count; ++i)
+                ComposeOne(in, i, out[i]);
+        }
+
+#if TRANSFORM_MATH_X86
+        // 4 objects per iteration: the math runs lane-parallel over the SoA
+        // streams, a 4x4 transpose per matrix row turns it back into AoS.
+        void ComposeSSE(const TRSStreams& in, uint32_t count, XMFLOAT4X4A* out)
+        {
+            const __m128 one  = _mm_set1_ps(1.0f);
+            const __m128 zero = _mm_setzero_ps();
+
+            uint32_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128 x = _mm_loadu_ps(in.rotX + i);
+                const __m128 y = _mm_loadu_ps(in.rotY + i);
+                const __m128 z = _mm_loadu_ps(in.rotZ + i);
+                const __m128 w = _mm_loadu_ps(in.rotW + i);
+
+                const __m128 x2 = _mm_add_ps(x, x), y2 = _mm_add_ps(y, y), z2 = _mm_add_ps(z, z);
+                const __m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+                const __m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+                const __m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+
+                const __m128 sx = _mm_loadu_ps(in.sclX + i);
+                const __m128 sy = _mm_loadu_ps(in.sclY + i);
+                const __m128 sz = _mm_loadu_ps(in.sclZ + i);
+
+                __m128 r0[4] = {
+                    _mm_mul_ps(sx, _mm_sub_ps(one, _mm_add_ps(yy, zz))),
+                    _mm_mul_ps(sx, _mm_add_ps(xy, wz)),
+                    _mm_mul_ps(sx, _mm_sub_ps(xz, wy)),
+                    zero };
+                __m128 r1[4] = {
+                    _mm_mul_ps(sy, _mm_sub_ps(xy, wz)),
+                    _mm_mul_ps(sy, _mm_sub_ps(one, _mm_add_ps(xx, zz))),
+                    _mm_mul_ps(sy, _mm_add_ps(yz, wx)),
+                    zero };
+                __m128 r2[4] = {
+                    _mm_mul_ps(sz, _mm_add_ps(xz, wy)),
+                    _mm_mul_ps(sz, _mm_sub_ps(yz, wx)),
+                    _mm_mul_ps(sz, _mm_sub_ps(one, _mm_add_ps(xx, yy))),
+                    zero };
+                __m128 r3[4] = {
+                    _mm_loadu_ps(in.posX + i),
+                    _mm_loadu_ps(in.posY + i),
+                    _mm_loadu_ps(in.posZ + i),
+                    one };
+
+                _MM_TRANSPOSE4_PS(r0[0], r0[1], r0[2], r0[3]);
+                _MM_TRANSPOSE4_PS(r1[0], r1[1], r1[2], r1[3]);
+                _MM_TRANSPOSE4_PS(r2[0], r2[1], r2[2], r2[3]);
+                _MM_TRANSPOSE4_PS(r3[0], r3[1], r3[2], r3[3]);
+
+                for (int k = 0; k < 4; ++k)
+                {
+                    float* m = &out[i + k].m[0][0];
+                    _mm_store_ps(m + 0,  r0[k]);
+                    _mm_store_ps(m + 4,  r1[k]);
+                    _mm_store_ps(m + 8,  r2[k]);
+                    _mm_store_ps(m + 12, r3[k]);
+                }
+            }
+
+            ComposeScalar(in, i, count, out);
+        }
+
+        // In-lane 4x4 transpose of four 8-wide vectors: the low 128 bits end
+        // up holding objects 0..3, the high 128 bits objects 4..7.
+        TRANSFORM_MATH_TARGET_AVX2
+        inline void Transpose4x8(__m256& a, __m256& b, __m256& c, __m256& d)
+        {
+            const __m256 t0 = _mm256_unpacklo_ps(a, b);
+            const __m256 t1 = _mm256_unpackhi_ps(a, b);
+            const __m256 t2 = _mm256_unpacklo_ps(c, d);
+            const __m256 t3 = _mm256_unpackhi_ps(c, d);
+            a = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+            b = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+            c = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+            d = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+        }
+
+        TRANSFORM_MATH_TARGET_AVX2
+        void ComposeAVX2(const TRSStreams& in, uint32_t count, XMFLOAT4X4A* out)
+        {
+            const __m256 one  = _mm256_set1_ps(1.0f);
+            const __m256 zero = _mm256_setzero_ps();
+
+            uint32_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256 x = _mm256_loadu_ps(in.rotX + i);
+                const __m256 y = _mm256_loadu_ps(in.rotY + i);
+                const __m256 z = _mm256_loadu_ps(in.rotZ + i);
+                const __m256 w = _mm256_loadu_ps(in.rotW + i);
+
+                const __m256 x2 = _mm256_add_ps(x, x), y2 = _mm256_add_ps(y, y), z2 = _mm256_add_ps(z, z);
+                const __m256 xx = _mm256_mul_ps(x, x2), yy = _mm256_mul_ps(y, y2), zz = _mm256_mul_ps(z, z2);
+                const __m256 xy = _mm256_mul_ps(x, y2), xz = _mm256_mul_ps(x, z2), yz = _mm256_mul_ps(y, z2);
+
+                // w*q2 folded into the sums/differences with FMA.
+                const __m256 xyPwz = _mm256_fmadd_ps(w, z2, xy);
+                const __m256 xyMwz = _mm256_fnmadd_ps(w, z2, xy);
+                const __m256 xzPwy = _mm256_fmadd_ps(w, y2, xz);
+                const __m256 xzMwy = _mm256_fnmadd_ps(w, y2, xz);
+                const __m256 yzPwx = _mm256_fmadd_ps(w, x2, yz);
+                const __m256 yzMwx = _mm256_fnmadd_ps(w, x2, yz);
+
+                const __m256 sx = _mm256_loadu_ps(in.sclX + i);
+                const __m256 sy = _mm256_loadu_ps(in.sclY + i);
+                const __m256 sz = _mm256_loadu_ps(in.sclZ + i);
+
+                __m256 r0a = _mm256_mul_ps(sx, _mm256_sub_ps(one, _mm256_add_ps(yy, zz)));
+                __m256 r0b = _mm256_mul_ps(sx, xyPwz);
+                __m256 r0c = _mm256_mul_ps(sx, xzMwy);
+                __m256 r0d = zero;
+                __m256 r1a = _mm256_mul_ps(sy, xyMwz);
+                __m256 r1b = _mm256_mul_ps(sy, _mm256_sub_ps(one, _mm256_add_ps(xx, zz)));
+                __m256 r1c = _mm256_mul_ps(sy, yzPwx);
+                __m256 r1d = zero;
+                __m256 r2a = _mm256_mul_ps(sz, xzPwy);
+                __m256 r2b = _mm256_mul_ps(sz, yzMwx);
+                __m256 r2c = _mm256_mul_ps(sz, _mm256_sub_ps(one, _mm256_add_ps(xx, yy)));
+                __m256 r2d = zero;
+                __m256 r3a = _mm256_loadu_ps(in.posX + i);
+                __m256 r3b = _mm256_loadu_ps(in.posY + i);
+                __m256 r3c = _mm256_loadu_ps(in.posZ + i);
+                __m256 r3d = one;
+
+                Transpose4x8(r0a, r0b, r0c, r0d);
+                Transpose4x8(r1a, r1b, r1c, r1d);
+                Transpose4x8(r2a, r2b, r2c, r2d);
+                Transpose4x8(r3a, r3b, r3c, r3d);
+
+                const __m256 r0[4] = { r0a, r0b, r0c, r0d };
+                const __m256 r1[4] = { r1a, r1b, r1c, r1d };
+                const __m256 r2[4] = { r2a, r2b, r2c, r2d };
+                const __m256 r3[4] = { r3a, r3b, r3c, r3d };
+
+                for (int k = 0; k < 4; ++k)
+                {
+                    float* lo = &out[i + k].m[0][0];
+                    float* hi = &out[i + k + 4].m[0][0];
+                    _mm_store_ps(lo + 0,  _mm256_castps256_ps128(r0[k]));
+                    _mm_store_ps(lo + 4,  _mm256_castps256_ps128(r1[k]));
+                    _mm_store_ps(lo + 8,  _mm256_castps256_ps128(r2[k]));
+                    _mm_store_ps(lo + 12, _mm256_castps256_ps128(r3[k]));
+                    _mm_store_ps(hi + 0,  _mm256_extractf128_ps(r0[k], 1));
+                    _mm_store_ps(hi + 4,  _mm256_extractf128_ps(r1[k], 1));
+                    _mm_store_ps(hi + 8,  _mm256_extractf128_ps(r2[k], 1));
+                    _mm_store_ps(hi + 12, _mm256_extractf128_ps(r3[k], 1));
+                }
+            }
+
+            ComposeScalar(in, i, count, out);
+        }
+
+        bool DetectAVX2()
+        {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+
+            __cpuid(info, 1);
+            const bool osxsave = (info[2] & (1 << 27)) != 0;
+            const bool avx     = (info[2] & (1 << 28)) != 0;
+            const bool fma     = (info[2] & (1 << 12)) != 0;
+            if (!osxsave || !avx || !fma) return false;
+
+            // OS must save the YMM state.
+            if ((_xgetbv(0) & 0x6) != 0x6) return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+        }
+#endif // TRANSFORM_MATH_X86
+
+        SimdPath DetectPath()
+        {
+#if TRANSFORM_MATH_X86
+            return DetectAVX2() ? SimdPath::AVX2 : SimdPath::SSE;
+#else
+            return SimdPath::Scalar;
+#endif
+        }
+
+        SimdPath& ActivePath()
+        {
+            static SimdPath s_path = GetSupportedPath();
+            return s_path;
+        }
+    }
+
+    SimdPath GetSupportedPath()
+    {
+        static const SimdPath s_supported = DetectPath();
+        return s_supported;
+    }
+
+    SimdPath GetPath()
+    {
+        return ActivePath();
+    }
+
+    SimdPath SetPath(SimdPath path)
+    {
+        const SimdPath supported = GetSupportedPath();
+        ActivePath() = (static_cast<uint8_t>(path) > static_cast<uint8_t>(supported)) ? supported : path;
+        return ActivePath();
+    }
+
+    const char* GetPathName(SimdPath path)
+    {
+        switch (path)
+        {
+        case SimdPath::Scalar: return "Scalar";
+        case SimdPath::SSE:    return "SSE";
+        case SimdPath::AVX2:   return "AVX2";
+        }
+        return "Unknown";
+    }
+
+    void ComposeTRSBatch(const TRSStreams& in, uint32_t count, XMFLOAT4X4A* out)
+    {
+        if (!out || count == 0) return;
+
+        switch (ActivePath())
+        {
+#if TRANSFORM_MATH_X86
+        case SimdPath::AVX2: ComposeAVX2(in, count, out); return;
+        case SimdPath::SSE:  ComposeSSE(in, count, out);  return;
+#endif
+        default:             ComposeScalar(in, 0, count, out); return;
+        }
+    }
+}
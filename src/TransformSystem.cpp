@@ -0,0 +1,312 @@
+#include "TransformSystem.h"
+#include "TransformMath.h"
+#include "gdxutil.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+TransformHandle TransformSystem::Create(TransformHandle parent)
+{
+    TransformHandle handle;
+    if (!m_freeHandles.empty())
+    {
+        handle = m_freeHandles.back();
+        m_freeHandles.pop_back();
+    }
+    else
+    {
+        handle = static_cast<TransformHandle>(m_handleToSlot.size());
+        m_handleToSlot.push_back(NO_SLOT);
+    }
+
+    const uint32_t slot = static_cast<uint32_t>(m_slotToHandle.size());
+    m_handleToSlot[handle] = slot;
+    m_slotToHandle.push_back(handle);
+
+    m_posX.push_back(0.0f); m_posY.push_back(0.0f); m_posZ.push_back(0.0f);
+    m_rotX.push_back(0.0f); m_rotY.push_back(0.0f); m_rotZ.push_back(0.0f); m_rotW.push_back(1.0f);
+    m_sclX.push_back(1.0f); m_sclY.push_back(1.0f); m_sclZ.push_back(1.0f);
+
+    XMFLOAT4X4A identity;
+    XMStoreFloat4x4A(&identity, XMMatrixIdentity());
+    m_world.push_back(identity);
+
+    // Appended last, so any existing parent already sits in an earlier slot.
+    const uint32_t parentSlot = SlotOf(parent);
+    m_parentSlot.push_back(parentSlot);
+    m_dirty.push_back(1);
+
+    return handle;
+}
+
+void TransformSystem::Destroy(TransformHandle handle)
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return;
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(m_parentSlot.size()); ++i)
+    {
+        if (m_parentSlot[i] == slot)
+        {
+            m_parentSlot[i] = NO_SLOT;
+            m_dirty[i] = 1;
+        }
+    }
+
+    const uint32_t last = static_cast<uint32_t>(m_slotToHandle.size() - 1);
+    if (slot != last)
+    {
+        MoveSlot(last, slot);
+        // The moved slot may now precede its parent.
+        m_orderDirty = true;
+    }
+
+    m_posX.pop_back(); m_posY.pop_back(); m_posZ.pop_back();
+    m_rotX.pop_back(); m_rotY.pop_back(); m_rotZ.pop_back(); m_rotW.pop_back();
+    m_sclX.pop_back(); m_sclY.pop_back(); m_sclZ.pop_back();
+    m_world.pop_back();
+    m_parentSlot.pop_back();
+    m_dirty.pop_back();
+    m_slotToHandle.pop_back();
+
+    m_handleToSlot[handle] = NO_SLOT;
+    m_freeHandles.push_back(handle);
+}
+
+void TransformSystem::MoveSlot(uint32_t from, uint32_t to)
+{
+    m_posX[to] = m_posX[from]; m_posY[to] = m_posY[from]; m_posZ[to] = m_posZ[from];
+    m_rotX[to] = m_rotX[from]; m_rotY[to] = m_rotY[from]; m_rotZ[to] = m_rotZ[from]; m_rotW[to] = m_rotW[from];
+    m_sclX[to] = m_sclX[from]; m_sclY[to] = m_sclY[from]; m_sclZ[to] = m_sclZ[from];
+    m_world[to]      = m_world[from];
+    m_parentSlot[to] = m_parentSlot[from];
+    m_dirty[to]      = m_dirty[from];
+
+    const TransformHandle moved = m_slotToHandle[from];
+    m_slotToHandle[to]     = moved;
+    m_handleToSlot[moved]  = to;
+
+    for (uint32_t& p : m_parentSlot)
+        if (p == from) p = to;
+}
+
+bool TransformSystem::IsValid(TransformHandle handle) const noexcept
+{
+    return SlotOf(handle) != NO_SLOT;
+}
+
+bool TransformSystem::SetParent(TransformHandle handle, TransformHandle parent)
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return false;
+
+    const uint32_t parentSlot = SlotOf(parent);
+    if (parent != INVALID_TRANSFORM && parentSlot == NO_SLOT) return false;
+
+    for (uint32_t p = parentSlot; p != NO_SLOT; p = m_parentSlot[p])
+    {
+        if (p == slot)
+        {
+            DBERROR("TransformSystem.cpp: SetParent - cycle detected, assignment rejected");
+            return false;
+        }
+    }
+
+    m_parentSlot[slot] = parentSlot;
+    MarkDirty(slot);
+    if (parentSlot != NO_SLOT && parentSlot > slot)
+        m_orderDirty = true;
+    return true;
+}
+
+TransformHandle TransformSystem::GetParent(TransformHandle handle) const noexcept
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT || m_parentSlot[slot] == NO_SLOT) return INVALID_TRANSFORM;
+    return m_slotToHandle[m_parentSlot[slot]];
+}
+
+void TransformSystem::SetPosition(TransformHandle handle, float x, float y, float z)
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return;
+
+    m_posX[slot] = x; m_posY[slot] = y; m_posZ[slot] = z;
+    MarkDirty(slot);
+}
+
+void TransformSystem::SetRotation(TransformHandle handle, const XMVECTOR& quaternion)
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return;
+
+    XMFLOAT4 q;
+    XMStoreFloat4(&q, XMQuaternionNormalize(quaternion));
+    m_rotX[slot] = q.x; m_rotY[slot] = q.y; m_rotZ[slot] = q.z; m_rotW[slot] = q.w;
+    MarkDirty(slot);
+}
+
+void TransformSystem::SetScale(TransformHandle handle, float x, float y, float z)
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return;
+
+    m_sclX[slot] = x; m_sclY[slot] = y; m_sclZ[slot] = z;
+    MarkDirty(slot);
+}
+
+void TransformSystem::SetLocal(TransformHandle handle, const XMFLOAT3& position,
+                               const XMFLOAT4& rotation, const XMFLOAT3& scale)
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return;
+
+    XMFLOAT4 q;
+    XMStoreFloat4(&q, XMQuaternionNormalize(XMLoadFloat4(&rotation)));
+
+    m_posX[slot] = position.x; m_posY[slot] = position.y; m_posZ[slot] = position.z;
+    m_rotX[slot] = q.x;        m_rotY[slot] = q.y;        m_rotZ[slot] = q.z;        m_rotW[slot] = q.w;
+    m_sclX[slot] = scale.x;    m_sclY[slot] = scale.y;    m_sclZ[slot] = scale.z;
+    MarkDirty(slot);
+}
+
+XMVECTOR TransformSystem::GetPosition(TransformHandle handle) const noexcept
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+    return XMVectorSet(m_posX[slot], m_posY[slot], m_posZ[slot], 1.0f);
+}
+
+XMVECTOR TransformSystem::GetRotation(TransformHandle handle) const noexcept
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return XMQuaternionIdentity();
+    return XMVectorSet(m_rotX[slot], m_rotY[slot], m_rotZ[slot], m_rotW[slot]);
+}
+
+XMVECTOR TransformSystem::GetScale(TransformHandle handle) const noexcept
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f);
+    return XMVectorSet(m_sclX[slot], m_sclY[slot], m_sclZ[slot], 0.0f);
+}
+
+XMMATRIX TransformSystem::GetWorldMatrix(TransformHandle handle) const noexcept
+{
+    const uint32_t slot = SlotOf(handle);
+    if (slot == NO_SLOT) return XMMatrixIdentity();
+    return XMLoadFloat4x4A(&m_world[slot]);
+}
+
+// Stable reorder by hierarchy depth: every parent ends up before its
+// children, siblings keep their relative order.
+void TransformSystem::SortHierarchy()
+{
+    m_orderDirty = false;
+
+    const uint32_t count = GetCount();
+    std::vector<uint32_t> depth(count, NO_SLOT);
+    uint32_t maxDepth = 0;
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        // Walk up until a slot with known depth (or a root) is found.
+        uint32_t d = 0;
+        uint32_t p = i;
+        while (p != NO_SLOT && depth[p] == NO_SLOT)
+        {
+            p = m_parentSlot[p];
+            ++d;
+        }
+        const uint32_t base = (p == NO_SLOT) ? 0 : depth[p] + 1;
+
+        // Second walk fills the depths of the chain just visited.
+        p = i;
+        for (uint32_t k = 0; k < d; ++k)
+        {
+            depth[p] = base + (d - 1 - k);
+            p = m_parentSlot[p];
+        }
+        if (depth[i] > maxDepth) maxDepth = depth[i];
+    }
+
+    // Counting sort by depth.
+    std::vector<uint32_t> start(maxDepth + 2, 0);
+    for (uint32_t i = 0; i < count; ++i) ++start[depth[i] + 1];
+    for (uint32_t d = 1; d < start.size(); ++d) start[d] += start[d - 1];
+
+    std::vector<uint32_t> newSlot(count);
+    for (uint32_t i = 0; i < count; ++i) newSlot[i] = start[depth[i]]++;
+
+    auto permute = [&](auto& stream)
+    {
+        auto copy = stream;
+        for (uint32_t i = 0; i < count; ++i) stream[newSlot[i]] = copy[i];
+    };
+
+    permute(m_posX); permute(m_posY); permute(m_posZ);
+    permute(m_rotX); permute(m_rotY); permute(m_rotZ); permute(m_rotW);
+    permute(m_sclX); permute(m_sclY); permute(m_sclZ);
+    permute(m_world);
+    permute(m_dirty);
+    permute(m_slotToHandle);
+    permute(m_parentSlot);
+
+    for (uint32_t& p : m_parentSlot)
+        if (p != NO_SLOT) p = newSlot[p];
+    for (uint32_t i = 0; i < count; ++i)
+        m_handleToSlot[m_slotToHandle[i]] = i;
+}
+
+uint32_t TransformSystem::Update()
+{
+    if (m_orderDirty)
+        SortHierarchy();
+
+    const uint32_t count = GetCount();
+    uint32_t updated = 0;
+
+    // 1) Propagate: parents come first, so their flag is already final.
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t parent = m_parentSlot[i];
+        if (parent != NO_SLOT && m_dirty[parent])
+            m_dirty[i] = 1;
+    }
+
+    // 2) Local matrices for each run of consecutive dirty slots, batched
+    //    (SSE/AVX2). Written straight into m_world.
+    for (uint32_t begin = 0; begin < count; )
+    {
+        if (!m_dirty[begin]) { ++begin; continue; }
+
+        uint32_t end = begin + 1;
+        while (end < count && m_dirty[end]) ++end;
+
+        const TransformMath::TRSStreams streams =
+        {
+            m_posX.data() + begin, m_posY.data() + begin, m_posZ.data() + begin,
+            m_rotX.data() + begin, m_rotY.data() + begin, m_rotZ.data() + begin, m_rotW.data() + begin,
+            m_sclX.data() + begin, m_sclY.data() + begin, m_sclZ.data() + begin,
+        };
+        TransformMath::ComposeTRSBatch(streams, end - begin, m_world.data() + begin);
+
+        updated += end - begin;
+        begin = end;
+    }
+
+    // 3) Concatenate with the parent; again in slot order so every parent
+    //    already holds its final world matrix.
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const uint32_t parent = m_parentSlot[i];
+        if (!m_dirty[i] || parent == NO_SLOT) continue;
+
+        const XMMATRIX world = XMMatrixMultiply(XMLoadFloat4x4A(&m_world[i]),
+                                                XMLoadFloat4x4A(&m_world[parent]));
+        XMStoreFloat4x4A(&m_world[i], world);
+    }
+
+    std::fill(m_dirty.begin(), m_dirty.end(), static_cast<uint8_t>(0));
+    return updated;
+}
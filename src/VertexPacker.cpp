@@ -0,0 +1,242 @@
+#include "VertexPacker.h"
+#include "Surface.h"
+#include "gdxutil.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace DirectX;
+
+uint16_t VertexPacker::FloatToHalf(float value) noexcept
+{
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+
+    const uint32_t sign     = (f >> 16) & 0x8000u;
+    const uint32_t exponent = (f >> 23) & 0xFFu;
+    uint32_t       mantissa = f & 0x7FFFFFu;
+
+    if (exponent == 0xFFu)                                   // Inf / NaN
+        return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+
+    const int32_t e = static_cast<int32_t>(exponent) - 127 + 15;
+    if (e >= 31)                                             // overflow -> Inf
+        return static_cast<uint16_t>(sign | 0x7C00u);
+
+    if (e <= 0)                                              // half subnormal
+    {
+        if (e < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000u;
+        const uint32_t shift = static_cast<uint32_t>(14 - e);
+        uint32_t       half  = mantissa >> shift;
+        const uint32_t rest  = mantissa & ((1u << shift) - 1u);
+        const uint32_t mid   = 1u << (shift - 1u);
+        if (rest > mid || (rest == mid && (half & 1u))) ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    // Round to nearest even; a carry into the exponent is the correct result.
+    uint32_t       half = (static_cast<uint32_t>(e) << 10) | (mantissa >> 13);
+    const uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ++half;
+    return static_cast<uint16_t>(sign | half);
+}
+
+float VertexPacker::HalfToFloat(uint16_t value) noexcept
+{
+    const uint32_t sign     = static_cast<uint32_t>(value & 0x8000u) << 16;
+    const uint32_t exponent = (value >> 10) & 0x1Fu;
+    const uint32_t mantissa = value & 0x3FFu;
+
+    if (exponent == 0)
+    {
+        const float m = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -m : m;
+    }
+
+    uint32_t f;
+    if (exponent == 31)
+        f = sign | 0x7F800000u | (mantissa << 13);
+    else
+        f = sign | ((exponent - 15u + 127u) << 23) | (mantissa << 13);
+
+    float result;
+    std::memcpy(&result, &f, sizeof(result));
+    return result;
+}
+
+int8_t VertexPacker::PackSnorm8(float value) noexcept
+{
+    const float v = (std::max)(-1.0f, (std::min)(1.0f, value));
+    return static_cast<int8_t>(std::lround(v * 127.0f));
+}
+
+float VertexPacker::UnpackSnorm8(int8_t value) noexcept
+{
+    // -128 and -127 both decode to -1 (D3D SNORM rule).
+    return (std::max)(-1.0f, static_cast<float>(value) / 127.0f);
+}
+
+uint8_t VertexPacker::PackUnorm8(float value) noexcept
+{
+    const float v = (std::max)(0.0f, (std::min)(1.0f, value));
+    return static_cast<uint8_t>(std::lround(v * 255.0f));
+}
+
+float VertexPacker::UnpackUnorm8(uint8_t value) noexcept
+{
+    return static_cast<float>(value) / 255.0f;
+}
+
+void VertexPacker::PackWeights(const XMFLOAT4& weights, uint8_t out[4]) noexcept
+{
+    const float w[4] = {
+        (std::max)(0.0f, weights.x), (std::max)(0.0f, weights.y),
+        (std::max)(0.0f, weights.z), (std::max)(0.0f, weights.w) };
+    const float sum = w[0] + w[1] + w[2] + w[3];
+
+    if (sum <= 0.0f)
+    {
+        out[0] = 255; out[1] = 0; out[2] = 0; out[3] = 0;
+        return;
+    }
+
+    int total   = 0;
+    int largest = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        out[i] = static_cast<uint8_t>(std::lround(w[i] / sum * 255.0f));
+        total += out[i];
+        if (w[i] > w[largest]) largest = i;
+    }
+
+    // Rounding may miss 255 by a few steps; the dominant bone absorbs it.
+    out[largest] = static_cast<uint8_t>((std::max)(0, (std::min)(255, out[largest] + 255 - total)));
+}
+
+uint32_t VertexPacker::Pack(const Surface& surface, std::vector<uint8_t>& out)
+{
+    out.clear();
+
+    const uint32_t count = surface.CountVertices();
+    if (count == 0) return 0;
+
+    const bool     skinned = surface.CountBoneData() > 0;
+    const uint32_t stride  = skinned ? STRIDE_SKINNED : STRIDE;
+
+    if (skinned)
+    {
+        for (const XMUINT4& b : surface.GetBoneIndices())
+        {
+            if (b.x > 255u || b.y > 255u || b.z > 255u || b.w > 255u)
+            {
+                DBLOG("VertexPacker.cpp: Pack - bone index above 255, surface not packed");
+                return 0;
+            }
+        }
+    }
+
+    const auto& positions = surface.GetPositions();
+    const auto& normals   = surface.GetNormals();
+    const auto& tangents  = surface.GetTangents();
+    const auto& colors    = surface.GetColors();
+    const auto& uv1       = surface.GetUV1();
+    const auto& uv2       = surface.GetUV2();
+    const auto& bones     = surface.GetBoneIndices();
+    const auto& weights   = surface.GetBoneWeights();
+
+    out.resize(static_cast<size_t>(count) * stride);
+
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        UnpackedVertex v;
+        v.position    = positions[i];
+        v.normal      = (i < normals.size())  ? normals[i]  : XMFLOAT3(0.0f, 0.0f, 1.0f);
+        v.tangent     = (i < tangents.size()) ? tangents[i] : XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f);
+        v.color       = (i < colors.size())   ? colors[i]   : XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        v.uv1         = (i < uv1.size())      ? uv1[i]      : XMFLOAT2(0.0f, 0.0f);
+        v.uv2         = (i < uv2.size())      ? uv2[i]      : XMFLOAT2(0.0f, 0.0f);
+        v.boneIndices = (i < bones.size())    ? bones[i]    : XMUINT4{ 0, 0, 0, 0 };
+        v.boneWeights = (i < weights.size())  ? weights[i]  : XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f);
+
+        PackVertex(v, stride, out.data() + static_cast<size_t>(i) * stride);
+    }
+
+    return stride;
+}
+
+void VertexPacker::PackVertex(const UnpackedVertex& in, uint32_t stride, uint8_t* out) noexcept
+{
+    if (!out || stride < STRIDE) return;
+
+    PackedVertex v{};
+
+    v.position[0] = in.position.x;
+    v.position[1] = in.position.y;
+    v.position[2] = in.position.z;
+
+    XMFLOAT3 n;
+    XMStoreFloat3(&n, XMVector3Normalize(XMLoadFloat3(&in.normal)));
+    v.normal[0] = PackSnorm8(n.x);
+    v.normal[1] = PackSnorm8(n.y);
+    v.normal[2] = PackSnorm8(n.z);
+
+    XMFLOAT3 t;
+    XMStoreFloat3(&t, XMVector3Normalize(XMVectorSet(in.tangent.x, in.tangent.y, in.tangent.z, 0.0f)));
+    v.tangent[0] = PackSnorm8(t.x);
+    v.tangent[1] = PackSnorm8(t.y);
+    v.tangent[2] = PackSnorm8(t.z);
+    v.tangent[3] = PackSnorm8(in.tangent.w < 0.0f ? -1.0f : 1.0f);
+
+    v.color[0] = PackUnorm8(in.color.x);
+    v.color[1] = PackUnorm8(in.color.y);
+    v.color[2] = PackUnorm8(in.color.z);
+    v.color[3] = PackUnorm8(in.color.w);
+
+    v.uv1[0] = FloatToHalf(in.uv1.x); v.uv1[1] = FloatToHalf(in.uv1.y);
+    v.uv2[0] = FloatToHalf(in.uv2.x); v.uv2[1] = FloatToHalf(in.uv2.y);
+
+    if (stride < STRIDE_SKINNED)
+    {
+        std::memcpy(out, &v, sizeof(v));
+        return;
+    }
+
+    PackedSkinnedVertex s{};
+    s.base = v;
+    s.boneIndices[0] = static_cast<uint8_t>((std::min)(in.boneIndices.x, 255u));
+    s.boneIndices[1] = static_cast<uint8_t>((std::min)(in.boneIndices.y, 255u));
+    s.boneIndices[2] = static_cast<uint8_t>((std::min)(in.boneIndices.z, 255u));
+    s.boneIndices[3] = static_cast<uint8_t>((std::min)(in.boneIndices.w, 255u));
+    PackWeights(in.boneWeights, s.boneWeights);
+    std::memcpy(out, &s, sizeof(s));
+}
+
+void VertexPacker::Unpack(const uint8_t* vertex, uint32_t stride, UnpackedVertex& out)
+{
+    out = UnpackedVertex{};
+    if (!vertex || stride < STRIDE) return;
+
+    PackedVertex v;
+    std::memcpy(&v, vertex, sizeof(v));
+
+    out.position = XMFLOAT3(v.position[0], v.position[1], v.position[2]);
+    out.normal   = XMFLOAT3(UnpackSnorm8(v.normal[0]), UnpackSnorm8(v.normal[1]), UnpackSnorm8(v.normal[2]));
+    out.tangent  = XMFLOAT4(UnpackSnorm8(v.tangent[0]), UnpackSnorm8(v.tangent[1]),
+                            UnpackSnorm8(v.tangent[2]), UnpackSnorm8(v.tangent[3]));
+    out.color    = XMFLOAT4(UnpackUnorm8(v.color[0]), UnpackUnorm8(v.color[1]),
+                            UnpackUnorm8(v.color[2]), UnpackUnorm8(v.color[3]));
+    out.uv1      = XMFLOAT2(HalfToFloat(v.uv1[0]), HalfToFloat(v.uv1[1]));
+    out.uv2      = XMFLOAT2(HalfToFloat(v.uv2[0]), HalfToFloat(v.uv2[1]));
+    out.boneWeights = XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f);
+
+    if (stride >= STRIDE_SKINNED)
+    {
+        PackedSkinnedVertex s;
+        std::memcpy(&s, vertex, sizeof(s));
+        out.boneIndices = XMUINT4{ s.boneIndices[0], s.boneIndices[1], s.boneIndices[2], s.boneIndices[3] };
+        out.boneWeights = XMFLOAT4(UnpackUnorm8(s.boneWeights[0]), UnpackUnorm8(s.boneWeights[1]),
+                                   UnpackUnorm8(s.boneWeights[2]), UnpackUnorm8(s.boneWeights[3]));
+    }
+}
@@ -1,6 +1,8 @@
 #include "gdxutil.h"
 #include "gdxdevice.h"
-#include "Dx11RenderBackend.h" 
+#ifdef _WIN32
+#include "Dx11RenderBackend.h"
+#endif
   
 
 GDXDevice::GDXDevice() : m_bInitialized(false),
@@ -25,6 +27,7 @@ GDXDevice::~GDXDevice()
 
 void GDXDevice::Release()
 {
+#ifdef _WIN32
     if (m_bInitialized)
     {
         if (m_pSwapChain != nullptr)
@@ -41,11 +44,16 @@ void GDXDevice::Release()
         Memory::SafeRelease(m_pRasterizerState);
 
         }
+#endif
 
     m_bInitialized = false;
     m_deviceReady = false;
 }
 
+// Off Windows a GDXDevice is never initialized: it only exists so that
+// RenderManager can run on RecordingRenderBackend (see gdxplatform.h).
+#ifdef _WIN32
+
 HRESULT GDXDevice::Init()
 {
     return EnumerateSystemDevices();
@@ -462,4 +470,5 @@ HRESULT GDXDevice::CreateDepthStencilState()
 }
 
 // Step 3:
-// Shadow resource creation moved to Dx11ShadowMap (owned by Dx11RenderBackend).
\ No newline at end of file
+// Shadow resource creation moved to Dx11ShadowMap (owned by Dx11RenderBackend).
+#endif
@@ -3,6 +3,7 @@
 #include "gdxwin.h"      
 #include "core.h"
 #include "Dx11MaterialGpuData.h"
+#include "Dx11RenderBackend.h"
 #include <fstream>
 
 namespace Engine
@@ -51,7 +52,7 @@ GDXEngine* GDXEngine::s_instance = nullptr;
 
 GDXEngine::GDXEngine(HWND hwnd, HINSTANCE hinst, unsigned int bpp, unsigned int screenX, unsigned int screenY, int* result) :
 	m_scene(),
-	m_assetManager(),
+	m_assetManager(m_scene.GetRenderRevision()),
 	m_objectManager(m_scene, m_assetManager),
 	m_renderManager(m_scene, m_assetManager, m_device)
 {
@@ -60,12 +61,26 @@ GDXEngine::GDXEngine(HWND hwnd, HINSTANCE hinst, unsigned int bpp, unsigned int
 	m_screenHeight = screenY;
 	m_hwnd = hwnd;
 
-	m_globalAmbient = DirectX::XMFLOAT4(0.2f, 0.2f, 0.2f, 1.0f);  // Standard Ambient
 	s_instance = this;  // Singleton setzen
 	m_device.Init();
 
 	m_interface.Init(bpp);
 
+	m_jobSystem.Start(Core::GetDesc().jobThreads);
+	m_renderManager.SetJobSystem(&m_jobSystem);
+
+	// RenderManager knows no graphics API; the D3D11 backend is created
+	// through this factory once the device exists (EnsureBackend).
+	m_renderManager.SetBackendFactory([](GDXDevice& device) -> std::unique_ptr<IRenderBackend>
+	{
+		if (!device.IsInitialized())
+		{
+			DBERROR("gdxengine.cpp: Dx11RenderBackend - device not ready");
+			return nullptr;
+		}
+		return std::make_unique<Dx11RenderBackend>(device);
+	});
+
 	int bestAdapter = FindBestAdapter();
 	this->SetAdapter(bestAdapter);
 
@@ -130,6 +145,8 @@ void GDXEngine::Cleanup()
 	if (m_bInitialized)
 	{
 		// Clean-up operations
+		m_renderManager.SetJobSystem(nullptr);
+		m_jobSystem.Stop();
 	}
 
 	m_bInitialized = false;
@@ -342,6 +359,49 @@ HRESULT GDXEngine::Graphic(unsigned int width, unsigned int height, bool windowe
 		}
 	}
 
+	// Instanced standard shader: same PS, world matrix from the instance stream.
+	// Linked as instancedVariant so RenderManager can batch identical draws.
+	{
+		std::wstring vsInst = Core::ResolvePath(VERTEX_INSTANCED_SHADER_FILE);
+		Shader* instShader = GetAM().CreateShader();
+
+		if (instShader == nullptr)
+		{
+			DBLOG("gdxengine.cpp: failed to allocate instanced standard shader");
+		}
+		else
+		{
+			const DWORD instFlags =
+				D3DVERTEX_POSITION | D3DVERTEX_COLOR | D3DVERTEX_NORMAL | D3DVERTEX_TEX1 |
+				D3DVERTEX_INSTANCE_WORLD;
+
+			HRESULT hrInst = GetSM().CreateShader(instShader, vsInst.c_str(), "main", ps.c_str(), "main");
+			if (FAILED(hrInst))
+			{
+				DBLOG_HR(hrInst);
+			}
+			else
+			{
+				hrInst = GetILM().CreateInputLayoutVertex(
+					&instShader->inputlayoutVertex,
+					instShader,
+					instShader->flagsVertex,
+					instFlags);
+
+				if (FAILED(hrInst))
+				{
+					DBLOG_HR(hrInst);
+				}
+				else
+				{
+					GetSM().SetShader(ShaderKey::StandardInstanced, instShader);
+					GetSM().GetShader()->instancedVariant = instShader;
+					DBLOG("gdxengine.cpp: internal instanced standard shader registered");
+				}
+			}
+		}
+	}
+
 	// Shadow-Pass VS: liest World aus b0, Light-View/Proj aus b3.
 	// Gleiche Vertex-Signatur wie Standard-VS (kein Skinning).
 	// PS wird nicht benoetigt (depth-only).
@@ -435,6 +495,11 @@ HRESULT GDXEngine::RenderWorld()
 
 	pContext->ClearDepthStencilView(dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
+	// Finished async texture loads replace their fallbacks before drawing.
+	// Streamed textures get the levels the last frame asked for.
+	m_texturePool.ProcessAsyncLoads(m_device.GetDevice());
+	m_texturePool.UpdateStreaming(m_device.GetDevice());
+
 	// Wichtig: RenderManager bekommt deterministisch die Camera
 	m_renderManager.SetCamera(pCamera);
 
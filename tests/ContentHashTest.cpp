@@ -0,0 +1,102 @@
+// ContentHashTest.cpp: XXH64 and texture cache keys (ctest).
+//
+// Xxh64 must reproduce the published xxHash test vectors, including inputs
+// that cross the 32-byte stripe, 8-byte and 4-byte tail boundaries, so the
+// hashes match the ones of external tools. CanonicalPath must give every
+// spelling of one file (case, '/' or '\', "." and ".." segments) the same
+// key and therefore the same hash.
+
+#include "TestCheck.h"
+#include "ContentHash.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    uint64_t Hash(const char* text, uint64_t seed = 0)
+    {
+        return ContentHash::Xxh64(text, std::strlen(text), seed);
+    }
+
+    uint64_t PathHash(const wchar_t* filename)
+    {
+        const std::wstring key = ContentHash::CanonicalPath(filename);
+        return ContentHash::Xxh64(key.data(), key.size() * sizeof(wchar_t));
+    }
+
+    void TestVectors()
+    {
+        EXPECT(Hash("")    == 0xEF46DB3751D8E999ull);
+        EXPECT(Hash("a")   == 0xD24EC4F1A98C6E5Bull);
+        EXPECT(Hash("abc") == 0x44BC2CF5AD770999ull);
+
+        // An empty range may come with a null pointer.
+        EXPECT(ContentHash::Xxh64(nullptr, 0) == 0xEF46DB3751D8E999ull);
+
+        // Split input: the result depends on the bytes only, not on where
+        // they sit in memory.
+        std::vector<uint8_t> bytes(200);
+        for (size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<uint8_t>(i * 31u + 7u);
+
+        std::vector<uint8_t> shifted(bytes.size() + 1);
+        std::memcpy(shifted.data() + 1, bytes.data(), bytes.size());
+
+        bool aligned = true, distinct = true;
+        uint64_t previous = 0;
+        for (size_t size = 0; size <= bytes.size(); ++size)
+        {
+            const uint64_t h = ContentHash::Xxh64(bytes.data(), size);
+            aligned  &= h == ContentHash::Xxh64(shifted.data() + 1, size);
+            distinct &= size == 0 || h != previous;
+            previous  = h;
+        }
+        EXPECT(aligned);
+        EXPECT(distinct);
+
+        // The seed changes the result.
+        EXPECT(Hash("abc", 1) != Hash("abc"));
+    }
+
+    void TestCanonicalPath()
+    {
+        EXPECT(ContentHash::CanonicalPath(nullptr).empty());
+        EXPECT(ContentHash::CanonicalPath(L"").empty());
+
+        const std::wstring key = ContentHash::CanonicalPath(L"assets/textures/Stone.PNG");
+        EXPECT(!key.empty());
+
+        // Lowercase throughout.
+        bool lower = true;
+        for (wchar_t c : key)
+            lower &= !(c >= L'A' && c <= L'Z');
+        EXPECT(lower);
+
+        const wchar_t* spellings[] = {
+            L"ASSETS/Textures/stone.png",
+            L"assets\\textures\\stone.png",
+            L"assets\\Textures/STONE.png",
+            L"./assets/textures/stone.png",
+            L"assets/models/../textures/./stone.png",
+        };
+        for (const wchar_t* spelling : spellings)
+        {
+            EXPECT(ContentHash::CanonicalPath(spelling) == key);
+            EXPECT(PathHash(spelling) == PathHash(L"assets/textures/Stone.PNG"));
+        }
+
+        EXPECT(ContentHash::CanonicalPath(L"assets/textures/stone2.png") != key);
+    }
+}
+
+int main()
+{
+    TestVectors();
+    TestCanonicalPath();
+
+    return TestCheck::Finish("ContentHash");
+}
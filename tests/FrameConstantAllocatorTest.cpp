@@ -0,0 +1,129 @@
+// FrameConstantAllocatorTest.cpp: per-frame constant block packing (ctest).
+//
+// FrameConstantAllocator is CPU only, so the packed bytes can be read back
+// directly: offsets must land on 256-byte boundaries with zero padding, a
+// frame that outgrows the first 64 KiB chunk must keep every earlier block
+// at its offset, the pending range must follow MarkCommitted, and Reset
+// must start the next frame at offset 0 with the capacity kept.
+
+#include "TestCheck.h"
+#include "FrameConstantAllocator.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    // A block filled with one byte value, as the entity constants would be.
+    std::vector<uint8_t> Block(uint32_t size, uint8_t value)
+    {
+        return std::vector<uint8_t>(size, value);
+    }
+
+    bool Holds(const FrameConstantAllocator& alloc, uint32_t offset, uint32_t size, uint8_t value)
+    {
+        const uint8_t* data = alloc.GetData() + offset;
+        for (uint32_t i = 0; i < size; ++i)
+            if (data[i] != value) return false;
+        return true;
+    }
+
+    void TestAlignment()
+    {
+        FrameConstantAllocator alloc;
+        const uint32_t sizes[] = { 1, 64, 255, 256, 257, 512 };
+
+        uint32_t expected = 0;
+        for (uint32_t size : sizes)
+        {
+            const std::vector<uint8_t> data = Block(size, 0xAB);
+            const uint32_t offset = alloc.Allocate(data.data(), size);
+
+            EXPECT(offset == expected);
+            EXPECT(offset % FrameConstantAllocator::ALIGNMENT == 0);
+            EXPECT(Holds(alloc, offset, size, 0xAB));
+
+            // The rest of the block is zero-filled.
+            const uint32_t block = FrameConstantAllocator::AlignedSize(size);
+            EXPECT(Holds(alloc, offset + size, block - size, 0x00));
+            expected += block;
+        }
+
+        EXPECT(alloc.GetUsedBytes() == expected);
+        EXPECT(alloc.GetAllocationCount() == 6);
+
+        // Nothing to copy: no block, no offset.
+        EXPECT(alloc.Allocate(nullptr, 64) == FrameConstantAllocator::INVALID_OFFSET);
+        EXPECT(alloc.Allocate(sizes, 0) == FrameConstantAllocator::INVALID_OFFSET);
+        EXPECT(alloc.GetAllocationCount() == 6);
+    }
+
+    void TestRollover()
+    {
+        FrameConstantAllocator alloc;
+
+        // 64 KiB hold 256 blocks; 600 force two growth steps.
+        constexpr uint32_t COUNT = 600;
+        std::vector<uint32_t> offsets;
+        for (uint32_t i = 0; i < COUNT; ++i)
+        {
+            const std::vector<uint8_t> data = Block(64, static_cast<uint8_t>(i));
+            offsets.push_back(alloc.Allocate(data.data(), 64));
+        }
+
+        bool contiguous = true, intact = true;
+        for (uint32_t i = 0; i < COUNT; ++i)
+        {
+            contiguous &= offsets[i] == i * FrameConstantAllocator::ALIGNMENT;
+            intact     &= Holds(alloc, offsets[i], 64, static_cast<uint8_t>(i));
+        }
+        EXPECT(contiguous);
+        EXPECT(intact);
+        EXPECT(alloc.GetUsedBytes() == COUNT * FrameConstantAllocator::ALIGNMENT);
+
+        // Pending range: everything after the last commit.
+        EXPECT(alloc.HasPending());
+        EXPECT(alloc.GetPendingBegin() == 0);
+        alloc.MarkCommitted();
+        EXPECT(!alloc.HasPending());
+
+        const std::vector<uint8_t> data = Block(64, 0xCD);
+        const uint32_t offset = alloc.Allocate(data.data(), 64);
+        EXPECT(alloc.HasPending());
+        EXPECT(alloc.GetPendingBegin() == offset);
+        EXPECT(alloc.GetUsedBytes() == offset + FrameConstantAllocator::ALIGNMENT);
+    }
+
+    void TestReset()
+    {
+        FrameConstantAllocator alloc;
+        const std::vector<uint8_t> first = Block(64, 0x11);
+        for (int i = 0; i < 300; ++i)
+            alloc.Allocate(first.data(), 64);
+        alloc.MarkCommitted();
+        const uint8_t* storage = alloc.GetData();
+
+        alloc.Reset();
+        EXPECT(alloc.GetUsedBytes() == 0);
+        EXPECT(alloc.GetPendingBegin() == 0);
+        EXPECT(alloc.GetAllocationCount() == 0);
+        EXPECT(!alloc.HasPending());
+
+        // Next frame starts at 0 again in the same storage.
+        const std::vector<uint8_t> second = Block(64, 0x22);
+        EXPECT(alloc.Allocate(second.data(), 64) == 0);
+        EXPECT(alloc.GetData() == storage);
+        EXPECT(Holds(alloc, 0, 64, 0x22));
+        EXPECT(alloc.HasPending());
+    }
+}
+
+int main()
+{
+    TestAlignment();
+    TestRollover();
+    TestReset();
+
+    return TestCheck::Finish("FrameConstantAllocator");
+}
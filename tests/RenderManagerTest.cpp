@@ -0,0 +1,248 @@
+// RenderManagerTest.cpp: command stream of RenderManager (ctest).
+//
+// A small scene is rendered through RenderManager with the headless
+// RecordingRenderBackend; the recorded stream is checked call by call:
+// every draw runs with the shader and material of its surface, three
+// meshes sharing a surface collapse into one instanced draw through the
+// shader's instancedVariant, the transparent draw comes last with blending
+// on, and a culled mesh issues nothing. Further frames check the retained
+// queues: an unchanged frame replays the same stream without a rebuild,
+// an uploaded vertex edit re-culls only the edited mesh, a moved mesh is
+// patched and keeps its collision box current while culled.
+
+#include "TestCheck.h"
+#include "RenderManager.h"
+#include "RecordingRenderBackend.h"
+#include "gdxdevice.h"
+#include "Scene.h"
+#include "AssetManager.h"
+#include "Camera.h"
+#include "Mesh.h"
+#include "Surface.h"
+#include "Material.h"
+#include "Shader.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace DirectX;
+using RecordType = RecordingRenderBackend::RecordType;
+
+namespace
+{
+    Surface* MakeTriangle(AssetManager& assets)
+    {
+        Surface* surface = assets.CreateSurface();
+        surface->AddVertex(-1, -0.5f, -0.5f, 0.0f);
+        surface->AddVertex(-1,  0.5f, -0.5f, 0.0f);
+        surface->AddVertex(-1,  0.0f,  0.5f, 0.0f);
+        return surface;
+    }
+
+    Mesh* MakeMesh(Scene& scene, AssetManager& assets, Surface* surface, Material* material,
+                   float x, float y, float z)
+    {
+        Mesh* mesh = assets.CreateManagedMesh(scene);
+        assets.AddSurfaceToMesh(mesh, surface);
+        assets.SetSlotMaterial(mesh, 0, material);
+        mesh->transform.Position(x, y, z);
+        return mesh;
+    }
+
+    // Draws in stream order with the shader/material bound at that point.
+    struct Draw
+    {
+        const void* surface;
+        uint32_t    shader;
+        uint32_t    material;
+        uint32_t    instances; // 0 = DrawSurface
+        bool        blend;
+    };
+
+    std::vector<Draw> CollectDraws(const RecordingRenderBackend& backend)
+    {
+        std::vector<Draw> draws;
+        uint32_t shader = 0, material = 0;
+        bool blend = false;
+        for (const RecordingRenderBackend::Record& r : backend.GetRecords())
+        {
+            switch (r.type)
+            {
+            case RecordType::BindShader:           shader   = r.id; break;
+            case RecordType::BindMaterial:         material = r.id; break;
+            case RecordType::SetAlphaBlend:        blend    = r.arg != 0; break;
+            case RecordType::DrawSurface:          draws.push_back({ r.object, shader, material, 0, blend }); break;
+            case RecordType::DrawSurfaceInstanced: draws.push_back({ r.object, shader, material, r.arg, blend }); break;
+            default: break;
+            }
+        }
+        return draws;
+    }
+
+    bool SameStream(const std::vector<RecordingRenderBackend::Record>& a,
+                    const std::vector<RecordingRenderBackend::Record>& b)
+    {
+        if (a.size() != b.size()) return false;
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (a[i].type != b[i].type || a[i].object != b[i].object ||
+                a[i].id != b[i].id || a[i].arg != b[i].arg)
+                return false;
+        }
+        return true;
+    }
+}
+
+int main()
+{
+    Scene        scene;
+    AssetManager assets(scene.GetRenderRevision());
+    GDXDevice    device;
+    RenderManager renderer(scene, assets, device);
+    renderer.SetBackendFactory([](GDXDevice&) { return std::make_unique<RecordingRenderBackend>(); });
+
+    Shader* instancedShader  = assets.CreateShader();
+    Shader* shader           = assets.CreateShader();
+    Shader* plainShader      = assets.CreateShader();
+    shader->instancedVariant = instancedShader;
+
+    Material* shared      = assets.CreateMaterial();
+    Material* plain       = assets.CreateMaterial();
+    Material* transparent = assets.CreateMaterial();
+    assets.AssignShaderToMaterial(shader, shared);
+    assets.AssignShaderToMaterial(plainShader, plain);
+    assets.AssignShaderToMaterial(plainShader, transparent);
+    transparent->SetTransparent(true);
+
+    Surface* sharedSurface      = MakeTriangle(assets);
+    Surface* plainSurfaceA      = MakeTriangle(assets);
+    Surface* plainSurfaceB      = MakeTriangle(assets);
+    Surface* transparentSurface = MakeTriangle(assets);
+
+    Mesh* instancedMesh = MakeMesh(scene, assets, sharedSurface, shared, -2.0f, 0.0f, 10.0f);
+    MakeMesh(scene, assets, sharedSurface, shared,  0.0f, 0.0f, 10.0f);
+    MakeMesh(scene, assets, sharedSurface, shared,  2.0f, 0.0f, 10.0f);
+    Mesh* editedMesh = MakeMesh(scene, assets, plainSurfaceA, plain, 0.0f, 2.0f, 10.0f);
+    MakeMesh(scene, assets, plainSurfaceB, plain, 0.0f, -2.0f, 10.0f);
+    MakeMesh(scene, assets, transparentSurface, transparent, 0.0f, 0.0f, 5.0f);
+    MakeMesh(scene, assets, plainSurfaceB, plain, 0.0f, 0.0f, -10.0f); // behind the camera
+
+    Camera* camera = scene.CreateCamera();
+    camera->GenerateViewMatrix(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f),
+                               XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f),
+                               XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    camera->GenerateProjectionMatrix(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    renderer.SetCamera(camera);
+
+    // Frame 1: full build.
+    renderer.RenderScene();
+
+    const RecordingRenderBackend* backend = static_cast<const RecordingRenderBackend*>(renderer.GetBackend());
+    EXPECT(backend != nullptr);
+    if (!backend) return TestCheck::Finish("RenderManager");
+
+    const std::vector<Draw> draws = CollectDraws(*backend);
+    EXPECT(draws.size() == 4);
+
+    unsigned int instancedDraws = 0, plainDraws = 0, transparentDraws = 0;
+    for (size_t i = 0; i < draws.size(); ++i)
+    {
+        const Draw& d = draws[i];
+        if (d.surface == sharedSurface)
+        {
+            ++instancedDraws;
+            EXPECT(d.instances == 3);
+            EXPECT(d.shader == instancedShader->id);
+            EXPECT(d.material == shared->id);
+            EXPECT(!d.blend);
+        }
+        else if (d.surface == plainSurfaceA || d.surface == plainSurfaceB)
+        {
+            ++plainDraws;
+            EXPECT(d.instances == 0);
+            EXPECT(d.shader == plainShader->id);
+            EXPECT(d.material == plain->id);
+            EXPECT(!d.blend);
+        }
+        else if (d.surface == transparentSurface)
+        {
+            ++transparentDraws;
+            EXPECT(i + 1 == draws.size());
+            EXPECT(d.shader == plainShader->id);
+            EXPECT(d.material == transparent->id);
+            EXPECT(d.blend);
+        }
+        else
+        {
+            EXPECT(!"draw of an unknown surface");
+        }
+    }
+    EXPECT(instancedDraws == 1);
+    EXPECT(plainDraws == 2);
+    EXPECT(transparentDraws == 1);
+
+    // DrawSurface records carry Surface::id.
+    for (const RecordingRenderBackend::Record& r : backend->GetRecords())
+        if (r.type == RecordType::DrawSurface)
+            EXPECT(r.id == static_cast<const Surface*>(r.object)->id);
+
+    // One instance upload with the three shared-surface worlds; the base
+    // shader is never bound for them.
+    EXPECT(backend->GetCount(RecordType::UploadInstances) == 1);
+    EXPECT(backend->GetInstanceData().size() == 3);
+    for (const RecordingRenderBackend::Record& r : backend->GetRecords())
+    {
+        if (r.type == RecordType::UploadInstances)      EXPECT(r.arg == 3);
+        if (r.type == RecordType::DrawSurfaceInstanced) EXPECT(r.id == 0); // firstInstance
+        if (r.type == RecordType::BindShader)           EXPECT(r.id != shader->id);
+    }
+
+    const RenderManager::FrameStats& stats = renderer.GetFrameStats();
+    EXPECT(stats.opaqueDrawCalls == 3);
+    EXPECT(stats.instancedDrawCalls == 1);
+    EXPECT(stats.instancedMeshes == 3);
+    EXPECT(stats.transparentDrawCalls == 1);
+    EXPECT(stats.visibleMeshes == 6);
+    EXPECT(stats.culledMeshes == 1);
+    EXPECT(stats.queueRebuilds == 1);
+
+    const std::vector<RecordingRenderBackend::Record> first = backend->GetRecords();
+
+    // Frame 2: nothing changed, the retained queue replays the same stream.
+    renderer.RenderScene();
+    EXPECT(renderer.GetFrameStats().queueRebuilds == 0);
+    EXPECT(renderer.GetFrameStats().queuePatchedMeshes == 0);
+    EXPECT(SameStream(first, backend->GetRecords()));
+
+    // Frame 3: a vertex edit is picked up on upload (FillBuffer touches the
+    // geometry counter); only the edited mesh is re-culled.
+    plainSurfaceA->AddVertex(-1, 0.0f, 1.0f, 0.0f);
+    scene.GetRenderRevision().TouchGeometry();
+    renderer.RenderScene();
+    EXPECT(renderer.GetFrameStats().queueRebuilds == 0);
+    EXPECT(renderer.GetFrameStats().queuePatchedMeshes == 1);
+    EXPECT(renderer.GetFrameStats().opaqueDrawCalls == 3);
+
+    // Frame 4: a moved mesh is patched, not rebuilt, and leaves the view.
+    // Its collision box follows the move although it is no longer drawn.
+    editedMesh->SetCollisionMode(COLLISION::BOX);
+    editedMesh->transform.Position(0.0f, 0.0f, -20.0f);
+    renderer.RenderScene();
+    EXPECT(renderer.GetFrameStats().queueRebuilds == 0);
+    EXPECT(renderer.GetFrameStats().queuePatchedMeshes == 1);
+    EXPECT(renderer.GetFrameStats().culledMeshes == 2);
+    EXPECT(CollectDraws(*backend).size() == 3);
+    EXPECT(editedMesh->obb.Center.z == -20.0f);
+
+    // Frame 5: instance run members get no entity upload; a collision box
+    // still follows the move.
+    instancedMesh->SetCollisionMode(COLLISION::BOX);
+    instancedMesh->transform.Position(-2.0f, 1.0f, 10.0f);
+    renderer.RenderScene();
+    EXPECT(renderer.GetFrameStats().instancedMeshes == 3);
+    EXPECT(instancedMesh->obb.Center.y == 1.0f);
+
+    return TestCheck::Finish("RenderManager");
+}
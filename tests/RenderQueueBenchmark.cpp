@@ -0,0 +1,207 @@
+// RenderQueueBenchmark.cpp: CPU cost of RenderManager queue build/sort/flush (ctest).
+//
+// 10k, 50k and 100k meshes rendered through RecordingRenderBackend with
+// command recording off, so only the engine's side of a frame is timed:
+//
+//   Full      retained queues off: cull, build, sort and flush every frame,
+//             serial and on the job system
+//   Replay    retained queues on, nothing changed: flush of the kept queues
+//   Moved     retained queues on, 10% of the meshes moved: incremental patch
+//             of the sorted queues plus flush
+//
+// Build + sort is about Full minus Replay. The meshes share 16 surfaces,
+// 8 materials and 4 shaders (two with an instanced variant) and fill a grid
+// in front of the camera; every fourth one sits behind it and is culled.
+// Best of REPEATS frames. Every visible mesh must be drawn in every mode, so
+// a change that drops draws cannot pass as a speedup. ctest runs it with
+// --quick (10k meshes, two frames per mode) as a check; for timings run an
+// optimized build without arguments.
+
+#include "TestCheck.h"
+#include "RenderManager.h"
+#include "RecordingRenderBackend.h"
+#include "gdxdevice.h"
+#include "JobSystem.h"
+#include "Scene.h"
+#include "AssetManager.h"
+#include "Camera.h"
+#include "Mesh.h"
+#include "Surface.h"
+#include "Material.h"
+#include "Shader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+    constexpr uint32_t MESH_COUNTS[] = { 10000, 50000, 100000 };
+    constexpr uint32_t QUICK_COUNT   = 10000;
+    constexpr uint32_t SURFACES      = 16;
+    constexpr uint32_t MATERIALS     = 8;
+    constexpr uint32_t SHADERS       = 4;
+    constexpr int      REPEATS       = 10;
+    constexpr int      QUICK_REPEATS = 2;
+
+    struct Fixture
+    {
+        Scene         scene;
+        AssetManager  assets{ scene.GetRenderRevision() };
+        GDXDevice     device;
+        RenderManager renderer{ scene, assets, device };
+        std::vector<Mesh*> meshes;
+        uint32_t      visible = 0;
+
+        explicit Fixture(uint32_t count)
+        {
+            renderer.SetBackendFactory([](GDXDevice&)
+            {
+                auto backend = std::make_unique<RecordingRenderBackend>();
+                backend->SetRecordCommands(false);
+                return backend;
+            });
+
+            std::vector<Shader*> shaders;
+            for (uint32_t i = 0; i < SHADERS; ++i)
+            {
+                Shader* shader = assets.CreateShader();
+                if (i % 2 == 0) shader->instancedVariant = assets.CreateShader();
+                shaders.push_back(shader);
+            }
+
+            std::vector<Material*> materials;
+            for (uint32_t i = 0; i < MATERIALS; ++i)
+            {
+                Material* material = assets.CreateMaterial();
+                assets.AssignShaderToMaterial(shaders[i % SHADERS], material);
+                materials.push_back(material);
+            }
+
+            std::vector<Surface*> surfaces;
+            for (uint32_t i = 0; i < SURFACES; ++i)
+            {
+                Surface* surface = assets.CreateSurface();
+                surface->AddVertex(-1, -0.5f, -0.5f, 0.0f);
+                surface->AddVertex(-1,  0.5f, -0.5f, 0.0f);
+                surface->AddVertex(-1,  0.0f,  0.5f, 0.0f);
+                surfaces.push_back(surface);
+            }
+
+            // 100 x 100 grid per layer, layers 2 units apart in depth.
+            meshes.reserve(count);
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                Mesh* mesh = assets.CreateManagedMesh(scene);
+                assets.AddSurfaceToMesh(mesh, surfaces[i % SURFACES]);
+                assets.SetSlotMaterial(mesh, 0, materials[(i / SURFACES) % MATERIALS]);
+
+                const float x = static_cast<float>(i % 100) - 49.5f;
+                const float y = static_cast<float>((i / 100) % 100) - 49.5f;
+                const float z = 60.0f + 2.0f * static_cast<float>(i / 10000);
+                const bool  behind = (i % 4 == 3);
+                mesh->transform.Position(x * 0.5f, y * 0.5f, behind ? -z : z);
+
+                meshes.push_back(mesh);
+                if (!behind) ++visible;
+            }
+
+            Camera* camera = scene.CreateCamera();
+            camera->GenerateViewMatrix(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f),
+                                       XMVectorSet(0.0f, 0.0f, 1.0f, 1.0f),
+                                       XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+            camera->GenerateProjectionMatrix(XMConvertToRadians(60.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+            renderer.SetCamera(camera);
+        }
+
+        // Every visible mesh drawn once, alone or as part of an instanced draw.
+        bool AllDrawn() const
+        {
+            const RenderManager::FrameStats& s = renderer.GetFrameStats();
+            return s.visibleMeshes == visible &&
+                   s.culledMeshes  == meshes.size() - visible &&
+                   s.opaqueDrawCalls - s.instancedDrawCalls + s.instancedMeshes == visible;
+        }
+    };
+
+    // prepare() runs untimed before every frame.
+    template<typename Prepare>
+    double BestOfMs(Fixture& f, int repeats, Prepare&& prepare, bool& drawn)
+    {
+        double best = 1e30;
+        for (int r = 0; r < repeats; ++r)
+        {
+            prepare(r);
+            const auto t0 = std::chrono::steady_clock::now();
+            f.renderer.RenderScene();
+            const auto t1 = std::chrono::steady_clock::now();
+            best  = (std::min)(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+            drawn = drawn && f.AllDrawn();
+        }
+        return best;
+    }
+
+    void Run(uint32_t count, int repeats, JobSystem& jobs)
+    {
+        Fixture f(count);
+        bool drawn = true;
+        const auto none = [](int) {};
+
+        f.renderer.SetRetainedQueues(false);
+        const double fullMs = BestOfMs(f, repeats, none, drawn);
+
+        f.renderer.SetJobSystem(&jobs);
+        const double parallelMs = BestOfMs(f, repeats, none, drawn);
+
+        f.renderer.SetRetainedQueues(true);
+        f.renderer.RenderScene();
+        const double replayMs = BestOfMs(f, repeats, none, drawn);
+        EXPECT(f.renderer.GetFrameStats().queueRebuilds == 0);
+
+        // Every tenth mesh steps up and down by a small amount.
+        const double movedMs = BestOfMs(f, repeats, [&](int r)
+        {
+            const float dy = (r % 2 == 0) ? 0.01f : -0.01f;
+            for (size_t i = 0; i < f.meshes.size(); i += 10)
+            {
+                XMFLOAT3 p;
+                XMStoreFloat3(&p, f.meshes[i]->transform.GetPosition());
+                f.meshes[i]->transform.Position(p.x, p.y + dy, p.z);
+            }
+        }, drawn);
+        EXPECT(f.renderer.GetFrameStats().queueRebuilds == 0);
+        EXPECT(f.renderer.GetFrameStats().queuePatchedMeshes > 0);
+        EXPECT(drawn);
+
+        const RenderManager::FrameStats& s = f.renderer.GetFrameStats();
+        std::printf("%6u meshes (%u visible, %u draws, %u instanced):\n",
+                    count, f.visible, s.opaqueDrawCalls, s.instancedDrawCalls);
+        std::printf("  Full     %8.2f ms  (%.0f ns/mesh)\n", fullMs, fullMs * 1.0e6 / count);
+        std::printf("  Full x%-2u %8.2f ms\n", jobs.GetThreadCount(), parallelMs);
+        std::printf("  Replay   %8.2f ms\n", replayMs);
+        std::printf("  Moved    %8.2f ms  (%zu moved)\n", movedMs, (f.meshes.size() + 9) / 10);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+
+    JobSystem jobs;
+    jobs.Start(0);
+
+    if (quick)
+        Run(QUICK_COUNT, QUICK_REPEATS, jobs);
+    else
+        for (uint32_t count : MESH_COUNTS)
+            Run(count, REPEATS, jobs);
+
+    jobs.Stop();
+    return TestCheck::Finish("RenderQueueBenchmark");
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+// TestCheck.h: check scaffold shared by the headless ctests (tests/ and
+// tools/texcook). No framework: a failed check prints its line and is
+// counted, Finish turns the count into the exit code.
+
+#include <cstdio>
+
+namespace TestCheck
+{
+    inline int g_failures = 0;
+
+    inline void Expect(bool condition, const char* what, int line)
+    {
+        if (condition) return;
+        std::printf("FAIL line %d: %s\n", line, what);
+        ++g_failures;
+    }
+
+    // For checks that print their own report.
+    inline void Fail() { ++g_failures; }
+
+    inline int Finish(const char* name)
+    {
+        if (g_failures)
+            std::printf("%d check(s) failed\n", g_failures);
+        else
+            std::printf("%s: all checks passed\n", name);
+        return g_failures ? 1 : 0;
+    }
+}
+
+#define EXPECT(condition) TestCheck::Expect((condition), #condition, __LINE__)
@@ -0,0 +1,211 @@
+// TextureResidencyTest.cpp: residency decisions of texture streaming (ctest).
+//
+// TextureResidency makes no D3D calls and reads no clock, so every rule of
+// Update can be driven frame by frame with made-up textures and checked
+// against byte counts from TextureImage.
+
+#include "TestCheck.h"
+#include "TextureResidency.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+    TextureImage MakeImage(uint32_t size, TextureFormat format = TextureFormat::RGBA8)
+    {
+        TextureImage image;
+        image.width     = size;
+        image.height    = size;
+        image.format    = format;
+        image.mipLevels = 1;
+        while ((size >> image.mipLevels) > 0)
+            ++image.mipLevels;
+        return image;
+    }
+
+    // Bytes of levels first..end, as the residency counts them.
+    uint64_t ChainBytes(uint32_t size, uint32_t first)
+    {
+        const TextureImage image = MakeImage(size);
+        uint64_t bytes = 0;
+        for (uint32_t l = first; l < image.mipLevels; ++l)
+            bytes += image.LevelSize(l);
+        return bytes;
+    }
+
+    TextureStreamingDesc Desc(uint64_t budget, uint32_t minResidentSize = 64, uint64_t uploadLimit = 0)
+    {
+        TextureStreamingDesc desc;
+        desc.budgetBytes          = budget;
+        desc.minResidentSize      = minResidentSize;
+        desc.uploadBytesPerUpdate = uploadLimit;
+        return desc;
+    }
+
+    // Everything requested fits: full detail, nothing evicted.
+    void BudgetFits()
+    {
+        TextureResidency r;
+        r.SetDesc(Desc(3 * ChainBytes(256, 0)));
+        for (int i = 0; i < 3; ++i) r.Add(MakeImage(256));
+
+        EXPECT(r.GetFirstLevel(0) == 2);              // starts at 64x64
+        EXPECT(r.GetStats().residentBytes == 3 * ChainBytes(256, 2));
+
+        for (uint32_t id = 0; id < 3; ++id) r.Request(id, 256.0f);
+        const auto& changes = r.Update();
+
+        EXPECT(changes.size() == 3);
+        for (uint32_t id = 0; id < 3; ++id) EXPECT(r.GetFirstLevel(id) == 0);
+        EXPECT(r.GetStats().residentBytes == 3 * ChainBytes(256, 0));
+        EXPECT(r.GetStats().promoted == 3);
+        EXPECT(r.GetStats().evicted == 0);
+        EXPECT(r.GetStats().bytesUploaded == 3 * ChainBytes(256, 0));
+
+        // Not drawn, but within the budget: the detail stays.
+        EXPECT(r.Update().empty());
+        EXPECT(r.GetFirstLevel(0) == 0);
+    }
+
+    // Over budget, textures not drawn in the last frame drop to their
+    // lowest levels, least recently used first.
+    std::vector<uint32_t> LruEviction()
+    {
+        const uint64_t full = ChainBytes(256, 0), low = ChainBytes(256, 2);
+        TextureResidency r;
+        r.SetDesc(Desc(2 * full + 2 * low));
+        for (int i = 0; i < 4; ++i) r.Add(MakeImage(256));
+
+        std::vector<uint32_t> trace;
+        auto frame = [&](uint32_t drawn)
+        {
+            r.Request(drawn, 256.0f);
+            r.Update();
+            for (uint32_t id = 0; id < 4; ++id) trace.push_back(r.GetFirstLevel(id));
+            trace.push_back(r.GetStats().evicted);
+        };
+
+        frame(0);
+        frame(1);
+        EXPECT(r.GetFirstLevel(0) == 0 && r.GetFirstLevel(1) == 0);   // exactly fits
+
+        frame(2);                                                     // 0 is the oldest
+        EXPECT(r.GetFirstLevel(0) == 2);
+        EXPECT(r.GetFirstLevel(1) == 0);
+        EXPECT(r.GetFirstLevel(2) == 0);
+        EXPECT(r.GetStats().evicted == 1);
+
+        frame(3);                                                     // now 1 is
+        EXPECT(r.GetFirstLevel(1) == 2);
+        EXPECT(r.GetFirstLevel(2) == 0);
+        EXPECT(r.GetFirstLevel(3) == 0);
+        EXPECT(r.GetStats().evicted == 1);
+        EXPECT(r.GetStats().residentBytes <= r.GetDesc().budgetBytes);
+        return trace;
+    }
+
+    // A drawn texture keeps detail beyond its request only while it fits.
+    void TrimBeyondRequest()
+    {
+        const uint64_t full = ChainBytes(256, 0);
+        TextureResidency r;
+        r.SetDesc(Desc(full + ChainBytes(256, 2), 16));               // lowest: 16x16, level 4
+        r.Add(MakeImage(256));
+        r.Add(MakeImage(256));
+
+        r.Request(0, 256.0f);
+        r.Update();
+        EXPECT(r.GetFirstLevel(0) == 0);
+
+        r.Request(0, 64.0f);                                          // wants level 2
+        r.Request(1, 256.0f);
+        r.Update();
+        EXPECT(r.GetFirstLevel(0) == 2);
+        EXPECT(r.GetFirstLevel(1) == 0);
+        EXPECT(r.GetStats().demoted == 1);
+        EXPECT(r.GetStats().evicted == 0);
+        EXPECT(r.GetStats().requestedBytes == full + ChainBytes(256, 2));
+    }
+
+    // Requests alone do not fit: the largest top level goes first.
+    void LargestTopLevelDemotion()
+    {
+        TextureResidency r;
+        r.SetDesc(Desc(ChainBytes(256, 1) + ChainBytes(128, 0), 16));
+        r.Add(MakeImage(256));
+        r.Add(MakeImage(128));
+
+        r.Request(0, 256.0f);
+        r.Request(1, 128.0f);
+        r.Update();
+        EXPECT(r.GetFirstLevel(0) == 1);
+        EXPECT(r.GetFirstLevel(1) == 0);
+        EXPECT(r.GetStats().residentBytes == ChainBytes(256, 1) + ChainBytes(128, 0));
+        EXPECT(r.GetStats().requestedBytes == ChainBytes(256, 0) + ChainBytes(128, 0));
+
+        // Budget below even the lowest levels: they stay anyway.
+        r.SetDesc(Desc(1, 16));
+        r.Request(0, 256.0f);
+        r.Request(1, 128.0f);
+        r.Update();
+        EXPECT(r.GetFirstLevel(0) == r.GetLowestFirstLevel(0));
+        EXPECT(r.GetFirstLevel(1) == r.GetLowestFirstLevel(1));
+    }
+
+    // Added detail per Update is capped; the first promotion always passes.
+    void UploadLimit()
+    {
+        const uint64_t full = ChainBytes(256, 0);
+        TextureResidency r;
+        r.SetDesc(Desc(0, 64, full));                                 // no budget, one full chain per Update
+        r.Add(MakeImage(256));
+        r.Add(MakeImage(256));
+
+        r.Request(0, 256.0f);
+        r.Request(1, 256.0f);
+        r.Update();
+        EXPECT(r.GetFirstLevel(0) == 0);
+        EXPECT(r.GetFirstLevel(1) == 2);
+        EXPECT(r.GetStats().bytesUploaded == full);
+
+        r.Request(0, 256.0f);
+        r.Request(1, 256.0f);
+        r.Update();
+        EXPECT(r.GetFirstLevel(1) == 0);
+        EXPECT(r.GetStats().bytesUploaded == full);
+    }
+
+    // BC top levels must be whole 4x4 blocks.
+    void BlockAlignedLowestLevel()
+    {
+        TextureImage bc = MakeImage(1000, TextureFormat::BC7);      // 1000, 500, 250, 125, 62, ...
+        TextureImage rgba = MakeImage(1000);
+        EXPECT(TextureResidency::LowestFirstLevel(rgba, 64) == 4);   // 62x62
+        EXPECT(TextureResidency::LowestFirstLevel(bc, 64) == 1);     // 250 is not a multiple of 4
+
+        TextureResidency r;
+        r.SetDesc(Desc(1, 64));
+        const uint32_t id = r.Add(bc);
+        EXPECT(r.GetLowestFirstLevel(id) == 1);
+        EXPECT(r.GetFirstLevel(id) == 1);
+
+        TextureImage aligned = MakeImage(1024, TextureFormat::BC1);
+        EXPECT(TextureResidency::LowestFirstLevel(aligned, 64) == 4);
+    }
+}
+
+int main()
+{
+    BudgetFits();
+    const std::vector<uint32_t> a = LruEviction();
+    const std::vector<uint32_t> b = LruEviction();
+    EXPECT(a == b);                                                   // same inputs, same decisions
+    TrimBeyondRequest();
+    LargestTopLevelDemotion();
+    UploadLimit();
+    BlockAlignedLowestLevel();
+
+    return TestCheck::Finish("TextureResidency");
+}
@@ -0,0 +1,224 @@
+// TransformSystemTest.cpp: hierarchy propagation of TransformSystem (ctest).
+//
+// A plain model keeps every transform's local TRS and parent and composes
+// the expected world matrix the way entity parenting does
+// (S * R * T * parentWorld). TransformSystem::Update must match it after
+// creation, moves, reparenting (including a parent created after its
+// child) and destruction, on every SIMD path of TransformMath, and must
+// only recompute the moved subtrees.
+
+#include "TestCheck.h"
+#include "TransformSystem.h"
+#include "TransformMath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+    constexpr float MAX_ERROR = 1e-3f;
+
+    struct Node
+    {
+        XMFLOAT3        position{ 0.0f, 0.0f, 0.0f };
+        XMFLOAT4        rotation{ 0.0f, 0.0f, 0.0f, 1.0f };
+        XMFLOAT3        scale{ 1.0f, 1.0f, 1.0f };
+        TransformHandle parent = INVALID_TRANSFORM;
+        bool            alive  = true;
+    };
+
+    // Expected state, indexed by handle.
+    struct Model
+    {
+        std::vector<Node> nodes;
+
+        XMMATRIX World(TransformHandle handle) const
+        {
+            const Node& n = nodes[handle];
+            XMMATRIX local =
+                XMMatrixScalingFromVector(XMLoadFloat3(&n.scale)) *
+                XMMatrixRotationQuaternion(XMLoadFloat4(&n.rotation)) *
+                XMMatrixTranslationFromVector(XMLoadFloat3(&n.position));
+            return n.parent == INVALID_TRANSFORM ? local : local * World(n.parent);
+        }
+    };
+
+    struct Fixture
+    {
+        TransformSystem system;
+        Model           model;
+        std::mt19937    rng{ 42 };
+
+        TransformHandle Create(TransformHandle parent)
+        {
+            std::uniform_real_distribution<float> pos(-5.0f, 5.0f);
+            std::uniform_real_distribution<float> angle(-XM_PI, XM_PI);
+            std::uniform_real_distribution<float> scl(0.5f, 1.5f);
+
+            Node n;
+            n.position = XMFLOAT3(pos(rng), pos(rng), pos(rng));
+            XMStoreFloat4(&n.rotation, XMQuaternionRotationRollPitchYaw(angle(rng), angle(rng), angle(rng)));
+            n.scale  = XMFLOAT3(scl(rng), scl(rng), scl(rng));
+            n.parent = parent;
+
+            const TransformHandle handle = system.Create(parent);
+            system.SetLocal(handle, n.position, n.rotation, n.scale);
+
+            if (model.nodes.size() <= handle) model.nodes.resize(handle + 1);
+            model.nodes[handle] = n;
+            return handle;
+        }
+
+        void Move(TransformHandle handle, float x, float y, float z)
+        {
+            model.nodes[handle].position = XMFLOAT3(x, y, z);
+            system.SetPosition(handle, x, y, z);
+        }
+
+        float MaxError() const
+        {
+            float err = 0.0f;
+            for (TransformHandle h = 0; h < static_cast<TransformHandle>(model.nodes.size()); ++h)
+            {
+                if (!model.nodes[h].alive) continue;
+
+                XMFLOAT4X4 expected, actual;
+                XMStoreFloat4x4(&expected, model.World(h));
+                XMStoreFloat4x4(&actual, system.GetWorldMatrix(h));
+                for (int r = 0; r < 4; ++r)
+                    for (int c = 0; c < 4; ++c)
+                        err = (std::max)(err, std::fabs(expected.m[r][c] - actual.m[r][c]));
+            }
+            return err;
+        }
+    };
+
+    // Chains of depth 4 plus a branching tree; odd counts leave SIMD tails.
+    void BuildHierarchy(Fixture& s, std::vector<TransformHandle>& roots)
+    {
+        for (int chain = 0; chain < 251; ++chain)
+        {
+            TransformHandle h = s.Create(INVALID_TRANSFORM);
+            roots.push_back(h);
+            for (int depth = 1; depth < 4; ++depth)
+                h = s.Create(h);
+        }
+
+        const TransformHandle treeRoot = s.Create(INVALID_TRANSFORM);
+        roots.push_back(treeRoot);
+        std::vector<TransformHandle> level{ treeRoot };
+        for (int depth = 0; depth < 5; ++depth)
+        {
+            std::vector<TransformHandle> next;
+            for (TransformHandle parent : level)
+                for (int c = 0; c < 3; ++c)
+                    next.push_back(s.Create(parent));
+            level.swap(next);
+        }
+    }
+
+    void TestPropagation(TransformMath::SimdPath path)
+    {
+        TransformMath::SetPath(path);
+
+        Fixture s;
+        std::vector<TransformHandle> roots;
+        BuildHierarchy(s, roots);
+
+        const uint32_t count = s.system.GetCount();
+        EXPECT(s.system.Update() == count);
+        EXPECT(s.MaxError() < MAX_ERROR);
+
+        // Nothing moved: nothing recomputed.
+        EXPECT(s.system.Update() == 0);
+
+        // Moving a chain root recomputes exactly its chain.
+        s.Move(roots[0], 1.0f, 2.0f, 3.0f);
+        s.Move(roots[7], -4.0f, 0.5f, 9.0f);
+        EXPECT(s.system.Update() == 8);
+        EXPECT(s.MaxError() < MAX_ERROR);
+
+        // Moving the tree root recomputes the whole tree (1+3+9+27+81+243).
+        s.Move(roots.back(), 0.0f, 10.0f, 0.0f);
+        EXPECT(s.system.Update() == 364);
+        EXPECT(s.MaxError() < MAX_ERROR);
+
+        std::printf("%s: propagation max error %g\n",
+                    TransformMath::GetPathName(path), static_cast<double>(s.MaxError()));
+    }
+
+    void TestReparent()
+    {
+        Fixture s;
+        const TransformHandle child  = s.Create(INVALID_TRANSFORM);
+        const TransformHandle grand  = s.Create(child);
+        const TransformHandle parent = s.Create(INVALID_TRANSFORM); // slot after its future child
+        s.system.Update();
+
+        // Parent created after the child: Update must re-sort before composing.
+        EXPECT(s.system.SetParent(child, parent));
+        s.model.nodes[child].parent = parent;
+        s.Move(parent, 3.0f, -1.0f, 2.0f);
+        s.system.Update();
+        EXPECT(s.system.GetParent(child) == parent);
+        EXPECT(s.MaxError() < MAX_ERROR);
+
+        // Cycles are rejected and change nothing.
+        EXPECT(!s.system.SetParent(parent, grand));
+        EXPECT(s.system.GetParent(parent) == INVALID_TRANSFORM);
+
+        // Detach: the child's world falls back to its local matrix.
+        EXPECT(s.system.SetParent(child, INVALID_TRANSFORM));
+        s.model.nodes[child].parent = INVALID_TRANSFORM;
+        s.system.Update();
+        EXPECT(s.MaxError() < MAX_ERROR);
+    }
+
+    void TestDestroy()
+    {
+        Fixture s;
+        const TransformHandle root  = s.Create(INVALID_TRANSFORM);
+        const TransformHandle mid   = s.Create(root);
+        const TransformHandle leafA = s.Create(mid);
+        const TransformHandle leafB = s.Create(mid);
+        s.system.Update();
+
+        // Children of a destroyed transform become roots with their local TRS.
+        s.system.Destroy(mid);
+        s.model.nodes[mid].alive    = false;
+        s.model.nodes[leafA].parent = INVALID_TRANSFORM;
+        s.model.nodes[leafB].parent = INVALID_TRANSFORM;
+        s.system.Update();
+
+        EXPECT(!s.system.IsValid(mid));
+        EXPECT(s.system.GetParent(leafA) == INVALID_TRANSFORM);
+        EXPECT(s.system.GetCount() == 3);
+        EXPECT(s.MaxError() < MAX_ERROR);
+
+        // The freed handle is reused and parented again.
+        const TransformHandle reused = s.Create(root);
+        EXPECT(reused == mid);
+        s.Move(root, 0.0f, 0.0f, -7.0f);
+        s.system.Update();
+        EXPECT(s.MaxError() < MAX_ERROR);
+    }
+}
+
+int main()
+{
+    const TransformMath::SimdPath supported = TransformMath::GetSupportedPath();
+    for (uint8_t p = 0; p <= static_cast<uint8_t>(supported); ++p)
+        TestPropagation(static_cast<TransformMath::SimdPath>(p));
+    TransformMath::SetPath(supported);
+
+    TestReparent();
+    TestDestroy();
+
+    return TestCheck::Finish("TransformSystem");
+}
@@ -0,0 +1,224 @@
+// VertexPackerTest.cpp: accuracy of the packed vertex layout (ctest).
+//
+// Every attribute goes through PackVertex and back through Unpack and is
+// compared with what went in. The normal bound is the reason the layout
+// keeps plain SNORM8 xyz instead of an octahedral encoding: after
+// renormalizing, no direction on the sphere is off by more than ~0.38
+// degrees, so 0.4 is asserted here.
+
+#include "TestCheck.h"
+#include "VertexPacker.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+using namespace DirectX;
+
+namespace
+{
+    constexpr double PI               = 3.14159265358979323846;
+    constexpr double MAX_NORMAL_ERROR = 0.4;                        // degrees
+    constexpr int    DIRECTIONS       = 20000;
+
+    UnpackedVertex MakeVertex()
+    {
+        UnpackedVertex v{};
+        v.normal      = XMFLOAT3(0.0f, 0.0f, 1.0f);
+        v.tangent     = XMFLOAT4(1.0f, 0.0f, 0.0f, 1.0f);
+        v.color       = XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+        v.boneWeights = XMFLOAT4(1.0f, 0.0f, 0.0f, 0.0f);
+        return v;
+    }
+
+    UnpackedVertex RoundTrip(const UnpackedVertex& in, uint32_t stride = VertexPacker::STRIDE)
+    {
+        uint8_t buffer[VertexPacker::STRIDE_SKINNED] = {};
+        VertexPacker::PackVertex(in, stride, buffer);
+        UnpackedVertex out;
+        VertexPacker::Unpack(buffer, stride, out);
+        return out;
+    }
+
+    // Evenly spread unit vectors (Fibonacci sphere).
+    XMFLOAT3 Direction(int i, int count)
+    {
+        const double z   = 1.0 - (2.0 * i + 1.0) / count;
+        const double r   = std::sqrt((std::max)(0.0, 1.0 - z * z));
+        const double phi = i * PI * (3.0 - std::sqrt(5.0));
+        return XMFLOAT3(static_cast<float>(r * std::cos(phi)), static_cast<float>(r * std::sin(phi)),
+                        static_cast<float>(z));
+    }
+
+    double AngleDegrees(const XMFLOAT3& a, float bx, float by, float bz)
+    {
+        const double la  = std::sqrt(double(a.x) * a.x + double(a.y) * a.y + double(a.z) * a.z);
+        const double lb  = std::sqrt(double(bx) * bx + double(by) * by + double(bz) * bz);
+        const double dot = (double(a.x) * bx + double(a.y) * by + double(a.z) * bz) / (la * lb);
+        return std::acos((std::min)(1.0, (std::max)(-1.0, dot))) * 180.0 / PI;
+    }
+
+    void Positions()
+    {
+        const XMFLOAT3 samples[] = {
+            { 0.0f, 0.0f, 0.0f }, { 1.5f, -2.25f, 1000.125f }, { -1e-7f, 3.0e5f, -0.3f } };
+        for (const XMFLOAT3& p : samples)
+        {
+            UnpackedVertex v = MakeVertex();
+            v.position = p;
+            const UnpackedVertex r = RoundTrip(v);
+            EXPECT(r.position.x == p.x && r.position.y == p.y && r.position.z == p.z);
+        }
+    }
+
+    void Normals()
+    {
+        double worst = 0.0;
+        for (int i = 0; i < DIRECTIONS; ++i)
+        {
+            UnpackedVertex v = MakeVertex();
+            v.normal = Direction(i, DIRECTIONS);
+            const UnpackedVertex r = RoundTrip(v);
+            worst = (std::max)(worst, AngleDegrees(v.normal, r.normal.x, r.normal.y, r.normal.z));
+        }
+        std::printf("normal: worst error %.4f degrees (bound %.1f)\n", worst, MAX_NORMAL_ERROR);
+        EXPECT(worst <= MAX_NORMAL_ERROR);
+
+        // Unnormalized input is normalized before quantizing.
+        UnpackedVertex v = MakeVertex();
+        v.normal = XMFLOAT3(0.0f, 3.0f, 0.0f);
+        EXPECT(RoundTrip(v).normal.y == 1.0f);
+    }
+
+    void Tangents()
+    {
+        double worst = 0.0;
+        for (int i = 0; i < DIRECTIONS; ++i)
+        {
+            const XMFLOAT3 d = Direction(i, DIRECTIONS);
+            UnpackedVertex v = MakeVertex();
+            v.tangent = XMFLOAT4(d.x, d.y, d.z, (i & 1) ? -1.0f : 1.0f);
+            const UnpackedVertex r = RoundTrip(v);
+            worst = (std::max)(worst, AngleDegrees(d, r.tangent.x, r.tangent.y, r.tangent.z));
+            EXPECT(r.tangent.w == v.tangent.w);
+        }
+        EXPECT(worst <= MAX_NORMAL_ERROR);
+
+        // Handedness is only a sign; any negative w becomes -1.
+        UnpackedVertex v = MakeVertex();
+        v.tangent.w = -0.2f;
+        EXPECT(RoundTrip(v).tangent.w == -1.0f);
+    }
+
+    void TexCoords()
+    {
+        // Exact where half can hold the value.
+        const float exact[] = { 0.0f, 0.5f, 1.0f, -1.0f, 0.25f, 2.0f };
+        for (float uv : exact)
+        {
+            UnpackedVertex v = MakeVertex();
+            v.uv1 = XMFLOAT2(uv, -uv);
+            v.uv2 = XMFLOAT2(uv, uv);
+            const UnpackedVertex r = RoundTrip(v);
+            EXPECT(r.uv1.x == uv && r.uv1.y == -uv && r.uv2.x == uv && r.uv2.y == uv);
+        }
+
+        // Elsewhere within half a unit in the last place: |uv| * 2^-11.
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> dist(-4.0f, 4.0f);
+        bool withinBound = true;
+        for (int i = 0; i < 10000; ++i)
+        {
+            UnpackedVertex v = MakeVertex();
+            v.uv1 = XMFLOAT2(dist(rng), dist(rng));
+            const UnpackedVertex r = RoundTrip(v);
+            withinBound &= std::fabs(r.uv1.x - v.uv1.x) <= std::fabs(v.uv1.x) * 0x1p-11f + 0x1p-25f;
+            withinBound &= std::fabs(r.uv1.y - v.uv1.y) <= std::fabs(v.uv1.y) * 0x1p-11f + 0x1p-25f;
+        }
+        EXPECT(withinBound);
+    }
+
+    void Colors()
+    {
+        bool withinBound = true;
+        for (int i = 0; i <= 1000; ++i)
+        {
+            const float c = i / 1000.0f;
+            UnpackedVertex v = MakeVertex();
+            v.color = XMFLOAT4(c, 1.0f - c, c * c, 0.5f);
+            const UnpackedVertex r = RoundTrip(v);
+            withinBound &= std::fabs(r.color.x - v.color.x) <= 0.5f / 255.0f + 1e-6f;
+            withinBound &= std::fabs(r.color.y - v.color.y) <= 0.5f / 255.0f + 1e-6f;
+            withinBound &= std::fabs(r.color.z - v.color.z) <= 0.5f / 255.0f + 1e-6f;
+        }
+        EXPECT(withinBound);
+    }
+
+    void Weights()
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+        bool sumIs255 = true, withinBound = true;
+        for (int i = 0; i < 20000; ++i)
+        {
+            float w[4] = { dist(rng), dist(rng), dist(rng), dist(rng) };
+            if (i % 4 == 1) w[3] = 0.0f;                            // fewer than four bones
+            if (i % 4 == 2) w[2] = w[3] = 0.0f;
+            const float sum = w[0] + w[1] + w[2] + w[3];
+
+            uint8_t packed[4];
+            VertexPacker::PackWeights(XMFLOAT4(w[0], w[1], w[2], w[3]), packed);
+            sumIs255 &= packed[0] + packed[1] + packed[2] + packed[3] == 255;
+
+            const int largest = static_cast<int>(std::max_element(w, w + 4) - w);
+            for (int k = 0; k < 4; ++k)
+            {
+                // Rounding is off by at most half a step; the dominant
+                // bone also takes up what the others missed.
+                const float error = std::fabs(packed[k] / 255.0f - w[k] / sum);
+                withinBound &= error <= (k == largest ? 2.0f : 0.5f) / 255.0f + 1e-5f;
+            }
+        }
+        EXPECT(sumIs255);
+        EXPECT(withinBound);
+
+        uint8_t packed[4];
+        VertexPacker::PackWeights(XMFLOAT4(0.0f, 0.0f, 0.0f, 0.0f), packed);  // no weights: bone 0
+        EXPECT(packed[0] == 255 && packed[1] == 0 && packed[2] == 0 && packed[3] == 0);
+    }
+
+    void Skinned()
+    {
+        UnpackedVertex v = MakeVertex();
+        v.position    = XMFLOAT3(1.0f, 2.0f, 3.0f);
+        v.uv1         = XMFLOAT2(0.5f, 0.25f);
+        v.boneIndices = XMUINT4{ 0, 17, 200, 255 };
+        v.boneWeights = XMFLOAT4(0.4f, 0.3f, 0.2f, 0.1f);
+
+        const UnpackedVertex r = RoundTrip(v, VertexPacker::STRIDE_SKINNED);
+        EXPECT(r.boneIndices.x == 0 && r.boneIndices.y == 17 && r.boneIndices.z == 200 && r.boneIndices.w == 255);
+        EXPECT(std::fabs(r.boneWeights.x + r.boneWeights.y + r.boneWeights.z + r.boneWeights.w - 1.0f) < 1e-5f);
+        EXPECT(r.position.x == 1.0f && r.position.y == 2.0f && r.position.z == 3.0f);
+        EXPECT(r.uv1.x == 0.5f && r.uv1.y == 0.25f);
+
+        // Unskinned stride: no bone block, Unpack reports bone 0 at full weight.
+        const UnpackedVertex plain = RoundTrip(v);
+        EXPECT(plain.boneIndices.x == 0 && plain.boneIndices.y == 0);
+        EXPECT(plain.boneWeights.x == 1.0f && plain.boneWeights.y == 0.0f);
+    }
+}
+
+int main()
+{
+    Positions();
+    Normals();
+    Tangents();
+    TexCoords();
+    Colors();
+    Weights();
+    Skinned();
+
+    return TestCheck::Finish("VertexPacker");
+}
@@ -0,0 +1,135 @@
+// BlockCompressorTest.cpp: PSNR floors of the BC encoders (ctest).
+//
+// Fixed, generated images per usage; every level of a full mip chain is
+// compressed, decoded and compared against its source. Level 0 and the
+// worst level have separate floors: the 4x4 level holds the whole image
+// in one block and scores far lower. The floors sit a little below what
+// the encoders reach today, so a change that loses quality fails here
+// before it reaches cooked assets.
+
+#include "BlockCompressor.h"
+#include "MipBuilder.h"
+#include "TestCheck.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+    uint8_t ToByte(double v)
+    {
+        return static_cast<uint8_t>(std::lround(v < 0.0 ? 0.0 : (v > 255.0 ? 255.0 : v)));
+    }
+
+    TextureImage MakeImage(uint32_t width, uint32_t height)
+    {
+        TextureImage image;
+        image.width  = width;
+        image.height = height;
+        image.pixels.resize(static_cast<size_t>(width) * height * 4);
+        return image;
+    }
+
+    // Smooth color gradients with a few hard edges and some texture detail.
+    TextureImage MakeColor(uint32_t width, uint32_t height, bool alpha)
+    {
+        TextureImage image = MakeImage(width, height);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const double u = static_cast<double>(x) / width;
+                const double v = static_cast<double>(y) / height;
+                const bool   brick = ((x / 16 + (y / 8) % 2) % 2) == 0;
+                uint8_t* p = &image.pixels[(static_cast<size_t>(y) * width + x) * 4];
+                p[0] = ToByte(200.0 * u + (brick ? 40.0 : 0.0) + 10.0 * std::sin(x * 0.7));
+                p[1] = ToByte(60.0 + 120.0 * v + 8.0 * std::cos(y * 0.9));
+                p[2] = ToByte(90.0 + 80.0 * std::sin(6.2831853 * (u + v)));
+                p[3] = alpha ? ToByte(255.0 * (0.5 + 0.5 * std::sin(3.0 * u + 2.0 * v))) : 255;
+            }
+        }
+        return image;
+    }
+
+    // Tangent-space normals of a field of bumps, xy in red/green.
+    TextureImage MakeNormal(uint32_t width, uint32_t height)
+    {
+        TextureImage image = MakeImage(width, height);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                const double dx = 0.6 * std::cos(x * 0.25) * std::cos(y * 0.15);
+                const double dy = -0.4 * std::sin(x * 0.25) * std::sin(y * 0.15);
+                const double len = std::sqrt(dx * dx + dy * dy + 1.0);
+                uint8_t* p = &image.pixels[(static_cast<size_t>(y) * width + x) * 4];
+                p[0] = ToByte(127.5 * (-dx / len + 1.0));
+                p[1] = ToByte(127.5 * (-dy / len + 1.0));
+                p[2] = ToByte(127.5 * (1.0 / len + 1.0));
+                p[3] = 255;
+            }
+        }
+        return image;
+    }
+
+    // Single channel data in red (roughness-like).
+    TextureImage MakeScalar(uint32_t width, uint32_t height)
+    {
+        TextureImage image = MakeImage(width, height);
+        for (uint32_t y = 0; y < height; ++y)
+        {
+            for (uint32_t x = 0; x < width; ++x)
+            {
+                uint8_t* p = &image.pixels[(static_cast<size_t>(y) * width + x) * 4];
+                p[0] = ToByte(128.0 + 90.0 * std::sin(x * 0.11) * std::cos(y * 0.07) + (((x ^ y) & 8) ? 20.0 : 0.0));
+                p[1] = 0;
+                p[2] = 0;
+                p[3] = 255;
+            }
+        }
+        return image;
+    }
+
+    void Check(const char* name, TextureImage source, TextureUsage usage,
+               TextureFormat format, uint32_t channels, double minTop, double minAll)
+    {
+        MipDesc mips;
+        MipBuilder::Build(source, usage, mips);
+
+        TextureImage compressed, decoded;
+        if (!BlockCompressor::Compress(source, format, compressed) ||
+            !BlockCompressor::Decompress(compressed, decoded))
+        {
+            std::printf("FAIL %s: compress/decompress failed\n", name);
+            TestCheck::Fail();
+            return;
+        }
+
+        const double top = BlockCompressor::Psnr(source, decoded, 0, channels);
+        double worst = top;
+        for (uint32_t level = 1; level < source.mipLevels; ++level)
+        {
+            const double psnr = BlockCompressor::Psnr(source, decoded, level, channels);
+            if (psnr < worst) worst = psnr;
+        }
+
+        const bool ok = top >= minTop && worst >= minAll && compressed.mipLevels == source.mipLevels;
+        std::printf("%s %s: %ux%u, %u levels, PSNR level 0 %.2f dB (floor %.1f), worst %.2f dB (floor %.1f)\n",
+                    ok ? "ok  " : "FAIL", name, source.width, source.height, source.mipLevels,
+                    top, minTop, worst, minAll);
+        if (!ok) TestCheck::Fail();
+    }
+}
+
+int main()
+{
+    Check("BC1 color",        MakeColor(128, 128, false), TextureUsage::Color,  TextureFormat::BC1, PSNR_RGB,        36.0, 16.5);
+    Check("BC7 color",        MakeColor(128, 128, false), TextureUsage::Color,  TextureFormat::BC7, PSNR_RGB,        42.5, 19.0);
+    Check("BC7 color+alpha",  MakeColor(128, 128, true),  TextureUsage::Color,  TextureFormat::BC7, PSNR_RGBA,       39.0, 17.0);
+    Check("BC7 odd size",     MakeColor(90, 38, false),   TextureUsage::Color,  TextureFormat::BC7, PSNR_RGB,        41.0, 26.0);
+    Check("BC4 scalar",       MakeScalar(128, 128),       TextureUsage::Scalar, TextureFormat::BC4, PSNR_R,          48.5, 33.0);
+    Check("BC5 normal",       MakeNormal(128, 128),       TextureUsage::Normal, TextureFormat::BC5, PSNR_R | PSNR_G, 46.0, 36.5);
+
+    return TestCheck::Finish("BlockCompressor");
+}
@@ -0,0 +1,277 @@
+// texcook - offline texture cooker.
+//
+// Decodes a source image (stb_image), builds its mip chain (MipBuilder),
+// compresses it to the BC format that fits its usage (BlockCompressor) and
+// writes a .dds or .ktx2 file (TextureFile) that TexturePool uploads
+// without any decoding. Every level is decoded again and compared with
+// the source; --min-psnr turns that into a check for build scripts.
+//
+//   texcook [options] <input image> <output.dds | output.ktx2>
+
+#include "BlockCompressor.h"
+#include "MipBuilder.h"
+#include "TextureFile.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace
+{
+    struct Options
+    {
+        const char*  input      = nullptr;
+        const char*  output     = nullptr;
+        bool         usageSet   = false;
+        TextureUsage usage      = TextureUsage::Color;
+        bool         formatSet  = false;
+        TextureFormat format    = TextureFormat::BC7;
+        bool         small      = false;
+        bool         mips       = true;
+        MipFilter    filter     = MipFilter::Kaiser;
+        double       minPsnr    = 0.0;
+        bool         quiet      = false;
+    };
+
+    void PrintUsage()
+    {
+        std::printf(
+            "usage: texcook [options] <input> <output.dds|output.ktx2>\n"
+            "  --usage color|normal|linear|scalar  texel usage (default: from the file name, else color)\n"
+            "  --format bc1|bc3|bc4|bc5|bc7|rgba8  override the format chosen for the usage\n"
+            "  --small                             BC1 (BC3 with alpha) instead of BC7 for color/linear\n"
+            "  --mips box|kaiser|none              mip filter (default kaiser)\n"
+            "  --min-psnr <dB>                     fail when a level decodes below this PSNR\n"
+            "  --quiet                             print errors only\n");
+    }
+
+    const char* UsageName(TextureUsage usage)
+    {
+        switch (usage)
+        {
+        case TextureUsage::Normal: return "normal";
+        case TextureUsage::Linear: return "linear";
+        case TextureUsage::Scalar: return "scalar";
+        default:                   return "color";
+        }
+    }
+
+    const char* FormatName(TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::BC1: return "BC1";
+        case TextureFormat::BC3: return "BC3";
+        case TextureFormat::BC4: return "BC4";
+        case TextureFormat::BC5: return "BC5";
+        case TextureFormat::BC7: return "BC7";
+        default:                 return "RGBA8";
+        }
+    }
+
+    bool ParseUsage(const char* s, TextureUsage& usage)
+    {
+        if (!std::strcmp(s, "color"))  { usage = TextureUsage::Color;  return true; }
+        if (!std::strcmp(s, "normal")) { usage = TextureUsage::Normal; return true; }
+        if (!std::strcmp(s, "linear")) { usage = TextureUsage::Linear; return true; }
+        if (!std::strcmp(s, "scalar")) { usage = TextureUsage::Scalar; return true; }
+        return false;
+    }
+
+    bool ParseFormat(const char* s, TextureFormat& format)
+    {
+        if (!std::strcmp(s, "bc1"))   { format = TextureFormat::BC1;   return true; }
+        if (!std::strcmp(s, "bc3"))   { format = TextureFormat::BC3;   return true; }
+        if (!std::strcmp(s, "bc4"))   { format = TextureFormat::BC4;   return true; }
+        if (!std::strcmp(s, "bc5"))   { format = TextureFormat::BC5;   return true; }
+        if (!std::strcmp(s, "bc7"))   { format = TextureFormat::BC7;   return true; }
+        if (!std::strcmp(s, "rgba8")) { format = TextureFormat::RGBA8; return true; }
+        return false;
+    }
+
+    // brick_normal.png, brick_n.png -> Normal; orm.png, brick_orm.png ->
+    // Linear; ao.png, brick-ao.png, brick_roughness.png, ... -> Scalar;
+    // else Color.
+    TextureUsage GuessUsage(const std::string& path)
+    {
+        std::string stem = std::filesystem::path(path).stem().string();
+        std::transform(stem.begin(), stem.end(), stem.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+        auto endsWith = [&](const char* suffix) {
+            const size_t n = std::strlen(suffix);
+            return stem.size() >= n && stem.compare(stem.size() - n, n, suffix) == 0;
+        };
+        // The whole stem, or its last word after a separator ("storm" is
+        // not an ORM map).
+        auto lastWordIs = [&](const char* word) {
+            const size_t n = std::strlen(word);
+            return endsWith(word) && (stem.size() == n || !std::isalnum(static_cast<unsigned char>(stem[stem.size() - n - 1])));
+        };
+
+        if (stem.find("normal") != std::string::npos || endsWith("_n") || endsWith("_nrm"))
+            return TextureUsage::Normal;
+        if (lastWordIs("orm"))
+            return TextureUsage::Linear;
+        if (stem.find("occlusion") != std::string::npos || stem.find("rough") != std::string::npos ||
+            stem.find("metal") != std::string::npos || lastWordIs("ao"))
+            return TextureUsage::Scalar;
+        return TextureUsage::Color;
+    }
+
+    // Channels the format keeps for the usage; the others are not compared.
+    uint32_t PsnrChannels(TextureUsage usage, TextureFormat format, bool hasAlpha)
+    {
+        switch (format)
+        {
+        case TextureFormat::BC4: return PSNR_R;
+        case TextureFormat::BC5: return PSNR_R | PSNR_G;
+        case TextureFormat::BC1: return PSNR_RGB;
+        default:
+            if (usage == TextureUsage::Scalar) return PSNR_R;
+            if (usage == TextureUsage::Normal) return PSNR_R | PSNR_G;
+            return hasAlpha ? PSNR_RGBA : PSNR_RGB;
+        }
+    }
+
+    bool ParseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            if (!std::strcmp(arg, "--usage") && hasValue)
+            {
+                if (!ParseUsage(argv[++i], opt.usage)) return false;
+                opt.usageSet = true;
+            }
+            else if (!std::strcmp(arg, "--format") && hasValue)
+            {
+                if (!ParseFormat(argv[++i], opt.format)) return false;
+                opt.formatSet = true;
+            }
+            else if (!std::strcmp(arg, "--mips") && hasValue)
+            {
+                const char* v = argv[++i];
+                if      (!std::strcmp(v, "box"))    opt.filter = MipFilter::Box;
+                else if (!std::strcmp(v, "kaiser")) opt.filter = MipFilter::Kaiser;
+                else if (!std::strcmp(v, "none"))   opt.mips = false;
+                else return false;
+            }
+            else if (!std::strcmp(arg, "--min-psnr") && hasValue)
+            {
+                opt.minPsnr = std::atof(argv[++i]);
+            }
+            else if (!std::strcmp(arg, "--small"))  opt.small = true;
+            else if (!std::strcmp(arg, "--quiet"))  opt.quiet = true;
+            else if (arg[0] == '-')                 return false;
+            else if (!opt.input)                    opt.input = arg;
+            else if (!opt.output)                   opt.output = arg;
+            else                                    return false;
+        }
+        return opt.input && opt.output;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!ParseArgs(argc, argv, opt))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    TextureFileType fileType;
+    if (!TextureFile::TypeFromPath(opt.output, fileType))
+    {
+        std::fprintf(stderr, "texcook: output must end in .dds or .ktx2: %s\n", opt.output);
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    int width = 0, height = 0, channels = 0;
+    stbi_uc* data = stbi_load(opt.input, &width, &height, &channels, 4);
+    if (!data)
+    {
+        std::fprintf(stderr, "texcook: cannot load %s: %s\n", opt.input, stbi_failure_reason());
+        return 1;
+    }
+
+    TextureImage source;
+    source.width  = static_cast<uint32_t>(width);
+    source.height = static_cast<uint32_t>(height);
+    source.pixels.assign(data, data + static_cast<size_t>(width) * height * 4);
+    stbi_image_free(data);
+
+    if (!opt.usageSet)
+        opt.usage = GuessUsage(opt.input);
+    if (opt.mips)
+        MipBuilder::Build(source, opt.usage, MipDesc{ opt.filter, 0 });
+
+    const bool hasAlpha = BlockCompressor::HasAlpha(source);
+    if (!opt.formatSet)
+        opt.format = BlockCompressor::ChooseFormat(opt.usage, hasAlpha, opt.small);
+    if (hasAlpha && opt.format == TextureFormat::BC1 && !opt.quiet)
+        std::printf("texcook: warning: BC1 drops the alpha channel of %s\n", opt.input);
+
+    TextureImage cooked;
+    if (opt.format == TextureFormat::RGBA8)
+        cooked = source;
+    else if (!BlockCompressor::Compress(source, opt.format, cooked))
+    {
+        std::fprintf(stderr, "texcook: compression failed: %s\n", opt.input);
+        return 1;
+    }
+
+    TextureImage decoded;
+    if (!BlockCompressor::Decompress(cooked, decoded))
+    {
+        std::fprintf(stderr, "texcook: cannot decode the cooked texture\n");
+        return 1;
+    }
+
+    const uint32_t mask = PsnrChannels(opt.usage, opt.format, hasAlpha);
+    double minPsnr = 99.0;
+    uint32_t worstLevel = 0;
+    for (uint32_t level = 0; level < cooked.mipLevels; ++level)
+    {
+        const double psnr = BlockCompressor::Psnr(source, decoded, level, mask);
+        if (psnr < minPsnr) { minPsnr = psnr; worstLevel = level; }
+    }
+    const double basePsnr = BlockCompressor::Psnr(source, decoded, 0, mask);
+
+    if (opt.minPsnr > 0.0 && minPsnr < opt.minPsnr)
+    {
+        std::fprintf(stderr, "texcook: %s: level %u at %.2f dB, below --min-psnr %.2f; nothing written\n",
+                     opt.input, worstLevel, minPsnr, opt.minPsnr);
+        return 2;
+    }
+
+    if (!TextureFile::Write(opt.output, cooked, fileType))
+    {
+        std::fprintf(stderr, "texcook: cannot write %s\n", opt.output);
+        return 1;
+    }
+
+    if (!opt.quiet)
+    {
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        const size_t rawBytes = source.LevelOffset(source.mipLevels);
+        const size_t bytes    = cooked.LevelOffset(cooked.mipLevels);
+        std::printf("%s -> %s: %ux%u, %u levels, %s as %s, %zu bytes (%.1f:1), PSNR %.2f dB (min %.2f dB, level %u), %.0f ms\n",
+                    opt.input, opt.output, cooked.width, cooked.height, cooked.mipLevels,
+                    UsageName(opt.usage), FormatName(opt.format), bytes,
+                    static_cast<double>(rawBytes) / static_cast<double>(bytes),
+                    basePsnr, minPsnr, worstLevel, ms);
+    }
+    return 0;
+}